@@ -0,0 +1,482 @@
+// CPreparedInput.cpp: implementation of the CPreparedInput class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <ctype.h>                  // isalpha, isspace
+#include <stdio.h>                  // sprintf
+#include <stdlib.h>                 // strtod, strtol
+#include <string.h>                 // strchr, strlen
+#include <algorithm>                // std::transform
+
+#include "CPreparedInput.hxx"       // CPreparedInput
+#include "Keywords.h"               // Keywords::KEYWORDS
+
+static size_t
+find_placeholder(const std::string& text, size_t pos, size_t& len)
+{
+	// position of the next {name} at or after pos, npos if none
+	while ((pos = text.find('{', pos)) != std::string::npos)
+	{
+		size_t end = pos + 1;
+		if (end < text.size() && (isalpha((int) text[end]) || text[end] == '_'))
+		{
+			while (end < text.size() && (isalnum((int) text[end]) || text[end] == '_'))
+			{
+				++end;
+			}
+			if (end < text.size() && text[end] == '}')
+			{
+				len = end + 1 - pos;
+				return pos;
+			}
+		}
+		++pos;
+	}
+	return std::string::npos;
+}
+
+static void
+split_tokens(const std::string& line, std::vector<std::string>& tokens)
+{
+	tokens.clear();
+	size_t i = 0;
+	while (i < line.size())
+	{
+		while (i < line.size() && isspace((int) line[i])) ++i;
+		if (i == line.size()) break;
+		size_t j = i;
+		while (j < line.size() && !isspace((int) line[j])) ++j;
+		tokens.push_back(line.substr(i, j - i));
+		i = j;
+	}
+}
+
+static Keywords::KEYWORDS
+keyword(const std::string& token)
+{
+	if (token.empty() || !isalpha((int) token[0]))
+	{
+		return Keywords::KEY_NONE;
+	}
+	std::string key(token);
+	std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+	return Keywords::Keyword_search(key);
+}
+
+CPreparedInput::CPreparedInput(void)
+: m_bTextOnly(false)
+{
+}
+
+CPreparedInput::~CPreparedInput(void)
+{
+}
+
+void CPreparedInput::Parse(const char* input)
+{
+	this->m_names.clear();
+	this->m_index.clear();
+	this->m_values.clear();
+	this->m_integer.clear();
+	this->m_bound.clear();
+	this->m_simulations.clear();
+	this->m_bTextOnly = false;
+
+	//
+	// split into simulations at END; each keeps its text and its
+	// logical lines (split at ';', comments removed)
+	//
+	std::vector< std::pair< std::string, std::vector<std::string> > > sims;
+	std::string text;
+	std::vector<std::string> lines;
+	std::vector<std::string> tokens;
+	const char* p = input ? input : "";
+	while (*p)
+	{
+		const char* e = ::strchr(p, '\n');
+		std::string physical = e ? std::string(p, e - p) : std::string(p);
+		p = e ? e + 1 : p + ::strlen(p);
+		text += physical;
+		text += "\n";
+
+		std::string logical = physical.substr(0, physical.find('#'));
+		if (logical.find('\\') != std::string::npos)
+		{
+			// continued lines
+			this->m_bTextOnly = true;
+		}
+		bool end = false;
+		size_t start = 0;
+		for (;;)
+		{
+			size_t semi = logical.find(';', start);
+			std::string part = logical.substr(start, (semi == std::string::npos) ? semi : semi - start);
+			split_tokens(part, tokens);
+			if (!tokens.empty())
+			{
+				if (end)
+				{
+					// input following END on the same line
+					this->m_bTextOnly = true;
+				}
+				if (keyword(tokens[0]) == Keywords::KEY_END)
+				{
+					end = true;
+				}
+				else
+				{
+					lines.push_back(part);
+				}
+			}
+			if (semi == std::string::npos) break;
+			start = semi + 1;
+		}
+		if (end)
+		{
+			sims.push_back(std::make_pair(text, lines));
+			text.clear();
+			lines.clear();
+		}
+	}
+	if (lines.size())
+	{
+		text += "END\n";
+		sims.push_back(std::make_pair(text, lines));
+	}
+
+	if (this->m_bTextOnly)
+	{
+		PreparedSimulation sim;
+		sim.native = false;
+		this->add_segments(sim, std::string(input ? input : ""));
+		this->m_simulations.push_back(sim);
+		return;
+	}
+
+	for (size_t i = 0; i < sims.size(); ++i)
+	{
+		PreparedSimulation sim;
+		this->add_segments(sim, sims[i].first);
+		sim.native = this->parse_blocks(sim, sims[i].second);
+		if (!sim.native)
+		{
+			sim.blocks.clear();
+		}
+		this->m_simulations.push_back(sim);
+	}
+}
+
+size_t CPreparedInput::GetParameterCount(void)const
+{
+	return this->m_names.size();
+}
+
+const std::string& CPreparedInput::GetParameterName(size_t n)const
+{
+	return this->m_names[n];
+}
+
+VRESULT CPreparedInput::SetValue(const char* name, double dValue, bool bInteger)
+{
+	std::map<std::string, int>::const_iterator it = this->m_index.find(name ? name : "");
+	if (it == this->m_index.end())
+	{
+		return VR_INVALIDARG;
+	}
+	this->m_values[it->second]  = dValue;
+	this->m_integer[it->second] = bInteger;
+	this->m_bound[it->second]   = true;
+	return VR_OK;
+}
+
+bool CPreparedInput::IsBound(std::string* missing)const
+{
+	for (size_t i = 0; i < this->m_bound.size(); ++i)
+	{
+		if (!this->m_bound[i])
+		{
+			if (missing) *missing = this->m_names[i];
+			return false;
+		}
+	}
+	return true;
+}
+
+double CPreparedInput::GetValue(const PreparedField& field)const
+{
+	return (field.param < 0) ? field.value : this->m_values[field.param];
+}
+
+size_t CPreparedInput::GetSimulationCount(void)const
+{
+	return this->m_simulations.size();
+}
+
+const PreparedSimulation& CPreparedInput::GetSimulation(size_t n)const
+{
+	return this->m_simulations[n];
+}
+
+bool CPreparedInput::IsTextOnly(void)const
+{
+	return this->m_bTextOnly;
+}
+
+void CPreparedInput::GetText(size_t n, std::string& text)const
+{
+	char buffer[40];
+	const std::vector<PreparedSegment>& segments = this->m_simulations[n].segments;
+
+	text.clear();
+	for (size_t i = 0; i < segments.size(); ++i)
+	{
+		int param = segments[i].param;
+		if (param < 0)
+		{
+			text += segments[i].text;
+		}
+		else
+		{
+			if (this->m_integer[param])
+			{
+				::sprintf(buffer, "%d", (int) this->m_values[param]);
+			}
+			else
+			{
+				::sprintf(buffer, "%.17g", this->m_values[param]);
+			}
+			text += buffer;
+		}
+	}
+}
+
+int CPreparedInput::parameter(const std::string& name)
+{
+	std::map<std::string, int>::const_iterator it = this->m_index.find(name);
+	if (it != this->m_index.end())
+	{
+		return it->second;
+	}
+	int n = (int) this->m_names.size();
+	this->m_index[name] = n;
+	this->m_names.push_back(name);
+	this->m_values.push_back(0.0);
+	this->m_integer.push_back(false);
+	this->m_bound.push_back(false);
+	return n;
+}
+
+void CPreparedInput::add_segments(PreparedSimulation& sim, const std::string& text)
+{
+	size_t pos = 0, len = 0, next;
+	while ((next = find_placeholder(text, pos, len)) != std::string::npos)
+	{
+		PreparedSegment segment;
+		if (next > pos)
+		{
+			segment.text  = text.substr(pos, next - pos);
+			segment.param = -1;
+			sim.segments.push_back(segment);
+		}
+		segment.text.clear();
+		segment.param = this->parameter(text.substr(next + 1, len - 2));
+		sim.segments.push_back(segment);
+		pos = next + len;
+	}
+	if (pos < text.size())
+	{
+		PreparedSegment segment;
+		segment.text  = text.substr(pos);
+		segment.param = -1;
+		sim.segments.push_back(segment);
+	}
+}
+
+bool CPreparedInput::parse_field(const std::string& token, bool bInteger, PreparedField& field)
+{
+	size_t len = 0;
+	if (find_placeholder(token, 0, len) == 0 && len == token.size())
+	{
+		field.value = 0.0;
+		field.param = this->parameter(token.substr(1, len - 2));
+		return true;
+	}
+
+	char *end;
+	field.param = -1;
+	if (bInteger)
+	{
+		long l = ::strtol(token.c_str(), &end, 10);
+		if (end == token.c_str() || *end != '\0' || l < 0)
+		{
+			return false;
+		}
+		field.value = (double) l;
+	}
+	else
+	{
+		field.value = ::strtod(token.c_str(), &end);
+		if (end == token.c_str() || *end != '\0')
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool CPreparedInput::parse_blocks(PreparedSimulation& sim, const std::vector<std::string>& lines)
+{
+	//
+	// Only the MIX, SAVE, COPY and USE forms written by the
+	// drivers are parsed; anything else (including the input
+	// errors read_input reports) leaves the simulation as text
+	//
+	std::vector<std::string> tokens;
+	int mix = -1;
+	for (size_t i = 0; i < lines.size(); ++i)
+	{
+		split_tokens(lines[i], tokens);
+		Keywords::KEYWORDS key = keyword(tokens[0]);
+		if (key == Keywords::KEY_NONE && mix >= 0)
+		{
+			// solution number and mixing fraction
+			PreparedField n, f;
+			if (tokens.size() != 2 || !this->parse_field(tokens[0], true, n) || !this->parse_field(tokens[1], false, f))
+			{
+				return false;
+			}
+			sim.blocks[mix].fields.push_back(n);
+			sim.blocks[mix].fields.push_back(f);
+			continue;
+		}
+
+		PreparedBlock block;
+		PreparedField field;
+		block.keyword = key;
+		block.entity  = Keywords::KEY_NONE;
+		mix = -1;
+		switch (key)
+		{
+		case Keywords::KEY_MIX:
+			// MIX [n [description]]
+			field.value = 1.0;
+			field.param = -1;
+			if (tokens.size() > 1 && !this->parse_field(tokens[1], true, field))
+			{
+				return false;
+			}
+			for (size_t j = 2; j < tokens.size(); ++j)
+			{
+				if (j > 2) block.description += " ";
+				block.description += tokens[j];
+			}
+			block.fields.push_back(field);
+			mix = (int) sim.blocks.size();
+			break;
+
+		case Keywords::KEY_SAVE:
+			// SAVE entity n
+			if (tokens.size() != 3 || !this->parse_field(tokens[2], true, field))
+			{
+				return false;
+			}
+			block.entity = keyword(tokens[1]);
+			switch (block.entity)
+			{
+			case Keywords::KEY_SOLUTION:
+			case Keywords::KEY_EQUILIBRIUM_PHASES:
+			case Keywords::KEY_EXCHANGE:
+			case Keywords::KEY_SURFACE:
+			case Keywords::KEY_GAS_PHASE:
+			case Keywords::KEY_SOLID_SOLUTIONS:
+				break;
+			default:
+				return false;
+			}
+			block.fields.push_back(field);
+			break;
+
+		case Keywords::KEY_USE:
+			// USE entity n|none
+			if (tokens.size() != 3)
+			{
+				return false;
+			}
+			if (tokens[2][0] == 'n' || tokens[2][0] == 'N')
+			{
+				field.value = -2.0;
+				field.param = -1;
+			}
+			else if (!this->parse_field(tokens[2], true, field))
+			{
+				return false;
+			}
+			block.entity = keyword(tokens[1]);
+			switch (block.entity)
+			{
+			case Keywords::KEY_SOLUTION:
+			case Keywords::KEY_MIX:
+			case Keywords::KEY_KINETICS:
+			case Keywords::KEY_REACTION:
+			case Keywords::KEY_REACTION_TEMPERATURE:
+			case Keywords::KEY_REACTION_PRESSURE:
+			case Keywords::KEY_EQUILIBRIUM_PHASES:
+			case Keywords::KEY_EXCHANGE:
+			case Keywords::KEY_SURFACE:
+			case Keywords::KEY_GAS_PHASE:
+			case Keywords::KEY_SOLID_SOLUTIONS:
+				break;
+			default:
+				return false;
+			}
+			block.fields.push_back(field);
+			break;
+
+		case Keywords::KEY_COPY:
+			// COPY entity source target
+			if (tokens.size() != 4 || !this->parse_field(tokens[2], true, field))
+			{
+				return false;
+			}
+			block.fields.push_back(field);
+			if (!this->parse_field(tokens[3], true, field))
+			{
+				return false;
+			}
+			block.fields.push_back(field);
+			block.entity = keyword(tokens[1]);
+			switch (block.entity)
+			{
+			case Keywords::KEY_SOLUTION:
+			case Keywords::KEY_EQUILIBRIUM_PHASES:
+			case Keywords::KEY_REACTION:
+			case Keywords::KEY_MIX:
+			case Keywords::KEY_EXCHANGE:
+			case Keywords::KEY_SURFACE:
+			case Keywords::KEY_REACTION_TEMPERATURE:
+			case Keywords::KEY_REACTION_PRESSURE:
+			case Keywords::KEY_GAS_PHASE:
+			case Keywords::KEY_KINETICS:
+			case Keywords::KEY_SOLID_SOLUTIONS:
+				break;
+			default:
+				return false;
+			}
+			break;
+
+		default:
+			return false;
+		}
+		sim.blocks.push_back(block);
+	}
+
+	for (size_t i = 0; i < sim.blocks.size(); ++i)
+	{
+		if (sim.blocks[i].keyword == Keywords::KEY_MIX && sim.blocks[i].fields.size() < 3)
+		{
+			// a MIX needs at least one solution
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,85 @@
+// CPreparedInput.hxx: interface for the CPreparedInput class.
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined _INC_PREPAREDINPUT_H
+#define _INC_PREPAREDINPUT_H
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include <string>
+#include <map>
+#include <vector>
+#include "Var.h"                    // VRESULT
+
+// A number in a prepared data block, either a literal or a {name} placeholder
+struct PreparedField
+{
+	double                          value;        // literal value
+	int                             param;        // placeholder index, -1 for a literal
+};
+
+// A MIX, SAVE, COPY or USE data block of a prepared simulation
+struct PreparedBlock
+{
+	int                             keyword;      // Keywords::KEYWORDS
+	int                             entity;       // SAVE, COPY and USE: Keywords::KEYWORDS of the entity
+	std::string                     description;  // MIX
+	std::vector<PreparedField>      fields;       // MIX: n_user, then solution and fraction pairs
+	                                              // SAVE and USE: n_user (-2 for USE ... none)
+	                                              // COPY: source, target
+};
+
+// Input text of a prepared simulation, either literal text or a {name} placeholder
+struct PreparedSegment
+{
+	std::string                     text;
+	int                             param;        // placeholder index, -1 for text
+};
+
+// One simulation (up to and including END) of a prepared input
+struct PreparedSimulation
+{
+	std::vector<PreparedSegment>    segments;
+	bool                            native;       // blocks describe the whole simulation
+	std::vector<PreparedBlock>      blocks;
+};
+
+class CPreparedInput
+{
+public:
+	CPreparedInput(void);
+	virtual ~CPreparedInput(void);
+
+	void Parse(const char* input);
+
+	size_t GetParameterCount(void)const;
+	const std::string& GetParameterName(size_t n)const;
+	VRESULT SetValue(const char* name, double dValue, bool bInteger);
+	bool IsBound(std::string* missing)const;
+	double GetValue(const PreparedField& field)const;
+
+	size_t GetSimulationCount(void)const;
+	const PreparedSimulation& GetSimulation(size_t n)const;
+	bool IsTextOnly(void)const;
+	void GetText(size_t n, std::string& text)const;
+
+protected:
+	int parameter(const std::string& name);
+	void add_segments(PreparedSimulation& sim, const std::string& text);
+	bool parse_field(const std::string& token, bool bInteger, PreparedField& field);
+	bool parse_blocks(PreparedSimulation& sim, const std::vector<std::string>& lines);
+
+protected:
+	std::vector<std::string>        m_names;      // placeholder names
+	std::map<std::string, int>      m_index;      // placeholder name -> index
+	std::vector<double>             m_values;     // bound values
+	std::vector<char>               m_integer;    // value was bound as an integer
+	std::vector<char>               m_bound;
+	std::vector<PreparedSimulation> m_simulations;
+	bool                            m_bTextOnly;  // run the whole input as one script
+};
+
+#endif // !defined(_INC_PREPAREDINPUT_H)
@@ -13,6 +13,8 @@
 #include <stdio.h>
 #include <string.h>                 // strlen
 
+#include <algorithm>                // std::copy, std::fill
+
 #include "Debug.h"                  // ASSERT
 
 #if defined(R_SO)
@@ -28,7 +30,10 @@ const size_t RESERVE_COLS = 80;
 CSelectedOutput::CSelectedOutput()
 : m_nRowCount(0)
 {
-	this->m_arrayVar.reserve(RESERVE_COLS);
+	this->m_arrayDouble.reserve(RESERVE_COLS);
+	this->m_arrayType.reserve(RESERVE_COLS);
+	this->m_arrayString.reserve(RESERVE_COLS);
+	this->m_vecOtherCount.reserve(RESERVE_COLS);
 }
 
 CSelectedOutput::~CSelectedOutput()
@@ -39,7 +44,10 @@ void CSelectedOutput::Clear(void)
 {
 	this->m_nRowCount = 0;
 	this->m_vecVarHeadings.clear();
-	this->m_arrayVar.clear();
+	this->m_arrayDouble.clear();
+	this->m_arrayType.clear();
+	this->m_arrayString.clear();
+	this->m_vecOtherCount.clear();
 	this->m_mapHeadingToCol.clear();
 }
 
@@ -87,8 +95,8 @@ VRESULT CSelectedOutput::Get(int nRow, int nCol, VAR* pVAR)const
 	}
 	if (nRow)
 	{
-		ASSERT((size_t)nRow <= this->m_arrayVar[nCol].size());
-		return ::VarCopy(pVAR, &(this->m_arrayVar[nCol])[nRow - 1]);
+		ASSERT((size_t)nRow <= this->m_arrayType[nCol].size());
+		return this->GetCell((size_t)nCol, (size_t)nRow - 1, pVAR);
 	}
 	else
 	{
@@ -96,6 +104,136 @@ VRESULT CSelectedOutput::Get(int nRow, int nCol, VAR* pVAR)const
 	}
 }
 
+VRESULT CSelectedOutput::GetCell(size_t col, size_t row, VAR* pVAR)const
+{
+	pVAR->type = (VAR_TYPE) this->m_arrayType[col][row];
+	switch (pVAR->type)
+	{
+	case TT_EMPTY:
+		break;
+	case TT_ERROR:
+		pVAR->vresult = (VRESULT) (int) this->m_arrayDouble[col][row];
+		break;
+	case TT_LONG:
+		pVAR->lVal = (long) this->m_arrayDouble[col][row];
+		break;
+	case TT_DOUBLE:
+		pVAR->dVal = this->m_arrayDouble[col][row];
+		break;
+	case TT_STRING:
+		{
+			std::map<size_t, std::string>::const_iterator it = this->m_arrayString[col].find(row);
+			ASSERT(it != this->m_arrayString[col].end());
+			pVAR->sVal = ::VarAllocString(it->second.c_str());
+			if (pVAR->sVal == NULL)
+			{
+				pVAR->type = TT_ERROR;
+				pVAR->vresult = VR_OUTOFMEMORY;
+				return pVAR->vresult;
+			}
+		}
+		break;
+	default:
+		ASSERT(false);
+		return VR_BADVARTYPE;
+	}
+	return VR_OK;
+}
+
+void CSelectedOutput::SetCell(size_t col, size_t row, const CVar& var)
+{
+	char old_type = this->m_arrayType[col][row];
+	if (old_type == TT_STRING)
+	{
+		this->m_arrayString[col].erase(row);
+	}
+	if (old_type != TT_DOUBLE)
+	{
+		--this->m_vecOtherCount[col];
+	}
+
+	double d = 0.0;
+	switch (var.type)
+	{
+	case TT_ERROR:
+		d = (double) var.vresult;
+		break;
+	case TT_LONG:
+		d = (double) var.lVal;
+		break;
+	case TT_DOUBLE:
+		d = var.dVal;
+		break;
+	case TT_STRING:
+		this->m_arrayString[col][row] = var.sVal;
+		break;
+	default:
+		break;
+	}
+	this->m_arrayDouble[col][row] = d;
+	this->m_arrayType[col][row] = (char) var.type;
+	if (var.type != TT_DOUBLE)
+	{
+		++this->m_vecOtherCount[col];
+	}
+}
+
+VRESULT CSelectedOutput::GetColumnDoubles(int nCol, double* values, int* types)const
+{
+	if ((size_t)nCol >= this->GetColCount() || nCol < 0)
+	{
+		return VR_INVALIDCOL;
+	}
+	const std::vector<double>& doubles = this->m_arrayDouble[nCol];
+	const std::vector<char>& vtypes = this->m_arrayType[nCol];
+	ASSERT(doubles.size() >= this->m_nRowCount);
+	if (this->m_vecOtherCount[nCol] == 0)
+	{
+		// all numbers
+		std::copy(doubles.begin(), doubles.begin() + this->m_nRowCount, values);
+		if (types)
+		{
+			std::fill(types, types + this->m_nRowCount, (int) TT_DOUBLE);
+		}
+		return VR_OK;
+	}
+	for (size_t row = 0; row < this->m_nRowCount; ++row)
+	{
+		if (vtypes[row] == TT_DOUBLE || vtypes[row] == TT_LONG)
+		{
+			values[row] = doubles[row];
+		}
+		if (types)
+		{
+			types[row] = vtypes[row];
+		}
+	}
+	return VR_OK;
+}
+
+VRESULT CSelectedOutput::GetRowDoubles(int nRow, double* values, int* types)const
+{
+	if ((size_t)nRow >= this->GetRowCount() || nRow < 1)
+	{
+		return VR_INVALIDROW;
+	}
+	size_t row = (size_t)nRow - 1;
+	size_t ncols = this->GetColCount();
+	for (size_t col = 0; col < ncols; ++col)
+	{
+		char vtype = this->m_arrayType[col][row];
+		if (vtype == TT_DOUBLE || vtype == TT_LONG)
+		{
+			values[col] = this->m_arrayDouble[col][row];
+		}
+		if (types)
+		{
+			types[col] = vtype;
+		}
+	}
+	return VR_OK;
+}
+
 
 int CSelectedOutput::EndRow(void)
 {
@@ -106,11 +244,13 @@ int CSelectedOutput::EndRow(void)
 		// make sure array is full
 		for (size_t col = 0; col < ncols; ++col)
 		{
-			size_t nrows = this->m_arrayVar[col].size();
+			size_t nrows = this->m_arrayType[col].size();
 			if (nrows < this->m_nRowCount)
 			{
 				// fill w/ empty
-				this->m_arrayVar[col].resize(this->m_nRowCount);
+				this->m_arrayDouble[col].resize(this->m_nRowCount, 0.0);
+				this->m_arrayType[col].resize(this->m_nRowCount, (char) TT_EMPTY);
+				this->m_vecOtherCount[col] += this->m_nRowCount - nrows;
 			}
 #if defined(_DEBUG)
 			else if (nrows > this->m_nRowCount)
@@ -142,26 +282,31 @@ int CSelectedOutput::PushBack(const char* key, const CVar& var)
 			this->m_vecVarHeadings.push_back(CVar(key));
 
 
-			// add new vector(col)
+			// add new column, with empty rows if nec
 			//
-			this->m_arrayVar.resize(this->m_arrayVar.size() + 1);
-			this->m_arrayVar.back().reserve(RESERVE_ROWS);
-
-			// add empty rows if nec
-			if (this->m_nRowCount)
-				this->m_arrayVar.back().resize(this->m_nRowCount);
-
-			this->m_arrayVar.back().push_back(var);
+			this->m_arrayDouble.resize(this->m_arrayDouble.size() + 1);
+			this->m_arrayDouble.back().reserve(RESERVE_ROWS);
+			this->m_arrayDouble.back().resize(this->m_nRowCount + 1, 0.0);
+			this->m_arrayType.resize(this->m_arrayType.size() + 1);
+			this->m_arrayType.back().reserve(RESERVE_ROWS);
+			this->m_arrayType.back().resize(this->m_nRowCount + 1, (char) TT_EMPTY);
+			this->m_arrayString.resize(this->m_arrayString.size() + 1);
+			this->m_vecOtherCount.push_back(this->m_nRowCount + 1);
+
+			this->SetCell(this->m_arrayType.size() - 1, this->m_nRowCount, var);
 		}
 		else
 		{
-			if (this->m_arrayVar[find->second].size() == this->m_nRowCount) {
-				this->m_arrayVar[find->second].push_back(var);
+			size_t col = find->second;
+			if (this->m_arrayType[col].size() == this->m_nRowCount) {
+				this->m_arrayDouble[col].push_back(0.0);
+				this->m_arrayType[col].push_back((char) TT_EMPTY);
+				++this->m_vecOtherCount[col];
 			}
 			else {
-				ASSERT(this->m_arrayVar[find->second].size() == this->m_nRowCount + 1);
-				this->m_arrayVar[find->second].at(this->m_nRowCount) = var;
+				ASSERT(this->m_arrayType[col].size() == this->m_nRowCount + 1);
 			}
+			this->SetCell(col, this->m_nRowCount, var);
 		}
 		return 0;
 	}
@@ -217,10 +362,11 @@ void CSelectedOutput::AssertValid(void)const
 {
 	if (size_t cols = this->GetColCount())
 	{
-		size_t rows = this->m_arrayVar[0].size();
+		size_t rows = this->m_arrayType[0].size();
 		for (size_t col = 0; col < cols; ++col)
 		{
-			ASSERT(rows == this->m_arrayVar[col].size());
+			ASSERT(rows == this->m_arrayType[col].size());
+			ASSERT(rows == this->m_arrayDouble[col].size());
 		}
 	}
 }
@@ -275,23 +421,25 @@ void CSelectedOutput::Serialize(
 	{
 		for (size_t i = row_number; i < (size_t)(row_number + 1); i++)
 		{
-			types.push_back(m_arrayVar[j][i].type);
-			switch(m_arrayVar[j][i].type)
+			CVar v;
+			this->GetCell(j, i, &v);
+			types.push_back(v.type);
+			switch(v.type)
 			{
 			case TT_EMPTY:
 				break;
 			case TT_ERROR:
-				longs.push_back(m_arrayVar[j][i].vresult);
+				longs.push_back(v.vresult);
 				break;
 			case TT_LONG:
-				longs.push_back(m_arrayVar[j][i].lVal);
+				longs.push_back(v.lVal);
 				break;
 			case TT_DOUBLE:
-				doubles.push_back(m_arrayVar[j][i].dVal);
+				doubles.push_back(v.dVal);
 				break;
 			case TT_STRING:
-				longs.push_back((long) strlen(m_arrayVar[j][i].sVal));
-				strings.append(m_arrayVar[j][i].sVal);
+				longs.push_back((long) strlen(v.sVal));
+				strings.append(v.sVal);
 				break;
 
 			}
@@ -374,7 +522,7 @@ void CSelectedOutput::Doublize(
 	{
 		for (size_t i = 0; i < (size_t)nrow; i++)
 		{
-			switch(m_arrayVar[j][i].type)
+			switch(m_arrayType[j][i])
 			{
 			case TT_EMPTY:
 				doubles.push_back((double) INACTIVE_CELL_VALUE);
@@ -383,10 +531,10 @@ void CSelectedOutput::Doublize(
 				doubles.push_back((double) INACTIVE_CELL_VALUE);
 				break;
 			case TT_LONG:
-				doubles.push_back((double) m_arrayVar[j][i].lVal);
+				doubles.push_back(m_arrayDouble[j][i]);
 				break;
 			case TT_DOUBLE:
-				doubles.push_back(m_arrayVar[j][i].dVal);
+				doubles.push_back(m_arrayDouble[j][i]);
 				break;
 			case TT_STRING:
 				doubles.push_back((double) INACTIVE_CELL_VALUE);
@@ -30,6 +30,9 @@ public:
 	CVar Get(int nRow, int nCol)const;
 	VRESULT Get(int nRow, int nCol, VAR* pVAR)const;
 
+	VRESULT GetColumnDoubles(int nCol, double* values, int* types)const;
+	VRESULT GetRowDoubles(int nRow, double* values, int* types)const;
+
 	int PushBack(const char* key, const CVar& var);
 
 	int PushBackDouble(const char* key, double dVal);
@@ -62,9 +65,17 @@ public:
 protected:
 	friend std::ostream& operator<< (std::ostream &os, const CSelectedOutput &a);
 
+	VRESULT GetCell(size_t col, size_t row, VAR* pVAR)const;
+	void SetCell(size_t col, size_t row, const CVar& var);
+
 	size_t m_nRowCount;
 
-	std::vector< std::vector<CVar> > m_arrayVar;
+	// columnar storage; longs and error codes are kept in the double
+	// columns, strings only for the cells that hold them
+	std::vector< std::vector<double> > m_arrayDouble;
+	std::vector< std::vector<char> > m_arrayType;                // VAR_TYPE of each cell, TT_EMPTY if missing
+	std::vector< std::map<size_t, std::string> > m_arrayString;  // row -> TT_STRING value
+	std::vector<size_t> m_vecOtherCount;                         // cells of each column that are not TT_DOUBLE
 	std::vector<CVar> m_vecVarHeadings;
 	std::map< std::string, size_t > m_mapHeadingToCol;
 
@@ -1,5 +1,7 @@
 #include <memory>                       // auto_ptr
 #include <map>
+#include <fstream>                      // std::ofstream
+#include <cstdio>                       // std::rename, std::remove
 #include <string.h>
 #include "IPhreeqc.hpp"                 // IPhreeqc
 #include "Phreeqc.h"                    // Phreeqc
@@ -9,8 +11,10 @@
 #include "Debug.h"                      // ASSERT
 #include "ErrorReporter.hxx"            // CErrorReporter
 #include "CSelectedOutput.hxx"          // CSelectedOutput
+#include "CPreparedInput.hxx"           // CPreparedInput
 #include "SelectedOutput.h"             // SelectedOutput
 #include "dumper.h"                     // dumper
+#include "cxxMix.h"                     // cxxMix
 
 // statics
 std::map<size_t, IPhreeqc*> IPhreeqc::Instances;
@@ -20,6 +24,25 @@ std::string IPhreeqc::Version(VERSION_STRING);
 
 static const char empty[] = "";
 
+enum { PERSISTENT_OUTPUT, PERSISTENT_ERROR, PERSISTENT_LOG };
+
+// An output, error or log file that stays open between runs (see SetPersistentFilesOn)
+class CPersistentFile
+{
+public:
+	CPersistentFile(const std::string& filename)
+		: name(filename)
+		, buffer(1 << 20)
+	{
+		// the buffer must be set before the file is opened
+		this->ofs.rdbuf()->pubsetbuf(&this->buffer[0], (std::streamsize) this->buffer.size());
+		this->ofs.open(filename.c_str(), std::ios_base::out | std::ios_base::app | std::ios_base::ate);
+	}
+	std::string                name;
+	std::vector<char>          buffer;
+	std::ofstream              ofs;
+};
+
 
 IPhreeqc::IPhreeqc(void)
 : DatabaseLoaded(false)
@@ -37,6 +60,14 @@ IPhreeqc::IPhreeqc(void)
 , WarningStringOn(true)
 , WarningReporter(0)
 , CurrentSelectedOutputUserNumber(1)
+, BasicBytecodeOn(true)
+, CvodeJacobianReuseOn(false)
+, IneqLUOn(false)
+, GammaMuTolerance(0.0)
+, ParallelJacobianOn(false)
+, ParallelJacobianThreshold(16)
+, PersistentFilesOn(false)
+, PersistentFilesLimit(0)
 , PhreeqcPtr(0)
 , input_file(0)
 , database_file(0)
@@ -45,6 +76,11 @@ IPhreeqc::IPhreeqc(void)
 	this->WarningReporter = new CErrorReporter<std::ostringstream>;
 	this->PhreeqcPtr      = new Phreeqc(this);
 
+	for (int i = 0; i < 3; ++i)
+	{
+		this->PersistentFiles[i] = 0;
+	}
+
 	ASSERT(this->PhreeqcPtr->phast == 0);
 	this->UnLoadDatabase();
 
@@ -83,6 +119,9 @@ IPhreeqc::~IPhreeqc(void)
 	}
 	this->SelectedOutputMap.clear();
 
+	this->ClearPrepared();
+	this->close_persistent_files();
+
 	mutex_lock(&map_lock);
 	std::map<size_t, IPhreeqc*>::iterator it = IPhreeqc::Instances.find(this->Index);
 	if (it != IPhreeqc::Instances.end())
@@ -131,11 +170,93 @@ void IPhreeqc::ClearAccumulatedLines(void)
 	this->StringInput.erase();
 }
 
+void IPhreeqc::ClearPrepared(void)
+{
+	for (size_t i = 0; i < this->PreparedInputs.size(); ++i)
+	{
+		delete this->PreparedInputs[i];
+	}
+	this->PreparedInputs.clear();
+}
+
+IPhreeqc* IPhreeqc::Clone(void)const
+{
+	IPhreeqc* clone = new IPhreeqc;
+
+	if (this->DatabaseLoaded)
+	{
+		try
+		{
+			// copies the definitions without reading the database again
+			// and re-tidies the model
+			clone->PhreeqcPtr->InternalCopy(this->PhreeqcPtr);
+			clone->DatabaseLoaded = (clone->PhreeqcPtr->get_input_errors() == 0);
+		}
+		catch (const IPhreeqcStop&)
+		{
+			clone->DatabaseLoaded = false;
+		}
+		clone->update_errors();
+	}
+
+	// output settings; the file names stay unique to the clone
+	clone->OutputFileOn           = this->OutputFileOn;
+	clone->LogFileOn              = this->LogFileOn;
+	clone->ErrorFileOn            = this->ErrorFileOn;
+	clone->DumpOn                 = this->DumpOn;
+	clone->DumpStringOn           = this->DumpStringOn;
+	clone->OutputStringOn         = this->OutputStringOn;
+	clone->LogStringOn            = this->LogStringOn;
+	clone->ErrorStringOn          = this->ErrorStringOn;
+	clone->WarningStringOn        = this->WarningStringOn;
+	clone->PersistentFilesOn      = this->PersistentFilesOn;
+	clone->BasicBytecodeOn        = this->BasicBytecodeOn;
+	clone->CvodeJacobianReuseOn   = this->CvodeJacobianReuseOn;
+	clone->IneqLUOn               = this->IneqLUOn;
+	clone->GammaMuTolerance       = this->GammaMuTolerance;
+	clone->ParallelJacobianOn     = this->ParallelJacobianOn;
+	clone->ParallelJacobianThreshold = this->ParallelJacobianThreshold;
+	clone->PersistentFilesLimit   = this->PersistentFilesLimit;
+	clone->SelectedOutputStringOn = this->SelectedOutputStringOn;
+	clone->CurrentSelectedOutputUserNumber = this->CurrentSelectedOutputUserNumber;
+	std::map< int, bool >::const_iterator it = this->SelectedOutputFileOnMap.begin();
+	for (; it != this->SelectedOutputFileOnMap.end(); ++it)
+	{
+		clone->SelectedOutputFileOnMap[(*it).first] = (*it).second;
+		clone->SelectedOutputFileNameMap[(*it).first] = clone->sel_file_name((*it).first);
+	}
+	return clone;
+}
+
+void IPhreeqc::FlushOutputFiles(void)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		CPersistentFile* pf = this->PersistentFiles[i];
+		if (!pf) continue;
+		pf->ofs.flush();
+		if (this->PersistentFilesLimit > 0 && pf->ofs.tellp() >= (std::streamoff) this->PersistentFilesLimit)
+		{
+			std::string name(pf->name);
+			std::string backup(name + ".1");
+			delete pf;
+			std::remove(backup.c_str());
+			std::rename(name.c_str(), backup.c_str());
+			this->PersistentFiles[i] = new CPersistentFile(name);
+		}
+	}
+}
+
 const std::string& IPhreeqc::GetAccumulatedLines(void)
 {
 	return this->StringInput;
 }
 
+bool IPhreeqc::GetBasicBytecodeOn(void)const
+{
+	return this->BasicBytecodeOn;
+}
+
 const char* IPhreeqc::GetComponent(int n)
 {
 	static const char empty[] = "";
@@ -163,6 +284,11 @@ int IPhreeqc::GetCurrentSelectedOutputUserNumber(void)const
 	return this->CurrentSelectedOutputUserNumber;
 }
 
+bool IPhreeqc::GetCvodeJacobianReuseOn(void)const
+{
+	return this->CvodeJacobianReuseOn;
+}
+
 const char* IPhreeqc::GetDumpFileName(void)const
 {
 	return this->DumpFileName.c_str();
@@ -244,11 +370,21 @@ bool IPhreeqc::GetErrorStringOn(void)const
 	return this->ErrorStringOn;
 }
 
+double IPhreeqc::GetGammaMuTolerance(void)const
+{
+	return this->GammaMuTolerance;
+}
+
 int IPhreeqc::GetId(void)const
 {
 	return (int)this->Index;
 }
 
+bool IPhreeqc::GetIneqLUOn(void)const
+{
+	return this->IneqLUOn;
+}
+
 const char* IPhreeqc::GetLogFileName(void)const
 {
 	return this->LogFileName.c_str();
@@ -344,6 +480,26 @@ bool IPhreeqc::GetOutputStringOn(void)const
 	return this->OutputStringOn;
 }
 
+bool IPhreeqc::GetParallelJacobianOn(void)const
+{
+	return this->ParallelJacobianOn;
+}
+
+int IPhreeqc::GetParallelJacobianThreshold(void)const
+{
+	return this->ParallelJacobianThreshold;
+}
+
+int IPhreeqc::GetPersistentFilesLimit(void)const
+{
+	return this->PersistentFilesLimit;
+}
+
+bool IPhreeqc::GetPersistentFilesOn(void)const
+{
+	return this->PersistentFilesOn;
+}
+
 int IPhreeqc::GetSelectedOutputColumnCount(void)const
 {
 	std::map< int, CSelectedOutput* >::const_iterator ci = this->SelectedOutputMap.find(this->CurrentSelectedOutputUserNumber);
@@ -354,6 +510,35 @@ int IPhreeqc::GetSelectedOutputColumnCount(void)const
 	return 0;
 }
 
+VRESULT IPhreeqc::GetSelectedOutputColumnDoubles(int col, double* values, int* vtypes)
+{
+	this->ErrorReporter->Clear();
+	if (!values)
+	{
+		this->AddError("GetSelectedOutputColumnDoubles: VR_INVALIDARG values is NULL.\n");
+		this->update_errors();
+		return VR_INVALIDARG;
+	}
+
+	std::map< int, CSelectedOutput* >::const_iterator ci = this->SelectedOutputMap.find(this->CurrentSelectedOutputUserNumber);
+	if (ci == this->SelectedOutputMap.end())
+	{
+		char buffer[120];
+		::sprintf(buffer, "GetSelectedOutputColumnDoubles: VR_INVALIDARG Invalid selected-output user number %d.\n", this->CurrentSelectedOutputUserNumber);
+		this->AddError(buffer);
+		this->update_errors();
+		return VR_INVALIDARG;
+	}
+
+	VRESULT v = (*ci).second->GetColumnDoubles(col, values, vtypes);
+	if (v == VR_INVALIDCOL)
+	{
+		this->AddError("GetSelectedOutputColumnDoubles: VR_INVALIDCOL Column index out of range.\n");
+		this->update_errors();
+	}
+	return v;
+}
+
 int IPhreeqc::GetSelectedOutputCount(void)const
 {
 	ASSERT(this->PhreeqcPtr->SelectedOutput_map.size() == this->SelectedOutputMap.size());
@@ -386,6 +571,35 @@ int IPhreeqc::GetSelectedOutputRowCount(void)const
 	return 0;
 }
 
+VRESULT IPhreeqc::GetSelectedOutputRowDoubles(int row, double* values, int* vtypes)
+{
+	this->ErrorReporter->Clear();
+	if (!values)
+	{
+		this->AddError("GetSelectedOutputRowDoubles: VR_INVALIDARG values is NULL.\n");
+		this->update_errors();
+		return VR_INVALIDARG;
+	}
+
+	std::map< int, CSelectedOutput* >::const_iterator ci = this->SelectedOutputMap.find(this->CurrentSelectedOutputUserNumber);
+	if (ci == this->SelectedOutputMap.end())
+	{
+		char buffer[120];
+		::sprintf(buffer, "GetSelectedOutputRowDoubles: VR_INVALIDARG Invalid selected-output user number %d.\n", this->CurrentSelectedOutputUserNumber);
+		this->AddError(buffer);
+		this->update_errors();
+		return VR_INVALIDARG;
+	}
+
+	VRESULT v = (*ci).second->GetRowDoubles(row, values, vtypes);
+	if (v == VR_INVALIDROW)
+	{
+		this->AddError("GetSelectedOutputRowDoubles: VR_INVALIDROW Row index out of range.\n");
+		this->update_errors();
+	}
+	return v;
+}
+
 const char* IPhreeqc::GetSelectedOutputString(void)const
 {
 	static const char err_msg[] = "GetSelectedOutputString: SelectedOutputStringOn not set.\n";
@@ -701,6 +915,97 @@ int IPhreeqc::LoadDatabaseString(const char* input)
 	return n;
 }
 
+int IPhreeqc::load_db_snapshot(const char* snapshot, const char* database)
+{
+	// the snapshot is keyed to the build and to a checksum of the database
+	std::ifstream dat(database, std::ios_base::in | std::ios_base::binary);
+	if (!dat.is_open())
+	{
+		return this->load_db(database);
+	}
+	std::ostringstream contents;
+	contents << dat.rdbuf();
+	dat.close();
+	const std::string text(contents.str());
+
+	// FNV-1a
+	unsigned long checksum = 2166136261UL;
+	for (size_t i = 0; i < text.size(); ++i)
+	{
+		checksum = ((checksum ^ (unsigned char)text[i]) * 16777619UL) & 0xffffffffUL;
+	}
+	std::ostringstream key;
+	key << "IPhreeqc " << VERSION_STRING << " " << std::hex << checksum << std::dec << " " << text.size();
+
+	std::ifstream ifs(snapshot, std::ios_base::in | std::ios_base::binary);
+	if (ifs.is_open())
+	{
+		bool restored = false;
+		try
+		{
+			this->UnLoadDatabase();
+			restored = this->PhreeqcPtr->read_database_snapshot(ifs, key.str());
+		}
+		catch (const IPhreeqcStop&)
+		{
+			restored = false;
+		}
+		ifs.close();
+		if (restored && this->PhreeqcPtr->get_input_errors() == 0)
+		{
+			this->DatabaseLoaded = true;
+			return 0;
+		}
+	}
+
+	// stale, damaged or missing snapshot
+	int n = this->load_db(database);
+	if (n == 0)
+	{
+		// written to a temporary so that a partly written snapshot is never read
+		std::string tmp(snapshot);
+		tmp += ".tmp";
+		std::ofstream ofs(tmp.c_str(), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+		bool written = ofs.is_open() && this->PhreeqcPtr->write_database_snapshot(ofs, key.str());
+		ofs.close();
+		if (written && std::rename(tmp.c_str(), snapshot) != 0)
+		{
+			// rename does not replace an existing file on windows
+			std::remove(snapshot);
+			written = (std::rename(tmp.c_str(), snapshot) == 0);
+		}
+		if (!written)
+		{
+			std::remove(tmp.c_str());
+		}
+	}
+	return n;
+}
+
+int IPhreeqc::LoadDatabaseSnapshot(const char* snapshot, const char* database)
+{
+	// save I/O state
+	bool bSaveErrorFileOn  = this->ErrorFileOn;
+	bool bSaveOutputOn     = this->OutputFileOn;
+	bool bSaveLogFileOn    = this->LogFileOn;
+	this->ErrorFileOn      = false;
+	this->OutputFileOn     = false;
+	this->LogFileOn        = false;
+
+	int n = this->load_db_snapshot(snapshot, database);
+	if (n == 0)
+	{
+		n = this->test_db();
+	}
+
+	// restore I/O state
+	this->ErrorFileOn  = bSaveErrorFileOn;
+	this->OutputFileOn = bSaveOutputOn;
+	this->LogFileOn    = bSaveLogFileOn;
+
+	return n;
+}
+
 void IPhreeqc::OutputAccumulatedLines(void)
 {
 #if !defined(R_SO)
@@ -722,9 +1027,33 @@ void IPhreeqc::OutputWarningString(void)
 #endif
 }
 
+int IPhreeqc::PrepareAccumulated(void)
+{
+	int n = this->PrepareString(this->GetAccumulatedLines().c_str());
+	this->ClearAccumulated = true;
+	return n;
+}
+
+int IPhreeqc::PrepareString(const char* input)
+{
+	try
+	{
+		CPreparedInput* prepared = new CPreparedInput;
+		prepared->Parse(input);
+		this->PreparedInputs.push_back(prepared);
+		return (int) this->PreparedInputs.size() - 1;
+	}
+	catch (...)
+	{
+		this->AddError("PrepareString: An unhandled exception occured.\n");
+		throw;
+	}
+	return VR_OUTOFMEMORY;
+}
+
 int IPhreeqc::RunAccumulated(void)
 {
-	static const char *sz_routine = "RunAccumulated";
+	static const char sz_routine[] = "RunAccumulated";
 	try
 	{
 		// DON'T clear accumulated (just set
@@ -785,7 +1114,7 @@ int IPhreeqc::RunAccumulated(void)
 
 int IPhreeqc::RunFile(const char* filename)
 {
-	static const char *sz_routine = "RunFile";
+	static const char sz_routine[] = "RunFile";
 	try
 	{
 		// clear accumulated
@@ -853,9 +1182,78 @@ int IPhreeqc::RunFile(const char* filename)
 	return this->PhreeqcPtr->get_input_errors();
 }
 
+int IPhreeqc::RunPrepared(int n)
+{
+	static const char sz_routine[] = "RunPrepared";
+	try
+	{
+		// these may throw
+		this->open_output_files(sz_routine);
+		this->check_database(sz_routine);
+
+		this->PhreeqcPtr->input_error = 0;
+		this->io_error_count = 0;
+
+		std::ostringstream oss;
+		std::string missing;
+		if (n < 0 || n >= (int) this->PreparedInputs.size())
+		{
+			oss << sz_routine << ": Invalid prepared input " << n;
+			this->PhreeqcPtr->input_error = 1;
+			this->PhreeqcPtr->error_msg(oss.str().c_str(), STOP); // throws
+		}
+		if (!this->PreparedInputs[n]->IsBound(&missing))
+		{
+			oss << sz_routine << ": No value given for {" << missing << "}";
+			this->PhreeqcPtr->input_error = 1;
+			this->PhreeqcPtr->error_msg(oss.str().c_str(), STOP); // throws
+		}
+
+		// this may throw
+		this->do_run_prepared(sz_routine, *this->PreparedInputs[n]);
+	}
+	catch (const IPhreeqcStop&)
+	{
+		// do nothing
+	}
+	catch(std::exception &e)
+	{
+		std::string errmsg("RunPrepared: ");
+		errmsg += e.what();
+		try
+		{
+			this->PhreeqcPtr->error_msg(errmsg.c_str(), STOP); // throws PhreeqcStop
+		}
+		catch (const IPhreeqcStop&)
+		{
+			// do nothing
+		}
+		throw;
+	}
+	catch(...)
+	{
+		const char *errmsg = "RunPrepared: An unhandled exception occured.\n";
+		try
+		{
+			this->PhreeqcPtr->error_msg(errmsg, STOP); // throws PhreeqcStop
+		}
+		catch (const IPhreeqcStop&)
+		{
+			// do nothing
+		}
+		throw;
+	}
+
+	this->close_output_files();
+	this->update_errors();
+	this->PhreeqcPtr->phrq_io->clear_istream();
+
+	return this->PhreeqcPtr->get_input_errors();
+}
+
 int IPhreeqc::RunString(const char* input)
 {
-	static const char *sz_routine = "RunString";
+	static const char sz_routine[] = "RunString";
 	try
 	{
 		// clear accumulated
@@ -931,6 +1329,13 @@ void IPhreeqc::SetBasicFortranCallback(double (*fcn)(double *x1, double *x2, con
 	this->PhreeqcPtr->register_fortran_basic_callback(fcn);
 }
 #endif
+
+void IPhreeqc::SetBasicBytecodeOn(bool bValue)
+{
+	this->BasicBytecodeOn = bValue;
+	this->PhreeqcPtr->basic_bytecode_on = bValue;
+}
+
 VRESULT IPhreeqc::SetCurrentSelectedOutputUserNumber(int n)
 {
 	if (0 <= n)
@@ -941,6 +1346,16 @@ VRESULT IPhreeqc::SetCurrentSelectedOutputUserNumber(int n)
 	return VR_INVALIDARG;
 }
 
+void IPhreeqc::SetCvodeJacobianReuseOn(bool bValue)
+{
+	this->CvodeJacobianReuseOn = bValue;
+	this->PhreeqcPtr->cvode_jacobian_reuse_on = bValue;
+	if (!bValue)
+	{
+		this->PhreeqcPtr->cvode_jacobian_map.clear();
+	}
+}
+
 void IPhreeqc::SetDumpFileName(const char *filename)
 {
 	if (filename && ::strlen(filename))
@@ -978,6 +1393,18 @@ void IPhreeqc::SetErrorStringOn(bool bValue)
 	this->ErrorStringOn = bValue;
 }
 
+void IPhreeqc::SetGammaMuTolerance(double tolerance)
+{
+	this->GammaMuTolerance = tolerance;
+	this->PhreeqcPtr->gamma_mu_tolerance = tolerance;
+}
+
+void IPhreeqc::SetIneqLUOn(bool bValue)
+{
+	this->IneqLUOn = bValue;
+	this->PhreeqcPtr->ineq_lu_on = bValue;
+}
+
 void IPhreeqc::SetLogFileName(const char *filename)
 {
 	if (filename && ::strlen(filename))
@@ -1014,6 +1441,50 @@ void IPhreeqc::SetOutputFileOn(bool bValue)
 	this->OutputFileOn = bValue;
 }
 
+void IPhreeqc::SetParallelJacobianOn(bool bValue)
+{
+	this->ParallelJacobianOn = bValue;
+	this->PhreeqcPtr->parallel_jacobian_on = bValue;
+}
+
+void IPhreeqc::SetParallelJacobianThreshold(int count)
+{
+	this->ParallelJacobianThreshold = count;
+	this->PhreeqcPtr->parallel_jacobian_threshold = count;
+}
+
+void IPhreeqc::SetPersistentFilesLimit(int bytes)
+{
+	this->PersistentFilesLimit = (bytes > 0) ? bytes : 0;
+}
+
+void IPhreeqc::SetPersistentFilesOn(bool bValue)
+{
+	this->PersistentFilesOn = bValue;
+	if (!bValue)
+	{
+		this->close_persistent_files();
+	}
+}
+
+VRESULT IPhreeqc::SetPreparedInteger(int n, const char* name, int value)
+{
+	if (n < 0 || n >= (int) this->PreparedInputs.size())
+	{
+		return VR_INVALIDARG;
+	}
+	return this->PreparedInputs[n]->SetValue(name, (double) value, true);
+}
+
+VRESULT IPhreeqc::SetPreparedValue(int n, const char* name, double value)
+{
+	if (n < 0 || n >= (int) this->PreparedInputs.size())
+	{
+		return VR_INVALIDARG;
+	}
+	return this->PreparedInputs[n]->SetValue(name, value, false);
+}
+
 void IPhreeqc::SetSelectedOutputFileName(const char *filename)
 {
 	if (filename && ::strlen(filename))
@@ -1111,6 +1582,12 @@ void IPhreeqc::UnLoadDatabase(void)
 	this->PhreeqcPtr->clean_up();
 	this->PhreeqcPtr->init();
 	this->PhreeqcPtr->do_initialize();
+	this->PhreeqcPtr->basic_bytecode_on = this->BasicBytecodeOn;
+	this->PhreeqcPtr->cvode_jacobian_reuse_on = this->CvodeJacobianReuseOn;
+	this->PhreeqcPtr->ineq_lu_on = this->IneqLUOn;
+	this->PhreeqcPtr->gamma_mu_tolerance = this->GammaMuTolerance;
+	this->PhreeqcPtr->parallel_jacobian_on = this->ParallelJacobianOn;
+	this->PhreeqcPtr->parallel_jacobian_threshold = this->ParallelJacobianThreshold;
 	this->PhreeqcPtr->input_error = 0;
 	this->io_error_count = 0;
 }
@@ -1232,256 +1709,268 @@ void IPhreeqc::do_run(const char* sz_routine, std::istream* pis, PFN_PRERUN_CALL
 		if (this->PhreeqcPtr->read_input() == EOF)
 			break;
 
-		// bool bWarning = false;
-		std::map< int, SelectedOutput >::iterator mit = this->PhreeqcPtr->SelectedOutput_map.begin();
-		for (; mit != this->PhreeqcPtr->SelectedOutput_map.end(); ++mit)
+		this->do_simulation(sz_routine);
+	}
+
+	this->do_run_end(pfn_post, cookie);
+}
+
+void IPhreeqc::do_simulation(const char* sz_routine)
+{
+	char token[MAX_LENGTH];
+
+	// bool bWarning = false;
+	std::map< int, SelectedOutput >::iterator mit = this->PhreeqcPtr->SelectedOutput_map.begin();
+	for (; mit != this->PhreeqcPtr->SelectedOutput_map.end(); ++mit)
+	{
+		if (this->SelectedOutputMap.find(mit->first) == this->SelectedOutputMap.end())
 		{
-			if (this->SelectedOutputMap.find(mit->first) == this->SelectedOutputMap.end())
-			{
-				// int -> CSelectedOutput*
-				std::map< int, CSelectedOutput* >::value_type item((*mit).first, new CSelectedOutput());
-				this->SelectedOutputMap.insert(item);
+			// int -> CSelectedOutput*
+			std::map< int, CSelectedOutput* >::value_type item((*mit).first, new CSelectedOutput());
+			this->SelectedOutputMap.insert(item);
 
-				// int -> std::string
-				this->SelectedOutputStringMap.insert(
-					std::map< int, std::string >::value_type((*mit).first, std::string()));
-			}
-			else
-			{
-				ASSERT(this->SelectedOutputMap.find((*mit).first) != this->SelectedOutputMap.end());
-				ASSERT(this->SelectedOutputStringMap.find((*mit).first) != this->SelectedOutputStringMap.end());
-			}
+			// int -> std::string
+			this->SelectedOutputStringMap.insert(
+				std::map< int, std::string >::value_type((*mit).first, std::string()));
 		}
-		ASSERT(this->PhreeqcPtr->SelectedOutput_map.size() == this->SelectedOutputMap.size());
-		ASSERT(this->PhreeqcPtr->SelectedOutput_map.size() == this->SelectedOutputStringMap.size());
-		if (this->PhreeqcPtr->title_x != NULL)
+		else
 		{
-			::sprintf(token, "TITLE");
-			this->PhreeqcPtr->dup_print(token, TRUE);
-			if (this->PhreeqcPtr->pr.headings == TRUE)
-			{
-				char *p = this->PhreeqcPtr->sformatf("%s\n\n", this->PhreeqcPtr->title_x);
-				this->PhreeqcPtr->output_msg(p);
-			}
+			ASSERT(this->SelectedOutputMap.find((*mit).first) != this->SelectedOutputMap.end());
+			ASSERT(this->SelectedOutputStringMap.find((*mit).first) != this->SelectedOutputStringMap.end());
+		}
+	}
+	ASSERT(this->PhreeqcPtr->SelectedOutput_map.size() == this->SelectedOutputMap.size());
+	ASSERT(this->PhreeqcPtr->SelectedOutput_map.size() == this->SelectedOutputStringMap.size());
+	if (this->PhreeqcPtr->title_x != NULL)
+	{
+		::sprintf(token, "TITLE");
+		this->PhreeqcPtr->dup_print(token, TRUE);
+		if (this->PhreeqcPtr->pr.headings == TRUE)
+		{
+			char *p = this->PhreeqcPtr->sformatf("%s\n\n", this->PhreeqcPtr->title_x);
+			this->PhreeqcPtr->output_msg(p);
 		}
+	}
 
 #ifdef SWIG_SHARED_OBJ
-		if (this->PhreeqcPtr->SelectedOutput_map.size() > 0)
-		{
-			//
-			// (punch.in == TRUE) when any "RUN" has contained
-			// a SELECTED_OUTPUT block since the last LoadDatabase call.
-			//
-			// Since LoadDatabase inititializes punch.in to FALSE
-			// (via UnLoadDatabase...do_initialize)
-			// and punch.in is set to TRUE in read_selected_output
-			//
-			// This causes the SELECTED_OUTPUT to contain the same headings
-			// until another SELECTED_OUTPUT is defined which sets the variable
-			// punch.new_def to TRUE
-			//
-			// WHAT IF A USER_PUNCH IS DEFINED?? IS punch.new_def SET TO
-			// TRUE ???
-			//
-			//
-			std::map< int, SelectedOutput >::iterator ai = this->PhreeqcPtr->SelectedOutput_map.begin();
-			for (; ai != this->PhreeqcPtr->SelectedOutput_map.end(); ++ai)
+	if (this->PhreeqcPtr->SelectedOutput_map.size() > 0)
+	{
+		//
+		// (punch.in == TRUE) when any "RUN" has contained
+		// a SELECTED_OUTPUT block since the last LoadDatabase call.
+		//
+		// Since LoadDatabase inititializes punch.in to FALSE
+		// (via UnLoadDatabase...do_initialize)
+		// and punch.in is set to TRUE in read_selected_output
+		//
+		// This causes the SELECTED_OUTPUT to contain the same headings
+		// until another SELECTED_OUTPUT is defined which sets the variable
+		// punch.new_def to TRUE
+		//
+		// WHAT IF A USER_PUNCH IS DEFINED?? IS punch.new_def SET TO
+		// TRUE ???
+		//
+		//
+		std::map< int, SelectedOutput >::iterator ai = this->PhreeqcPtr->SelectedOutput_map.begin();
+		for (; ai != this->PhreeqcPtr->SelectedOutput_map.end(); ++ai)
+		{
+			if (!this->SelectedOutputFileOnMap[(*ai).first])
 			{
-				if (!this->SelectedOutputFileOnMap[(*ai).first])
-				{
-					ASSERT((*ai).second.Get_punch_ostream() == 0);
-				}
+				ASSERT((*ai).second.Get_punch_ostream() == 0);
 			}
+		}
 
-			if (this->PhreeqcPtr->pr.punch == FALSE)
-			{
-				// No selected_output for this simulation
-				// this happens when
-				//    PRINT;  -selected_output false
-				// is given as input
-				// Note: this also disables the CSelectedOutput object
-				ASSERT(TRUE);
-			}
-			else
+		if (this->PhreeqcPtr->pr.punch == FALSE)
+		{
+			// No selected_output for this simulation
+			// this happens when
+			//    PRINT;  -selected_output false
+			// is given as input
+			// Note: this also disables the CSelectedOutput object
+			ASSERT(TRUE);
+		}
+		else
+		{
+			std::map< int, SelectedOutput >::iterator it = this->PhreeqcPtr->SelectedOutput_map.begin();
+			for (; it != this->PhreeqcPtr->SelectedOutput_map.end(); ++it)
 			{
-				std::map< int, SelectedOutput >::iterator it = this->PhreeqcPtr->SelectedOutput_map.begin();
-				for (; it != this->PhreeqcPtr->SelectedOutput_map.end(); ++it)
+				if (this->SelectedOutputFileOnMap[(*it).first] && !(*it).second.Get_punch_ostream())
 				{
-					if (this->SelectedOutputFileOnMap[(*it).first] && !(*it).second.Get_punch_ostream())
+					//
+					// LoadDatabase
+					// do_run -- containing SELECTED_OUTPUT ****TODO**** check -file option
+					// another do_run without SELECTED_OUTPUT
+					//
+					ASSERT(!this->SelectedOutputFileNameMap[(*it).first].empty());
+					std::string filename = this->SelectedOutputFileNameMap[(*it).first];
+					if (!punch_open(filename.c_str(), std::ios_base::out, (*it).first))
+					{
+						std::ostringstream oss;
+						oss << sz_routine << ": Unable to open:" << "\"" << filename << "\".\n";
+						this->PhreeqcPtr->warning_msg(oss.str().c_str());
+					}
+					else
 					{
-						//
-						// LoadDatabase
-						// do_run -- containing SELECTED_OUTPUT ****TODO**** check -file option
-						// another do_run without SELECTED_OUTPUT
-						//
-						ASSERT(!this->SelectedOutputFileNameMap[(*it).first].empty());
-						std::string filename = this->SelectedOutputFileNameMap[(*it).first];
-						if (!punch_open(filename.c_str(), std::ios_base::out, (*it).first))
-						{
-							std::ostringstream oss;
-							oss << sz_routine << ": Unable to open:" << "\"" << filename << "\".\n";
-							this->PhreeqcPtr->warning_msg(oss.str().c_str());
-						}
-						else
-						{
-							ASSERT(this->Get_punch_ostream() != NULL);
-							ASSERT((*it).second.Get_punch_ostream() == NULL);
-
-							int n_user = (*it).first;
-							this->PhreeqcPtr->SelectedOutput_map[n_user].Set_punch_ostream(this->Get_punch_ostream());
-							this->Set_punch_ostream(NULL);
-							
-							// output selected_output headings
-							(*it).second.Set_new_def(TRUE);
-							this->PhreeqcPtr->tidy_punch();
-						}
+						ASSERT(this->Get_punch_ostream() != NULL);
+						ASSERT((*it).second.Get_punch_ostream() == NULL);
+
+						int n_user = (*it).first;
+						this->PhreeqcPtr->SelectedOutput_map[n_user].Set_punch_ostream(this->Get_punch_ostream());
+						this->Set_punch_ostream(NULL);
+						
+						// output selected_output headings
+						(*it).second.Set_new_def(TRUE);
+						this->PhreeqcPtr->tidy_punch();
 					}
 				}
 			}
 		}
-		else
-		{
-			ASSERT(TRUE);
-		}
-		
+	}
+	else
+	{
+		ASSERT(TRUE);
+	}
+	
 
-		std::map< int, SelectedOutput >::iterator it = this->PhreeqcPtr->SelectedOutput_map.begin();
-		for (; it != this->PhreeqcPtr->SelectedOutput_map.end(); ++it)
+	std::map< int, SelectedOutput >::iterator it = this->PhreeqcPtr->SelectedOutput_map.begin();
+	for (; it != this->PhreeqcPtr->SelectedOutput_map.end(); ++it)
+	{
+		if (this->SelectedOutputFileOnMap[(*it).first])
 		{
-			if (this->SelectedOutputFileOnMap[(*it).first])
-			{
-				ASSERT((*it).second.Get_punch_ostream());
-			}
-			else
-			{
-				ASSERT(!(*it).second.Get_punch_ostream());
-			}
+			ASSERT((*it).second.Get_punch_ostream());
 		}
-
-		// Consider this addition
+		else
 		{
-			this->PhreeqcPtr->pr.all = (this->OutputFileOn || this->OutputStringOn) ? TRUE : FALSE;
-			//this->PhreeqcPtr->pr.punch = (this->SelectedOutputFileOn || this->SelectedOutputStringOn) ? TRUE : FALSE;
+			ASSERT(!(*it).second.Get_punch_ostream());
 		}
-		/* the converse is not necessarily true */
+	}
 
-		this->PhreeqcPtr->n_user_punch_index = -1;
+	// Consider this addition
+	{
+		this->PhreeqcPtr->pr.all = (this->OutputFileOn || this->OutputStringOn) ? TRUE : FALSE;
+		//this->PhreeqcPtr->pr.punch = (this->SelectedOutputFileOn || this->SelectedOutputStringOn) ? TRUE : FALSE;
+	}
+	/* the converse is not necessarily true */
+
+	this->PhreeqcPtr->n_user_punch_index = -1;
 #endif // SWIG_SHARED_OBJ
-		{
-			this->PhreeqcPtr->pr.all = (this->OutputFileOn || this->OutputStringOn) ? TRUE : FALSE;
-		}
+	{
+		this->PhreeqcPtr->pr.all = (this->OutputFileOn || this->OutputStringOn) ? TRUE : FALSE;
+	}
 
-		this->PhreeqcPtr->tidy_model();
+	this->PhreeqcPtr->tidy_model();
 #ifdef PHREEQ98
                 if (!phreeq98_debug)
-				{
+			{
 #endif
 
 /*
  *   Calculate distribution of species for initial solutions
  */
-		if (this->PhreeqcPtr->new_solution)
-			this->PhreeqcPtr->initial_solutions(TRUE);
+	if (this->PhreeqcPtr->new_solution)
+		this->PhreeqcPtr->initial_solutions(TRUE);
 /*
  *   Calculate distribution for exchangers
  */
-		if (this->PhreeqcPtr->new_exchange)
-			this->PhreeqcPtr->initial_exchangers(TRUE);
+	if (this->PhreeqcPtr->new_exchange)
+		this->PhreeqcPtr->initial_exchangers(TRUE);
 /*
  *   Calculate distribution for surfaces
  */
-		if (this->PhreeqcPtr->new_surface)
-			this->PhreeqcPtr->initial_surfaces(TRUE);
+	if (this->PhreeqcPtr->new_surface)
+		this->PhreeqcPtr->initial_surfaces(TRUE);
 /*
  *   Calculate initial gas composition
  */
-		if (this->PhreeqcPtr->new_gas_phase)
-			this->PhreeqcPtr->initial_gas_phases(TRUE);
+	if (this->PhreeqcPtr->new_gas_phase)
+		this->PhreeqcPtr->initial_gas_phases(TRUE);
 /*
  *   Calculate reactions
  */
-		this->PhreeqcPtr->reactions();
+	this->PhreeqcPtr->reactions();
 /*
  *   Calculate inverse models
  */
-		this->PhreeqcPtr->inverse_models();
+	this->PhreeqcPtr->inverse_models();
 /*
  *   Calculate advection
  */
-		if (this->PhreeqcPtr->use.Get_advect_in())
-		{
-			this->PhreeqcPtr->dup_print("Beginning of advection calculations.", TRUE);
-			this->PhreeqcPtr->advection();
-		}
+	if (this->PhreeqcPtr->use.Get_advect_in())
+	{
+		this->PhreeqcPtr->dup_print("Beginning of advection calculations.", TRUE);
+		this->PhreeqcPtr->advection();
+	}
 /*
  *   Calculate transport
  */
-		if (this->PhreeqcPtr->use.Get_trans_in())
-		{
-			this->PhreeqcPtr->dup_print("Beginning of transport calculations.", TRUE);
-			this->PhreeqcPtr->transport();
-		}
+	if (this->PhreeqcPtr->use.Get_trans_in())
+	{
+		this->PhreeqcPtr->dup_print("Beginning of transport calculations.", TRUE);
+		this->PhreeqcPtr->transport();
+	}
 /*
  *   run
  */
-		this->PhreeqcPtr->run_as_cells();
+	this->PhreeqcPtr->run_as_cells();
 /*
  *   Calculate mixes
  */
-		this->PhreeqcPtr->do_mixes();
+	this->PhreeqcPtr->do_mixes();
 /*
  *   Copy
  */
-		if (this->PhreeqcPtr->new_copy) this->PhreeqcPtr->copy_entities();
+	if (this->PhreeqcPtr->new_copy) this->PhreeqcPtr->copy_entities();
 /*
  *   dump
  */
-		dumper dump_info_save(this->PhreeqcPtr->dump_info);
-		if (this->DumpOn)
-		{
-			this->PhreeqcPtr->dump_entities();
-			this->DumpFileName = this->PhreeqcPtr->dump_info.Get_file_name();
-		}
-		if (this->DumpStringOn)
+	dumper dump_info_save(this->PhreeqcPtr->dump_info);
+	if (this->DumpOn)
+	{
+		this->PhreeqcPtr->dump_entities();
+		this->DumpFileName = this->PhreeqcPtr->dump_info.Get_file_name();
+	}
+	if (this->DumpStringOn)
+	{
+		this->PhreeqcPtr->dump_info = dump_info_save;
+		if (this->PhreeqcPtr->dump_info.Get_bool_any())
 		{
-			this->PhreeqcPtr->dump_info = dump_info_save;
-			if (this->PhreeqcPtr->dump_info.Get_bool_any())
+			std::ostringstream oss;
+			this->PhreeqcPtr->dump_ostream(oss);
+			if (this->PhreeqcPtr->dump_info.Get_append())
 			{
-				std::ostringstream oss;
-				this->PhreeqcPtr->dump_ostream(oss);
-				if (this->PhreeqcPtr->dump_info.Get_append())
-				{
-					this->DumpString += oss.str();
-				}
-				else
-				{
-					this->DumpString = oss.str();
-				}
+				this->DumpString += oss.str();
+			}
+			else
+			{
+				this->DumpString = oss.str();
+			}
 
-				/* Fill dump lines */
-				this->DumpLines.clear();
-				std::istringstream iss(this->DumpString);
-				std::string line;
-				while (std::getline(iss, line))
-				{
-					this->DumpLines.push_back(line);
-				}
+			/* Fill dump lines */
+			this->DumpLines.clear();
+			std::istringstream iss(this->DumpString);
+			std::string line;
+			while (std::getline(iss, line))
+			{
+				this->DumpLines.push_back(line);
 			}
 		}
+	}
 /*
  *   delete
  */
-		this->PhreeqcPtr->delete_entities();
+	this->PhreeqcPtr->delete_entities();
 
 /*
  *   End of simulation
  */
-		this->PhreeqcPtr->dup_print( "End of simulation.", TRUE);
+	this->PhreeqcPtr->dup_print( "End of simulation.", TRUE);
 #ifdef PHREEQ98
                 } /* if (!phreeq98_debug) */
 #endif
-	}
+}
 
+void IPhreeqc::do_run_end(PFN_POSTRUN_CALLBACK pfn_post, void *cookie)
+{
 /*
  *   Display successful status
  */
@@ -1544,6 +2033,273 @@ void IPhreeqc::do_run(const char* sz_routine, std::istream* pis, PFN_PRERUN_CALL
 	}
 }
 
+void IPhreeqc::do_run_prepared(const char* sz_routine, const CPreparedInput& prepared)
+{
+	char token[MAX_LENGTH];
+	std::string input;
+
+	if (prepared.IsTextOnly())
+	{
+		prepared.GetText(0, input);
+		std::istringstream iss(input);
+		this->do_run(sz_routine, &iss, NULL, NULL, NULL);
+		return;
+	}
+
+	// the parsed data blocks are only used when the input would
+	// not be echoed to the output
+	bool echo = this->OutputFileOn || this->OutputStringOn;
+
+	this->PhreeqcPtr->first_read_input = TRUE;
+	for (this->PhreeqcPtr->simulation = 1; ; this->PhreeqcPtr->simulation++)
+	{
+		::sprintf(token, "Reading input data for simulation %d.", this->PhreeqcPtr->simulation);
+		this->PhreeqcPtr->dup_print(token, TRUE);
+		if (this->PhreeqcPtr->simulation > (int) prepared.GetSimulationCount())
+		{
+			this->PhreeqcPtr->init_read_input();
+			break;
+		}
+
+		size_t n = (size_t) this->PhreeqcPtr->simulation - 1;
+		if (prepared.GetSimulation(n).native && !echo)
+		{
+			this->PhreeqcPtr->init_read_input();
+			this->do_prepared_blocks(prepared, n);
+			this->PhreeqcPtr->next_keyword = Keywords::KEY_END;
+			this->PhreeqcPtr->keycount[Keywords::KEY_END]++;
+			this->PhreeqcPtr->first_read_input = FALSE;
+		}
+		else
+		{
+			prepared.GetText(n, input);
+			std::istringstream iss(input);
+			this->PhreeqcPtr->phrq_io->push_istream(&iss, false);
+			this->PhreeqcPtr->read_input();
+			this->PhreeqcPtr->phrq_io->clear_istream();
+		}
+
+		this->do_simulation(sz_routine);
+	}
+
+	this->do_run_end(NULL, NULL);
+}
+
+void IPhreeqc::do_prepared_blocks(const CPreparedInput& prepared, size_t n)
+{
+	Phreeqc *phreeqc_ptr = this->PhreeqcPtr;
+	const std::vector<PreparedBlock>& blocks = prepared.GetSimulation(n).blocks;
+
+	for (size_t i = 0; i < blocks.size(); ++i)
+	{
+		const PreparedBlock& block = blocks[i];
+		int n_user = (int) prepared.GetValue(block.fields[0]);
+		if (n_user < 0 && block.fields[0].param >= 0)
+		{
+			phreeqc_ptr->input_error++;
+			phreeqc_ptr->error_msg("Number must be a positive integer.", CONTINUE);
+		}
+
+		switch (block.keyword)
+		{
+		case Keywords::KEY_MIX:
+			{
+				cxxMix temp_mix;
+				temp_mix.Set_n_user(n_user);
+				temp_mix.Set_n_user_end(n_user);
+				temp_mix.Set_description(block.description.c_str());
+				for (size_t j = 1; j + 1 < block.fields.size(); j += 2)
+				{
+					temp_mix.Add((int) prepared.GetValue(block.fields[j]), prepared.GetValue(block.fields[j + 1]));
+				}
+				this->set_mix_input(temp_mix);
+			}
+			break;
+
+		case Keywords::KEY_SAVE:
+			this->set_save_input(block.entity, n_user);
+			break;
+
+		case Keywords::KEY_COPY:
+			this->set_copy_input(block.entity, n_user, (int) prepared.GetValue(block.fields[1]));
+			break;
+
+		case Keywords::KEY_USE:
+			this->set_use_input(block.entity, n_user);
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+/*
+ *   The set_*_input functions set the same data that read_mix, read_save,
+ *   read_copy and read_use set for one data block; the entity is given
+ *   by its Keywords::KEY_NAME
+ */
+void IPhreeqc::set_mix_input(const cxxMix& mix)
+{
+	Phreeqc *phreeqc_ptr = this->PhreeqcPtr;
+
+	phreeqc_ptr->Rxn_mix_map[mix.Get_n_user()] = mix;
+	if (phreeqc_ptr->use.Get_mix_in() == FALSE)
+	{
+		phreeqc_ptr->use.Set_mix_in(true);
+		phreeqc_ptr->use.Set_n_mix_user(mix.Get_n_user());
+	}
+	phreeqc_ptr->keycount[Keywords::KEY_MIX]++;
+}
+
+void IPhreeqc::set_save_input(int entity, int n_user)
+{
+	Phreeqc *phreeqc_ptr = this->PhreeqcPtr;
+
+	switch (entity)
+	{
+	case Keywords::KEY_SOLUTION:
+		phreeqc_ptr->save.solution = TRUE;
+		phreeqc_ptr->save.n_solution_user = n_user;
+		phreeqc_ptr->save.n_solution_user_end = n_user;
+		break;
+	case Keywords::KEY_EQUILIBRIUM_PHASES:
+		phreeqc_ptr->save.pp_assemblage = TRUE;
+		phreeqc_ptr->save.n_pp_assemblage_user = n_user;
+		phreeqc_ptr->save.n_pp_assemblage_user_end = n_user;
+		break;
+	case Keywords::KEY_EXCHANGE:
+		phreeqc_ptr->save.exchange = TRUE;
+		phreeqc_ptr->save.n_exchange_user = n_user;
+		phreeqc_ptr->save.n_exchange_user_end = n_user;
+		break;
+	case Keywords::KEY_SURFACE:
+		phreeqc_ptr->save.surface = TRUE;
+		phreeqc_ptr->save.n_surface_user = n_user;
+		phreeqc_ptr->save.n_surface_user_end = n_user;
+		break;
+	case Keywords::KEY_GAS_PHASE:
+		phreeqc_ptr->save.gas_phase = TRUE;
+		phreeqc_ptr->save.n_gas_phase_user = n_user;
+		phreeqc_ptr->save.n_gas_phase_user_end = n_user;
+		break;
+	case Keywords::KEY_SOLID_SOLUTIONS:
+		phreeqc_ptr->save.ss_assemblage = TRUE;
+		phreeqc_ptr->save.n_ss_assemblage_user = n_user;
+		phreeqc_ptr->save.n_ss_assemblage_user_end = n_user;
+		break;
+	default:
+		break;
+	}
+	phreeqc_ptr->keycount[Keywords::KEY_SAVE]++;
+}
+
+void IPhreeqc::set_copy_input(int entity, int n_user, int target)
+{
+	Phreeqc *phreeqc_ptr = this->PhreeqcPtr;
+	struct copier *copier_ptr = NULL;
+
+	switch (entity)
+	{
+	case Keywords::KEY_SOLUTION:
+		copier_ptr = &phreeqc_ptr->copy_solution;
+		break;
+	case Keywords::KEY_EQUILIBRIUM_PHASES:
+		copier_ptr = &phreeqc_ptr->copy_pp_assemblage;
+		break;
+	case Keywords::KEY_REACTION:
+		copier_ptr = &phreeqc_ptr->copy_reaction;
+		break;
+	case Keywords::KEY_MIX:
+		copier_ptr = &phreeqc_ptr->copy_mix;
+		break;
+	case Keywords::KEY_EXCHANGE:
+		copier_ptr = &phreeqc_ptr->copy_exchange;
+		break;
+	case Keywords::KEY_SURFACE:
+		copier_ptr = &phreeqc_ptr->copy_surface;
+		break;
+	case Keywords::KEY_REACTION_TEMPERATURE:
+		copier_ptr = &phreeqc_ptr->copy_temperature;
+		break;
+	case Keywords::KEY_REACTION_PRESSURE:
+		copier_ptr = &phreeqc_ptr->copy_pressure;
+		break;
+	case Keywords::KEY_GAS_PHASE:
+		copier_ptr = &phreeqc_ptr->copy_gas_phase;
+		break;
+	case Keywords::KEY_KINETICS:
+		copier_ptr = &phreeqc_ptr->copy_kinetics;
+		break;
+	case Keywords::KEY_SOLID_SOLUTIONS:
+		copier_ptr = &phreeqc_ptr->copy_ss_assemblage;
+		break;
+	default:
+		break;
+	}
+	if (copier_ptr)
+	{
+		phreeqc_ptr->copier_add(copier_ptr, n_user, target, target);
+	}
+	phreeqc_ptr->keycount[Keywords::KEY_COPY]++;
+}
+
+void IPhreeqc::set_use_input(int entity, int n_user)
+{
+	Phreeqc *phreeqc_ptr = this->PhreeqcPtr;
+
+	switch (entity)
+	{
+	case Keywords::KEY_SOLUTION:
+		phreeqc_ptr->use.Set_n_solution_user(n_user);
+		phreeqc_ptr->use.Set_solution_in(n_user >= 0);
+		break;
+	case Keywords::KEY_EQUILIBRIUM_PHASES:
+		phreeqc_ptr->use.Set_n_pp_assemblage_user(n_user);
+		phreeqc_ptr->use.Set_pp_assemblage_in(n_user >= 0);
+		break;
+	case Keywords::KEY_REACTION:
+		phreeqc_ptr->use.Set_n_reaction_user(n_user);
+		phreeqc_ptr->use.Set_reaction_in(n_user >= 0);
+		break;
+	case Keywords::KEY_MIX:
+		phreeqc_ptr->use.Set_n_mix_user(n_user);
+		phreeqc_ptr->use.Set_mix_in(n_user >= 0);
+		break;
+	case Keywords::KEY_EXCHANGE:
+		phreeqc_ptr->use.Set_n_exchange_user(n_user);
+		phreeqc_ptr->use.Set_exchange_in(n_user >= 0);
+		break;
+	case Keywords::KEY_SURFACE:
+		phreeqc_ptr->use.Set_n_surface_user(n_user);
+		phreeqc_ptr->use.Set_surface_in(n_user >= 0);
+		break;
+	case Keywords::KEY_REACTION_TEMPERATURE:
+		phreeqc_ptr->use.Set_n_temperature_user(n_user);
+		phreeqc_ptr->use.Set_temperature_in(n_user >= 0);
+		break;
+	case Keywords::KEY_REACTION_PRESSURE:
+		phreeqc_ptr->use.Set_n_pressure_user(n_user);
+		phreeqc_ptr->use.Set_pressure_in(n_user >= 0);
+		break;
+	case Keywords::KEY_GAS_PHASE:
+		phreeqc_ptr->use.Set_n_gas_phase_user(n_user);
+		phreeqc_ptr->use.Set_gas_phase_in(n_user >= 0);
+		break;
+	case Keywords::KEY_KINETICS:
+		phreeqc_ptr->use.Set_n_kinetics_user(n_user);
+		phreeqc_ptr->use.Set_kinetics_in(n_user >= 0);
+		break;
+	case Keywords::KEY_SOLID_SOLUTIONS:
+		phreeqc_ptr->use.Set_n_ss_assemblage_user(n_user);
+		phreeqc_ptr->use.Set_ss_assemblage_in(n_user >= 0);
+		break;
+	default:
+		break;
+	}
+	phreeqc_ptr->keycount[Keywords::KEY_USE]++;
+}
+
 void IPhreeqc::update_errors(void)
 {
 	this->ErrorLines.clear();
@@ -1661,6 +2417,22 @@ void IPhreeqc::punch_msg(const char *str)
 
 void IPhreeqc::open_output_files(const char* sz_routine)
 {
+	if (this->PersistentFilesOn)
+	{
+		if (this->OutputFileOn)
+		{
+			this->output_ostream = this->persistent_stream(PERSISTENT_OUTPUT, this->OutputFileName, sz_routine);
+		}
+		if (this->ErrorFileOn)
+		{
+			this->error_ostream = this->persistent_stream(PERSISTENT_ERROR, this->ErrorFileName, sz_routine);
+		}
+		if (this->LogFileOn)
+		{
+			this->log_ostream = this->persistent_stream(PERSISTENT_LOG, this->LogFileName, sz_routine);
+		}
+		return;
+	}
 	if (this->OutputFileOn)
 	{
 		if (this->output_ostream != NULL)
@@ -1711,6 +2483,54 @@ void IPhreeqc::open_output_files(const char* sz_routine)
 	}
 }
 
+std::ostream* IPhreeqc::persistent_stream(int i, const std::string& name, const char* sz_routine)
+{
+	CPersistentFile*& pf = this->PersistentFiles[i];
+	if (pf && (pf->name != name || !pf->ofs.is_open()))
+	{
+		delete pf;
+		pf = 0;
+	}
+	if (!pf)
+	{
+		pf = new CPersistentFile(name);
+		if (!pf->ofs.is_open())
+		{
+			delete pf;
+			pf = 0;
+
+			std::ostringstream oss;
+			oss << sz_routine << ": Unable to open:" << "\"" << name << "\".\n";
+			this->warning_msg(oss.str().c_str());
+			return NULL;
+		}
+	}
+	return &pf->ofs;
+}
+
+void IPhreeqc::release_stream(std::ostream** stream_ptr)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		if (this->PersistentFiles[i] && *stream_ptr == &this->PersistentFiles[i]->ofs)
+		{
+			// persistent files stay open until SetPersistentFilesOn(false)
+			*stream_ptr = NULL;
+			return;
+		}
+	}
+	safe_close(stream_ptr);
+}
+
+void IPhreeqc::close_persistent_files(void)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		delete this->PersistentFiles[i];
+		this->PersistentFiles[i] = 0;
+	}
+}
+
 int IPhreeqc::close_input_files(void)
 {
 	int i = 0;
@@ -1730,10 +2550,10 @@ int IPhreeqc::close_output_files(void)
 {
 	int ret = 0;
 
-	safe_close(&this->output_ostream);
-	safe_close(&this->log_ostream);
+	this->release_stream(&this->output_ostream);
+	this->release_stream(&this->log_ostream);
 	safe_close(&this->dump_ostream);
-	safe_close(&this->error_ostream);
+	this->release_stream(&this->error_ostream);
 
 	std::map< int, SelectedOutput >::iterator it = this->PhreeqcPtr->SelectedOutput_map.begin();
 	for (; it != this->PhreeqcPtr->SelectedOutput_map.end(); ++it)
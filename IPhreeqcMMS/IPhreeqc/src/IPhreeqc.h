@@ -16,6 +16,10 @@
  *   <tr><td class="indexkey"><a class="el" href="Var_8h.html">Var.h</a></td><td class="indexvalue">IPhreeqc VARIANT Documentation </td></tr>
  *  </table>
  *  @endhtmlonly
+ *
+ *  Distinct instances (see @ref CreateIPhreeqc) share no mutable state and may be used
+ *  concurrently from different threads.  A single instance must not be used from more
+ *  than one thread at a time.
  */
 
 /*! @brief Enumeration used to return error codes.
@@ -131,6 +135,54 @@ extern "C" {
 	IPQ_DLL_EXPORT IPQ_RESULT  ClearAccumulatedLines(int id);
 
 
+/**
+ *  Releases all of the inputs prepared by @ref PrepareAccumulated and @ref PrepareString.
+ *  @param id                The instance id returned from @ref CreateIPhreeqc.
+ *  @retval IPQ_OK           Success.
+ *  @retval IPQ_BADINSTANCE  The given id is invalid.
+ *  @see                     PrepareAccumulated, PrepareString, RunPrepared
+ *  @par Fortran90 Interface:
+ *  @htmlonly
+ *  <CODE>
+ *  <PRE>
+ *  FUNCTION ClearPrepared(ID)
+ *    INTEGER(KIND=4), INTENT(IN) :: ID
+ *    INTEGER(KIND=4)             :: ClearPrepared
+ *  END FUNCTION ClearPrepared
+ *  </PRE>
+ *  </CODE>
+ *  @endhtmlonly
+ */
+	IPQ_DLL_EXPORT IPQ_RESULT  ClearPrepared(int id);
+
+
+/**
+ *  Create a new IPhreeqc instance that is a deep copy of the given instance: the loaded database and
+ *  all of the solutions, reactants, and <b>SELECTED_OUTPUT</b>/<b>USER_PUNCH</b> definitions saved by previous runs.
+ *  The database is copied rather than read again, so cloning is faster than @ref LoadDatabase followed by
+ *  the runs that defined the reactants.
+ *  The on/off settings for output files and strings are copied; file names are not, so the clone writes
+ *  to its own default files.  Accumulated input, prepared inputs, errors, warnings, and the results of
+ *  previous runs are not copied.
+ *  @param id            The instance id returned from @ref CreateIPhreeqc.
+ *  @return      The id of the new instance if successful; otherwise a negative value indicates an error occured (see @ref IPQ_RESULT).
+ *               If the copy fails, the errors are available from @ref GetErrorString of the new instance.
+ *  @see         CreateIPhreeqc, DestroyIPhreeqc
+ *  @par Fortran90 Interface:
+ *  @htmlonly
+ *  <CODE>
+ *  <PRE>
+ *  FUNCTION CloneIPhreeqc(ID)
+ *    INTEGER(KIND=4),  INTENT(IN)  :: ID
+ *    INTEGER(KIND=4)               :: CloneIPhreeqc
+ *  END FUNCTION CloneIPhreeqc
+ *  </PRE>
+ *  </CODE>
+ *  @endhtmlonly
+ */
+	IPQ_DLL_EXPORT int         CloneIPhreeqc(int id);
+
+
 /**
  *  Create a new IPhreeqc instance.
  *  @return      A non-negative value if successful; otherwise a negative value indicates an error occured (see @ref IPQ_RESULT).
@@ -184,6 +236,29 @@ extern "C" {
 	IPQ_DLL_EXPORT IPQ_RESULT  DestroyIPhreeqc(int id);
 
 
+/**
+ *  Writes the buffered contents of the persistent output, error, and log files to disk (see @ref SetPersistentFilesOn).
+ *  Files that have grown past the limit set by @ref SetPersistentFilesLimit are rotated:
+ *  <B><I>name</I></B> is renamed to <B><I>name.1</I></B> and a new <B><I>name</I></B> is started.
+ *  @param id                The instance id returned from @ref CreateIPhreeqc.
+ *  @retval IPQ_OK           Success.
+ *  @retval IPQ_BADINSTANCE  The given id is invalid.
+ *  @see                     GetPersistentFilesOn, SetPersistentFilesLimit, SetPersistentFilesOn
+ *  @par Fortran90 Interface:
+ *  @htmlonly
+ *  <CODE>
+ *  <PRE>
+ *  FUNCTION FlushOutputFiles(ID)
+ *    INTEGER(KIND=4), INTENT(IN) :: ID
+ *    INTEGER(KIND=4)             :: FlushOutputFiles
+ *  END FUNCTION FlushOutputFiles
+ *  </PRE>
+ *  </CODE>
+ *  @endhtmlonly
+ */
+	IPQ_DLL_EXPORT IPQ_RESULT  FlushOutputFiles(int id);
+
+
 /**
  *  Retrieves the given component.
  *  @param id            The instance id returned from @ref CreateIPhreeqc.
@@ -795,6 +870,46 @@ extern "C" {
 	IPQ_DLL_EXPORT int         GetOutputStringOn(int id);
 
 
+/**
+ *  Retrieves the size at which persistent files are rotated by @ref FlushOutputFiles.
+ *  @param id            The instance id returned from @ref CreateIPhreeqc.
+ *  @return              The size in bytes; zero if files are never rotated.
+ *  @see                 FlushOutputFiles, SetPersistentFilesLimit
+ *  @par Fortran90 Interface:
+ *  @htmlonly
+ *  <CODE>
+ *  <PRE>
+ *  FUNCTION GetPersistentFilesLimit(ID)
+ *    INTEGER(KIND=4),  INTENT(IN)  :: ID
+ *    INTEGER(KIND=4)               :: GetPersistentFilesLimit
+ *  END FUNCTION GetPersistentFilesLimit
+ *  </PRE>
+ *  </CODE>
+ *  @endhtmlonly
+ */
+	IPQ_DLL_EXPORT int         GetPersistentFilesLimit(int id);
+
+
+/**
+ *  Retrieves the current value of the persistent files switch.
+ *  @param id            The instance id returned from @ref CreateIPhreeqc.
+ *  @return              Non-zero if the output, error, and log files stay open between runs, 0 (zero) otherwise.
+ *  @see                 FlushOutputFiles, SetPersistentFilesOn
+ *  @par Fortran90 Interface:
+ *  @htmlonly
+ *  <CODE>
+ *  <PRE>
+ *  FUNCTION GetPersistentFilesOn(ID)
+ *    INTEGER(KIND=4),  INTENT(IN)  :: ID
+ *    LOGICAL(KIND=4)               :: GetPersistentFilesOn
+ *  END FUNCTION GetPersistentFilesOn
+ *  </PRE>
+ *  </CODE>
+ *  @endhtmlonly
+ */
+	IPQ_DLL_EXPORT int         GetPersistentFilesOn(int id);
+
+
 /**
  *  Retrieves the number of columns in the selected-output buffer.
  *  @param id            The instance id returned from @ref CreateIPhreeqc.
@@ -814,6 +929,36 @@ extern "C" {
  */
 	IPQ_DLL_EXPORT int         GetSelectedOutputColumnCount(int id);
 
+/**
+ *  Copies the numbers of a column of the current selected-output buffer (see @ref SetCurrentSelectedOutputUserNumber) into an array.
+ *  @param id               The instance id returned from @ref CreateIPhreeqc.
+ *  @param col              The column index (zero-based; one-based from Fortran).
+ *  @param values           Array of at least (@ref GetSelectedOutputRowCount - 1) elements to receive the values of rows 1, 2, ...
+ *                          Elements whose cells are not numbers are left unchanged.
+ *  @param vtypes           Array of the same size to receive the @ref VAR_TYPE of each cell, or NULL.
+ *  @retval IPQ_OK          Success.
+ *  @retval IPQ_INVALIDARG  The current selected-output user number is invalid or values is NULL.
+ *  @retval IPQ_INVALIDCOL  The given column is out of range.
+ *  @retval IPQ_BADINSTANCE The given id is invalid.
+ *  @see                    GetSelectedOutputRowCount, GetSelectedOutputRowDoubles, GetSelectedOutputValue, SetCurrentSelectedOutputUserNumber
+ *  @par Fortran90 Interface:
+ *  From Fortran, integers are returned with a type of TT_DOUBLE, as with GetSelectedOutputValue.
+ *  @htmlonly
+ *  <CODE>
+ *  <PRE>
+ *  FUNCTION GetSelectedOutputColumnDoubles(ID,COL,VALUES,VTYPES)
+ *    INTEGER(KIND=4),   INTENT(IN)   :: ID
+ *    INTEGER(KIND=4),   INTENT(IN)   :: COL
+ *    REAL(KIND=8),      INTENT(INOUT):: VALUES(*)
+ *    INTEGER(KIND=4),   INTENT(OUT)  :: VTYPES(*)
+ *    INTEGER(KIND=4)                 :: GetSelectedOutputColumnDoubles
+ *  END FUNCTION GetSelectedOutputColumnDoubles
+ *  </PRE>
+ *  </CODE>
+ *  @endhtmlonly
+ */
+	IPQ_DLL_EXPORT IPQ_RESULT  GetSelectedOutputColumnDoubles(int id, int col, double* values, int* vtypes);
+
 /**
  *  Retrieves the count of <B>SELECTED_OUTPUT</B> blocks that are currently defined.
  *  @param id            The instance id returned from @ref CreateIPhreeqc.
@@ -898,6 +1043,36 @@ extern "C" {
  */
 	IPQ_DLL_EXPORT int         GetSelectedOutputRowCount(int id);
 
+/**
+ *  Copies the numbers of a row of the current selected-output buffer (see @ref SetCurrentSelectedOutputUserNumber) into an array.
+ *  @param id               The instance id returned from @ref CreateIPhreeqc.
+ *  @param row              The row index; row 0 (the headings) is not valid.
+ *  @param values           Array of at least @ref GetSelectedOutputColumnCount elements to receive the values of the row.
+ *                          Elements whose cells are not numbers are left unchanged.
+ *  @param vtypes           Array of the same size to receive the @ref VAR_TYPE of each cell, or NULL.
+ *  @retval IPQ_OK          Success.
+ *  @retval IPQ_INVALIDARG  The current selected-output user number is invalid or values is NULL.
+ *  @retval IPQ_INVALIDROW  The given row is out of range.
+ *  @retval IPQ_BADINSTANCE The given id is invalid.
+ *  @see                    GetSelectedOutputColumnCount, GetSelectedOutputColumnDoubles, GetSelectedOutputValue, SetCurrentSelectedOutputUserNumber
+ *  @par Fortran90 Interface:
+ *  From Fortran, integers are returned with a type of TT_DOUBLE, as with GetSelectedOutputValue.
+ *  @htmlonly
+ *  <CODE>
+ *  <PRE>
+ *  FUNCTION GetSelectedOutputRowDoubles(ID,ROW,VALUES,VTYPES)
+ *    INTEGER(KIND=4),   INTENT(IN)   :: ID
+ *    INTEGER(KIND=4),   INTENT(IN)   :: ROW
+ *    REAL(KIND=8),      INTENT(INOUT):: VALUES(*)
+ *    INTEGER(KIND=4),   INTENT(OUT)  :: VTYPES(*)
+ *    INTEGER(KIND=4)                 :: GetSelectedOutputRowDoubles
+ *  END FUNCTION GetSelectedOutputRowDoubles
+ *  </PRE>
+ *  </CODE>
+ *  @endhtmlonly
+ */
+	IPQ_DLL_EXPORT IPQ_RESULT  GetSelectedOutputRowDoubles(int id, int row, double* values, int* vtypes);
+
 
 /**
  *  Retrieves the string buffer containing the current <b>SELECTED_OUTPUT</b> (see @ref SetCurrentSelectedOutputUserNumber).
@@ -1448,6 +1623,37 @@ Headings
 	IPQ_DLL_EXPORT int         LoadDatabase(int id, const char* filename);
 
 
+/**
+ *  Load the specified database file into phreeqc, using a binary snapshot of the database when possible.
+ *  @param id            The instance id returned from @ref CreateIPhreeqc.
+ *  @param snapshot      The name of the snapshot file.
+ *  @param database      The name of the phreeqc database to load.
+ *  @return              The number of errors encountered.
+ *  @see                 LoadDatabase
+ *  @remarks
+ *  All previous definitions are cleared.
+ *  @remarks
+ *  The snapshot is used only if it was written by the same build of IPhreeqc from a database
+ *  with the same checksum.  Otherwise the database is read as text, as @ref LoadDatabase does,
+ *  and the snapshot is (re)written.  Databases with keywords that cannot be saved (PITZER, SIT,
+ *  SELECTED_OUTPUT, ...) are always read as text.
+ *  @par Fortran90 Interface:
+ *  @htmlonly
+ *  <CODE>
+ *  <PRE>
+ *  FUNCTION LoadDatabaseSnapshot(ID,SNAPSHOT,DATABASE)
+ *    INTEGER(KIND=4),   INTENT(IN)  :: ID
+ *    CHARACTER(LEN=*),  INTENT(IN)  :: SNAPSHOT
+ *    CHARACTER(LEN=*),  INTENT(IN)  :: DATABASE
+ *    INTEGER(KIND=4)                :: LoadDatabaseSnapshot
+ *  END FUNCTION LoadDatabaseSnapshot
+ *  </PRE>
+ *  </CODE>
+ *  @endhtmlonly
+ */
+	IPQ_DLL_EXPORT int         LoadDatabaseSnapshot(int id, const char* snapshot, const char* database);
+
+
 /**
  *  Load the specified string as a database into phreeqc.
  *  @param id            The instance id returned from @ref CreateIPhreeqc.
@@ -1535,6 +1741,55 @@ Headings
 	IPQ_DLL_EXPORT void        OutputWarningString(int id);
 
 
+/**
+ *  Prepares the input buffer as defined by calls to @ref AccumulateLine for repeated runs
+ *  with @ref RunPrepared (see @ref PrepareString).
+ *  @param id            The instance id returned from @ref CreateIPhreeqc.
+ *  @return              The index of the prepared input if successful; otherwise a negative value indicates an error occured (see @ref IPQ_RESULT).
+ *  @see                 AccumulateLine, PrepareString, RunPrepared, SetPreparedInteger, SetPreparedValue
+ *  @remarks
+ *  The accumulated input is cleared at the next call to @ref AccumulateLine.
+ *  @par Fortran90 Interface:
+ *  @htmlonly
+ *  <CODE>
+ *  <PRE>
+ *  FUNCTION PrepareAccumulated(ID)
+ *    INTEGER(KIND=4),  INTENT(IN)  :: ID
+ *    INTEGER(KIND=4)               :: PrepareAccumulated
+ *  END FUNCTION PrepareAccumulated
+ *  </PRE>
+ *  </CODE>
+ *  @endhtmlonly
+ */
+	IPQ_DLL_EXPORT int         PrepareAccumulated(int id);
+
+
+/**
+ *  Prepares phreeqc input for repeated runs with @ref RunPrepared.  Numbers written as
+ *  <CODE>{name}</CODE> are placeholders whose values are set with @ref SetPreparedInteger
+ *  and @ref SetPreparedValue before each run.  Simulations made up of <B>MIX</B>, <B>SAVE</B>,
+ *  <B>COPY</B> and <B>USE</B> data blocks are parsed once; other simulations are read with
+ *  the current values on each run.
+ *  @param id            The instance id returned from @ref CreateIPhreeqc.
+ *  @param input         String containing phreeqc input.
+ *  @return              The index of the prepared input if successful; otherwise a negative value indicates an error occured (see @ref IPQ_RESULT).
+ *  @see                 ClearPrepared, PrepareAccumulated, RunPrepared, SetPreparedInteger, SetPreparedValue
+ *  @par Fortran90 Interface:
+ *  @htmlonly
+ *  <CODE>
+ *  <PRE>
+ *  FUNCTION PrepareString(ID,INPUT)
+ *    INTEGER(KIND=4),   INTENT(IN)  :: ID
+ *    CHARACTER(LEN=*),  INTENT(IN)  :: INPUT
+ *    INTEGER(KIND=4)                :: PrepareString
+ *  END FUNCTION PrepareString
+ *  </PRE>
+ *  </CODE>
+ *  @endhtmlonly
+ */
+	IPQ_DLL_EXPORT int         PrepareString(int id, const char* input);
+
+
 /**
  *  Runs the input buffer as defined by calls to @ref AccumulateLine.
  *  @param id            The instance id returned from @ref CreateIPhreeqc.
@@ -1590,6 +1845,32 @@ Headings
 	IPQ_DLL_EXPORT int         RunFile(int id, const char* filename);
 
 
+/**
+ *  Runs an input prepared by @ref PrepareAccumulated or @ref PrepareString with the current placeholder values.
+ *  @param id            The instance id returned from @ref CreateIPhreeqc.
+ *  @param n             The index returned by @ref PrepareAccumulated or @ref PrepareString.
+ *  @return              The number of errors encountered during the run.
+ *  @see                 PrepareAccumulated, PrepareString, SetPreparedInteger, SetPreparedValue
+ *  @remarks
+ *  Prepared simulations are echoed to the output only when output is written to a file or string;
+ *  otherwise the parsed data blocks are used directly.
+ *  @pre                 (@ref LoadDatabase, @ref LoadDatabaseString) must have been called and returned 0 (zero) errors.
+ *  @par Fortran90 Interface:
+ *  @htmlonly
+ *  <CODE>
+ *  <PRE>
+ *  FUNCTION RunPrepared(ID,N)
+ *    INTEGER(KIND=4),  INTENT(IN)  :: ID
+ *    INTEGER(KIND=4),  INTENT(IN)  :: N
+ *    INTEGER(KIND=4)               :: RunPrepared
+ *  END FUNCTION RunPrepared
+ *  </PRE>
+ *  </CODE>
+ *  @endhtmlonly
+ */
+	IPQ_DLL_EXPORT int         RunPrepared(int id, int n);
+
+
 /**
  *  Runs the specified string as input to phreeqc.
  *  @param id            The instance id returned from @ref CreateIPhreeqc.
@@ -2042,6 +2323,111 @@ Headings
 	IPQ_DLL_EXPORT IPQ_RESULT  SetOutputStringOn(int id, int output_string_on);
 
 
+/**
+ *  Sets the size at which persistent files are rotated by @ref FlushOutputFiles.  The initial setting is zero.
+ *  @param id               The instance id returned from @ref CreateIPhreeqc.
+ *  @param bytes            The size in bytes; zero or less never rotates the files.
+ *  @retval IPQ_OK          Success.
+ *  @retval IPQ_BADINSTANCE The given id is invalid.
+ *  @see                    FlushOutputFiles, GetPersistentFilesLimit, SetPersistentFilesOn
+ *  @par Fortran90 Interface:
+ *  @htmlonly
+ *  <CODE>
+ *  <PRE>
+ *  FUNCTION SetPersistentFilesLimit(ID,BYTES)
+ *    INTEGER(KIND=4),  INTENT(IN)  :: ID
+ *    INTEGER(KIND=4),  INTENT(IN)  :: BYTES
+ *    INTEGER(KIND=4)               :: SetPersistentFilesLimit
+ *  END FUNCTION SetPersistentFilesLimit
+ *  </PRE>
+ *  </CODE>
+ *  @endhtmlonly
+ */
+	IPQ_DLL_EXPORT IPQ_RESULT  SetPersistentFilesLimit(int id, int bytes);
+
+
+/**
+ *  Sets the persistent files switch on or off.  When on, the output, error, and log files
+ *  are opened once in append mode with a large buffer and stay open between runs, instead of being
+ *  recreated by every run.  Output reaches the disk when the buffer fills, on @ref FlushOutputFiles,
+ *  when the switch is turned off, or when the instance is destroyed.  The initial setting is off.
+ *  @param id               The instance id returned from @ref CreateIPhreeqc.
+ *  @param persistent_on    If non-zero, keeps the files open; if zero, flushes and closes any persistent files.
+ *  @retval IPQ_OK          Success.
+ *  @retval IPQ_BADINSTANCE The given id is invalid.
+ *  @see                    FlushOutputFiles, GetPersistentFilesOn, SetPersistentFilesLimit
+ *  @par Fortran90 Interface:
+ *  @htmlonly
+ *  <CODE>
+ *  <PRE>
+ *  FUNCTION SetPersistentFilesOn(ID,PERSISTENT_ON)
+ *    INTEGER(KIND=4),  INTENT(IN)  :: ID
+ *    LOGICAL(KIND=4),  INTENT(IN)  :: PERSISTENT_ON
+ *    INTEGER(KIND=4)               :: SetPersistentFilesOn
+ *  END FUNCTION SetPersistentFilesOn
+ *  </PRE>
+ *  </CODE>
+ *  @endhtmlonly
+ */
+	IPQ_DLL_EXPORT IPQ_RESULT  SetPersistentFilesOn(int id, int persistent_on);
+
+
+/**
+ *  Sets an integer placeholder of a prepared input (see @ref PrepareString).
+ *  @param id                   The instance id returned from @ref CreateIPhreeqc.
+ *  @param n                    The index returned by @ref PrepareAccumulated or @ref PrepareString.
+ *  @param name                 The placeholder name, without braces.
+ *  @param value                The value used by the following calls to @ref RunPrepared.
+ *  @retval IPQ_OK              Success.
+ *  @retval IPQ_BADINSTANCE     The given id is invalid.
+ *  @retval IPQ_INVALIDARG      The prepared input or the placeholder does not exist.
+ *  @see                        PrepareString, RunPrepared, SetPreparedValue
+ *  @par Fortran90 Interface:
+ *  @htmlonly
+ *  <CODE>
+ *  <PRE>
+ *  FUNCTION SetPreparedInteger(ID,N,NAME,VALUE)
+ *    INTEGER(KIND=4),   INTENT(IN)  :: ID
+ *    INTEGER(KIND=4),   INTENT(IN)  :: N
+ *    CHARACTER(LEN=*),  INTENT(IN)  :: NAME
+ *    INTEGER(KIND=4),   INTENT(IN)  :: VALUE
+ *    INTEGER(KIND=4)                :: SetPreparedInteger
+ *  END FUNCTION SetPreparedInteger
+ *  </PRE>
+ *  </CODE>
+ *  @endhtmlonly
+ */
+	IPQ_DLL_EXPORT IPQ_RESULT  SetPreparedInteger(int id, int n, const char* name, int value);
+
+
+/**
+ *  Sets a numeric placeholder of a prepared input (see @ref PrepareString).
+ *  @param id                   The instance id returned from @ref CreateIPhreeqc.
+ *  @param n                    The index returned by @ref PrepareAccumulated or @ref PrepareString.
+ *  @param name                 The placeholder name, without braces.
+ *  @param value                The value used by the following calls to @ref RunPrepared.
+ *  @retval IPQ_OK              Success.
+ *  @retval IPQ_BADINSTANCE     The given id is invalid.
+ *  @retval IPQ_INVALIDARG      The prepared input or the placeholder does not exist.
+ *  @see                        PrepareString, RunPrepared, SetPreparedInteger
+ *  @par Fortran90 Interface:
+ *  @htmlonly
+ *  <CODE>
+ *  <PRE>
+ *  FUNCTION SetPreparedValue(ID,N,NAME,VALUE)
+ *    INTEGER(KIND=4),   INTENT(IN)  :: ID
+ *    INTEGER(KIND=4),   INTENT(IN)  :: N
+ *    CHARACTER(LEN=*),  INTENT(IN)  :: NAME
+ *    REAL(KIND=8),      INTENT(IN)  :: VALUE
+ *    INTEGER(KIND=4)                :: SetPreparedValue
+ *  END FUNCTION SetPreparedValue
+ *  </PRE>
+ *  </CODE>
+ *  @endhtmlonly
+ */
+	IPQ_DLL_EXPORT IPQ_RESULT  SetPreparedValue(int id, int n, const char* name, double value);
+
+
 /**
  *  Sets the name of the current selected output file (see @ref SetCurrentSelectedOutputUserNumber).  This file name is used if not specified within <B>SELECTED_OUTPUT</B> input.
  *  The default value is <B><I>selected_n.id.out</I></B>.
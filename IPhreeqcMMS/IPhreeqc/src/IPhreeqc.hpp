@@ -24,6 +24,9 @@ class Phreeqc;
 class IErrorReporter;
 class CSelectedOutput;
 class SelectedOutput;
+class CPreparedInput;
+class cxxMix;
+class CPersistentFile;
 
 /**
  * @class IPhreeqcStop
@@ -43,6 +46,10 @@ public:
  * @brief Provides an interface to PHREEQC (Version 3)--A Computer
  * Program for Speciation, Batch-Reaction, One-Dimensional Transport,
  * and Inverse Geochemical Calculations
+ *
+ * Distinct instances share no mutable state and may be used concurrently
+ * from different threads.  A single instance must not be used from more
+ * than one thread at a time.
  */
 
 class IPQ_DLL_EXPORT IPhreeqc : public PHRQ_io
@@ -96,6 +103,35 @@ public:
 	 */
 	void                     ClearAccumulatedLines(void);
 
+	/**
+	 *  Releases all of the inputs prepared by @ref PrepareAccumulated and @ref PrepareString.
+	 *  @see                    PrepareAccumulated, PrepareString, RunPrepared
+	 */
+	void                     ClearPrepared(void);
+
+	/**
+	 *  Creates a new instance that is a deep copy of this one: the loaded database and all of the
+	 *  solutions, reactants, and <b>SELECTED_OUTPUT</b>/<b>USER_PUNCH</b> definitions saved by previous runs.
+	 *  The database is copied rather than read again, so cloning is faster than @ref LoadDatabase
+	 *  followed by the runs that defined the reactants.
+	 *  The on/off settings for output files and strings are copied; file names are not, so the clone
+	 *  writes to its own default files.  Accumulated input, prepared inputs, errors, warnings, and the
+	 *  results of previous runs are not copied.
+	 *  @return                 The new instance; the caller is responsible for deleting it.
+	 *                          If the copy fails, the errors are available from @ref GetErrorString of the new instance.
+	 *  @see                    LoadDatabase
+	 */
+	IPhreeqc*                Clone(void)const;
+
+	/**
+	 *  Writes the buffered contents of the persistent output, error, and log files to disk (see @ref SetPersistentFilesOn).
+	 *  Files that have grown past the limit set by @ref SetPersistentFilesLimit are rotated:
+	 *  <B><I>name</I></B> is renamed to <B><I>name.1</I></B> (replacing any previous <B><I>name.1</I></B>) and a new <B><I>name</I></B> is started.
+	 *  Does nothing if no persistent files are open.
+	 *  @see                    GetPersistentFilesOn, SetPersistentFilesLimit, SetPersistentFilesOn
+	 */
+	void                     FlushOutputFiles(void);
+
 	/**
 	 *  Retrieve the accumulated input string.  The accumulated input string can be run
 	 *  with @ref RunAccumulated.
@@ -104,6 +140,14 @@ public:
 	 */
 	const std::string&       GetAccumulatedLines(void);
 
+	/**
+	 *  Retrieves the current value of the BASIC bytecode switch.
+	 *  @retval true            BASIC programs (<B>RATES</B>, <B>USER_PUNCH</B>, <B>CALCULATE_VALUES</B>, ...) are compiled to bytecode the first time they are run.
+	 *  @retval false           BASIC programs are interpreted.
+	 *  @see                    SetBasicBytecodeOn
+	 */
+	bool                     GetBasicBytecodeOn(void)const;
+
 	/**
 	 *  Retrieves the given component.
 	 *  @param n                The zero-based index of the component to retrieve.
@@ -127,6 +171,14 @@ public:
 	 */
 	int                      GetCurrentSelectedOutputUserNumber(void)const;
 
+	/**
+	 *  Retrieves the current value of the CVODE Jacobian reuse switch.
+	 *  @retval true            <B>KINETICS</B> integrated with <B>-cvode</B> keep their Jacobian between time steps.
+	 *  @retval false           Each integration starts with a new Jacobian.
+	 *  @see                    SetCvodeJacobianReuseOn
+	 */
+	bool                     GetCvodeJacobianReuseOn(void)const;
+
 	/**
 	 *  Retrieves the name of the dump file.  This file name is used if not specified within <B>DUMP</B> input.
 	 *  The default value is <B><I>dump.id.out</I></B>, where id is obtained from @ref GetId.
@@ -223,6 +275,13 @@ public:
 	 */
 	bool                     GetErrorStringOn(void)const;
 
+	/**
+	 *  Retrieves the ionic-strength tolerance for reusing aqueous activity coefficients.
+	 *  @return                 The tolerance, relative to the ionic strength.
+	 *  @see                    SetGammaMuTolerance
+	 */
+	double                   GetGammaMuTolerance(void)const;
+
 	/**
 	 *  Retrieves the id of this object.  Each instance receives an id which is incremented for each instance
 	 *  starting with the value zero.
@@ -230,6 +289,14 @@ public:
 	 */
 	int                      GetId(void)const;
 
+	/**
+	 *  Retrieves the current value of the LU switch for the Newton steps of equilibrium calculations.
+	 *  @retval true            Steps with only equality constraints, as many as unknowns, are solved by LU decomposition.
+	 *  @retval false           All steps are solved by the Cl1 optimizer.
+	 *  @see                    SetIneqLUOn
+	 */
+	bool                     GetIneqLUOn(void)const;
+
 	/**
 	 *  Retrieves the name of the log file. The default value is <B><I>phreeqc.id.log</I></B>, where id is obtained from @ref GetId.
 	 *  @return filename        The name of the file to write to.
@@ -340,6 +407,36 @@ public:
 	 */
 	bool                     GetOutputStringOn(void)const;
 
+	/**
+	 *  Retrieves the current value of the parallel Jacobian switch.
+	 *  @retval true            Columns of the numerical Pitzer Jacobian are evaluated on several threads.
+	 *  @retval false           Columns are evaluated one after another.
+	 *  @see                    GetParallelJacobianThreshold, SetParallelJacobianOn, SetParallelJacobianThreshold
+	 */
+	bool                     GetParallelJacobianOn(void)const;
+
+	/**
+	 *  Retrieves the fewest unknowns for which Jacobian columns are evaluated on several threads.
+	 *  @return                 The number of unknowns.
+	 *  @see                    GetParallelJacobianOn, SetParallelJacobianOn, SetParallelJacobianThreshold
+	 */
+	int                      GetParallelJacobianThreshold(void)const;
+
+	/**
+	 *  Retrieves the size at which persistent files are rotated by @ref FlushOutputFiles.
+	 *  @return                 The size in bytes; zero if files are never rotated.
+	 *  @see                    FlushOutputFiles, GetPersistentFilesOn, SetPersistentFilesLimit, SetPersistentFilesOn
+	 */
+	int                      GetPersistentFilesLimit(void)const;
+
+	/**
+	 *  Retrieves the current value of the persistent files switch.
+	 *  @retval true            The output, error, and log files stay open between runs.
+	 *  @retval false           The output, error, and log files are recreated by each run.
+	 *  @see                    FlushOutputFiles, GetPersistentFilesLimit, SetPersistentFilesLimit, SetPersistentFilesOn
+	 */
+	bool                     GetPersistentFilesOn(void)const;
+
 	/**
 	 *  Retrieves the number of columns in the current selected-output buffer (see @ref SetCurrentSelectedOutputUserNumber).
 	 *  @return                 The number of columns.
@@ -347,6 +444,19 @@ public:
 	 */
 	int                      GetSelectedOutputColumnCount(void)const;
 
+	/**
+	 *  Copies the numbers of a column of the current selected-output buffer (see @ref SetCurrentSelectedOutputUserNumber) into an array.
+	 *  @param col              The column index.
+	 *  @param values           Array of at least (@ref GetSelectedOutputRowCount - 1) elements to receive the values of rows 1, 2, ...
+	 *                          Elements whose cells are not numbers are left unchanged.
+	 *  @param vtypes           Array of the same size to receive the @c VAR_TYPE of each cell, or NULL.
+	 *  @retval VR_OK           Success.
+	 *  @retval VR_INVALIDARG   The current selected-output user number is invalid or values is NULL.
+	 *  @retval VR_INVALIDCOL   The given column is out of range.
+	 *  @see                    GetSelectedOutputRowCount, GetSelectedOutputRowDoubles, GetSelectedOutputValue, SetCurrentSelectedOutputUserNumber
+	 */
+	VRESULT                  GetSelectedOutputColumnDoubles(int col, double* values, int* vtypes);
+
 	/**
 	 *  Retrieves the count of <B>SELECTED_OUTPUT</B> blocks that are currently defined.
 	 *  @return                 The number of <B>SELECTED_OUTPUT</B> blocks.
@@ -377,6 +487,19 @@ public:
 	 */
 	int                      GetSelectedOutputRowCount(void)const;
 
+	/**
+	 *  Copies the numbers of a row of the current selected-output buffer (see @ref SetCurrentSelectedOutputUserNumber) into an array.
+	 *  @param row              The row index; row 0 (the headings) is not valid.
+	 *  @param values           Array of at least @ref GetSelectedOutputColumnCount elements to receive the values of the row.
+	 *                          Elements whose cells are not numbers are left unchanged.
+	 *  @param vtypes           Array of the same size to receive the @c VAR_TYPE of each cell, or NULL.
+	 *  @retval VR_OK           Success.
+	 *  @retval VR_INVALIDARG   The current selected-output user number is invalid or values is NULL.
+	 *  @retval VR_INVALIDROW   The given row is out of range.
+	 *  @see                    GetSelectedOutputColumnCount, GetSelectedOutputColumnDoubles, GetSelectedOutputValue, SetCurrentSelectedOutputUserNumber
+	 */
+	VRESULT                  GetSelectedOutputRowDoubles(int row, double* values, int* vtypes);
+
 	/**
 	 *  Retrieves the string buffer containing <b>SELECTED_OUTPUT</b> for the currently selected user number (see @ref SetCurrentSelectedOutputUserNumber).
 	 *  @return                 A null terminated string containing <b>SELECTED_OUTPUT</b>.
@@ -634,6 +757,23 @@ public:
 	 */
 	int                      LoadDatabase(const char* filename);
 
+	/**
+	 *  Load the specified database file into phreeqc, using a binary snapshot of the database when possible.
+	 *  @param snapshot         The name of the snapshot file.
+	 *  @param database         The name of the phreeqc database to load.
+	 *  @return                 The number of errors encountered.
+	 *  @see                    LoadDatabase
+	 *  @remarks
+	 *      All previous definitions are cleared.
+	 *  @remarks
+	 *      The snapshot is used only if it was written by the same build of IPhreeqc
+	 *      from a database with the same checksum.  Otherwise the database is read as
+	 *      text, as @ref LoadDatabase does, and the snapshot is (re)written.  Databases
+	 *      with keywords that cannot be saved (PITZER, SIT, SELECTED_OUTPUT, ...) are
+	 *      always read as text.
+	 */
+	int                      LoadDatabaseSnapshot(const char* snapshot, const char* database);
+
 	/**
 	 *  Load the specified string as a database into phreeqc.
 	 *  @param input            String containing data to be used as the phreeqc database.
@@ -663,6 +803,27 @@ public:
 	 */
 	void                     OutputWarningString(void);
 
+	/**
+	 *  Prepares the input buffer as defined by calls to @ref AccumulateLine for repeated runs with @ref RunPrepared.
+	 *  @return                 The index of the prepared input.
+	 *  @see                    AccumulateLine, PrepareString, RunPrepared, SetPreparedInteger, SetPreparedValue
+	 *  @remarks
+	 *      The accumulated input is cleared at the next call to @ref AccumulateLine.
+	 */
+	int                      PrepareAccumulated(void);
+
+	/**
+	 *  Prepares phreeqc input for repeated runs with @ref RunPrepared.  Numbers written as
+	 *  <CODE>{name}</CODE> are placeholders whose values are set with @ref SetPreparedInteger
+	 *  and @ref SetPreparedValue before each run.  <B>MIX</B>, <B>SAVE</B>, <B>COPY</B> and
+	 *  <B>USE</B> data blocks are parsed once; simulations containing other keywords are
+	 *  read with the current values on each run.
+	 *  @param input            String containing phreeqc input.
+	 *  @return                 The index of the prepared input.
+	 *  @see                    ClearPrepared, PrepareAccumulated, RunPrepared, SetPreparedInteger, SetPreparedValue
+	 */
+	int                      PrepareString(const char* input);
+
 	/**
 	 *  Runs the input buffer as defined by calls to @ref AccumulateLine.
 	 *  @return                 The number of errors encountered.
@@ -684,6 +845,20 @@ public:
 	 */
 	int                      RunFile(const char* filename);
 
+	/**
+	 *  Runs an input prepared by @ref PrepareAccumulated or @ref PrepareString with the current placeholder values.
+	 *  @param n                The index returned by @ref PrepareAccumulated or @ref PrepareString.
+	 *  @return                 The number of errors encountered during the run.
+	 *  @see                    PrepareAccumulated, PrepareString, SetPreparedInteger, SetPreparedValue
+	 *  @remarks
+	 *      Prepared simulations are echoed to the output only when output is written to a file or string;
+	 *      otherwise the parsed data blocks are used directly.
+	 *  @pre
+	 *      @ref LoadDatabase/@ref LoadDatabaseString must have been called and returned 0 (zero) errors.
+	 *      All placeholders must have values.
+	 */
+	int                      RunPrepared(int n);
+
 	/**
 	 *  Runs the specified string as input to phreeqc.
 	 *  @param input            String containing phreeqc input.
@@ -719,6 +894,15 @@ public:
 	void                     SetBasicFortranCallback(double (*fcn)(double *x1, double *x2, const char *str, int l));
 #endif
 
+	/**
+	 *  Sets the BASIC bytecode switch on or off.  When on, each BASIC program is compiled the first time it is run
+	 *  and the compiled form is reused until the program is redefined; programs that cannot be compiled are interpreted.
+	 *  Results are the same either way.  The initial setting is true.
+	 *  @param bValue           If true, compiles BASIC programs; if false, interprets them.
+	 *  @see                    GetBasicBytecodeOn
+	 */
+	void                     SetBasicBytecodeOn(bool bValue);
+
 	/**
 	 *  Sets the current <B>SELECTED_OUTPUT</B> user number for use in subsequent calls to (@ref GetSelectedOutputColumnCount, 
      *  @ref GetSelectedOutputFileName, @ref GetSelectedOutputRowCount, @ref GetSelectedOutputString, @ref GetSelectedOutputStringLine, 
@@ -731,6 +915,17 @@ public:
 	 */
 	VRESULT                  SetCurrentSelectedOutputUserNumber(int n);
 
+	/**
+	 *  Sets the CVODE Jacobian reuse switch on or off.  When on, each <B>KINETICS</B> block integrated with <B>-cvode</B>
+	 *  starts an integration with the Jacobian of its last one, as long as the corrector converged and fewer than 50 steps
+	 *  were taken with it; reactants whose rates were found not to depend on one another are then perturbed together when
+	 *  a new Jacobian is needed.  Results agree with the default within the integration tolerances but are not identical.
+	 *  The initial setting is false.
+	 *  @param bValue           If true, keeps Jacobians between integrations; if false, computes a new one for each integration.
+	 *  @see                    GetCvodeJacobianReuseOn
+	 */
+	void                     SetCvodeJacobianReuseOn(bool bValue);
+
 	/**
 	 *  Sets the name of the dump file.  This file name is used if not specified within <B>DUMP</B> input.
 	 *  The default value is <B><I>dump.id.out</I></B>, where id is obtained from @ref GetId.
@@ -782,6 +977,29 @@ public:
 	 */
 	void                     SetErrorStringOn(bool bValue);
 
+	/**
+	 *  Sets the ionic-strength tolerance for reusing aqueous activity coefficients.  The Davies, Debye-Huckel
+	 *  and LLNL activity coefficients of aqueous species depend only on the ionic strength and temperature; they are
+	 *  recomputed when the temperature changes or the ionic strength changes by more than this fraction of itself,
+	 *  and otherwise kept from the previous iteration.  With the initial setting of 0, they are reused only for an
+	 *  unchanged ionic strength, and results are identical to recomputing them every time.
+	 *  @param tolerance        The tolerance, relative to the ionic strength.
+	 *  @see                    GetGammaMuTolerance
+	 */
+	void                     SetGammaMuTolerance(double tolerance);
+
+	/**
+	 *  Sets the LU switch for the Newton steps of equilibrium calculations on or off.  When on, a step whose
+	 *  equations are all equalities, as many as there are unknowns, is solved by LU decomposition with partial
+	 *  pivoting instead of the Cl1 optimizer.  Steps with inequalities (pure phases, gases, solid solutions),
+	 *  and steps whose equations are singular or badly conditioned, are still solved by Cl1.  Results agree with
+	 *  the default within the convergence tolerances but are not identical.
+	 *  The initial setting is false.
+	 *  @param bValue           If true, tries LU first; if false, uses Cl1 for every step.
+	 *  @see                    GetIneqLUOn
+	 */
+	void                     SetIneqLUOn(bool bValue);
+
 	/**
 	 *  Sets the name of the log file. The default value is <B><I>phreeqc.id.log</I></B>, where id is obtained from @ref GetId.
 	 *  @param filename         The name of the file to write log output to.
@@ -831,6 +1049,69 @@ public:
 	 */
 	void                     SetOutputStringOn(bool bValue);
 
+	/**
+	 *  Sets the parallel Jacobian switch on or off.  With the Pitzer aqueous model, the Jacobian is calculated
+	 *  numerically, one column per unknown, and the Pitzer sums of each column take most of the time.  When on,
+	 *  the molalities of every column are gathered first and the Pitzer sums of the columns are evaluated on
+	 *  several threads, each with its own arrays; the columns are then assembled in order.  Results are identical
+	 *  to the default.  Applies only to calculations without surfaces, gas phases or solid solutions, with at
+	 *  least @ref SetParallelJacobianThreshold unknowns, and uses threads only in builds with OpenMP.
+	 *  The initial setting is false.
+	 *  @param bValue           If true, evaluates columns on several threads; if false, one after another.
+	 *  @see                    GetParallelJacobianOn, GetParallelJacobianThreshold, SetParallelJacobianThreshold
+	 */
+	void                     SetParallelJacobianOn(bool bValue);
+
+	/**
+	 *  Sets the fewest unknowns for which Jacobian columns are evaluated on several threads; smaller systems
+	 *  are evaluated one column after another.  The initial setting is 16.
+	 *  @param count            The number of unknowns.
+	 *  @see                    GetParallelJacobianOn, GetParallelJacobianThreshold, SetParallelJacobianOn
+	 */
+	void                     SetParallelJacobianThreshold(int count);
+
+	/**
+	 *  Sets the size at which persistent files are rotated by @ref FlushOutputFiles.  The initial setting is zero.
+	 *  @param bytes            The size in bytes; zero or less never rotates the files.
+	 *  @see                    FlushOutputFiles, GetPersistentFilesLimit, GetPersistentFilesOn, SetPersistentFilesOn
+	 */
+	void                     SetPersistentFilesLimit(int bytes);
+
+	/**
+	 *  Sets the persistent files switch on or off.  When on, the output, error, and log files
+	 *  are opened once in append mode with a large buffer and stay open between runs, instead of being
+	 *  recreated by every run.  A file is reopened when its name changes; turning a file off
+	 *  (for example with @ref SetOutputFileOn) only stops writing to it.  The initial setting is false.
+	 *  @param bValue           If true, keeps the files open; if false, flushes and closes any persistent files.
+	 *  @remarks
+	 *      Output is written to disk only when the buffer fills, on @ref FlushOutputFiles, when the switch is turned off,
+	 *      or when the instance is destroyed.
+	 *  @see                    FlushOutputFiles, GetPersistentFilesOn, SetPersistentFilesLimit
+	 */
+	void                     SetPersistentFilesOn(bool bValue);
+
+	/**
+	 *  Sets an integer placeholder of a prepared input.
+	 *  @param n                The index returned by @ref PrepareAccumulated or @ref PrepareString.
+	 *  @param name             The placeholder name, without braces.
+	 *  @param value            The value used by the following calls to @ref RunPrepared.
+	 *  @retval VR_OK           Success
+	 *  @retval VR_INVALIDARG   The prepared input or the placeholder does not exist.
+	 *  @see                    PrepareString, RunPrepared, SetPreparedValue
+	 */
+	VRESULT                  SetPreparedInteger(int n, const char* name, int value);
+
+	/**
+	 *  Sets a numeric placeholder of a prepared input.
+	 *  @param n                The index returned by @ref PrepareAccumulated or @ref PrepareString.
+	 *  @param name             The placeholder name, without braces.
+	 *  @param value            The value used by the following calls to @ref RunPrepared.
+	 *  @retval VR_OK           Success
+	 *  @retval VR_INVALIDARG   The prepared input or the placeholder does not exist.
+	 *  @see                    PrepareString, RunPrepared, SetPreparedInteger
+	 */
+	VRESULT                  SetPreparedValue(int n, const char* name, double value);
+
 	/**
 	 *  Sets the name of the current selected output file (see @ref SetCurrentSelectedOutputUserNumber).  This file name is used if not specified within <B>SELECTED_OUTPUT</B> input.
 	 *  The default value is <B><I>selected_n.id.out</I></B>, where id is obtained from @ref GetId.
@@ -883,14 +1164,26 @@ protected:
 	void check_database(const char* sz_routine);
 	int close_input_files(void);
 	int close_output_files(void);
+	std::ostream* persistent_stream(int i, const std::string& name, const char* sz_routine);
+	void release_stream(std::ostream** stream_ptr);
+	void close_persistent_files(void);
 	void open_output_files(const char* sz_routine);
 
 	void do_run(const char* sz_routine, std::istream* pis, PFN_PRERUN_CALLBACK pfn_pre, PFN_POSTRUN_CALLBACK pfn_post, void *cookie);
+	void do_simulation(const char* sz_routine);
+	void do_run_end(PFN_POSTRUN_CALLBACK pfn_post, void *cookie);
+	void do_run_prepared(const char* sz_routine, const CPreparedInput& prepared);
+	void do_prepared_blocks(const CPreparedInput& prepared, size_t n);
+	void set_mix_input(const cxxMix& mix);
+	void set_save_input(int entity, int n_user);
+	void set_copy_input(int entity, int n_user, int target);
+	void set_use_input(int entity, int n_user);
 
 	void update_errors(void);
 
 	int load_db(const char* filename);
 	int load_db_str(const char* filename);
+	int load_db_snapshot(const char* snapshot, const char* database);
 	int test_db(void);
 
 	bool get_sel_out_file_on(int n)const;
@@ -973,10 +1266,23 @@ protected:
 	std::string                LogFileName;
 	std::string                DumpFileName;
 
+	bool                       BasicBytecodeOn;
+	bool                       CvodeJacobianReuseOn;
+	bool                       IneqLUOn;
+	double                     GammaMuTolerance;
+	bool                       ParallelJacobianOn;
+	int                        ParallelJacobianThreshold;
+
+	bool                       PersistentFilesOn;
+	int                        PersistentFilesLimit;
+	CPersistentFile           *PersistentFiles[3];      // output, error, log
+
 	std::map< int, bool >                         SelectedOutputStringOn;
 	std::map< int, std::string >                  SelectedOutputStringMap;
 	std::map< int, std::vector< std::string > >   SelectedOutputLinesMap;
 
+	std::vector< CPreparedInput* >                PreparedInputs;
+
 protected:
 	Phreeqc* PhreeqcPtr;
 	FILE *input_file;
@@ -10,6 +10,7 @@ class IPhreeqcLib
 {
 public:
 	//static void CleanupIPhreeqcInstances(void);
+	static int CloneIPhreeqc(int id);
 	static int CreateIPhreeqc(void);
 	static IPQ_RESULT DestroyIPhreeqc(int n);
 	static IPhreeqc* GetInstance(int n);
@@ -68,6 +69,24 @@ ClearAccumulatedLines(int id)
 	return IPQ_BADINSTANCE;
 }
 
+IPQ_RESULT
+ClearPrepared(int id)
+{
+	IPhreeqc* IPhreeqcPtr = IPhreeqcLib::GetInstance(id);
+	if (IPhreeqcPtr)
+	{
+		IPhreeqcPtr->ClearPrepared();
+		return IPQ_OK;
+	}
+	return IPQ_BADINSTANCE;
+}
+
+int
+CloneIPhreeqc(int id)
+{
+	return IPhreeqcLib::CloneIPhreeqc(id);
+}
+
 int
 CreateIPhreeqc(void)
 {
@@ -80,6 +99,18 @@ DestroyIPhreeqc(int id)
 	return IPhreeqcLib::DestroyIPhreeqc(id);
 }
 
+IPQ_RESULT
+FlushOutputFiles(int id)
+{
+	IPhreeqc* IPhreeqcPtr = IPhreeqcLib::GetInstance(id);
+	if (IPhreeqcPtr)
+	{
+		IPhreeqcPtr->FlushOutputFiles();
+		return IPQ_OK;
+	}
+	return IPQ_BADINSTANCE;
+}
+
 // TODO Maybe GetAccumulatedLines
 
 const char*
@@ -471,6 +502,35 @@ GetOutputStringOn(int id)
 	return IPQ_BADINSTANCE;
 }
 
+int
+GetPersistentFilesLimit(int id)
+{
+	IPhreeqc* IPhreeqcPtr = IPhreeqcLib::GetInstance(id);
+	if (IPhreeqcPtr)
+	{
+		return IPhreeqcPtr->GetPersistentFilesLimit();
+	}
+	return IPQ_BADINSTANCE;
+}
+
+int
+GetPersistentFilesOn(int id)
+{
+	IPhreeqc* IPhreeqcPtr = IPhreeqcLib::GetInstance(id);
+	if (IPhreeqcPtr)
+	{
+		if (IPhreeqcPtr->GetPersistentFilesOn())
+		{
+			return 1;
+		}
+		else
+		{
+			return 0;
+		}
+	}
+	return IPQ_BADINSTANCE;
+}
+
 int
 GetSelectedOutputColumnCount(int id)
 {
@@ -482,6 +542,24 @@ GetSelectedOutputColumnCount(int id)
 	return IPQ_BADINSTANCE;
 }
 
+IPQ_RESULT
+GetSelectedOutputColumnDoubles(int id, int col, double* values, int* vtypes)
+{
+	IPhreeqc* IPhreeqcPtr = IPhreeqcLib::GetInstance(id);
+	if (IPhreeqcPtr)
+	{
+		switch (IPhreeqcPtr->GetSelectedOutputColumnDoubles(col, values, vtypes))
+		{
+		case VR_OK:          return IPQ_OK;
+		case VR_INVALIDARG:  return IPQ_INVALIDARG;
+		case VR_INVALIDCOL:  return IPQ_INVALIDCOL;
+		default:
+			assert(false);
+		}
+	}
+	return IPQ_BADINSTANCE;
+}
+
 int
 GetSelectedOutputCount(int id)
 {
@@ -534,6 +612,24 @@ GetSelectedOutputRowCount(int id)
 	return IPQ_BADINSTANCE;
 }
 
+IPQ_RESULT
+GetSelectedOutputRowDoubles(int id, int row, double* values, int* vtypes)
+{
+	IPhreeqc* IPhreeqcPtr = IPhreeqcLib::GetInstance(id);
+	if (IPhreeqcPtr)
+	{
+		switch (IPhreeqcPtr->GetSelectedOutputRowDoubles(row, values, vtypes))
+		{
+		case VR_OK:          return IPQ_OK;
+		case VR_INVALIDARG:  return IPQ_INVALIDARG;
+		case VR_INVALIDROW:  return IPQ_INVALIDROW;
+		default:
+			assert(false);
+		}
+	}
+	return IPQ_BADINSTANCE;
+}
+
 const char*
 GetSelectedOutputString(int id)
 {
@@ -681,6 +777,17 @@ LoadDatabase(int id, const char* filename)
 	return IPQ_BADINSTANCE;
 }
 
+int
+LoadDatabaseSnapshot(int id, const char* snapshot, const char* database)
+{
+	IPhreeqc* IPhreeqcPtr = IPhreeqcLib::GetInstance(id);
+	if (IPhreeqcPtr)
+	{
+		return IPhreeqcPtr->LoadDatabaseSnapshot(snapshot, database);
+	}
+	return IPQ_BADINSTANCE;
+}
+
 int
 LoadDatabaseString(int id, const char* input)
 {
@@ -737,6 +844,28 @@ OutputWarningString(int id)
 #endif
 }
 
+int
+PrepareAccumulated(int id)
+{
+	IPhreeqc* IPhreeqcPtr = IPhreeqcLib::GetInstance(id);
+	if (IPhreeqcPtr)
+	{
+		return IPhreeqcPtr->PrepareAccumulated();
+	}
+	return IPQ_BADINSTANCE;
+}
+
+int
+PrepareString(int id, const char* input)
+{
+	IPhreeqc* IPhreeqcPtr = IPhreeqcLib::GetInstance(id);
+	if (IPhreeqcPtr)
+	{
+		return IPhreeqcPtr->PrepareString(input);
+	}
+	return IPQ_BADINSTANCE;
+}
+
 int
 RunAccumulated(int id)
 {
@@ -759,6 +888,17 @@ RunFile(int id, const char* filename)
 	return IPQ_BADINSTANCE;
 }
 
+int
+RunPrepared(int id, int n)
+{
+	IPhreeqc* IPhreeqcPtr = IPhreeqcLib::GetInstance(id);
+	if (IPhreeqcPtr)
+	{
+		return IPhreeqcPtr->RunPrepared(n);
+	}
+	return IPQ_BADINSTANCE;
+}
+
 int
 RunString(int id, const char* input)
 {
@@ -968,6 +1108,62 @@ SetOutputStringOn(int id, int value)
 	return IPQ_BADINSTANCE;
 }
 
+IPQ_RESULT
+SetPersistentFilesLimit(int id, int bytes)
+{
+	IPhreeqc* IPhreeqcPtr = IPhreeqcLib::GetInstance(id);
+	if (IPhreeqcPtr)
+	{
+		IPhreeqcPtr->SetPersistentFilesLimit(bytes);
+		return IPQ_OK;
+	}
+	return IPQ_BADINSTANCE;
+}
+
+IPQ_RESULT
+SetPersistentFilesOn(int id, int value)
+{
+	IPhreeqc* IPhreeqcPtr = IPhreeqcLib::GetInstance(id);
+	if (IPhreeqcPtr)
+	{
+		IPhreeqcPtr->SetPersistentFilesOn(value != 0);
+		return IPQ_OK;
+	}
+	return IPQ_BADINSTANCE;
+}
+
+IPQ_RESULT
+SetPreparedInteger(int id, int n, const char* name, int value)
+{
+	IPhreeqc* IPhreeqcPtr = IPhreeqcLib::GetInstance(id);
+	if (IPhreeqcPtr)
+	{
+		switch (IPhreeqcPtr->SetPreparedInteger(n, name, value))
+		{
+		case VR_INVALIDARG: return IPQ_INVALIDARG;
+		case VR_OK:         return IPQ_OK;
+		default:            assert(false);
+		}
+	}
+	return IPQ_BADINSTANCE;
+}
+
+IPQ_RESULT
+SetPreparedValue(int id, int n, const char* name, double value)
+{
+	IPhreeqc* IPhreeqcPtr = IPhreeqcLib::GetInstance(id);
+	if (IPhreeqcPtr)
+	{
+		switch (IPhreeqcPtr->SetPreparedValue(n, name, value))
+		{
+		case VR_INVALIDARG: return IPQ_INVALIDARG;
+		case VR_OK:         return IPQ_OK;
+		default:            assert(false);
+		}
+	}
+	return IPQ_BADINSTANCE;
+}
+
 IPQ_RESULT
 SetSelectedOutputFileName(int id, const char* filename)
 {
@@ -1024,6 +1220,25 @@ IPhreeqcLib::CreateIPhreeqc(void)
 	return n;
 }
 
+int
+IPhreeqcLib::CloneIPhreeqc(int id)
+{
+	IPhreeqc* IPhreeqcPtr = IPhreeqcLib::GetInstance(id);
+	if (IPhreeqcPtr)
+	{
+		try
+		{
+			IPhreeqc* clone = IPhreeqcPtr->Clone();
+			return (int) clone->Index;
+		}
+		catch (const std::bad_alloc&)
+		{
+			return IPQ_OUTOFMEMORY;
+		}
+	}
+	return IPQ_BADINSTANCE;
+}
+
 IPQ_RESULT
 IPhreeqcLib::DestroyIPhreeqc(int id)
 {
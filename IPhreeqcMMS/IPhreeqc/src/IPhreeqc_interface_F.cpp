@@ -68,6 +68,18 @@ ClearAccumulatedLinesF(int *id)
 	return ::ClearAccumulatedLines(*id);
 }
 
+IPQ_RESULT
+ClearPreparedF(int *id)
+{
+	return ::ClearPrepared(*id);
+}
+
+int
+CloneIPhreeqcF(int *id)
+{
+	return ::CloneIPhreeqc(*id);
+}
+
 int
 CreateIPhreeqcF(void)
 {
@@ -80,6 +92,12 @@ DestroyIPhreeqcF(int *id)
 	return ::DestroyIPhreeqc(*id);
 }
 
+IPQ_RESULT
+FlushOutputFilesF(int *id)
+{
+	return ::FlushOutputFiles(*id);
+}
+
 int
 GetComponentCountF(int *id)
 {
@@ -232,12 +250,40 @@ GetOutputFileOnF(int *id)
 	return ::GetOutputFileOn(*id);
 }
 
+int
+GetPersistentFilesLimitF(int *id)
+{
+	return ::GetPersistentFilesLimit(*id);
+}
+
+int
+GetPersistentFilesOnF(int *id)
+{
+	return ::GetPersistentFilesOn(*id);
+}
+
 int
 GetSelectedOutputColumnCountF(int *id)
 {
 	return ::GetSelectedOutputColumnCount(*id);
 }
 
+IPQ_RESULT
+GetSelectedOutputColumnDoublesF(int *id, int *col, double* values, int* vtypes)
+{
+	int adjcol = *col - 1;
+	IPQ_RESULT result = ::GetSelectedOutputColumnDoubles(*id, adjcol, values, vtypes);
+	if (result == IPQ_OK)
+	{
+		int rows = ::GetSelectedOutputRowCount(*id) - 1;
+		for (int i = 0; i < rows; ++i)
+		{
+			if (vtypes[i] == TT_LONG) vtypes[i] = TT_DOUBLE;
+		}
+	}
+	return result;
+}
+
 int
 GetSelectedOutputCountF(int *id)
 {
@@ -289,6 +335,21 @@ GetSelectedOutputRowCountF(int *id)
 	return rows;
 }
 
+IPQ_RESULT
+GetSelectedOutputRowDoublesF(int *id, int *row, double* values, int* vtypes)
+{
+	IPQ_RESULT result = ::GetSelectedOutputRowDoubles(*id, *row, values, vtypes);
+	if (result == IPQ_OK)
+	{
+		int cols = ::GetSelectedOutputColumnCount(*id);
+		for (int i = 0; i < cols; ++i)
+		{
+			if (vtypes[i] == TT_LONG) vtypes[i] = TT_DOUBLE;
+		}
+	}
+	return result;
+}
+
 IPQ_RESULT
 GetSelectedOutputValueF(int *id, int *row, int *col, int *vtype, double* dvalue, char* svalue, int* svalue_length)
 {
@@ -360,6 +421,13 @@ LoadDatabaseF(int *id, char* filename)
 	return n;
 }
 
+int
+LoadDatabaseSnapshotF(int *id, char* snapshot, char* database)
+{
+	int n = ::LoadDatabaseSnapshot(*id, snapshot, database);
+	return n;
+}
+
 int
 LoadDatabaseStringF(int *id, char* input)
 {
@@ -385,6 +453,19 @@ OutputWarningStringF(int *id)
 	::OutputWarningString(*id);
 }
 
+int
+PrepareAccumulatedF(int *id)
+{
+	return ::PrepareAccumulated(*id);
+}
+
+int
+PrepareStringF(int *id, char* input)
+{
+	int n = ::PrepareString(*id, input);
+	return n;
+}
+
 int
 RunAccumulatedF(int *id)
 {
@@ -398,6 +479,12 @@ RunFileF(int *id, char* filename)
 	return n;
 }
 
+int
+RunPreparedF(int *id, int *n)
+{
+	return ::RunPrepared(*id, *n);
+}
+
 int
 RunStringF(int *id, char* input)
 {
@@ -500,6 +587,30 @@ SetOutputStringOnF(int *id, int* output_string_on)
 	return ::SetOutputStringOn(*id, *output_string_on);
 }
 
+IPQ_RESULT
+SetPersistentFilesLimitF(int *id, int* bytes)
+{
+	return ::SetPersistentFilesLimit(*id, *bytes);
+}
+
+IPQ_RESULT
+SetPersistentFilesOnF(int *id, int* persistent_on)
+{
+	return ::SetPersistentFilesOn(*id, *persistent_on);
+}
+
+IPQ_RESULT
+SetPreparedIntegerF(int *id, int *n, char* name, int *value)
+{
+	return ::SetPreparedInteger(*id, *n, name, *value);
+}
+
+IPQ_RESULT
+SetPreparedValueF(int *id, int *n, char* name, double *value)
+{
+	return ::SetPreparedValue(*id, *n, name, *value);
+}
+
 IPQ_RESULT
 SetSelectedOutputFileNameF(int *id, char* fname)
 {
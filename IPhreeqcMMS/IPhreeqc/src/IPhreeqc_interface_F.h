@@ -13,8 +13,11 @@
 #define AddErrorF                           FC_FUNC (adderrorf,                           ADDERRORF)
 #define AddWarningF                         FC_FUNC (addwarningf,                         ADDWARNINGF)
 #define ClearAccumulatedLinesF              FC_FUNC (clearaccumulatedlinesf,              CLEARACCUMULATEDLINESF)
+#define ClearPreparedF                      FC_FUNC (clearpreparedf,                      CLEARPREPAREDF)
+#define CloneIPhreeqcF                      FC_FUNC (cloneiphreeqcf,                      CLONEIPHREEQCF)
 #define CreateIPhreeqcF                     FC_FUNC (createiphreeqcf,                     CREATEIPHREEQCF)
 #define DestroyIPhreeqcF                    FC_FUNC (destroyiphreeqcf,                    DESTROYIPHREEQCF)
+#define FlushOutputFilesF                   FC_FUNC (flushoutputfilesf,                   FLUSHOUTPUTFILESF)
 #define GetComponentF                       FC_FUNC (getcomponentf,                       GETCOMPONENTF)
 #define GetComponentCountF                  FC_FUNC (getcomponentcountf,                  GETCOMPONENTCOUNTF)
 #define GetCurrentSelectedOutputUserNumberF FC_FUNC (getcurrentselectedoutputusernumberf, GETCURRENTSELECTEDOUTPUTUSERNUMBERF)
@@ -39,11 +42,15 @@
 #define GetOutputStringLineF                FC_FUNC (getoutputstringlinef,                GETOUTPUTSTRINGLINEF)
 #define GetOutputStringLineCountF           FC_FUNC (getoutputstringlinecountf,           GETOUTPUTSTRINGLINECOUNTF)
 #define GetOutputStringOnF                  FC_FUNC (getoutputstringonf,                  GETOUTPUTSTRINGONF)
+#define GetPersistentFilesLimitF            FC_FUNC (getpersistentfileslimitf,            GETPERSISTENTFILESLIMITF)
+#define GetPersistentFilesOnF               FC_FUNC (getpersistentfilesonf,               GETPERSISTENTFILESONF)
 #define GetSelectedOutputColumnCountF       FC_FUNC (getselectedoutputcolumncountf,       GETSELECTEDOUTPUTCOLUMNCOUNTF)
+#define GetSelectedOutputColumnDoublesF     FC_FUNC (getselectedoutputcolumndoublesf,     GETSELECTEDOUTPUTCOLUMNDOUBLESF)
 #define GetSelectedOutputCountF             FC_FUNC (getselectedoutputcountf,             GETSELECTEDOUTPUTCOUNTF)
 #define GetSelectedOutputFileNameF          FC_FUNC (getselectedoutputfilenamef,          GETSELECTEDOUTPUTFILENAMEF)
 #define GetSelectedOutputFileOnF            FC_FUNC (getselectedoutputfileonf,            GETSELECTEDOUTPUTFILEONF)
 #define GetSelectedOutputRowCountF          FC_FUNC (getselectedoutputrowcountf,          GETSELECTEDOUTPUTROWCOUNTF)
+#define GetSelectedOutputRowDoublesF        FC_FUNC (getselectedoutputrowdoublesf,        GETSELECTEDOUTPUTROWDOUBLESF)
 #define GetSelectedOutputStringLineF        FC_FUNC (getselectedoutputstringlinef,        GETSELECTEDOUTPUTSTRINGLINEF)
 #define GetSelectedOutputStringLineCountF   FC_FUNC (getselectedoutputstringlinecountf,   GETSELECTEDOUTPUTSTRINGLINECOUNTF)
 #define GetSelectedOutputStringOnF          FC_FUNC (getselectedoutputstringonf,          GETSELECTEDOUTPUTSTRINGONF)
@@ -52,12 +59,16 @@
 #define GetWarningStringLineF               FC_FUNC (getwarningstringlinef,               GETWARNINGSTRINGLINEF)
 #define GetWarningStringLineCountF          FC_FUNC (getwarningstringlinecountf,          GETWARNINGSTRINGLINECOUNTF)
 #define LoadDatabaseF                       FC_FUNC (loaddatabasef,                       LOADDATABASEF)
+#define LoadDatabaseSnapshotF               FC_FUNC (loaddatabasesnapshotf,               LOADDATABASESNAPSHOTF)
 #define LoadDatabaseStringF                 FC_FUNC (loaddatabasestringf,                 LOADDATABASESTRINGF)
 #define OutputAccumulatedLinesF             FC_FUNC (outputaccumulatedlinesf,             OUTPUTACCUMULATEDLINESF)
 #define OutputErrorStringF                  FC_FUNC (outputerrorstringf,                  OUTPUTERRORSTRINGF)
 #define OutputWarningStringF                FC_FUNC (outputwarningstringf,                OUTPUTWARNINGSTRINGF)
+#define PrepareAccumulatedF                 FC_FUNC (prepareaccumulatedf,                 PREPAREACCUMULATEDF)
+#define PrepareStringF                      FC_FUNC (preparestringf,                      PREPARESTRINGF)
 #define RunAccumulatedF                     FC_FUNC (runaccumulatedf,                     RUNACCUMULATEDF)
 #define RunFileF                            FC_FUNC (runfilef,                            RUNFILEF)
+#define RunPreparedF                        FC_FUNC (runpreparedf,                        RUNPREPAREDF)
 #define RunStringF                          FC_FUNC (runstringf,                          RUNSTRINGF)
 #define SetBasicFortranCallbackF            FC_FUNC (setbasicfortrancallbackf,            SETFOTRANBASICCALLBACKF)
 #define SetCurrentSelectedOutputUserNumberF FC_FUNC (setcurrentselectedoutputusernumberf, SETCURRENTSELECTEDOUTPUTUSERNUMBERF)
@@ -73,6 +84,10 @@
 #define SetOutputFileNameF                  FC_FUNC (setoutputfilenamef,                  SETOUTPUTFILENAMEF)
 #define SetOutputFileOnF                    FC_FUNC (setoutputfileonf,                    SETOUTPUTFILEONF)
 #define SetOutputStringOnF                  FC_FUNC (setoutputstringonf,                  SETOUTPUTSTRINGONF)
+#define SetPersistentFilesLimitF            FC_FUNC (setpersistentfileslimitf,            SETPERSISTENTFILESLIMITF)
+#define SetPersistentFilesOnF               FC_FUNC (setpersistentfilesonf,               SETPERSISTENTFILESONF)
+#define SetPreparedIntegerF                 FC_FUNC (setpreparedintegerf,                 SETPREPAREDINTEGERF)
+#define SetPreparedValueF                   FC_FUNC (setpreparedvaluef,                   SETPREPAREDVALUEF)
 #define SetSelectedOutputFileNameF          FC_FUNC (setselectedoutputfilenamef,          SETSELECTEDOUTPUTFILENAMEF)
 #define SetSelectedOutputFileOnF            FC_FUNC (setselectedoutputfileonf,            SETSELECTEDOUTPUTFILEONF)
 #define SetSelectedOutputStringOnF          FC_FUNC (setselectedoutputstringonf,          SETSELECTEDOUTPUTSTRINGONF)
@@ -87,8 +102,11 @@ extern "C" {
   IPQ_DLL_EXPORT int        AddErrorF(int *id, char *error_msg);
   IPQ_DLL_EXPORT int        AddWarningF(int *id, char *warn_msg);
   IPQ_DLL_EXPORT IPQ_RESULT ClearAccumulatedLinesF(int *id);
+  IPQ_DLL_EXPORT IPQ_RESULT ClearPreparedF(int *id);
+  IPQ_DLL_EXPORT int        CloneIPhreeqcF(int *id);
   IPQ_DLL_EXPORT int        CreateIPhreeqcF(void);
   IPQ_DLL_EXPORT int        DestroyIPhreeqcF(int *id);
+  IPQ_DLL_EXPORT IPQ_RESULT FlushOutputFilesF(int *id);
   IPQ_DLL_EXPORT void       GetComponentF(int *id, int* n, char* line, int* line_length);
   IPQ_DLL_EXPORT int        GetComponentCountF(int *id);
   IPQ_DLL_EXPORT int        GetCurrentSelectedOutputUserNumberF(int *id);
@@ -113,11 +131,15 @@ extern "C" {
   IPQ_DLL_EXPORT void       GetOutputStringLineF(int *id, int* n, char* line, int* line_length);
   IPQ_DLL_EXPORT int        GetOutputStringLineCountF(int *id);
   IPQ_DLL_EXPORT int        GetOutputStringOnF(int *id);
+  IPQ_DLL_EXPORT int        GetPersistentFilesLimitF(int *id);
+  IPQ_DLL_EXPORT int        GetPersistentFilesOnF(int *id);
   IPQ_DLL_EXPORT int        GetSelectedOutputColumnCountF(int *id);
+  IPQ_DLL_EXPORT IPQ_RESULT GetSelectedOutputColumnDoublesF(int *id, int *col, double* values, int* vtypes);
   IPQ_DLL_EXPORT int        GetSelectedOutputCountF(int *id);
   IPQ_DLL_EXPORT void       GetSelectedOutputFileNameF(int *id, char* filename, int* filename_length);
   IPQ_DLL_EXPORT int        GetSelectedOutputFileOnF(int *id);
   IPQ_DLL_EXPORT int        GetSelectedOutputRowCountF(int *id);
+  IPQ_DLL_EXPORT IPQ_RESULT GetSelectedOutputRowDoublesF(int *id, int *row, double* values, int* vtypes);
   IPQ_DLL_EXPORT void       GetSelectedOutputStringLineF(int *id, int* n, char* line, int* line_length);
   IPQ_DLL_EXPORT int        GetSelectedOutputStringLineCountF(int *id);
   IPQ_DLL_EXPORT int        GetSelectedOutputStringOnF(int *id);
@@ -126,12 +148,16 @@ extern "C" {
   IPQ_DLL_EXPORT void       GetWarningStringLineF(int *id, int* n, char* line, int* line_length);
   IPQ_DLL_EXPORT int        GetWarningStringLineCountF(int *id);
   IPQ_DLL_EXPORT int        LoadDatabaseF(int *id, char* filename);
+  IPQ_DLL_EXPORT int        LoadDatabaseSnapshotF(int *id, char* snapshot, char* database);
   IPQ_DLL_EXPORT int        LoadDatabaseStringF(int *id, char* input);
   IPQ_DLL_EXPORT void       OutputAccumulatedLinesF(int *id);
   IPQ_DLL_EXPORT void       OutputErrorStringF(int *id);
   IPQ_DLL_EXPORT void       OutputWarningStringF(int *id);
+  IPQ_DLL_EXPORT int        PrepareAccumulatedF(int *id);
+  IPQ_DLL_EXPORT int        PrepareStringF(int *id, char* input);
   IPQ_DLL_EXPORT int        RunAccumulatedF(int *id);
   IPQ_DLL_EXPORT int        RunFileF(int *id, char* filename);
+  IPQ_DLL_EXPORT int        RunPreparedF(int *id, int *n);
   IPQ_DLL_EXPORT int        RunStringF(int *id, char* input);
 #ifdef IPHREEQC_NO_FORTRAN_MODULE
   IPQ_DLL_EXPORT IPQ_RESULT SetBasicFortranCallbackF(int *id, double (*fcn)(double *x1, double *x2, char *str, size_t l));
@@ -151,6 +177,10 @@ extern "C" {
   IPQ_DLL_EXPORT IPQ_RESULT SetOutputFileNameF(int *id, char* fname);
   IPQ_DLL_EXPORT IPQ_RESULT SetOutputFileOnF(int *id, int* output_on);
   IPQ_DLL_EXPORT IPQ_RESULT SetOutputStringOnF(int *id, int* output_string_on);
+  IPQ_DLL_EXPORT IPQ_RESULT SetPersistentFilesLimitF(int *id, int* bytes);
+  IPQ_DLL_EXPORT IPQ_RESULT SetPersistentFilesOnF(int *id, int* persistent_on);
+  IPQ_DLL_EXPORT IPQ_RESULT SetPreparedIntegerF(int *id, int *n, char* name, int *value);
+  IPQ_DLL_EXPORT IPQ_RESULT SetPreparedValueF(int *id, int *n, char* name, double *value);
   IPQ_DLL_EXPORT IPQ_RESULT SetSelectedOutputFileNameF(int *id, char* fname);
   IPQ_DLL_EXPORT IPQ_RESULT SetSelectedOutputFileOnF(int *id, int* selected_output_file_on);
   IPQ_DLL_EXPORT IPQ_RESULT SetSelectedOutputStringOnF(int *id, int* selected_output_string_on);
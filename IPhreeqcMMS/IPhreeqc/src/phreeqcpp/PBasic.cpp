@@ -1722,6 +1722,7 @@ parseinput(tokenrec ** l_buf)
 	parse(inbuf, l_buf);
 	if (curline == 0)
 		return;
+	discard_program();
 	l = linebase;
 	l0 = NULL;
 	while (l != NULL && l->num < curline)
@@ -4498,6 +4499,7 @@ cmdnew(struct LOC_exec *LINK)
 	cmdend(LINK);
 	clearloops();
 	restoredata();
+	discard_program();
 	while (linebase != NULL)
 	{
 		p = linebase->next;
@@ -4674,6 +4676,16 @@ cmdrun(struct LOC_exec *LINK)
 	clearloops();
 	restoredata();
 	PhreeqcPtr->free_check_null(l_s);
+	if (l != NULL && l == linebase && PhreeqcPtr->basic_bytecode_on && !parse_all && !phreeqci_gui)
+	{
+		PBasicProgram *program = find_program();
+		if (program != NULL)
+		{
+			run_program(program);
+			stmtline = NULL;
+			LINK->t = NULL;
+		}
+	}
 	return;
 }
 
@@ -4817,6 +4829,7 @@ cmddel(struct LOC_exec *LINK)
 	linerec *l, *l0, *l1;
 	long n1, n2;
 
+	discard_program();
 	do
 	{
 		if (iseos(LINK))
@@ -4889,6 +4902,7 @@ cmdrenum(struct LOC_exec *LINK)
 			step = intexpr(LINK);
 		}
 	}
+	discard_program();
 	l = linebase;
 	if (l == NULL)
 		return;
@@ -5004,47 +5018,66 @@ cmdpunch(struct LOC_exec *LINK)
 			continue;
 		}
 		n = expr(LINK);
-		bool temp_high_precision = (PhreeqcPtr->current_selected_output != NULL) ? 
-			PhreeqcPtr->current_selected_output->Get_high_precision() : 
-			PhreeqcPtr->high_precision;
 		if (n.stringval)
 		{
 /*      fputs(n.UU.sval, stdout); */
-
-			if (!temp_high_precision)
-			{
-				if (strlen(n.UU.sval) <= 12)
-				{
-					PhreeqcPtr->fpunchf_user(PhreeqcPtr->n_user_punch_index, "%12.12s\t", n.UU.sval);
-				}
-				else
-				{
-					PhreeqcPtr->fpunchf_user(PhreeqcPtr->n_user_punch_index, "%s\t", n.UU.sval);
-				}
-			}
-			else
-			{
-				if (strlen(n.UU.sval) <= 20)
-				{
-					PhreeqcPtr->fpunchf_user(PhreeqcPtr->n_user_punch_index, "%20.20s\t", n.UU.sval);
-				}
-				else
-				{
-					PhreeqcPtr->fpunchf_user(PhreeqcPtr->n_user_punch_index, "%s\t", n.UU.sval);
-				}
-			}
+			punch_string(n.UU.sval);
 			PhreeqcPtr->PHRQ_free(n.UU.sval);
 		}
-		else if (!temp_high_precision)
+		else
+		{
+			punch_value(n.UU.val);
+		}
+	}
+}
+
+/* writes one column of USER_PUNCH output */
+void PBasic::
+punch_value(LDBLE value)
+{
+	bool temp_high_precision = (PhreeqcPtr->current_selected_output != NULL) ? 
+		PhreeqcPtr->current_selected_output->Get_high_precision() : 
+		PhreeqcPtr->high_precision;
+	if (!temp_high_precision)
+	{
+		PhreeqcPtr->fpunchf_user(PhreeqcPtr->n_user_punch_index, "%12.4e\t", (double) value);
+	}
+	else
+	{
+		PhreeqcPtr->fpunchf_user(PhreeqcPtr->n_user_punch_index, "%20.12e\t", (double) value);
+	}
+	++PhreeqcPtr->n_user_punch_index;
+}
+
+void PBasic::
+punch_string(char * s)
+{
+	bool temp_high_precision = (PhreeqcPtr->current_selected_output != NULL) ? 
+		PhreeqcPtr->current_selected_output->Get_high_precision() : 
+		PhreeqcPtr->high_precision;
+	if (!temp_high_precision)
+	{
+		if (strlen(s) <= 12)
+		{
+			PhreeqcPtr->fpunchf_user(PhreeqcPtr->n_user_punch_index, "%12.12s\t", s);
+		}
+		else
+		{
+			PhreeqcPtr->fpunchf_user(PhreeqcPtr->n_user_punch_index, "%s\t", s);
+		}
+	}
+	else
+	{
+		if (strlen(s) <= 20)
 		{
-			PhreeqcPtr->fpunchf_user(PhreeqcPtr->n_user_punch_index, "%12.4e\t", (double) n.UU.val);
+			PhreeqcPtr->fpunchf_user(PhreeqcPtr->n_user_punch_index, "%20.20s\t", s);
 		}
 		else
 		{
-			PhreeqcPtr->fpunchf_user(PhreeqcPtr->n_user_punch_index, "%20.12e\t", (double) n.UU.val);
+			PhreeqcPtr->fpunchf_user(PhreeqcPtr->n_user_punch_index, "%s\t", s);
 		}
-		++PhreeqcPtr->n_user_punch_index;
 	}
+	++PhreeqcPtr->n_user_punch_index;
 }
 
 #if defined PHREEQ98 
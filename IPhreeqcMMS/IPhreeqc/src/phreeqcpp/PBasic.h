@@ -4,6 +4,7 @@
 #include <windows.h>
 #endif
 #include <map>
+#include <vector>
 #include <stdio.h>
 #include <limits.h>
 #include <ctype.h>
@@ -130,6 +131,87 @@ struct LOC_exec
 	tokenrec *t;
 };
 
+/*  bytecode of a compiled program, see PBasicVM.cpp */
+struct PBasicInstr
+{
+	int op;
+	int a, b;                       /* jump targets */
+	linerec *line_a, *line_b;       /* lines of the jump targets */
+	LDBLE num;
+	varrec *vp;
+	tokenrec *tok, *tok_end;        /* tokens handed back to the interpreter */
+};
+
+/*  species, phase or master species named by a string constant */
+struct PBasicBinding
+{
+	const char *name;
+	void *ptr;                      /* NULL if looked up by name on every call */
+	LDBLE value;                    /* GFW */
+	long model;                     /* Phreeqc::tidy_rebuilds when bound, -1 if unbound */
+};
+
+class PBasicProgram
+{
+public:
+	enum VM_OP
+	{
+		vm_line,
+		vm_num,
+		vm_var,
+		vm_factor,
+		vm_bound,
+		vm_expr,
+		vm_neg,
+		vm_not,
+		vm_sqr,
+		vm_sqrt,
+		vm_ceil,
+		vm_floor,
+		vm_log10,
+		vm_sin,
+		vm_cos,
+		vm_tan,
+		vm_arctan,
+		vm_log,
+		vm_exp,
+		vm_abs,
+		vm_sgn,
+		vm_pow,
+		vm_times,
+		vm_div,
+		vm_mod,
+		vm_plus,
+		vm_minus,
+		vm_eq,
+		vm_lt,
+		vm_gt,
+		vm_le,
+		vm_ge,
+		vm_ne,
+		vm_and,
+		vm_or,
+		vm_xor,
+		vm_check,
+		vm_store,
+		vm_jump,
+		vm_jz,
+		vm_gosub,
+		vm_return,
+		vm_for,
+		vm_next,
+		vm_save,
+		vm_punch,
+		vm_punch_str,
+		vm_stmt,
+		vm_stop,
+		vm_end
+	};
+	std::vector<PBasicInstr> code;
+	std::vector<PBasicBinding> bindings;
+	int depth;                      /* deepest value stack of any expression */
+};
+
 class PBasic: public PHRQ_base
 {
 public:
@@ -470,6 +552,13 @@ public:
 	int basic_compile(char *commands, void **lnbase, void **vbase, void **lpbase);
 	int basic_run(char *commands, void *lnbase, void *vbase, void *lpbase);
 	int basic_init(void);
+	PBasicProgram * find_program(void);
+	PBasicProgram * compile_program(void);
+	void run_program(PBasicProgram * program);
+	LDBLE bound_value(int kind, PBasicBinding * binding);
+	void discard_program(void);
+	void punch_value(LDBLE value);
+	void punch_string(char * s);
 #ifdef PHREEQ98
 	void GridChar(char *s, char *a);
 #endif
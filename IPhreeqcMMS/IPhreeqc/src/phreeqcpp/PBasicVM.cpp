@@ -0,0 +1,1589 @@
+#include <stdlib.h>
+#include "PBasic.h"
+#include "Phreeqc.h"
+
+/*
+ *   Bytecode for BASIC programs (RATES, USER_PUNCH, CALCULATE_VALUES, ...).
+ *
+ *   A program is compiled the first time it is RUN and the bytecode is kept
+ *   in Phreeqc::basic_programs until the program is freed with NEW.
+ *   Numeric expressions become stack code with constants folded; scalar
+ *   variables are read and written through their varrec.  Functions of the
+ *   model (MOL, SI, KIN, ...), array elements and string expressions are
+ *   handed back to factor or realexpr on their own tokens, and statements
+ *   without a compiled form (PRINT, PUT, DIM, ...) to the command routines
+ *   of the interpreter, so results and error messages are the same as when
+ *   the program is interpreted.  Functions such as MOL("Ca+2") or SI("Calcite")
+ *   with a string constant look up the species, phase or master species once
+ *   and again only after the model is rebuilt.  Programs that use RUN, NEW, ON, WHILE or
+ *   other commands that depend on the position of the interpreter are not
+ *   compiled and are interpreted as before.
+ */
+
+#define VM_MAX_DEPTH 64
+
+typedef PBasicProgram VM;
+
+/* ---------------------------------------------------------------------- */
+static bool
+vm_iseos(const tokenrec * t)
+/* ---------------------------------------------------------------------- */
+{
+	return (t == NULL || t->kind == PBasic::tokelse || t->kind == PBasic::tokcolon);
+}
+
+/* ---------------------------------------------------------------------- */
+static tokenrec *
+vm_skiptoeos(tokenrec * t)
+/* ---------------------------------------------------------------------- */
+{
+	while (!vm_iseos(t))
+		t = t->next;
+	return t;
+}
+
+/* ---------------------------------------------------------------------- */
+static tokenrec *
+vm_find(tokenrec * t, int kind)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   returns the first token of kind in the rest of the statement, or NULL
+ */
+	while (!vm_iseos(t) && t->kind != kind)
+		t = t->next;
+	return (t != NULL && t->kind == kind) ? t : NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+static bool
+vm_skipparen(tokenrec ** t)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   moves *t from an opening parenthesis past the matching close
+ */
+	int depth = 0;
+	do
+	{
+		if (vm_iseos(*t))
+			return false;
+		if ((*t)->kind == PBasic::toklp)
+			depth++;
+		else if ((*t)->kind == PBasic::tokrp)
+			depth--;
+		*t = (*t)->next;
+	}
+	while (depth > 0);
+	return true;
+}
+
+/* ---------------------------------------------------------------------- */
+static int
+vm_function_args(int kind)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   numeric functions that are evaluated by PBasic::factor
+ *   returns 0 if the function takes no argument, 1 if its arguments
+ *   are in parentheses, -1 if it is not a numeric function
+ */
+	switch (kind)
+	{
+	case PBasic::toktc:
+	case PBasic::toktk:
+	case PBasic::toktime:
+	case PBasic::toksim_time:
+	case PBasic::toktotal_time:
+	case PBasic::tokm0:
+	case PBasic::tokm:
+	case PBasic::tokkin_time:
+	case PBasic::tokmu:
+	case PBasic::tokosmotic:
+	case PBasic::tokalk:
+	case PBasic::tokrxn:
+	case PBasic::tokdist:
+	case PBasic::tokstep_no:
+	case PBasic::tokcell_no:
+	case PBasic::toksim_no:
+	case PBasic::tokcharge_balance:
+	case PBasic::tokpercent_error:
+	case PBasic::tokcell_pore_volume:
+	case PBasic::tokporevolume:
+	case PBasic::tokrho:
+	case PBasic::tokrho_0:
+	case PBasic::tokcell_volume:
+	case PBasic::tokcell_porosity:
+	case PBasic::tokcell_saturation:
+	case PBasic::tokvelocity_x:
+	case PBasic::tokvelocity_y:
+	case PBasic::tokvelocity_z:
+	case PBasic::toktransport_cell_no:
+	case PBasic::toksc:
+	case PBasic::tokpressure:
+	case PBasic::tokgas_p:
+	case PBasic::tokgas_vm:
+	case PBasic::tokeps_r:
+	case PBasic::tokaphi:
+	case PBasic::tokdh_a:
+	case PBasic::tokdh_b:
+	case PBasic::tokdh_av:
+	case PBasic::tokqbrn:
+	case PBasic::tokkappa:
+	case PBasic::toksoln_vol:
+	case PBasic::tokviscos:
+	case PBasic::tokviscos_0:
+	case PBasic::tokcurrent_a:
+	case PBasic::tokpot_v:
+	case PBasic::tokiterations:
+		return 0;
+
+	case PBasic::tokparm:
+	case PBasic::tokact:
+	case PBasic::tokgamma:
+	case PBasic::toklg:
+	case PBasic::tokget_por:
+	case PBasic::tokedl:
+	case PBasic::toksurf:
+	case PBasic::tokequi:
+	case PBasic::tokequi_delta:
+	case PBasic::tokkin:
+	case PBasic::tokkin_delta:
+	case PBasic::tokgas:
+	case PBasic::toks_s:
+	case PBasic::tokmisc1:
+	case PBasic::tokmisc2:
+	case PBasic::toklk_species:
+	case PBasic::toklk_named:
+	case PBasic::toklk_phase:
+	case PBasic::toksum_species:
+	case PBasic::toksum_gas:
+	case PBasic::toksum_s_s:
+	case PBasic::tokcalc_value:
+	case PBasic::tokinstr:
+	case PBasic::tokiso:
+	case PBasic::toksys:
+	case PBasic::tokedl_species:
+	case PBasic::toklist_s_s:
+	case PBasic::tokkinetics_formula:
+	case PBasic::tokphase_formula:
+	case PBasic::tokspecies_formula:
+	case PBasic::tokmol:
+	case PBasic::tokla:
+	case PBasic::toklm:
+	case PBasic::toksr:
+	case PBasic::tokget:
+	case PBasic::tokexists:
+	case PBasic::toksi:
+	case PBasic::toktot:
+	case PBasic::toktotmole:
+	case PBasic::toktotmol:
+	case PBasic::toktotmoles:
+	case PBasic::tokpr_p:
+	case PBasic::tokpr_phi:
+	case PBasic::tokgfw:
+	case PBasic::tokvm:
+	case PBasic::tokphase_vm:
+	case PBasic::tokt_sc:
+	case PBasic::tokeq_frac:
+	case PBasic::tokequiv_frac:
+	case PBasic::tokcallback:
+	case PBasic::toksa_declercq:
+	case PBasic::tokdiff_c:
+	case PBasic::toksetdiff_c:
+	case PBasic::tokval:
+	case PBasic::tokasc:
+	case PBasic::toklen:
+		return 1;
+
+	default:
+		return -1;
+	}
+}
+
+/* ---------------------------------------------------------------------- */
+static bool
+vm_bindable(int kind)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   functions of one name that PBasic::bound_value evaluates
+ */
+	switch (kind)
+	{
+	case PBasic::tokact:
+	case PBasic::tokgamma:
+	case PBasic::toklg:
+	case PBasic::tokmol:
+	case PBasic::tokla:
+	case PBasic::toklm:
+	case PBasic::toksr:
+	case PBasic::toksi:
+	case PBasic::toktot:
+	case PBasic::toktotmole:
+	case PBasic::toktotmol:
+	case PBasic::toktotmoles:
+	case PBasic::tokgfw:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* ---------------------------------------------------------------------- */
+static bool
+vm_fold(int op, LDBLE a, LDBLE b, LDBLE * r)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   evaluates a binary operator on constants, false if it must be left
+ *   to run time (zero divide warning, negative base)
+ */
+	switch (op)
+	{
+	case VM::vm_pow:
+		if (a < 0)
+			return false;
+		*r = (a > 0) ? exp(b * log(a)) : a;
+		return true;
+	case VM::vm_times:
+		*r = a * b;
+		return true;
+	case VM::vm_div:
+		if (b == 0)
+			return false;
+		*r = a / b;
+		return true;
+	case VM::vm_mod:
+		*r = (a != 0) ? fabs(a) / a * fmod(fabs(a) + 1e-14, b) : 0;
+		return true;
+	case VM::vm_plus:
+		*r = a + b;
+		return true;
+	case VM::vm_minus:
+		*r = a - b;
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* ---------------------------------------------------------------------- */
+static LDBLE
+vm_unary(int op, LDBLE x)
+/* ---------------------------------------------------------------------- */
+{
+	switch (op)
+	{
+	case VM::vm_neg:
+		return -x;
+	case VM::vm_not:
+		return (LDBLE) ~((long) floor(x + 0.5));
+	case VM::vm_sqr:
+		return x * x;
+	case VM::vm_sqrt:
+		return sqrt(x);
+	case VM::vm_ceil:
+		return ceil(x);
+	case VM::vm_floor:
+		return floor(x);
+	case VM::vm_log10:
+		return log10(x);
+	case VM::vm_sin:
+		return sin(x);
+	case VM::vm_cos:
+		return cos(x);
+	case VM::vm_tan:
+		return sin(x) / cos(x);
+	case VM::vm_arctan:
+		return atan(x);
+	case VM::vm_log:
+		return log(x);
+	case VM::vm_exp:
+		return exp(x);
+	case VM::vm_abs:
+		return fabs(x);
+	case VM::vm_sgn:
+		return (LDBLE) ((x > 0) - (x < 0));
+	default:
+		return x;
+	}
+}
+
+class PBasicCompiler
+{
+public:
+	PBasicCompiler(VM * program_ptr, linerec * base)
+	{
+		program = program_ptr;
+		linebase = base;
+		depth = 0;
+		program->depth = 0;
+	}
+	bool compile(void);
+
+protected:
+	struct jump
+	{
+		size_t pc;              /* instruction to patch */
+		bool second;            /* patch b and line_b */
+		linerec *line;          /* line of the target */
+		tokenrec *tok;          /* statement, NULL for the start of line */
+	};
+	VM *program;
+	linerec *linebase;
+	int depth;
+	std::map<const linerec *, int> line_pc;
+	std::map<const tokenrec *, int> stmt_pc;
+	std::vector<jump> jumps;
+
+	size_t emit(int op);
+	void stack(int n);
+	bool unary(int op);
+	bool binary(int op);
+	bool factor(tokenrec ** t);
+	bool upexpr(tokenrec ** t);
+	bool term(tokenrec ** t);
+	bool sexpr(tokenrec ** t);
+	bool relexpr(tokenrec ** t);
+	bool andexpr(tokenrec ** t);
+	bool expr(tokenrec ** t);
+	void numexpr(tokenrec * start, tokenrec * end, int follow);
+	bool numvar(tokenrec * t);
+	void target(size_t pc, bool second, linerec * l, tokenrec * tok);
+	bool line_target(size_t pc, bool second, tokenrec * num);
+	bool statement(linerec * l, tokenrec ** t);
+};
+
+size_t PBasicCompiler::
+emit(int op)
+{
+	PBasicInstr instr;
+	memset(&instr, 0, sizeof(instr));
+	instr.op = op;
+	program->code.push_back(instr);
+	return program->code.size() - 1;
+}
+
+void PBasicCompiler::
+stack(int n)
+{
+	depth += n;
+	if (depth > program->depth)
+		program->depth = depth;
+}
+
+bool PBasicCompiler::
+unary(int op)
+{
+	PBasicInstr & last = program->code.back();
+	if (last.op == VM::vm_num)
+	{
+		last.num = vm_unary(op, last.num);
+		return true;
+	}
+	emit(op);
+	return true;
+}
+
+bool PBasicCompiler::
+binary(int op)
+{
+	std::vector<PBasicInstr> & code = program->code;
+	size_t n = code.size();
+	LDBLE r;
+	/* an operand that is a single constant is the last instruction of its code */
+	if (code[n - 1].op == VM::vm_num && code[n - 2].op == VM::vm_num &&
+		vm_fold(op, code[n - 2].num, code[n - 1].num, &r))
+	{
+		code.pop_back();
+		code.back().num = r;
+	}
+	else
+	{
+		emit(op);
+	}
+	stack(-1);
+	return true;
+}
+
+bool PBasicCompiler::
+factor(tokenrec ** t)
+{
+	tokenrec *facttok = *t;
+	size_t i;
+
+	if (facttok == NULL)
+		return false;
+	*t = facttok->next;
+	switch (facttok->kind)
+	{
+	case PBasic::toknum:
+		i = emit(VM::vm_num);
+		program->code[i].num = facttok->UU.num;
+		stack(1);
+		return true;
+
+	case PBasic::tokvar:
+		if (facttok->UU.vp->stringvar)
+			return false;
+		if (*t != NULL && (*t)->kind == PBasic::toklp)
+		{
+			/* array element */
+			if (!vm_skipparen(t))
+				return false;
+			i = emit(VM::vm_factor);
+			program->code[i].tok = facttok;
+			program->code[i].tok_end = *t;
+		}
+		else
+		{
+			i = emit(VM::vm_var);
+			program->code[i].vp = facttok->UU.vp;
+		}
+		stack(1);
+		return true;
+
+	case PBasic::toklp:
+		if (!expr(t) || *t == NULL || (*t)->kind != PBasic::tokrp)
+			return false;
+		*t = (*t)->next;
+		return true;
+
+	case PBasic::tokplus:
+		return factor(t);
+	case PBasic::tokminus:
+		return factor(t) && unary(VM::vm_neg);
+	case PBasic::toknot:
+		return factor(t) && unary(VM::vm_not);
+	case PBasic::toksqr:
+		return factor(t) && unary(VM::vm_sqr);
+	case PBasic::toksqrt:
+		return factor(t) && unary(VM::vm_sqrt);
+	case PBasic::tokceil:
+		return factor(t) && unary(VM::vm_ceil);
+	case PBasic::tokfloor:
+		return factor(t) && unary(VM::vm_floor);
+	case PBasic::toklog10:
+		return factor(t) && unary(VM::vm_log10);
+	case PBasic::toksin:
+		return factor(t) && unary(VM::vm_sin);
+	case PBasic::tokcos:
+		return factor(t) && unary(VM::vm_cos);
+	case PBasic::toktan:
+		return factor(t) && unary(VM::vm_tan);
+	case PBasic::tokarctan:
+		return factor(t) && unary(VM::vm_arctan);
+	case PBasic::toklog:
+		return factor(t) && unary(VM::vm_log);
+	case PBasic::tokexp:
+		return factor(t) && unary(VM::vm_exp);
+	case PBasic::tokabs:
+		return factor(t) && unary(VM::vm_abs);
+	case PBasic::toksgn:
+		return factor(t) && unary(VM::vm_sgn);
+
+	default:
+		if (vm_bindable(facttok->kind) && *t != NULL && (*t)->kind == PBasic::toklp &&
+			(*t)->next != NULL && (*t)->next->kind == PBasic::tokstr &&
+			(*t)->next->next != NULL && (*t)->next->next->kind == PBasic::tokrp)
+		{
+			PBasicBinding binding;
+			binding.name = (*t)->next->UU.sp;
+			binding.ptr = NULL;
+			binding.value = 0;
+			binding.model = -1;
+			i = emit(VM::vm_bound);
+			program->code[i].tok = facttok;
+			program->code[i].b = (int) program->bindings.size();
+			program->bindings.push_back(binding);
+			*t = (*t)->next->next->next;
+			stack(1);
+			return true;
+		}
+		switch (vm_function_args(facttok->kind))
+		{
+		case 0:
+			break;
+		case 1:
+			if (*t == NULL || (*t)->kind != PBasic::toklp || !vm_skipparen(t))
+				return false;
+			break;
+		default:
+			return false;
+		}
+		i = emit(VM::vm_factor);
+		program->code[i].tok = facttok;
+		program->code[i].tok_end = *t;
+		stack(1);
+		return true;
+	}
+}
+
+bool PBasicCompiler::
+upexpr(tokenrec ** t)
+{
+	if (!factor(t))
+		return false;
+	while (*t != NULL && (*t)->kind == PBasic::tokup)
+	{
+		*t = (*t)->next;
+		if (!upexpr(t))
+			return false;
+		binary(VM::vm_pow);
+	}
+	return true;
+}
+
+bool PBasicCompiler::
+term(tokenrec ** t)
+{
+	if (!upexpr(t))
+		return false;
+	while (*t != NULL && ((*t)->kind == PBasic::toktimes || (*t)->kind == PBasic::tokdiv ||
+		(*t)->kind == PBasic::tokmod))
+	{
+		int k = (*t)->kind;
+		*t = (*t)->next;
+		if (!upexpr(t))
+			return false;
+		binary(k == PBasic::toktimes ? VM::vm_times : (k == PBasic::tokdiv ? VM::vm_div : VM::vm_mod));
+	}
+	return true;
+}
+
+bool PBasicCompiler::
+sexpr(tokenrec ** t)
+{
+	if (!term(t))
+		return false;
+	while (*t != NULL && ((*t)->kind == PBasic::tokplus || (*t)->kind == PBasic::tokminus))
+	{
+		int k = (*t)->kind;
+		*t = (*t)->next;
+		if (!term(t))
+			return false;
+		binary(k == PBasic::tokplus ? VM::vm_plus : VM::vm_minus);
+	}
+	return true;
+}
+
+bool PBasicCompiler::
+relexpr(tokenrec ** t)
+{
+	if (!sexpr(t))
+		return false;
+	while (*t != NULL && (*t)->kind >= PBasic::tokeq && (*t)->kind <= PBasic::tokne)
+	{
+		int k = (*t)->kind;
+		*t = (*t)->next;
+		if (!sexpr(t))
+			return false;
+		binary(VM::vm_eq + (k - PBasic::tokeq));
+	}
+	return true;
+}
+
+bool PBasicCompiler::
+andexpr(tokenrec ** t)
+{
+	if (!relexpr(t))
+		return false;
+	while (*t != NULL && (*t)->kind == PBasic::tokand)
+	{
+		*t = (*t)->next;
+		if (!relexpr(t))
+			return false;
+		binary(VM::vm_and);
+	}
+	return true;
+}
+
+bool PBasicCompiler::
+expr(tokenrec ** t)
+{
+	if (!andexpr(t))
+		return false;
+	while (*t != NULL && ((*t)->kind == PBasic::tokor || (*t)->kind == PBasic::tokxor))
+	{
+		int k = (*t)->kind;
+		*t = (*t)->next;
+		if (!andexpr(t))
+			return false;
+		binary(k == PBasic::tokor ? VM::vm_or : VM::vm_xor);
+	}
+	return true;
+}
+
+void PBasicCompiler::
+numexpr(tokenrec * start, tokenrec * end, int follow)
+{
+/*
+ *   compiles the numeric expression from start to end; if it has no
+ *   compiled form (strings, syntax errors) realexpr evaluates it at run
+ *   time and checks that it ends at end, followed by token follow, or at
+ *   the end of the statement if follow < 0
+ */
+	size_t n = program->code.size();
+	int d = depth;
+	tokenrec *t = start;
+	if (expr(&t) && t == end && depth == d + 1)
+		return;
+	program->code.resize(n);
+	depth = d;
+	size_t i = emit(VM::vm_expr);
+	program->code[i].tok = start;
+	program->code[i].tok_end = end;
+	program->code[i].a = follow;
+	stack(1);
+}
+
+bool PBasicCompiler::
+numvar(tokenrec * t)
+{
+/*
+ *   true if t is a numeric scalar variable
+ */
+	return (t != NULL && t->kind == PBasic::tokvar && !t->UU.vp->stringvar &&
+		(t->next == NULL || t->next->kind != PBasic::toklp));
+}
+
+void PBasicCompiler::
+target(size_t pc, bool second, linerec * l, tokenrec * tok)
+{
+/*
+ *   jump to the statement where the interpreter continues with
+ *   stmtline = l and LINK->t = tok
+ */
+	jump j;
+	while (tok != NULL && tok->kind == PBasic::tokcolon)
+		tok = tok->next;
+	j.pc = pc;
+	j.second = second;
+	j.line = (tok == NULL) ? l->next : l;
+	j.tok = tok;
+	jumps.push_back(j);
+}
+
+bool PBasicCompiler::
+line_target(size_t pc, bool second, tokenrec * num)
+{
+/*
+ *   jump to the line numbered by a constant
+ */
+	long n = (long) floor(num->UU.num + 0.5);
+	linerec *l = linebase;
+	while (l != NULL && l->num != n)
+		l = l->next;
+	if (l == NULL)
+		return false;
+	jump j;
+	j.pc = pc;
+	j.second = second;
+	j.line = l;
+	j.tok = NULL;
+	jumps.push_back(j);
+	return true;
+}
+
+bool PBasicCompiler::
+statement(linerec * l, tokenrec ** t)
+{
+/*
+ *   compiles the statement at *t and moves *t to its end;
+ *   false if the program must be interpreted
+ */
+	tokenrec *stmttok = *t, *tok, *end;
+	size_t i, n;
+	int d;
+
+	*t = stmttok->next;
+	switch (stmttok->kind)
+	{
+	case PBasic::tokrem:
+		if (!vm_iseos(*t))
+			break;
+		return true;
+
+	case PBasic::toklet:
+	case PBasic::tokvar:
+		tok = (stmttok->kind == PBasic::toklet) ? *t : stmttok;
+		if (!numvar(tok) || tok->next == NULL || tok->next->kind != PBasic::tokeq)
+			break;
+		end = vm_skiptoeos(tok);
+		i = emit(VM::vm_check);
+		program->code[i].vp = tok->UU.vp;
+		numexpr(tok->next->next, end, -1);
+		i = emit(VM::vm_store);
+		program->code[i].vp = tok->UU.vp;
+		stack(-1);
+		*t = end;
+		return true;
+
+	case PBasic::toksave:
+	case PBasic::tokpunch:
+		n = program->code.size();
+		d = depth;
+		tok = *t;
+		while (!vm_iseos(tok))
+		{
+			if (tok->kind == PBasic::toksemi || tok->kind == PBasic::tokcomma)
+			{
+				tok = tok->next;
+				continue;
+			}
+			if (stmttok->kind == PBasic::tokpunch && tok->kind == PBasic::tokstr &&
+				(vm_iseos(tok->next) || tok->next->kind == PBasic::toksemi || tok->next->kind == PBasic::tokcomma))
+			{
+				i = emit(VM::vm_punch_str);
+				program->code[i].tok = tok;
+				tok = tok->next;
+				continue;
+			}
+			if (!expr(&tok) || depth != d + 1 ||
+				!(vm_iseos(tok) || tok->kind == PBasic::toksemi || tok->kind == PBasic::tokcomma))
+			{
+				tok = NULL;
+				break;
+			}
+			emit(stmttok->kind == PBasic::toksave ? VM::vm_save : VM::vm_punch);
+			stack(-1);
+		}
+		if (tok == *t && stmttok->kind == PBasic::toksave)
+		{
+			break;
+		}
+		if (tok != NULL)
+		{
+			*t = tok;
+			return true;
+		}
+		program->code.resize(n);
+		depth = d;
+		break;
+
+	case PBasic::tokprint:
+	case PBasic::tokput:
+	case PBasic::tokchange_por:
+	case PBasic::tokchange_surf:
+#if defined PHREEQ98 || defined MULTICHART
+	case PBasic::tokgraph_x:
+	case PBasic::tokgraph_y:
+	case PBasic::tokgraph_sy:
+#endif
+#if defined MULTICHART
+	case PBasic::tokplot_xy:
+#endif
+	case PBasic::tokread:
+	case PBasic::tokdata:
+	case PBasic::tokrestore:
+	case PBasic::tokgotoxy:
+	case PBasic::tokdim:
+	case PBasic::tokerase:
+		break;
+
+	case PBasic::tokgoto:
+		if (*t == NULL || (*t)->kind != PBasic::toknum || !vm_iseos((*t)->next))
+			return false;
+		if (!line_target(emit(VM::vm_jump), false, *t))
+			return false;
+		*t = (*t)->next;
+		return true;
+
+	case PBasic::tokgosub:
+		if (*t == NULL || (*t)->kind != PBasic::toknum || !vm_iseos((*t)->next))
+			return false;
+		i = emit(VM::vm_gosub);
+		if (!line_target(i, false, *t))
+			return false;
+		target(i, true, l, (*t)->next);
+		*t = (*t)->next;
+		return true;
+
+	case PBasic::tokreturn:
+		emit(VM::vm_return);
+		*t = vm_skiptoeos(*t);
+		return true;
+
+	case PBasic::tokend:
+		emit(VM::vm_end);
+		*t = vm_skiptoeos(*t);
+		return true;
+
+	case PBasic::tokstop:
+		emit(VM::vm_stop);
+		*t = vm_skiptoeos(*t);
+		return true;
+
+	case PBasic::tokelse:
+		target(emit(VM::vm_jump), false, l, NULL);
+		if (*t != NULL && (*t)->kind == PBasic::toknum)
+		{
+			/* target of the IF, see below */
+			*t = (*t)->next;
+			if (!vm_iseos(*t))
+				return false;
+		}
+		return true;
+
+	case PBasic::tokif:
+		{
+			tokenrec *then_tok = vm_find(*t, PBasic::tokthen);
+			if (then_tok == NULL)
+				return false;
+			numexpr(*t, then_tok, PBasic::tokthen);
+			i = emit(VM::vm_jz);
+			stack(-1);
+			/* false: after the matching ELSE, as in cmdif */
+			long count = 0;
+			tok = then_tok->next;
+			do
+			{
+				if (tok != NULL)
+				{
+					if (tok->kind == PBasic::tokif)
+						count++;
+					if (tok->kind == PBasic::tokelse)
+						count--;
+					tok = tok->next;
+				}
+			}
+			while (tok != NULL && count >= 0);
+			if (tok != NULL && tok->kind == PBasic::toknum)
+			{
+				if (!line_target(i, false, tok))
+					return false;
+			}
+			else
+			{
+				target(i, false, l, tok);
+			}
+			/* true: the statement after THEN */
+			*t = then_tok->next;
+			if (*t != NULL && (*t)->kind == PBasic::toknum)
+			{
+				if (!line_target(emit(VM::vm_jump), false, *t))
+					return false;
+				*t = (*t)->next;
+			}
+			return true;
+		}
+
+	case PBasic::tokfor:
+		{
+			varrec *v;
+			tokenrec *to_tok, *step_tok;
+			if (!numvar(*t) || (*t)->next == NULL || (*t)->next->kind != PBasic::tokeq)
+				return false;
+			v = (*t)->UU.vp;
+			to_tok = vm_find((*t)->next, PBasic::tokto);
+			if (to_tok == NULL)
+				return false;
+			step_tok = vm_find(to_tok, PBasic::tokstep);
+			end = vm_skiptoeos(to_tok);
+			i = emit(VM::vm_check);
+			program->code[i].vp = v;
+			numexpr((*t)->next->next, to_tok, PBasic::tokto);
+			i = emit(VM::vm_store);
+			program->code[i].vp = v;
+			stack(-1);
+			if (step_tok != NULL)
+			{
+				numexpr(to_tok->next, step_tok, -1);
+				numexpr(step_tok->next, end, -1);
+			}
+			else
+			{
+				numexpr(to_tok->next, end, -1);
+				i = emit(VM::vm_num);
+				program->code[i].num = 1.0;
+				stack(1);
+			}
+			i = emit(VM::vm_for);
+			program->code[i].vp = v;
+			stack(-2);
+			/* loop not entered: after the matching NEXT, as in cmdfor */
+			linerec *skipline = l;
+			long count = 0, count_v = 0;
+			tok = end;
+			do
+			{
+				while (tok == NULL)
+				{
+					if (skipline->next == NULL)
+						return false;
+					skipline = skipline->next;
+					tok = skipline->txt;
+				}
+				if (tok->kind == PBasic::tokfor || tok->kind == PBasic::toknext)
+				{
+					int up = (tok->kind == PBasic::tokfor) ? 1 : -1;
+					if (tok->next != NULL && tok->next->kind == PBasic::tokvar && tok->next->UU.vp == v)
+						count_v += up;
+					else
+						count += up;
+				}
+				tok = tok->next;
+			}
+			while (count >= 0 && count_v >= 0);
+			target(i, false, skipline, vm_skiptoeos(tok));
+			/* loop entered: the statement after FOR */
+			target(i, true, l, end);
+			*t = end;
+			return true;
+		}
+
+	case PBasic::toknext:
+		i = emit(VM::vm_next);
+		if (!vm_iseos(*t))
+		{
+			if (!numvar(*t) || !vm_iseos((*t)->next))
+				return false;
+			program->code[i].vp = (*t)->UU.vp;
+			*t = (*t)->next;
+		}
+		return true;
+
+	default:
+		return false;
+	}
+
+	/* statements run by the interpreter */
+	i = emit(VM::vm_stmt);
+	program->code[i].tok = stmttok;
+	*t = vm_skiptoeos(*t);
+	return true;
+}
+
+bool PBasicCompiler::
+compile(void)
+{
+	linerec *l;
+	tokenrec *t, *prev;
+	size_t i;
+
+	for (l = linebase; l != NULL; l = l->next)
+	{
+		line_pc[l] = (int) emit(VM::vm_line);
+		program->code.back().line_a = l;
+		t = l->txt;
+		prev = NULL;
+		for (;;)
+		{
+			while (t != NULL && t->kind == PBasic::tokcolon)
+			{
+				prev = t;
+				t = t->next;
+			}
+			if (t == NULL)
+				break;
+			if (t->kind == PBasic::toknum)
+			{
+				/* line number after THEN or ELSE, compiled with the IF */
+				if (prev == NULL || (prev->kind != PBasic::tokthen && prev->kind != PBasic::tokelse))
+					return false;
+				prev = t;
+				t = t->next;
+				continue;
+			}
+			stmt_pc[t] = (int) program->code.size();
+			if (t->kind == PBasic::tokif)
+			{
+				/* the statement after THEN follows directly */
+				tokenrec *then_tok = vm_find(t->next, PBasic::tokthen);
+				if (!statement(l, &t))
+					return false;
+				prev = then_tok;
+				continue;
+			}
+			if (t->kind == PBasic::tokelse)
+			{
+				prev = t;
+				if (!statement(l, &t))
+					return false;
+				continue;
+			}
+			if (!statement(l, &t))
+				return false;
+			if (!vm_iseos(t))
+				return false;
+			prev = NULL;
+		}
+	}
+	int end_pc = (int) emit(VM::vm_end);
+	if (program->depth > VM_MAX_DEPTH)
+		return false;
+
+	/* resolve jumps */
+	for (i = 0; i < jumps.size(); i++)
+	{
+		const jump & j = jumps[i];
+		int pc;
+		if (j.line == NULL)
+		{
+			pc = end_pc;
+		}
+		else if (j.tok == NULL)
+		{
+			pc = line_pc[j.line];
+		}
+		else
+		{
+			std::map<const tokenrec *, int>::const_iterator it = stmt_pc.find(j.tok);
+			if (it == stmt_pc.end())
+				return false;
+			pc = it->second;
+		}
+		PBasicInstr & instr = program->code[j.pc];
+		if (j.second)
+		{
+			instr.b = pc;
+			instr.line_b = j.line;
+		}
+		else
+		{
+			instr.a = pc;
+			instr.line_a = j.line;
+		}
+	}
+	return true;
+}
+
+/* ---------------------------------------------------------------------- */
+PBasicProgram * PBasic::
+compile_program(void)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   returns the bytecode of the program at linebase, or NULL if the
+ *   program must be interpreted
+ */
+	PBasicProgram *program = new PBasicProgram;
+	PBasicCompiler compiler(program, linebase);
+	if (!compiler.compile())
+	{
+		delete program;
+		return NULL;
+	}
+	return program;
+}
+
+/* ---------------------------------------------------------------------- */
+PBasicProgram * PBasic::
+find_program(void)
+/* ---------------------------------------------------------------------- */
+{
+	std::map<const void *, PBasicProgram *>::iterator it = PhreeqcPtr->basic_programs.find(linebase);
+	if (it != PhreeqcPtr->basic_programs.end())
+	{
+		return it->second;
+	}
+	PBasicProgram *program = compile_program();
+	PhreeqcPtr->basic_programs[linebase] = program;
+	return program;
+}
+
+/* ---------------------------------------------------------------------- */
+void PBasic::
+discard_program(void)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   called before the lines at linebase are changed or freed
+ */
+	std::map<const void *, PBasicProgram *>::iterator it = PhreeqcPtr->basic_programs.find(linebase);
+	if (it != PhreeqcPtr->basic_programs.end())
+	{
+		delete it->second;
+		PhreeqcPtr->basic_programs.erase(it);
+	}
+}
+
+/* ---------------------------------------------------------------------- */
+LDBLE PBasic::
+bound_value(int kind, PBasicBinding * binding)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   evaluates a function of a name given as a string constant;
+ *   the name is looked up again only after tidy_model has rebuilt the model
+ */
+	if (binding->model != PhreeqcPtr->tidy_rebuilds)
+	{
+		int l;
+		binding->ptr = NULL;
+		switch (kind)
+		{
+		case toksr:
+		case toksi:
+			binding->ptr = PhreeqcPtr->phase_bsearch(binding->name, &l, FALSE);
+			break;
+		case toktot:
+		case toktotmole:
+		case toktotmol:
+		case toktotmoles:
+			/* H, O, water and charge are not master species */
+			if (strcmp(binding->name, "H") != 0 && strcmp(binding->name, "O") != 0)
+			{
+				binding->ptr = PhreeqcPtr->master_bsearch(binding->name);
+			}
+			break;
+		case tokgfw:
+			if (PhreeqcPtr->compute_gfw(binding->name, &binding->value) == OK)
+			{
+				binding->ptr = &binding->value;
+			}
+			break;
+		default:
+			binding->ptr = PhreeqcPtr->s_search(binding->name);
+			break;
+		}
+		binding->model = PhreeqcPtr->tidy_rebuilds;
+	}
+
+	struct species *s_ptr = (struct species *) binding->ptr;
+	struct phase *phase_ptr = (struct phase *) binding->ptr;
+	struct master *master_ptr = (struct master *) binding->ptr;
+	LDBLE iap, si;
+	switch (kind)
+	{
+	case tokact:
+		return PhreeqcPtr->activity(s_ptr);
+	case tokgamma:
+		return PhreeqcPtr->activity_coefficient(s_ptr);
+	case toklg:
+		return PhreeqcPtr->log_activity_coefficient(s_ptr);
+	case tokmol:
+		return PhreeqcPtr->molality(s_ptr);
+	case tokla:
+		return PhreeqcPtr->log_activity(s_ptr);
+	case toklm:
+		return PhreeqcPtr->log_molality(s_ptr);
+	case toksr:
+		return (phase_ptr != NULL) ? PhreeqcPtr->saturation_ratio(phase_ptr) : PhreeqcPtr->saturation_ratio(binding->name);
+	case toksi:
+		if (phase_ptr != NULL)
+		{
+			PhreeqcPtr->saturation_index(phase_ptr, &iap, &si);
+		}
+		else
+		{
+			PhreeqcPtr->saturation_index(binding->name, &iap, &si);
+		}
+		return si;
+	case toktot:
+		return (master_ptr != NULL) ? PhreeqcPtr->total(master_ptr) : PhreeqcPtr->total(binding->name);
+	case toktotmole:
+	case toktotmol:
+	case toktotmoles:
+		return (master_ptr != NULL) ? PhreeqcPtr->total_mole(master_ptr) : PhreeqcPtr->total_mole(binding->name);
+	case tokgfw:
+		if (binding->ptr == NULL)
+		{
+			LDBLE gfw = 0;
+			PhreeqcPtr->compute_gfw(binding->name, &gfw);
+			return gfw;
+		}
+		return binding->value;
+	}
+	return 0;
+}
+
+struct vm_loop
+{
+	int kind;
+	varrec *vp;
+	LDBLE max, step;
+	int pc;
+	linerec *line;
+};
+
+/* ---------------------------------------------------------------------- */
+void PBasic::
+run_program(PBasicProgram * program)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   executes the bytecode; errors are raised as by the interpreter, with
+ *   stmtline set to the current line
+ */
+	struct LOC_exec V;
+	LDBLE stack[VM_MAX_DEPTH + 1];
+	LDBLE *sp = stack;
+	std::vector<vm_loop> loops;
+	const PBasicInstr *code = &program->code[0];
+	const PBasicInstr *in;
+	int pc = 0;
+	varrec *v;
+	LDBLE a, b;
+	valrec n;
+
+	V.gotoflag = false;
+	V.elseflag = false;
+	V.t = NULL;
+	for (;;)
+	{
+		in = &code[pc++];
+		switch (in->op)
+		{
+		case VM::vm_line:
+			stmtline = in->line_a;
+			break;
+
+		case VM::vm_num:
+			*sp++ = in->num;
+			break;
+
+		case VM::vm_var:
+			if (in->vp->numdims != 0)
+				badsubscr();
+			*sp++ = *in->vp->UU.U0.val;
+			break;
+
+		case VM::vm_factor:
+			V.t = in->tok;
+			n = factor(&V);
+			if (n.stringval)
+			{
+				PhreeqcPtr->PHRQ_free(n.UU.sval);
+				tmerr(": found characters, not a number");
+			}
+			if (V.t != in->tok_end)
+				checkextra(&V);
+			*sp++ = n.UU.val;
+			break;
+
+		case VM::vm_bound:
+			*sp++ = bound_value(in->tok->kind, &program->bindings[in->b]);
+			break;
+
+		case VM::vm_expr:
+			V.t = in->tok;
+			*sp++ = realexpr(&V);
+			if (V.t != in->tok_end)
+			{
+				if (in->a < 0)
+					checkextra(&V);
+				else
+					require(in->a, &V);
+			}
+			break;
+
+		case VM::vm_neg:
+		case VM::vm_not:
+		case VM::vm_sqr:
+		case VM::vm_sqrt:
+		case VM::vm_ceil:
+		case VM::vm_floor:
+		case VM::vm_log10:
+		case VM::vm_sin:
+		case VM::vm_cos:
+		case VM::vm_tan:
+		case VM::vm_arctan:
+		case VM::vm_log:
+		case VM::vm_exp:
+		case VM::vm_abs:
+		case VM::vm_sgn:
+			sp[-1] = vm_unary(in->op, sp[-1]);
+			break;
+
+		case VM::vm_pow:
+			b = *--sp;
+			a = sp[-1];
+			if (a >= 0)
+			{
+				if (a > 0)
+				{
+					sp[-1] = exp(b * log(a));
+				}
+			}
+			else if (b != (long) b)
+			{
+				tmerr(": negative number cannot be raised to a fractional power.");
+			}
+			else
+			{
+				a = exp(b * log(-a));
+				if (((long) b) & 1)
+					a = -a;
+				sp[-1] = a;
+			}
+			break;
+
+		case VM::vm_times:
+			b = *--sp;
+			sp[-1] *= b;
+			break;
+
+		case VM::vm_div:
+			b = *--sp;
+			if (b != 0)
+			{
+				sp[-1] /= b;
+			}
+			else
+			{
+				if (!parse_all)
+				{
+					char * error_string = PhreeqcPtr->sformatf( "Zero divide in BASIC line\n %ld %s.\nValue set to zero.", stmtline->num, stmtline->inbuf);
+					PhreeqcPtr->warning_msg(error_string);
+				}
+				sp[-1] = 0;
+			}
+			break;
+
+		case VM::vm_mod:
+			b = *--sp;
+			a = sp[-1];
+			sp[-1] = (a != 0) ? fabs(a) / a * fmod(fabs(a) + 1e-14, b) : 0;
+			break;
+
+		case VM::vm_plus:
+			b = *--sp;
+			sp[-1] += b;
+			break;
+
+		case VM::vm_minus:
+			b = *--sp;
+			sp[-1] -= b;
+			break;
+
+		case VM::vm_eq:
+			b = *--sp;
+			sp[-1] = (sp[-1] == b);
+			break;
+
+		case VM::vm_lt:
+			b = *--sp;
+			sp[-1] = (sp[-1] < b);
+			break;
+
+		case VM::vm_gt:
+			b = *--sp;
+			sp[-1] = (sp[-1] > b);
+			break;
+
+		case VM::vm_le:
+			b = *--sp;
+			sp[-1] = (sp[-1] == b || sp[-1] < b);
+			break;
+
+		case VM::vm_ge:
+			b = *--sp;
+			sp[-1] = (sp[-1] == b || sp[-1] > b);
+			break;
+
+		case VM::vm_ne:
+			b = *--sp;
+			sp[-1] = (sp[-1] < b || sp[-1] > b);
+			break;
+
+		case VM::vm_and:
+			b = *--sp;
+			sp[-1] = ((long) sp[-1]) & ((long) b);
+			break;
+
+		case VM::vm_or:
+			b = *--sp;
+			sp[-1] = ((long) sp[-1]) | ((long) b);
+			break;
+
+		case VM::vm_xor:
+			b = *--sp;
+			sp[-1] = ((long) sp[-1]) ^ ((long) b);
+			break;
+
+		case VM::vm_check:
+			if (in->vp->numdims != 0)
+				badsubscr();
+			break;
+
+		case VM::vm_store:
+			v = in->vp;
+			v->UU.U0.val = &v->UU.U0.rv;
+			v->UU.U0.rv = *--sp;
+			break;
+
+		case VM::vm_jump:
+			pc = in->a;
+			stmtline = in->line_a;
+			break;
+
+		case VM::vm_jz:
+			if (*--sp == 0)
+			{
+				pc = in->a;
+				stmtline = in->line_a;
+			}
+			break;
+
+		case VM::vm_gosub:
+			{
+				vm_loop l;
+				l.kind = gosubloop;
+				l.vp = NULL;
+				l.max = l.step = 0;
+				l.pc = in->b;
+				l.line = in->line_b;
+				loops.push_back(l);
+				pc = in->a;
+				stmtline = in->line_a;
+			}
+			break;
+
+		case VM::vm_return:
+			for (;;)
+			{
+				if (loops.empty())
+					errormsg("RETURN without GOSUB");
+				if (loops.back().kind == gosubloop)
+					break;
+				loops.pop_back();
+			}
+			pc = loops.back().pc;
+			stmtline = loops.back().line;
+			loops.pop_back();
+			break;
+
+		case VM::vm_for:
+			{
+				vm_loop l;
+				l.kind = forloop;
+				l.vp = in->vp;
+				l.step = *--sp;
+				l.max = *--sp;
+				a = *l.vp->UU.U0.val;
+				if ((l.step >= 0 && a > l.max) || (l.step <= 0 && a < l.max))
+				{
+					pc = in->a;
+					stmtline = in->line_a;
+					break;
+				}
+				l.pc = in->b;
+				l.line = in->line_b;
+				loops.push_back(l);
+				pc = in->b;
+				stmtline = in->line_b;
+			}
+			break;
+
+		case VM::vm_next:
+			v = in->vp;
+			if (v != NULL && v->numdims != 0)
+				badsubscr();
+			for (;;)
+			{
+				if (loops.empty() || loops.back().kind == gosubloop)
+					errormsg("NEXT without FOR");
+				if (loops.back().kind == forloop && (v == NULL || loops.back().vp == v))
+					break;
+				loops.pop_back();
+			}
+			{
+				vm_loop & l = loops.back();
+				*l.vp->UU.U0.val += l.step;
+				if ((l.step < 0 || *l.vp->UU.U0.val <= l.max) &&
+					(l.step > 0 || *l.vp->UU.U0.val >= l.max))
+				{
+					pc = l.pc;
+					stmtline = l.line;
+					break;
+				}
+			}
+			loops.pop_back();
+			break;
+
+		case VM::vm_save:
+			PhreeqcPtr->rate_moles = *--sp;
+			break;
+
+		case VM::vm_punch:
+			punch_value(*--sp);
+			break;
+
+		case VM::vm_punch_str:
+			punch_string(in->tok->UU.sp);
+			break;
+
+		case VM::vm_stmt:
+			stmttok = in->tok;
+			V.t = stmttok->next;
+			V.gotoflag = false;
+			V.elseflag = false;
+			switch (stmttok->kind)
+			{
+			case tokrem:
+				break;
+			case toklet:
+				cmdlet(false, &V);
+				break;
+			case tokvar:
+				cmdlet(true, &V);
+				break;
+			case toksave:
+				cmdsave(&V);
+				break;
+			case tokprint:
+				cmdprint(&V);
+				break;
+			case tokpunch:
+				cmdpunch(&V);
+				break;
+			case tokput:
+				cmdput(&V);
+				break;
+			case tokchange_por:
+				cmdchange_por(&V);
+				break;
+			case tokchange_surf:
+				cmdchange_surf(&V);
+				break;
+#if defined PHREEQ98 || defined MULTICHART
+			case tokgraph_x:
+				cmdgraph_x(&V);
+				break;
+			case tokgraph_y:
+				cmdgraph_y(&V);
+				break;
+			case tokgraph_sy:
+				cmdgraph_sy(&V);
+				break;
+#endif
+#if defined MULTICHART
+			case tokplot_xy:
+				cmdplot_xy(&V);
+				break;
+#endif
+			case tokread:
+				cmdread(&V);
+				break;
+			case tokdata:
+				cmddata(&V);
+				break;
+			case tokrestore:
+				cmdrestore(&V);
+				break;
+			case tokgotoxy:
+				cmdgotoxy(&V);
+				break;
+			case tokdim:
+				cmddim(&V);
+				break;
+			case tokerase:
+				cmderase(&V);
+				break;
+			}
+			if (!iseos(&V))
+				checkextra(&V);
+			break;
+
+		case VM::vm_stop:
+			P_escapecode = -20;
+			throw PBasicStop();
+
+		case VM::vm_end:
+			stmtline = NULL;
+			return;
+		}
+	}
+}
@@ -1085,6 +1085,7 @@ void Phreeqc::init(void)
 	s_pTail                 = NULL;
 	/* Basic */
 	basic_interpreter       = NULL;
+	basic_bytecode_on       = true;
 	basic_callback_ptr      = NULL;
 	basic_callback_cookie   = NULL;
 	basic_fortran_callback_ptr  = NULL;
@@ -1220,6 +1221,13 @@ void Phreeqc::init(void)
 	kinetics_cvode_mem      = NULL;
 	cvode_pp_assemblage_save= NULL;
 	cvode_ss_assemblage_save= NULL;
+	cvode_jacobian_reuse_on = false;
+	cvode_jacobian_seeded   = FALSE;
+	cvode_jacobian_n_user   = -99;
+	cvode_integrations      = 0;
+	cvode_f_evals           = 0;
+	cvode_jac_evals         = 0;
+	cvode_factorizations    = 0;
 	m_original              = NULL;
 	m_temp                  = NULL;
 	rk_moles                = NULL;
@@ -1228,6 +1236,17 @@ void Phreeqc::init(void)
 	/* model.cpp ------------------------------- */
 	gas_in                  = FALSE;
 	min_value               = 1e-10;
+	warm_start              = FALSE;
+	warm_start_ptr          = NULL;
+	warm_start_n_user       = -99;
+	solve_count             = 0;
+	solve_iterations        = 0;
+	warm_start_count        = 0;
+	warm_start_fallbacks    = 0;
+	ineq_lu_on              = false;
+	ineq_solves             = 0;
+	ineq_lu_solves          = 0;
+	ineq_lu_rejects         = 0;
 	normal                  = NULL;
 	ineq_array              = NULL;
 	res                     = NULL;
@@ -1299,11 +1318,10 @@ void Phreeqc::init(void)
 	IPRSNT                  = NULL;
 	M                       = NULL;
 	LGAMMA                  = NULL;
-	for (int i = 0; i < 23; i++)
-	{
-		BK[i]				= 0.0;
-		DK[i]				= 0.0;
-	}
+	pitz_ionic_x.I          = -1.0;
+	pitz_ionic_x.A0         = 0.0;
+	parallel_jacobian_on    = false;
+	parallel_jacobian_threshold = 16;
 #ifdef PHREEQ98
 	int connect_simulations, graph_initial_solutions;
 	int shifts_as_points;
@@ -1312,6 +1330,15 @@ void Phreeqc::init(void)
 	int RowOffset, ColumnOffset;
 #endif
 	dummy                   = 0;
+	/* prep.cpp ------------------------------- */
+	model_image_valid       = false;
+	model_image_gamma_valid = false;
+	gamma_mu_tolerance      = 0.0;
+	model_cache_max         = 4;
+	model_cache_live        = FALSE;
+	model_cache_hits        = 0;
+	model_cache_misses      = 0;
+	logk_tc_max             = 64;
 	/* print.cpp ------------------------------- */
 	sformatf_buffer = (char *) PHRQ_malloc(256 * sizeof(char));
 	if (sformatf_buffer == NULL) 
@@ -1358,6 +1385,10 @@ void Phreeqc::init(void)
 	a1                      = 0;
 	kc                      = 0;
 	kb                      = 0;
+	tidy_valid              = FALSE;
+	tidy_count              = 0;
+	tidy_skipped            = 0;
+	tidy_rebuilds           = 0;
 	/* tally.cpp ------------------------------- */
 	t_buffer                = NULL;
 	tally_count_component   = 0;
@@ -1389,6 +1420,22 @@ void Phreeqc::init(void)
 	heat_mix_f_m            = 0;
 	warn_MCD_X              = 0;
 	warn_fixed_Surf         = 0;
+	tk_x2                   = 0;
+	dV_dcell                = 0;
+	find_current            = 0;
+	current_cells           = NULL;
+	sum_R                   = 0;
+	sum_Rd                  = 0;
+	ct                      = NULL;
+	moles_added             = NULL;
+	count_moles_added       = 0;
+	Ct2                     = NULL;
+	l_tk_x2                 = NULL;
+	A                       = NULL;
+	LU                      = NULL;
+	mixf                    = NULL;
+	mixf_stag               = NULL;
+	mixf_comp_size          = 0;
 #ifdef PHREEQ98
 	int AutoLoadOutputFile, CreateToC;
 	int ProcessMessages, ShowProgress, ShowProgressWindow, ShowChart;
@@ -2503,6 +2550,15 @@ Phreeqc::InternalCopy(const Phreeqc *pSrc)
 	viscos = pSrc->viscos;
 	viscos_0 = pSrc->viscos_0;
 	viscos_0_25 = pSrc->viscos_0_25; // viscosity of the solution, of pure water, of pure water at 25 C
+	/* model.cpp ------------------------------- */
+	warm_start              = pSrc->warm_start;
+	warm_start_map          = pSrc->warm_start_map;
+	ineq_lu_on              = pSrc->ineq_lu_on;
+	gamma_mu_tolerance      = pSrc->gamma_mu_tolerance;
+	/* kinetics.cpp */
+	cvode_jacobian_reuse_on = pSrc->cvode_jacobian_reuse_on;
+	/* Basic */
+	basic_bytecode_on       = pSrc->basic_bytecode_on;
 #ifdef SKIP
 	LDBLE cell_pore_volume;
 	LDBLE cell_porosity;
@@ -2684,6 +2740,8 @@ protected:
 		}
 	}
 	use_etheta              = pSrc->use_etheta;
+	parallel_jacobian_on    = pSrc->parallel_jacobian_on;
+	parallel_jacobian_threshold = pSrc->parallel_jacobian_threshold;
 	/*
 	OTEMP					= -100.0;
 	OPRESS					= -100.0;
@@ -2712,11 +2770,8 @@ protected:
 	IPRSNT                  = NULL;
 	M                       = NULL;
 	LGAMMA                  = NULL;
-	for (int i = 0; i < 23; i++)
-	{
-		BK[i]				= 0.0;
-		DK[i]				= 0.0;
-	}
+	pitz_ionic_x.I          = -1.0;
+	pitz_ionic_x.A0         = 0.0;
 	*/
 
 #ifdef PHREEQ98
@@ -2727,6 +2782,9 @@ protected:
 	int RowOffset, ColumnOffset;
 #endif
 	dummy                   = 0;
+	/* prep.cpp ------------------------------- */
+	model_cache_max         = pSrc->model_cache_max;
+	logk_tc_max             = pSrc->logk_tc_max;
 	/* print.cpp ------------------------------- */
 	/*
 	sformatf_buffer = (char *) PHRQ_malloc(256 * sizeof(char));
@@ -2822,6 +2880,14 @@ protected:
 	current_x = pSrc->current_x;
 	current_A = pSrc->current_A;
 	fix_current = pSrc->fix_current;
+	// transport work space is created and freed in transport.cpp
+	current_cells = NULL;
+	ct = NULL;
+	moles_added = NULL;
+	count_moles_added = 0;
+	Ct2 = l_tk_x2 = NULL;
+	A = LU = mixf = mixf_stag = NULL;
+	mixf_comp_size = 0;
 
 #ifdef PHREEQ98
 	int AutoLoadOutputFile, CreateToC;
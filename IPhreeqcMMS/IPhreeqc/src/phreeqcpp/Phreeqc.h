@@ -17,6 +17,7 @@ typedef unsigned char boolean;
 #include <fstream>
 #include <sstream>
 #include <map>
+#include <set>
 #ifdef HASH
 #include <hash_map>
 #endif
@@ -65,6 +66,7 @@ class cxxStorageBin;
 
 #include "global_structures.h"
 class PBasic;
+class PBasicProgram;
 
 class Phreeqc
 {
@@ -100,8 +102,11 @@ public:
 #endif
 
 	LDBLE activity(const char *species_name);
+	LDBLE activity(struct species *s_ptr);
 	LDBLE activity_coefficient(const char *species_name);
+	LDBLE activity_coefficient(struct species *s_ptr);
 	LDBLE log_activity_coefficient(const char *species_name);
+	LDBLE log_activity_coefficient(struct species *s_ptr);
 	LDBLE aqueous_vm(const char *species_name);
 	LDBLE phase_vm(const char *phase_name);
 	LDBLE diff_c(const char *species_name);
@@ -134,13 +139,18 @@ public:
 	LDBLE kinetics_moles(const char *kinetics_name);
 	LDBLE kinetics_moles_delta(const char *kinetics_name);
 	LDBLE log_activity(const char *species_name);
+	LDBLE log_activity(struct species *s_ptr);
 	LDBLE log_molality(const char *species_name);
+	LDBLE log_molality(struct species *s_ptr);
 	LDBLE molality(const char *species_name);
+	LDBLE molality(struct species *s_ptr);
 	LDBLE pressure(void);
 	LDBLE pr_pressure(const char *phase_name);
 	LDBLE pr_phi(const char *phase_name);
 	LDBLE saturation_ratio(const char *phase_name);
+	LDBLE saturation_ratio(struct phase *phase_ptr);
 	int saturation_index(const char *phase_name, LDBLE * iap, LDBLE * si);
+	int saturation_index(struct phase *phase_ptr, LDBLE * iap, LDBLE * si);
 	int solution_number(void);
 	LDBLE solution_sum_secondary(const char *total_name);
 	LDBLE sum_match_gases(const char *stemplate, const char *name);
@@ -169,7 +179,9 @@ public:
 	int system_total_elt(const char *total_name);
 	int system_total_elt_secondary(const char *total_name);
 	LDBLE total(const char *total_name);
+	LDBLE total(struct master *master_ptr);
 	LDBLE total_mole(const char *total_name);
+	LDBLE total_mole(struct master *master_ptr);
 	int system_total_solids(cxxExchange *exchange_ptr,
 		cxxPPassemblage *pp_assemblage_ptr,
 		cxxGasPhase *gas_phase_ptr,
@@ -416,6 +428,9 @@ public:
 		LDBLE step_fraction);
 	int set_advection(int i, int use_mix, int use_kinetics, int nsaver);
 	int free_cvode(void);
+	struct cvode_jacobian *cvode_jacobian_find(int n_user, cxxKinetics *kinetics_ptr);
+	void cvode_jacobian_groups(struct cvode_jacobian *jac_ptr, int n);
+	void cvode_integration_done(int n_user, long *iopt, bool converged);
 public:
 	static void f(integertype N, realtype t, N_Vector y, N_Vector ydot,
 		void *f_data);
@@ -465,6 +480,7 @@ public:
 	int check_residuals(void);
 	int free_model_allocs(void);
 	int ineq(int kode);
+	int ineq_lu(int n, LDBLE * a, int ncols, LDBLE * l_delta);
 	int model(void);
 	int jacobian_sums(void);
 	int mb_gases(void);
@@ -496,6 +512,8 @@ public:
 	int gammas_a_f(int i);
 	int initial_guesses(void);
 	int revise_guesses(void);
+	int warm_start_apply(void);
+	int warm_start_save(int n_user);
 	int ss_binary(cxxSS *ss_ptr);
 	int ss_ideal(cxxSS *ss_ptr);
 	void ineq_init(int max_row_count, int max_column_count);
@@ -546,6 +564,12 @@ public:
 	int read_pitzer(void);
 	int set_pz(int initial);
 	int calc_pitz_param(struct pitz_param *pz_ptr, LDBLE TK, LDBLE TR);
+	int store_pitz_param(struct pitz_param *pz_ptr, LDBLE param);
+	void pitzer_ionic(struct pitz_ionic *ionic, LDBLE I);
+	int pitzer_sums(const LDBLE *l_M, const int *l_IPRSNT, LDBLE I,
+		struct pitz_ionic *ionic, LDBLE *l_LGAMMA, LDBLE *cosmot, LDBLE *aw);
+	void pitzer_molalities(LDBLE *l_M, int *l_IPRSNT);
+	void pitzer_column(int i);
 	int check_gammas_pz(void);	
 #ifdef SKIP
 	LDBLE DC(LDBLE T);
@@ -564,6 +588,9 @@ public:
 	//LDBLE JAY(LDBLE X);
 	//LDBLE JPRIME(LDBLE Y);
 	int jacobian_pz(void);
+	bool jacobian_pz_perturb(int i, LDBLE d, LDBLE *d1, LDBLE *d2);
+	void jacobian_pz_unperturb(int i, LDBLE d, LDBLE d1, LDBLE d2);
+	int jacobian_pz_columns(LDBLE d, int pz_max_unknowns);
 
 	// pitzer_structures.cpp -------------------------------
 	struct pitz_param *pitz_param_alloc(void);
@@ -583,6 +610,7 @@ public:
 	int build_mb_sums(void);
 	int build_min_exch(void);
 	int build_model(void);
+	int build_model_image(void);
 	int build_pure_phases(void);
 	int build_ss_assemblage(void);
 	int build_solution_phase_boundaries(void);
@@ -637,8 +665,17 @@ public:
 	int write_mass_action_eqn_x(int stop);
 
 	int check_same_model(void);
+	int check_same_model_reactants(void);
+	int model_cache_find(void);
+	int model_cache_save(void);
+	int model_cache_restore(struct model_cache_entry *entry_ptr);
+	int model_cache_entry_free(struct model_cache_entry *entry_ptr);
+	int model_cache_free(void);
 	int k_temp(LDBLE tc, LDBLE pa);
+	const LDBLE *k_temp_table(LDBLE tc);
 	LDBLE k_calc(LDBLE * logk, LDBLE tempk, LDBLE presPa);
+	LDBLE k_calc_tc(LDBLE * logk, LDBLE tempk);
+	LDBLE k_calc_pressure(LDBLE lk, LDBLE * logk, LDBLE tempk, LDBLE presPa);
 	int prep(void);
 	int reprep(void);
 	int rewrite_master_to_secondary(struct master *master_ptr1,
@@ -689,6 +726,7 @@ public:
 
 	// read.cpp -------------------------------
 	int read_input(void);
+	void init_read_input(void);
 	int read_conc(cxxSolution *solution_ptr, int count_mass_balance, char *str);
 	int *read_list_ints_range(char **ptr, int *count_ints, int positive,
 		int *int_list);
@@ -823,6 +861,20 @@ public:
 	void sit_make_lists(void);
 	int jacobian_sit(void);
 
+	// snapshot.cpp -------------------------------
+	bool database_snapshot_supported(void);
+	bool read_database_snapshot(std::istream &is, const std::string &key);
+	bool write_database_snapshot(std::ostream &os, const std::string &key);
+	void snapshot_write_header(std::ostream &os, const std::string &key);
+	bool snapshot_read_header(std::istream &is, const std::string &key);
+	void snapshot_write_name_coef(std::ostream &os, const struct name_coef *nc, int count);
+	bool snapshot_read_name_coef(std::istream &is, struct name_coef **nc, int count);
+	void snapshot_write_elt_list(std::ostream &os, const struct elt_list *elts);
+	bool snapshot_read_elt_list(std::istream &is, struct elt_list **elts);
+	void snapshot_write_rxn(std::ostream &os, const struct reaction *rxn);
+	bool snapshot_read_rxn(std::istream &is, struct reaction **rxn);
+	bool snapshot_read_doubles(std::istream &is, LDBLE **d, int *count);
+
 	// spread.cpp -------------------------------
 	int read_solution_spread(void);
 	int copy_token_tab(char *token_ptr, char **ptr, int *length);
@@ -1000,7 +1052,8 @@ public:
 	int get_tally_table_column_heading(int column, int *type, char *string);
 	int get_tally_table_row_heading(int column, char *string);
 	int store_tally_table(LDBLE * array, int row_dim, int col_dim,
-		LDBLE fill_factor);
+		LDBLE fill_factor, std::vector<char> *written = NULL);
+	int select_tally_table_columns(int *n_user, const int *columns, int count);
 	int zero_tally_table(void);
 	int elt_list_to_tally_table(struct tally_buffer *buffer_ptr);
 	int master_to_tally_table(struct tally_buffer *buffer_ptr);
@@ -1789,6 +1842,8 @@ protected:
 
 	/* Basic */
 	PBasic * basic_interpreter;
+	std::map<const void *, PBasicProgram *> basic_programs;   /* compiled programs by first line, NULL if interpreted */
+	bool basic_bytecode_on;
 	double (*basic_callback_ptr) (double x1, double x2, const char *str, void *cookie);
 	void *basic_callback_cookie;
 #ifdef IPHREEQC_NO_FORTRAN_MODULE
@@ -1870,6 +1925,11 @@ public:
 	void *kinetics_cvode_mem;
 	cxxSSassemblage *cvode_ss_assemblage_save;
 	cxxPPassemblage *cvode_pp_assemblage_save;
+	bool cvode_jacobian_reuse_on;
+	int cvode_jacobian_seeded;
+	int cvode_jacobian_n_user;
+	std::map<int, struct cvode_jacobian> cvode_jacobian_map;
+	long cvode_integrations, cvode_f_evals, cvode_jac_evals, cvode_factorizations;
 protected:
 	LDBLE *m_original;
 	LDBLE *m_temp;
@@ -1884,6 +1944,15 @@ protected:
 	int *iu, *is, *back_eq;
 	int normal_max, ineq_array_max, res_max, cu_max, zero_max,
 		delta1_max, iu_max, is_max, back_eq_max;
+	int warm_start;
+	std::map<int, struct warm_start_guess> warm_start_map;
+	struct warm_start_guess *warm_start_ptr;
+	int warm_start_n_user;
+	long solve_count, solve_iterations;
+	long warm_start_count, warm_start_fallbacks;
+	bool ineq_lu_on;
+	std::vector<LDBLE> ineq_lu_work;
+	long ineq_solves, ineq_lu_solves, ineq_lu_rejects;
 
 	/* phrq_io_output.cpp ------------------------------- */
 	int forward_output_to_log;
@@ -1917,7 +1986,13 @@ protected:
 	struct pitz_param *mcb0, *mcb1, *mcc0;
 	int *IPRSNT;
 	LDBLE *M, *LGAMMA;
-	LDBLE BK[23], DK[23];
+	std::map<LDBLE, std::vector<LDBLE> > pitz_param_tk_cache;	/* p of pitz_params and aphi by TK */
+	std::vector<struct pitz_term> pitz_terms;
+	std::vector<LDBLE> pitz_alphas;
+	struct pitz_ionic pitz_ionic_x;
+	struct pitz_columns pitz_columns_x;
+	bool parallel_jacobian_on;					/* columns of jacobian_pz on threads */
+	int parallel_jacobian_threshold;			/* fewest unknowns for parallel columns */
 
 #ifdef PHREEQ98
 	int connect_simulations, graph_initial_solutions;
@@ -1928,6 +2003,27 @@ protected:
 #endif
 	LDBLE dummy;
 
+	/* prep.cpp ------------------------------- */
+	bool model_image_valid;							/* cleared whenever s_x or the rxn_x of s change */
+	std::vector<struct species *> model_image_s;	/* species whose lm molalities calculates */
+	std::vector<int> model_image_start;				/* first term of each mass-action equation */
+	std::vector<int> model_image_master;			/* term, index into model_image_la */
+	std::vector<LDBLE> model_image_coef;			/* term, stoichiometric coefficient */
+	std::vector<struct species *> model_image_la_s;	/* master species in the equations */
+	std::vector<LDBLE> model_image_la;				/* their la, gathered by molalities */
+	std::vector<struct gamma_batch> model_image_gamma;	/* species by gamma formula */
+	std::vector<int> model_image_gamma_other;		/* s_x index of the other species */
+	bool model_image_gamma_valid;					/* batch lg and dg_coef are current */
+	LDBLE model_image_gamma_mu, model_image_gamma_a, model_image_gamma_b;
+	LDBLE model_image_gamma_llnl[3];				/* a, b, bdot of LLNL_AQUEOUS_MODEL */
+	LDBLE gamma_mu_tolerance;
+	int model_cache_max;
+	int model_cache_live;
+	std::vector<struct model_cache_entry *> model_cache;
+	long model_cache_hits, model_cache_misses;
+	std::map<LDBLE, std::vector<LDBLE> > logk_tc_table;
+	int logk_tc_max;
+
 	/* print.cpp ------------------------------- */
 #ifdef PHREEQ98
 	int colnr, rownr;
@@ -1968,6 +2064,8 @@ protected:
 
 	/* tidy.cpp ------------------------------- */
 	LDBLE a0, a1, kc, kb;
+	int tidy_valid;
+	long tidy_count, tidy_skipped, tidy_rebuilds;
 
 	/* tally.cpp ------------------------------- */
 	struct tally_buffer *t_buffer;
@@ -1975,6 +2073,7 @@ protected:
 	struct tally *tally_table;
 	int count_tally_table_columns;
 	int count_tally_table_rows;
+	std::vector<int> tally_columns;
 
 	/* transport.cpp ------------------------------- */
 	struct sol_D *sol_D;
@@ -1993,6 +2092,21 @@ protected:
 	LDBLE heat_mix_f_imm, heat_mix_f_m;
 	int warn_MCD_X, warn_fixed_Surf;
 	LDBLE current_x, current_A, fix_current; // current: coulomb / s, Ampere, fixed current (Ampere)
+	LDBLE tk_x2; // average tk_x of icell and jcell
+	LDBLE dV_dcell; // difference in Volt among icell and jcell
+	int find_current;
+	struct CURRENT_CELLS *current_cells;
+	LDBLE sum_R, sum_Rd; // sum of R, sum of (current_cells[0].dif - current_cells[i].dif) * R
+	struct CT *ct;
+	struct MOLES_ADDED *moles_added;
+	int count_moles_added;
+	// implicit...
+	std::set <std::string> dif_spec_names;
+	std::set <std::string> dif_els_names;
+	std::map<int, std::map<std::string, double> > neg_moles;
+	std::map<std::string, double> els;
+	double *Ct2, *l_tk_x2, **A, **LU, **mixf, **mixf_stag;
+	int mixf_comp_size;
 
 #ifdef PHREEQ98
 	int AutoLoadOutputFile, CreateToC;
@@ -16,10 +16,16 @@ LDBLE Phreeqc::
 activity(const char *species_name)
 /* ---------------------------------------------------------------------- */
 {
-	struct species *s_ptr;
+	return activity(s_search(species_name));
+}
+
+/* ---------------------------------------------------------------------- */
+LDBLE Phreeqc::
+activity(struct species *s_ptr)
+/* ---------------------------------------------------------------------- */
+{
 	LDBLE a;
 
-	s_ptr = s_search(species_name);
 	if (s_ptr == s_h2o)
 	{
 		a = pow((LDBLE) 10., s_h2o->la);
@@ -44,10 +50,16 @@ LDBLE Phreeqc::
 activity_coefficient(const char *species_name)
 /* ---------------------------------------------------------------------- */
 {
-	struct species *s_ptr;
+	return activity_coefficient(s_search(species_name));
+}
+
+/* ---------------------------------------------------------------------- */
+LDBLE Phreeqc::
+activity_coefficient(struct species *s_ptr)
+/* ---------------------------------------------------------------------- */
+{
 	LDBLE g, dum = 0.0;
 
-	s_ptr = s_search(species_name);
 	if (s_ptr != NULL && s_ptr->in != FALSE && ((s_ptr->type < EMINUS) || (s_ptr->type == EX) || (s_ptr->type == SURF)))
 	{
 		if (s_ptr->type == EX && s_ptr->equiv && s_ptr->alk)
@@ -66,10 +78,16 @@ LDBLE Phreeqc::
 log_activity_coefficient(const char *species_name)
 /* ---------------------------------------------------------------------- */
 {
-	struct species *s_ptr;
+	return log_activity_coefficient(s_search(species_name));
+}
+
+/* ---------------------------------------------------------------------- */
+LDBLE Phreeqc::
+log_activity_coefficient(struct species *s_ptr)
+/* ---------------------------------------------------------------------- */
+{
 	LDBLE g, dum = 0.0;
 
-	s_ptr = s_search(species_name);
 	if (s_ptr != NULL && s_ptr->in != FALSE && ((s_ptr->type < EMINUS) || (s_ptr->type == EX) || (s_ptr->type == SURF)))
 	{
 		if (s_ptr->type == EX && s_ptr->equiv && s_ptr->alk)
@@ -1517,10 +1535,15 @@ LDBLE Phreeqc::
 log_activity(const char *species_name)
 /* ---------------------------------------------------------------------- */
 {
-	struct species *s_ptr;
-	LDBLE la;
+	return log_activity(s_search(species_name));
+}
 
-	s_ptr = s_search(species_name);
+/* ---------------------------------------------------------------------- */
+LDBLE Phreeqc::
+log_activity(struct species *s_ptr)
+/* ---------------------------------------------------------------------- */
+{
+	LDBLE la;
 
 	if (s_ptr == s_eminus)
 	{
@@ -1546,10 +1569,15 @@ LDBLE Phreeqc::
 log_molality(const char *species_name)
 /* ---------------------------------------------------------------------- */
 {
-	struct species *s_ptr;
-	LDBLE lm;
+	return log_molality(s_search(species_name));
+}
 
-	s_ptr = s_search(species_name);
+/* ---------------------------------------------------------------------- */
+LDBLE Phreeqc::
+log_molality(struct species *s_ptr)
+/* ---------------------------------------------------------------------- */
+{
+	LDBLE lm;
 
 	if (s_ptr == s_eminus)
 	{
@@ -1575,10 +1603,16 @@ LDBLE Phreeqc::
 molality(const char *species_name)
 /* ---------------------------------------------------------------------- */
 {
-	struct species *s_ptr;
+	return molality(s_search(species_name));
+}
+
+/* ---------------------------------------------------------------------- */
+LDBLE Phreeqc::
+molality(struct species *s_ptr)
+/* ---------------------------------------------------------------------- */
+{
 	LDBLE m;
 
-	s_ptr = s_search(species_name);
 	if (s_ptr == NULL || s_ptr == s_eminus || s_ptr->in == FALSE)
 	{
 		m = 1e-99;
@@ -1645,12 +1679,9 @@ LDBLE Phreeqc::
 saturation_ratio(const char *phase_name)
 /* ---------------------------------------------------------------------- */
 {
-	struct rxn_token *rxn_ptr;
 	struct phase *phase_ptr;
 	int l;
-	LDBLE si, iap;
 
-	iap = 0.0;
 	phase_ptr = phase_bsearch(phase_name, &l, FALSE);
 	if (phase_ptr == NULL)
 	{
@@ -1658,7 +1689,19 @@ saturation_ratio(const char *phase_name)
 		warning_msg(error_string);
 		return (1e-99);
 	}
-	else if (phase_ptr->in != FALSE)
+	return saturation_ratio(phase_ptr);
+}
+
+/* ---------------------------------------------------------------------- */
+LDBLE Phreeqc::
+saturation_ratio(struct phase *phase_ptr)
+/* ---------------------------------------------------------------------- */
+{
+	struct rxn_token *rxn_ptr;
+	LDBLE si, iap;
+
+	iap = 0.0;
+	if (phase_ptr->in != FALSE)
 	{
 		for (rxn_ptr = phase_ptr->rxn_x->token + 1; rxn_ptr->s != NULL;
 			 rxn_ptr++)
@@ -1677,20 +1720,31 @@ int Phreeqc::
 saturation_index(const char *phase_name, LDBLE * iap, LDBLE * si)
 /* ---------------------------------------------------------------------- */
 {
-	struct rxn_token *rxn_ptr;
 	struct phase *phase_ptr;
 	int l;
 
-	*si = -99.99;
-	*iap = 0.0;
 	phase_ptr = phase_bsearch(phase_name, &l, FALSE);
 	if (phase_ptr == NULL)
 	{
+		*iap = 0.0;
 		error_string = sformatf( "Mineral %s, not found.", phase_name);
 		warning_msg(error_string);
 		*si = -99;
+		return (OK);
 	}
-	else if (phase_ptr->in != FALSE)
+	return saturation_index(phase_ptr, iap, si);
+}
+
+/* ---------------------------------------------------------------------- */
+int Phreeqc::
+saturation_index(struct phase *phase_ptr, LDBLE * iap, LDBLE * si)
+/* ---------------------------------------------------------------------- */
+{
+	struct rxn_token *rxn_ptr;
+
+	*si = -99.99;
+	*iap = 0.0;
+	if (phase_ptr->in != FALSE)
 	{
 		for (rxn_ptr = phase_ptr->rxn_x->token + 1; rxn_ptr->s != NULL;
 			 rxn_ptr++)
@@ -2716,8 +2770,6 @@ total(const char *total_name)
 /* ---------------------------------------------------------------------- */
 {
 	struct master *master_ptr;
-	LDBLE t;
-	int i;
 
 	if (strcmp(total_name, "H") == 0)
 	{
@@ -2728,7 +2780,6 @@ total(const char *total_name)
 		return (total_o_x / mass_water_aq_x);
 	}
 	master_ptr = master_bsearch(total_name);
-	t = 0.0;
 	if (master_ptr == NULL)
 	{
 		if (strcmp_nocase(total_name, "water") == 0)
@@ -2744,11 +2795,23 @@ total(const char *total_name)
 	         total_name);
         warning_msg (error_string);
 */
+		return (0.0);
 	}
+	return total(master_ptr);
+}
+
+/* ---------------------------------------------------------------------- */
+LDBLE Phreeqc::
+total(struct master *master_ptr)
+/* ---------------------------------------------------------------------- */
+{
+	LDBLE t;
+	int i;
+
 /*
  *  Primary master species
  */
-	else if (master_ptr->primary == TRUE)
+	if (master_ptr->primary == TRUE)
 	{
 		/*
 		 *  Not a redox element
@@ -2786,8 +2849,6 @@ total_mole(const char *total_name)
 /* ---------------------------------------------------------------------- */
 {
 	struct master *master_ptr;
-	LDBLE t;
-	int i;
 
 	if (strcmp(total_name, "H") == 0)
 	{
@@ -2798,7 +2859,6 @@ total_mole(const char *total_name)
 		return (total_o_x);
 	}
 	master_ptr = master_bsearch(total_name);
-	t = 0.0;
 	if (master_ptr == NULL)
 	{
 		if (strcmp_nocase(total_name, "water") == 0)
@@ -2814,11 +2874,23 @@ total_mole(const char *total_name)
 	         total_name);
         warning_msg (error_string);
 */
+		return (0.0);
 	}
+	return total_mole(master_ptr);
+}
+
+/* ---------------------------------------------------------------------- */
+LDBLE Phreeqc::
+total_mole(struct master *master_ptr)
+/* ---------------------------------------------------------------------- */
+{
+	LDBLE t;
+	int i;
+
 /*
  *  Primary master species
  */
-	else if (master_ptr->primary == TRUE)
+	if (master_ptr->primary == TRUE)
 	{
 		/*
 		 *  Not a redox element
@@ -4386,6 +4458,12 @@ basic_run(char *commands, void *lnbase, void *vbase, void *lpbase)
 void Phreeqc::
 basic_free(void)
 {
+	std::map<const void *, PBasicProgram *>::iterator it = basic_programs.begin();
+	for (; it != basic_programs.end(); it++)
+	{
+		delete it->second;
+	}
+	basic_programs.clear();
 	delete this->basic_interpreter;
 }
 
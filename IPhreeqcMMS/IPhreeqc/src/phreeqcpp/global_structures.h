@@ -390,6 +390,43 @@ struct save
 	int n_ss_assemblage_user_end;
 };
 
+/*----------------------------------------------------------------------
+ *   Warm start, converged guesses of a saved solution
+ *---------------------------------------------------------------------- */
+struct warm_start_guess
+{
+	LDBLE mu;
+	LDBLE la_h2o;
+	cxxNameDouble la;			/* log activities, keyed by master species name */
+};
+
+/*----------------------------------------------------------------------
+ *   CVODE, Jacobian of a kinetics block kept between integrations
+ *---------------------------------------------------------------------- */
+struct cvode_jacobian
+{
+	std::vector<std::string> names;	/* rate names of the kinetics components */
+	long model;					/* tidy_rebuilds when the names were set */
+	std::vector<LDBLE> jac;		/* last Jacobian, column major */
+	long age;					/* steps taken with jac in finished integrations */
+	long nst, ncfn;				/* CVODE steps and convergence failures when jac was computed */
+	std::vector<char> nonzero;	/* nonzero pattern of the last full Jacobian */
+	std::vector<int> group;		/* reactants that do not share a nonzero row */
+	int count_groups;
+};
+
+/*----------------------------------------------------------------------
+ *   Aqueous species of a model that share an activity-coefficient formula
+ *---------------------------------------------------------------------- */
+struct gamma_batch
+{
+	int gflag;					/* 0 uncharged, 1 Davies, 2 D-H, 7 LLNL */
+	std::vector<struct species *> s;
+	std::vector<LDBLE> z, dha, dhb;
+	std::vector<LDBLE> lg;		/* log gamma at model_image_gamma_mu */
+	std::vector<LDBLE> dg_coef;	/* dg / moles at model_image_gamma_mu */
+};
+
 /*----------------------------------------------------------------------
  *   Copy
  *---------------------------------------------------------------------- */
@@ -1060,6 +1097,31 @@ struct M_S
 	const char *name;
 	LDBLE tot1, tot2, tot_stag, charge; /* master species transport in cells i and j */
 };
+struct CURRENT_CELLS
+{
+	LDBLE dif, ele, R; // diffusive and electric components, relative cell resistance
+};
+struct V_M   // For calculating Vinograd and McBain's zero-charge, diffusive tranfer of individual solutes
+{
+	LDBLE grad, D, z, c, zc, Dz, Dzc;
+	LDBLE b_ij; // harmonic mean of cell properties, with EDL enrichment
+};
+struct CT /* summed parts of V_M and mcd transfer in a timestep for all cells, for free + DL water */
+{
+	LDBLE kgw, dl_s, Dz2c, Dz2c_stag, visc1, visc2, J_ij_sum;
+	LDBLE A_ij_il, Dz2c_il, mixf_il;
+	int J_ij_count_spec, J_ij_il_count_spec;
+	struct V_M *v_m, *v_m_il;
+	struct J_ij *J_ij, *J_ij_il;
+	int count_m_s;
+	struct M_S *m_s;
+	int v_m_size, J_ij_size, m_s_size;
+};
+struct MOLES_ADDED /* total moles added to balance negative conc's */
+{
+	char *name;
+	LDBLE moles;
+};
 // Pitzer definitions
 typedef enum
 { TYPE_B0, TYPE_B1, TYPE_B2, TYPE_C0, TYPE_THETA, TYPE_LAMDA, TYPE_ZETA,
@@ -1105,6 +1167,41 @@ struct theta_param
 	LDBLE ethetap;
 };
 
+/*
+ *   Pitzer interaction term of the model, one per entry of param_list
+ */
+struct pitz_term
+{
+	int type;					/* pitz_param_type */
+	int i0, i1, i2;				/* spec indices */
+	int param;					/* index in pitz_params */
+	int alpha;					/* index in pitz_alphas, TYPE_B1 and TYPE_B2 */
+	int theta;					/* index in theta_params, TYPE_ETHETA */
+	LDBLE p;					/* parameter at the current temperature */
+	LDBLE coef[3];				/* ln_coef, or 2 sqrt(|z0 z1|) for TYPE_C0 */
+	LDBLE os_coef;
+};
+
+/*
+ *   Terms of the Pitzer sums that depend only on the ionic strength
+ */
+struct pitz_ionic
+{
+	LDBLE I, A0;				/* ionic strength and Debye-Huckel slope */
+	std::vector<LDBLE> g, gp, ex;	/* G, GP and exp(-alpha sqrt(I)) by pitz_alphas */
+	std::vector<LDBLE> etheta, ethetap;	/* by theta_params */
+};
+
+struct pitz_columns
+{
+	std::vector<int> in;		/* column of jacobian_pz is evaluated */
+	std::vector<LDBLE> I;		/* ionic strength by column */
+	std::vector<LDBLE> m;		/* M of s_list by column */
+	std::vector<int> iprsnt;	/* IPRSNT of s_list by column */
+	std::vector<LDBLE> lgamma;	/* LGAMMA of s_list by column */
+	std::vector<LDBLE> cosmot, aw;	/* by column */
+};
+
 struct const_iso
 {
 	const char *name;
@@ -1112,5 +1209,55 @@ struct const_iso
 	LDBLE uncertainty;
 };
 
+/*----------------------------------------------------------------------
+ *   Model cache, a prepared model set aside by prep for later reuse
+ *---------------------------------------------------------------------- */
+struct model_cache_entry
+{
+	struct model model;
+	/* unknowns, jacobian and mass-balance lists */
+	struct unknown **x;
+	int count_unknowns, max_unknowns;
+	LDBLE *my_array, *delta, *residual;
+	struct species **s_x;
+	int count_s_x, max_s_x;
+	struct list1 *sum_mb1;
+	int count_sum_mb1, max_sum_mb1;
+	struct list2 *sum_mb2;
+	int count_sum_mb2, max_sum_mb2;
+	struct list0 *sum_jacob0;
+	int count_sum_jacob0, max_sum_jacob0;
+	struct list1 *sum_jacob1;
+	int count_sum_jacob1, max_sum_jacob1;
+	struct list2 *sum_jacob2;
+	int count_sum_jacob2, max_sum_jacob2;
+	struct list2 *sum_delta;
+	int count_sum_delta, max_sum_delta;
+	struct species_list *species_list;
+	int count_species_list, max_species_list;
+	std::vector<struct unknown *> gas_unknowns;
+	struct unknown *mb_unknown, *ah2o_unknown, *mass_hydrogen_unknown,
+		*mass_oxygen_unknown, *mu_unknown, *alkalinity_unknown,
+		*carbon_unknown, *ph_unknown, *pe_unknown, *charge_balance_unknown,
+		*solution_phase_boundary_unknown, *pure_phase_unknown,
+		*exchange_unknown, *surface_unknown, *gas_unknown, *ss_unknown;
+	std::map < std::string, cxxChemRxn > pe_x;
+	std::string default_pe_x;
+	LDBLE gfw_water;
+	std::map<LDBLE, std::vector<LDBLE> > logk_tc_table;
+	/* model data of species, phases and masters, indexed as s, phases, master */
+	std::vector<int> s_in;
+	std::vector<struct reaction *> s_rxn_x;
+	std::vector<struct elt_list *> s_next_sys_total;
+	std::vector<LDBLE> s_dz;	/* 3 per species */
+	std::vector<int> phase_in;
+	std::vector<struct reaction *> phase_rxn_x;
+	std::vector<struct elt_list *> phase_next_sys_total;
+	std::vector<int> master_in, master_last_model, master_has_unknown;
+	std::vector<struct unknown *> master_unknown;
+	std::vector<const char *> master_pe_rxn;
+	std::vector<struct reaction *> master_rxn_secondary;
+};
+
 #endif /* _INC_GLOBAL_STRUCTURES_H  */
 
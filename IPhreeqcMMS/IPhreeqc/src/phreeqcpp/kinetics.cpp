@@ -1267,6 +1267,16 @@ set_and_run_wrapper(int i, int use_mix, int use_kinetics, int nsaver,
 	std::auto_ptr<cxxKinetics> kinetics_save(NULL);
 #endif
 	int restart = 0;
+	int warm_retry = FALSE;
+	/*
+	 *   Only reactions with exchangers, surfaces, phases, kinetics or
+	 *   irreversible reactions are warm started; a mix alone starts from
+	 *   the activities the mixed solutions carry
+	 */
+	bool warm = (warm_start == TRUE && state == REACTION && warm_start_n_user != -99
+		&& (use.Get_exchange_in() || use.Get_surface_in() || use.Get_pp_assemblage_in()
+		|| use.Get_gas_phase_in() || use.Get_ss_assemblage_in() || use.Get_kinetics_in()
+		|| use.Get_reaction_in()));
 	
 	small_pe_step = 5.;
 	small_step = 10.;
@@ -1491,7 +1501,7 @@ restart:
 			//	goto restart;
 			//}
 		}
-		if (j > 0)
+		if (j > 0 || warm_retry == TRUE)
 		{
 			if (pp_assemblage_save.get() != NULL)
 			{
@@ -1534,6 +1544,20 @@ restart:
 			}
 		}
 		set_and_run_attempt = j;
+		/*
+		 *   First attempt starts from the last converged guesses of the
+		 *   solution being saved, if any
+		 */
+		warm_start_ptr = NULL;
+		if (j == 0 && warm_retry == FALSE && warm)
+		{
+			std::map<int, struct warm_start_guess>::iterator wit =
+				warm_start_map.find(warm_start_n_user);
+			if (wit != warm_start_map.end())
+			{
+				warm_start_ptr = &(wit->second);
+			}
+		}
 
 		converge =
 			set_and_run(i, use_mix, use_kinetics, nsaver, step_fraction);
@@ -1549,6 +1573,18 @@ restart:
 		aqueous_only = 0;
 		negative_concentrations = FALSE;
 		always_full_pitzer = FALSE;
+		if (warm_start_ptr != NULL)
+		{
+			warm_start_ptr = NULL;
+			if (converge == FALSE)
+			{
+				/* retry first attempt with the usual guesses */
+				warm_start_fallbacks++;
+				warm_retry = TRUE;
+				j--;
+				continue;
+			}
+		}
 		if (converge == TRUE)
 		{
 			break;
@@ -1605,6 +1641,10 @@ restart:
 	{
 		return (MASS_BALANCE);
 	}
+	if (warm)
+	{
+		warm_start_save(warm_start_n_user);
+	}
 	return (OK);
 }
 
@@ -1695,6 +1735,8 @@ set_and_run(int i, int use_mix, int use_kinetics, int nsaver,
 		set(FALSE);
 		converge = model();
 	}
+	solve_count++;
+	solve_iterations += iterations;
 	sum_species();
 	viscosity();
 	return (converge);
@@ -2594,6 +2636,8 @@ run_reactions(int i, LDBLE kin_time, int use_mix, LDBLE step_fraction)
 			kinetics_ptr = Utilities::Rxn_find(Rxn_kinetics_map, i);
 			n_reactions = (int) kinetics_ptr->Get_kinetics_comps().size();
 			cvode_n_user = i;
+			/* batch reactions run on a copy numbered -2 */
+			cvode_jacobian_n_user = (i == -2) ? use.Get_n_kinetics_user() : i;
 			cvode_kinetics_ptr = (void *) kinetics_ptr;
 			cvode_n_reactions = n_reactions;
 			cvode_rate_sim_time_start = rate_sim_time_start;
@@ -2699,7 +2743,10 @@ run_reactions(int i, LDBLE kin_time, int use_mix, LDBLE step_fraction)
 			/*ropt[HMAX] = tout/10.; */
 			/*ropt[HMIN] = 1e-17; */
 			use_save = use;
+			cvode_integrations++;
+			cvode_jacobian_seeded = FALSE;
 			flag = CVode(kinetics_cvode_mem, tout, kinetics_y, &t, NORMAL);
+			cvode_integration_done(cvode_jacobian_n_user, iopt, flag == SUCCESS);
 			rate_sim_time = rate_sim_time_start + t;
 			/*
 			   printf("At t = %0.4e   y =%14.6e  %14.6e  %14.6e\n",
@@ -2779,6 +2826,7 @@ run_reactions(int i, LDBLE kin_time, int use_mix, LDBLE step_fraction)
 				}
 				flag =
 					CVode(kinetics_cvode_mem, tout1, kinetics_y, &t, NORMAL);
+				cvode_integration_done(cvode_jacobian_n_user, iopt, flag == SUCCESS);
 				/*
 				   error_string = sformatf( "CVode failed, flag=%d.\n", flag);
 				   error_msg(error_string, STOP);
@@ -2815,6 +2863,7 @@ run_reactions(int i, LDBLE kin_time, int use_mix, LDBLE step_fraction)
 				/*error_msg("FAIL 2 after successful integration in CVode", CONTINUE); */
 				warning_msg("FAIL 2 after successful integration in CVode");
 				flag = -1;
+				cvode_jacobian_map.erase(cvode_jacobian_n_user);
 				goto RESTART;
 			}
 			for (size_t j = 0; j < kinetics_ptr->Get_kinetics_comps().size(); j++)
@@ -3353,6 +3402,10 @@ Jac(integertype N, DenseMat J, RhsFn f, void *f_data,
 	LDBLE *initial_rates, del;
 	cxxKinetics *kinetics_ptr;
 	LDBLE step_fraction;
+	struct cvode_jacobian *jac_ptr;
+	CVodeMem cv_mem;
+	int count_groups;
+	bool grouped;
 
 	Phreeqc *pThis = (Phreeqc *) f_data;
 
@@ -3362,6 +3415,51 @@ Jac(integertype N, DenseMat J, RhsFn f, void *f_data,
 	kinetics_ptr = (cxxKinetics *) pThis->cvode_kinetics_ptr;
 	step_fraction = pThis->cvode_step_fraction;
 	pThis->rate_sim_time = pThis->cvode_rate_sim_time;
+	cv_mem = (CVodeMem) pThis->kinetics_cvode_mem;
+
+	/*
+	 *   Start an integration with the Jacobian kept from the last one
+	 */
+	jac_ptr = NULL;
+	if (pThis->cvode_jacobian_reuse_on)
+	{
+		jac_ptr = pThis->cvode_jacobian_find(pThis->cvode_jacobian_n_user, kinetics_ptr);
+		if (!pThis->cvode_jacobian_seeded &&
+			jac_ptr->jac.size() == (size_t) (n_reactions * n_reactions) &&
+			jac_ptr->age <= CVD_MSBJ)
+		{
+			pThis->cvode_jacobian_seeded = TRUE;
+			for (int i = 0; i < n_reactions; i++)
+			{
+				for (int j = 0; j < n_reactions; j++)
+				{
+					IJth(J, j + 1, i + 1) = jac_ptr->jac[i * n_reactions + j];
+				}
+			}
+			return;
+		}
+	}
+	pThis->cvode_jacobian_seeded = TRUE;
+	pThis->cvode_jac_evals++;
+
+	/*
+	 *   Reactants in one group have no nonzero row in common and are
+	 *   perturbed together, unless the corrector failed since the pattern was found
+	 */
+	std::vector<int> group(n_reactions);
+	for (int i = 0; i < n_reactions; i++)
+	{
+		group[i] = i;
+	}
+	count_groups = n_reactions;
+	grouped = false;
+	if (jac_ptr != NULL && jac_ptr->count_groups > 0 && jac_ptr->count_groups < n_reactions &&
+		cv_mem != NULL && cv_mem->cv_ncfn == jac_ptr->ncfn)
+	{
+		group = jac_ptr->group;
+		count_groups = jac_ptr->count_groups;
+		grouped = true;
+	}
 
 	initial_rates =
 		(LDBLE *) pThis->PHRQ_malloc ((size_t) n_reactions * sizeof(LDBLE));
@@ -3412,6 +3510,7 @@ Jac(integertype N, DenseMat J, RhsFn f, void *f_data,
 		return;
 	}
 	pThis->run_reactions_iterations += pThis->iterations;
+	(*nfePtr)++;
 	for (size_t i = 0; i < kinetics_ptr->Get_kinetics_comps().size(); i++)
 	{
 		cxxKineticsComp * kinetics_comp_ptr = &(kinetics_ptr->Get_kinetics_comps()[i]);
@@ -3423,9 +3522,8 @@ Jac(integertype N, DenseMat J, RhsFn f, void *f_data,
 		cxxKineticsComp * kinetics_comp_ptr = &(kinetics_ptr->Get_kinetics_comps()[i]);
 		initial_rates[i] = kinetics_comp_ptr->Get_moles();
 	}
-	for (size_t i = 0; i < kinetics_ptr->Get_kinetics_comps().size(); i++)
+	for (int g = 0; g < count_groups; g++)
 	{
-		cxxKineticsComp * kinetics_comp_i_ptr = &(kinetics_ptr->Get_kinetics_comps()[i]);
 		/* calculate reaction up to current time */
 		del = 1e-12;
 		pThis->cvode_error = TRUE;
@@ -3442,6 +3540,12 @@ Jac(integertype N, DenseMat J, RhsFn f, void *f_data,
 				 */
 				kinetics_comp_j_ptr->Set_moles(Ith(y, j + 1));
 				kinetics_comp_j_ptr->Set_m(pThis->m_original[j] - Ith(y, j + 1));
+			}
+			for (int i = 0; i < n_reactions; i++)
+			{
+				if (group[i] != g)
+					continue;
+				cxxKineticsComp * kinetics_comp_i_ptr = &(kinetics_ptr->Get_kinetics_comps()[i]);
 				if (kinetics_comp_i_ptr->Get_m() < 0)
 				{
 					/*
@@ -3458,15 +3562,15 @@ Jac(integertype N, DenseMat J, RhsFn f, void *f_data,
 					kinetics_comp_i_ptr->Set_moles(pThis->m_original[i]);
 					kinetics_comp_i_ptr->Set_m(0.0);
 				}
-			}
 
-			/* Add small amount of ith reaction */
-			kinetics_comp_i_ptr->Set_m(kinetics_comp_i_ptr->Get_m() - del);
-			if (kinetics_comp_i_ptr->Get_m() < 0)
-			{
-				kinetics_comp_i_ptr->Set_m(0);
+				/* Add small amount of ith reaction */
+				kinetics_comp_i_ptr->Set_m(kinetics_comp_i_ptr->Get_m() - del);
+				if (kinetics_comp_i_ptr->Get_m() < 0)
+				{
+					kinetics_comp_i_ptr->Set_m(0);
+				}
+				kinetics_comp_i_ptr->Set_moles(kinetics_comp_i_ptr->Get_moles() + del);
 			}
-			kinetics_comp_i_ptr->Set_moles(kinetics_comp_i_ptr->Get_moles() + del);
 			pThis->calc_final_kinetic_reaction(kinetics_ptr);
 			if (pThis->use.Get_pp_assemblage_ptr() != NULL)
 			{
@@ -3488,6 +3592,7 @@ Jac(integertype N, DenseMat J, RhsFn f, void *f_data,
 			}
 			pThis->cvode_error = FALSE;
 			pThis->run_reactions_iterations += pThis->iterations;
+			(*nfePtr)++;
 			/*kinetics_ptr->comps[i].moles -= del; */
 			for (size_t j = 0; j < kinetics_ptr->Get_kinetics_comps().size(); j++)
 			{
@@ -3498,11 +3603,21 @@ Jac(integertype N, DenseMat J, RhsFn f, void *f_data,
 
 			/* calculate new rates for df/dy[i] */
 			/* dfdx[i + 1] = 0.0; */
-			for (size_t j = 0; j < kinetics_ptr->Get_kinetics_comps().size(); j++)
+			for (int i = 0; i < n_reactions; i++)
 			{
-				cxxKineticsComp * kinetics_comp_ptr = &(kinetics_ptr->Get_kinetics_comps()[j]);
-				IJth(J, j + 1, i + 1) =
-					(kinetics_comp_ptr->Get_moles() - initial_rates[j]) / del;
+				if (group[i] != g)
+					continue;
+				for (size_t j = 0; j < kinetics_ptr->Get_kinetics_comps().size(); j++)
+				{
+					cxxKineticsComp * kinetics_comp_ptr = &(kinetics_ptr->Get_kinetics_comps()[j]);
+					if (grouped && !jac_ptr->nonzero[i * n_reactions + j])
+					{
+						IJth(J, j + 1, i + 1) = 0.0;
+						continue;
+					}
+					IJth(J, j + 1, i + 1) =
+						(kinetics_comp_ptr->Get_moles() - initial_rates[j]) / del;
+				}
 			}
 		}
 	}
@@ -3512,6 +3627,28 @@ Jac(integertype N, DenseMat J, RhsFn f, void *f_data,
 		kinetics_comp_ptr->Set_moles(0);
 	}
 	initial_rates = (LDBLE *) pThis->free_check_null(initial_rates);
+
+	/*
+	 *   Keep the Jacobian for the next integration of this kinetics block
+	 */
+	if (jac_ptr != NULL)
+	{
+		jac_ptr->jac.resize((size_t) (n_reactions * n_reactions));
+		for (int i = 0; i < n_reactions; i++)
+		{
+			for (int j = 0; j < n_reactions; j++)
+			{
+				jac_ptr->jac[i * n_reactions + j] = IJth(J, j + 1, i + 1);
+			}
+		}
+		jac_ptr->age = 0;
+		jac_ptr->nst = (cv_mem != NULL) ? cv_mem->cv_nst : 0;
+		if (!grouped)
+		{
+			jac_ptr->ncfn = (cv_mem != NULL) ? cv_mem->cv_ncfn : 0;
+			pThis->cvode_jacobian_groups(jac_ptr, n_reactions);
+		}
+	}
 	return;
 }
 
@@ -3537,6 +3674,112 @@ cvode_init(void)
 	cvode_ss_assemblage_save = NULL;
 	return;
 }
+/* ---------------------------------------------------------------------- */
+struct cvode_jacobian * Phreeqc::
+cvode_jacobian_find(int n_user, cxxKinetics *kinetics_ptr)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   Returns the Jacobian kept for kinetics n_user, emptied if the rates
+ *   or the model changed since it was computed
+ */
+	struct cvode_jacobian &jac_ref = cvode_jacobian_map[n_user];
+	std::vector<cxxKineticsComp> &comps = kinetics_ptr->Get_kinetics_comps();
+	bool same = (jac_ref.model == tidy_rebuilds && jac_ref.names.size() == comps.size());
+	for (size_t i = 0; same && i < comps.size(); i++)
+	{
+		same = (jac_ref.names[i] == comps[i].Get_rate_name());
+	}
+	if (!same)
+	{
+		jac_ref.names.clear();
+		for (size_t i = 0; i < comps.size(); i++)
+		{
+			jac_ref.names.push_back(comps[i].Get_rate_name());
+		}
+		jac_ref.model = tidy_rebuilds;
+		jac_ref.jac.clear();
+		jac_ref.nonzero.clear();
+		jac_ref.group.clear();
+		jac_ref.count_groups = 0;
+		jac_ref.age = 0;
+		jac_ref.nst = 0;
+		jac_ref.ncfn = 0;
+	}
+	return (&jac_ref);
+}
+/* ---------------------------------------------------------------------- */
+void Phreeqc::
+cvode_jacobian_groups(struct cvode_jacobian *jac_ptr, int n)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   Groups the columns of a full Jacobian so that no two columns in a
+ *   group have a nonzero in the same row; each group then needs only one
+ *   rate evaluation
+ */
+	std::vector<char> used;
+
+	jac_ptr->nonzero.resize((size_t) (n * n));
+	for (size_t k = 0; k < jac_ptr->nonzero.size(); k++)
+	{
+		jac_ptr->nonzero[k] = (jac_ptr->jac[k] != 0.0);
+	}
+	jac_ptr->group.assign((size_t) n, -1);
+	jac_ptr->count_groups = 0;
+	for (int i = 0; i < n; i++)
+	{
+		for (int g = 0; g <= jac_ptr->count_groups; g++)
+		{
+			if (g == jac_ptr->count_groups)
+			{
+				used.resize((size_t) ((g + 1) * n), 0);
+				jac_ptr->count_groups++;
+			}
+			bool fits = true;
+			for (int j = 0; fits && j < n; j++)
+			{
+				fits = !(jac_ptr->nonzero[i * n + j] && used[g * n + j]);
+			}
+			if (fits)
+			{
+				jac_ptr->group[i] = g;
+				for (int j = 0; j < n; j++)
+				{
+					if (jac_ptr->nonzero[i * n + j])
+						used[g * n + j] = 1;
+				}
+				break;
+			}
+		}
+	}
+}
+/* ---------------------------------------------------------------------- */
+void Phreeqc::
+cvode_integration_done(int n_user, long *iopt, bool converged)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   Adds the work of a CVODE call to the counters; the Jacobian of
+ *   kinetics n_user is kept for the next integration only if the
+ *   corrector converged on every step
+ */
+	cvode_f_evals += iopt[NFE];
+	cvode_factorizations += iopt[NSETUPS];
+	if (!cvode_jacobian_reuse_on)
+		return;
+	std::map<int, struct cvode_jacobian>::iterator it = cvode_jacobian_map.find(n_user);
+	if (it == cvode_jacobian_map.end())
+		return;
+	if (!converged || iopt[NCFN] > 0)
+	{
+		cvode_jacobian_map.erase(it);
+		return;
+	}
+	it->second.age += iopt[NST] - it->second.nst;
+	it->second.nst = 0;
+	it->second.ncfn = 0;
+}
 bool Phreeqc::
 cvode_update_reactants(int i, int nsaver, bool save_it)
 {
@@ -1077,6 +1077,11 @@ reactions(void)
  *  save data for saving solutions
  */
 	memcpy(&save_data, &save, sizeof(struct save));
+	/*
+	 *   Reaction steps save to -2; warm starts are kept for the solution
+	 *   the reaction is finally saved to
+	 */
+	warm_start_n_user = (save.solution == TRUE) ? save.n_solution_user : -99;
 	/*
 	 *Copy everything to -2
 	 */
@@ -1140,6 +1145,7 @@ reactions(void)
  *   save end of reaction
  */
 	memcpy(&save, &save_data, sizeof(struct save));
+	warm_start_n_user = -99;
 	if (use.Get_kinetics_in() == TRUE)
 	{
 		Utilities::Rxn_copy(Rxn_kinetics_map, -2, use.Get_n_kinetics_user());
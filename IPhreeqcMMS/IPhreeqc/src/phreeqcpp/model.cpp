@@ -650,31 +650,96 @@ gammas(LDBLE mu)
 	}
 
 /*
- *   Calculate activity coefficients
+ *   Aqueous activity coefficients, one formula per batch of the model
+ *   image.  lg and dg / moles depend only on mu and the temperature
+ *   constants, so they are kept until these change (by more than
+ *   gamma_mu_tolerance relative to mu).
  */
-	for (i = 0; i < count_s_x; i++)
+	if (!model_image_valid)
+	{
+		build_model_image();
+	}
+	if (!model_image_gamma_valid || a != model_image_gamma_a
+		|| b != model_image_gamma_b
+		|| a_llnl != model_image_gamma_llnl[0]
+		|| b_llnl != model_image_gamma_llnl[1]
+		|| bdot_llnl != model_image_gamma_llnl[2]
+		|| fabs(mu - model_image_gamma_mu) > gamma_mu_tolerance * mu)
+	{
+		for (size_t k = 0; k < model_image_gamma.size(); k++)
+		{
+			struct gamma_batch &batch = model_image_gamma[k];
+			int count = (int) batch.s.size();
+			const LDBLE *z = &batch.z[0];
+			const LDBLE *dha = &batch.dha[0];
+			const LDBLE *dhb = &batch.dhb[0];
+			LDBLE *lg = &batch.lg[0];
+			LDBLE *dg_coef = &batch.dg_coef[0];
+			switch (batch.gflag)
+			{
+			case 0:				/* uncharged */
+				for (i = 0; i < count; i++)
+				{
+					lg[i] = dhb[i] * mu;
+					dg_coef[i] = dhb[i] * LOG_10;
+				}
+				break;
+			case 1:				/* Davies */
+				for (i = 0; i < count; i++)
+				{
+					lg[i] = -z[i] * z[i] * a *
+						(muhalf / (1.0 + muhalf) - 0.3 * mu);
+					dg_coef[i] = c1 * z[i] * z[i];
+				}
+				break;
+			case 2:				/* Extended D-H, WATEQ D-H */
+				for (i = 0; i < count; i++)
+				{
+					LDBLE d = 1.0 + dha[i] * b * muhalf;
+					lg[i] = -a * muhalf * z[i] * z[i] / d + dhb[i] * mu;
+					dg_coef[i] = (c2 * z[i] * z[i] / (d * d) + dhb[i]) * LOG_10;
+				}
+				break;
+			case 7:				/* LLNL, charged species */
+				if (llnl_count_temp <= 0)
+				{
+					error_msg("LLNL_AQUEOUS_MODEL_PARAMETERS not defined.", STOP);
+				}
+				for (i = 0; i < count; i++)
+				{
+					LDBLE d = 1.0 + dha[i] * b_llnl * muhalf;
+					lg[i] = -a_llnl * muhalf * z[i] * z[i] / d + bdot_llnl * mu;
+					dg_coef[i] = (c2_llnl * z[i] * z[i] / (d * d) + bdot_llnl) * LOG_10;
+				}
+				break;
+			}
+		}
+		model_image_gamma_valid = true;
+		model_image_gamma_mu = mu;
+		model_image_gamma_a = a;
+		model_image_gamma_b = b;
+		model_image_gamma_llnl[0] = a_llnl;
+		model_image_gamma_llnl[1] = b_llnl;
+		model_image_gamma_llnl[2] = bdot_llnl;
+	}
+	for (size_t k = 0; k < model_image_gamma.size(); k++)
 	{
+		struct gamma_batch &batch = model_image_gamma[k];
+		int count = (int) batch.s.size();
+		for (i = 0; i < count; i++)
+		{
+			batch.s[i]->lg = batch.lg[i];
+			batch.s[i]->dg = batch.dg_coef[i] * batch.s[i]->moles;
+		}
+	}
+/*
+ *   Remaining species
+ */
+	for (size_t k = 0; k < model_image_gamma_other.size(); k++)
+	{
+		i = model_image_gamma_other[k];
 		switch (s_x[i]->gflag)
 		{
-		case 0:				/* uncharged */
-			s_x[i]->lg = s_x[i]->dhb * mu;
-			s_x[i]->dg = s_x[i]->dhb * LOG_10 * s_x[i]->moles;
-			break;
-		case 1:				/* Davies */
-			s_x[i]->lg = -s_x[i]->z * s_x[i]->z * a *
-				(muhalf / (1.0 + muhalf) - 0.3 * mu);
-			s_x[i]->dg = c1 * s_x[i]->z * s_x[i]->z * s_x[i]->moles;
-			break;
-		case 2:				/* Extended D-H, WATEQ D-H */
-			s_x[i]->lg = -a * muhalf * s_x[i]->z * s_x[i]->z /
-				(1.0 + s_x[i]->dha * b * muhalf) + s_x[i]->dhb * mu;
-			s_x[i]->dg = (c2 * s_x[i]->z * s_x[i]->z /
-						  ((1.0 + s_x[i]->dha * b * muhalf) * (1.0 +
-															   s_x[i]->dha *
-															   b * muhalf)) +
-						  s_x[i]->dhb) * LOG_10 * s_x[i]->moles;
-/*			if (mu_x < 1e-6) s_x[i]->dg = 0.0; */
-			break;
 		case 3:				/* Always 1.0 */
 			s_x[i]->lg = 0.0;
 			s_x[i]->dg = 0.0;
@@ -819,29 +884,11 @@ gammas(LDBLE mu)
 				s_x[i]->dg = 0.0;
 			}
 			break;
-		case 7:				/* LLNL */
+		case 7:				/* LLNL, uncharged species */
 			if (llnl_count_temp > 0)
 			{
-				if (s_x[i]->z == 0)
-				{
-					s_x[i]->lg = 0.0;
-					s_x[i]->dg = 0.0;
-				}
-				else
-				{
-					s_x[i]->lg = -a_llnl * muhalf * s_x[i]->z * s_x[i]->z /
-						(1.0 + s_x[i]->dha * b_llnl * muhalf) +
-						bdot_llnl * mu;
-					s_x[i]->dg =
-						(c2_llnl * s_x[i]->z * s_x[i]->z /
-						 ((1.0 + s_x[i]->dha * b_llnl * muhalf) * (1.0 +
-																   s_x[i]->
-																   dha *
-																   b_llnl *
-																   muhalf)) +
-						 bdot_llnl) * LOG_10 * s_x[i]->moles;
-					break;
-				}
+				s_x[i]->lg = 0.0;
+				s_x[i]->dg = 0.0;
 			}
 			else
 			{
@@ -1797,12 +1844,39 @@ ineq(int in_kode)
 	memcpy((void *) &(slnq_delta1[0]), (void *) &(zero[0]),
 		   (size_t) max_column_count * sizeof(LDBLE));
 #endif
+/*
+ *   Square system of equalities only, try LU before CL1
+ */
+	bool lu_solved = false;
+	ineq_solves++;
+	if (ineq_lu_on && k == 0 && m == 0 && l == n && n > 0)
+	{
+		if (ineq_lu(n, ineq_array, l_n2d, delta1) == OK)
+		{
+			lu_solved = true;
+			ineq_lu_solves++;
+			l_kode = 0;
+			l_iter = 0;
+			l_error = 0.0;
+		}
+		else
+		{
+			ineq_lu_rejects++;
+			if (debug_model == TRUE)
+			{
+				output_msg(sformatf( "LU solution rejected, using Cl1.\n"));
+			}
+		}
+	}
 /*
  *   Call CL1
  */
-	cl1(k, l, m, n,
-		l_nklmd, l_n2d, ineq_array,
-		&l_kode, ineq_tol, &l_iter, delta1, res, &l_error, cu, iu, is, FALSE);
+	if (!lu_solved)
+	{
+		cl1(k, l, m, n,
+			l_nklmd, l_n2d, ineq_array,
+			&l_kode, ineq_tol, &l_iter, delta1, res, &l_error, cu, iu, is, FALSE);
+	}
 /*   Set return_kode */
 	if (l_kode == 1)
 	{
@@ -1944,6 +2018,136 @@ ineq(int in_kode)
 	return (return_code);
 }
 
+#define INEQ_LU_PIVOT_RATIO 1e-13
+#define INEQ_LU_RESIDUAL 1e-10
+/* ---------------------------------------------------------------------- */
+int Phreeqc::
+ineq_lu(int n, LDBLE * a, int ncols, LDBLE * l_delta)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   Solves n equations in n unknowns, coefficients in the first n
+ *   columns of a and right-hand sides in column n, by LU decomposition
+ *   with partial pivoting. Each row is scaled by a power of 2 that
+ *   brings its largest coefficient near 1. Returns ERROR, with a and
+ *   l_delta unchanged, if a pivot is small relative to the largest
+ *   pivot or the residual of the scaled equations is not small
+ *   relative to their norm; ineq then uses cl1.
+ */
+	int i, j, k, m;
+	int n1 = n + 1;
+	int e;
+	LDBLE b, f, sum;
+	LDBLE pivot_min, pivot_max;
+	LDBLE a_norm, b_norm, x_norm, r_norm;
+
+	ineq_lu_work.resize((size_t) n * n1 + 2 * n);
+	LDBLE *lu = &ineq_lu_work[0];
+	LDBLE *scale = &ineq_lu_work[(size_t) n * n1];
+	LDBLE *x_lu = &ineq_lu_work[(size_t) n * n1 + n];
+/*
+ *   Copy and scale rows
+ */
+	for (i = 0; i < n; i++)
+	{
+		b = 0.0;
+		for (j = 0; j < n; j++)
+		{
+			if (fabs(a[i * ncols + j]) > b)
+				b = fabs(a[i * ncols + j]);
+		}
+		if (b == 0.0)
+			return (ERROR);
+		frexp(b, &e);
+		scale[i] = ldexp(1.0, -e);
+		for (j = 0; j <= n; j++)
+		{
+			lu[i * n1 + j] = a[i * ncols + j] * scale[i];
+		}
+	}
+/*
+ *   Factor, carrying the right-hand side along
+ */
+	pivot_min = pivot_max = 0.0;
+	for (k = 0; k < n; k++)
+	{
+		b = fabs(lu[k * n1 + k]);
+		m = k;
+		for (i = k + 1; i < n; i++)
+		{
+			if (fabs(lu[i * n1 + k]) > b)
+			{
+				b = fabs(lu[i * n1 + k]);
+				m = i;
+			}
+		}
+		if (k == 0 || b > pivot_max)
+			pivot_max = b;
+		if (k == 0 || b < pivot_min)
+			pivot_min = b;
+		if (!(pivot_min > INEQ_LU_PIVOT_RATIO * pivot_max))
+			return (ERROR);
+		if (m != k)
+		{
+			std::swap_ranges(&lu[k * n1 + k], &lu[k * n1 + n1], &lu[m * n1 + k]);
+		}
+		const LDBLE *pivot_row = &lu[k * n1];
+		for (i = k + 1; i < n; i++)
+		{
+			LDBLE *row = &lu[i * n1];
+			if (row[k] == 0.0)
+				continue;
+			f = row[k] / pivot_row[k];
+			for (j = k + 1; j <= n; j++)
+			{
+				row[j] -= f * pivot_row[j];
+			}
+		}
+	}
+/*
+ *   Back substitution
+ */
+	for (i = n - 1; i >= 0; i--)
+	{
+		const LDBLE *row = &lu[i * n1];
+		sum = row[n];
+		for (j = i + 1; j < n; j++)
+		{
+			sum -= row[j] * x_lu[j];
+		}
+		x_lu[i] = sum / row[i];
+	}
+/*
+ *   Check residuals of the scaled equations
+ */
+	a_norm = b_norm = x_norm = r_norm = 0.0;
+	for (j = 0; j < n; j++)
+	{
+		if (fabs(x_lu[j]) > x_norm)
+			x_norm = fabs(x_lu[j]);
+	}
+	for (i = 0; i < n; i++)
+	{
+		sum = a[i * ncols + n];
+		b = 0.0;
+		for (j = 0; j < n; j++)
+		{
+			sum -= a[i * ncols + j] * x_lu[j];
+			b += fabs(a[i * ncols + j]);
+		}
+		if (b * scale[i] > a_norm)
+			a_norm = b * scale[i];
+		if (fabs(a[i * ncols + n]) * scale[i] > b_norm)
+			b_norm = fabs(a[i * ncols + n]) * scale[i];
+		if (fabs(sum) * scale[i] > r_norm)
+			r_norm = fabs(sum) * scale[i];
+	}
+	if (!(r_norm <= INEQ_LU_RESIDUAL * (a_norm * x_norm + b_norm)))
+		return (ERROR);
+	memcpy((void *) l_delta, (void *) x_lu, (size_t) n * sizeof(LDBLE));
+	return (OK);
+}
+
 /* ---------------------------------------------------------------------- */
 int Phreeqc::
 jacobian_sums(void)
@@ -2371,7 +2575,6 @@ molalities(int allow_overflow)
  */
 	int i, j;
 	LDBLE total_g;
-	struct rxn_token *rxn_ptr;
 /*
  *   la for master species
  */
@@ -2393,45 +2596,55 @@ molalities(int allow_overflow)
 		s_h2o->tot_g_moles = s_h2o->moles;
 		s_h2o->tot_dh2o_moles = 0.0;
 	}
-	for (i = 0; i < count_s_x; i++)
+/*
+ *   la of the master species in the model image, which is rebuilt if
+ *   s_x or a mass-action equation changed since it was built
+ */
+	if (!model_image_valid)
 	{
-		if (s_x[i]->type > HPLUS && s_x[i]->type != EX
-			&& s_x[i]->type != SURF)
-			continue;
+		build_model_image();
+	}
+	int count_la = (int) model_image_la_s.size();
+	for (i = 0; i < count_la; i++)
+	{
+		model_image_la[i] = model_image_la_s[i]->la;
+	}
+	int count_image = (int) model_image_s.size();
+	const int *start = &model_image_start[0];
+	const int *master_index = model_image_master.empty() ? NULL : &model_image_master[0];
+	const LDBLE *coef = model_image_coef.empty() ? NULL : &model_image_coef[0];
+	const LDBLE *la = model_image_la.empty() ? NULL : &model_image_la[0];
+	for (i = 0; i < count_image; i++)
+	{
+		struct species *s_ptr = model_image_s[i];
 /*
  *   lm and moles for all aqueous species
  */
-		s_x[i]->lm = s_x[i]->lk - s_x[i]->lg;
-		for (rxn_ptr = s_x[i]->rxn_x->token + 1; rxn_ptr->s != NULL;
-			 rxn_ptr++)
+		LDBLE lm = s_ptr->lk - s_ptr->lg;
+		for (j = start[i]; j < start[i + 1]; j++)
 		{
-			s_x[i]->lm += rxn_ptr->s->la * rxn_ptr->coef;
-			/*
-			if (isnan(rxn_ptr->s->la))
-			{
-				fprintf(stderr,"molalities la %s %e\n", rxn_ptr->s->name, rxn_ptr->s->la);
-			}
-			*/
+			lm += la[master_index[j]] * coef[j];
 		}
-		if (s_x[i]->type == EX)
+		s_ptr->lm = lm;
+		if (s_ptr->type == EX)
 		{
-			s_x[i]->moles = Utilities::safe_exp(s_x[i]->lm * LOG_10);
+			s_ptr->moles = Utilities::safe_exp(s_ptr->lm * LOG_10);
 
 		}
-		else if (s_x[i]->type == SURF)
+		else if (s_ptr->type == SURF)
 		{
-			s_x[i]->moles = Utilities::safe_exp(s_x[i]->lm * LOG_10);
+			s_ptr->moles = Utilities::safe_exp(s_ptr->lm * LOG_10);
 
 		}
 		else
 		{
-			s_x[i]->moles = under(s_x[i]->lm) * mass_water_aq_x;
-			if (s_x[i]->moles / mass_water_aq_x > 100)
+			s_ptr->moles = under(s_ptr->lm) * mass_water_aq_x;
+			if (s_ptr->moles / mass_water_aq_x > 100)
 			{
 				log_msg(sformatf( "Overflow: %s\t%e\t%e\t%d\n",
-						   s_x[i]->name,
-						   (double) (s_x[i]->moles / mass_water_aq_x),
-						   (double) s_x[i]->lm, iterations));
+						   s_ptr->name,
+						   (double) (s_ptr->moles / mass_water_aq_x),
+						   (double) s_ptr->lm, iterations));
 
 				if (iterations >= 0 && allow_overflow == FALSE)
 				{
@@ -4831,6 +5044,8 @@ set(int initial)
 	s_eminus->la = -solution_ptr->Get_pe();
 	if (initial == TRUE)
 		initial_guesses();
+	else if (warm_start_ptr != NULL)
+		warm_start_apply();
 	if (dl_type_x != cxxSurface::NO_DL)
 		initial_surface_water();
 	revise_guesses();
@@ -5112,6 +5327,75 @@ revise_guesses(void)
 	return (OK);
 }
 
+/* ---------------------------------------------------------------------- */
+int Phreeqc::
+warm_start_apply(void)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   Replace guesses for la's of master species and ionic strength with
+ *   the values of the last converged calculation saved to the same solution
+ */
+	int i;
+	cxxNameDouble::const_iterator it;
+
+	mu_x = warm_start_ptr->mu;
+	s_h2o->la = warm_start_ptr->la_h2o;
+	for (i = 0; i < count_unknowns; i++)
+	{
+		if (x[i]->master == NULL || x[i]->master[0] == NULL)
+			continue;
+		it = warm_start_ptr->la.find(x[i]->master[0]->s->name);
+		if (it != warm_start_ptr->la.end())
+		{
+			x[i]->master[0]->s->la = it->second;
+		}
+	}
+	s_hplus->lm = s_hplus->la;
+	s_hplus->moles = exp(s_hplus->lm * LOG_10) * mass_water_aq_x;
+	warm_start_count++;
+	return (OK);
+}
+
+/* ---------------------------------------------------------------------- */
+int Phreeqc::
+warm_start_save(int n_user)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   Save converged la's of master species and ionic strength for
+ *   the next calculation saved to solution n_user
+ */
+	int i;
+	struct warm_start_guess &guess = warm_start_map[n_user];
+
+	guess.mu = mu_x;
+	guess.la_h2o = s_h2o->la;
+	guess.la.clear();
+	for (i = 0; i < count_unknowns; i++)
+	{
+		switch (x[i]->type)
+		{
+		case MB:
+		case ALK:
+		case CB:
+		case SOLUTION_PHASE_BOUNDARY:
+		case MH:
+		case EXCH:
+		case SURFACE:
+		case SURFACE_CB:
+		case SURFACE_CB1:
+		case SURFACE_CB2:
+			if (x[i]->master != NULL && x[i]->master[0] != NULL)
+			{
+				guess.la[x[i]->master[0]->s->name] = x[i]->master[0]->s->la;
+			}
+			break;
+		}
+	}
+	return (OK);
+}
+
 /* ---------------------------------------------------------------------- */
 int Phreeqc::
 sum_species(void)
@@ -5409,6 +5693,7 @@ free_model_allocs(void)
 	residual = (LDBLE *) free_check_null(residual);
 	s_x = (struct species **) free_check_null(s_x);
 	count_s_x = 0;
+	model_image_valid = false;
 	sum_mb1 = (struct list1 *) free_check_null(sum_mb1);
 	count_sum_mb1 = 0;
 	sum_mb2 = (struct list2 *) free_check_null(sum_mb2);
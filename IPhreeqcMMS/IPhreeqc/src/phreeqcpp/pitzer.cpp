@@ -10,7 +10,6 @@ int Phreeqc::
 pitzer_init(void)
 /* ---------------------------------------------------------------------- */
 {
-	int i;
 /*
  *      Initialization for pitzer
  */
@@ -29,11 +28,7 @@ pitzer_init(void)
 	ICON = TRUE;
 	OTEMP = -100.;
 	OPRESS = -100.;
-	for (i = 0; i < 23; i++)
-	{
-		BK[i] = 0.0;
-		DK[i] = 0.0;
-	}
+	pitz_param_tk_cache.clear();
 	pitzer_pe = FALSE;
 	VP = 0;
 	DW0 = 0;
@@ -60,6 +55,7 @@ pitzer_tidy(void)
 	*/
 	OTEMP = -100.;
 	OPRESS = -100.;
+	pitz_param_tk_cache.clear();
 	/*
 	 *  allocate pointers to species structures
 	 */
@@ -789,26 +785,47 @@ C
 		calc_pitz_param(pitz_params[i], TK, TR);
 	}
 #else
-	for (size_t j = 0; j < param_list.size(); j++)
-	{
-		int i = param_list[j];
-		calc_pitz_param(pitz_params[i], TK, TR);
-	}
-	if (aphi)
-	{
-		calc_pitz_param(aphi, TK, TR);
-	}
-	if (mcb0) 
+	/*
+	 *   Parameters of all pitz_params, and aphi last, are kept by TK, so
+	 *   that a new model or a return to an earlier temperature does not
+	 *   evaluate them again.
+	 */
+	std::map<LDBLE, std::vector<LDBLE> >::iterator it = pitz_param_tk_cache.find(TK);
+	size_t count_cached = (size_t) count_pitz_param + (aphi ? 1 : 0);
+	if (it != pitz_param_tk_cache.end() && it->second.size() == count_cached)
 	{
-		calc_pitz_param(mcb0, TK, TR);
+		const std::vector<LDBLE> &cached = it->second;
+		for (int i = 0; i < count_pitz_param; i++)
+		{
+			store_pitz_param(pitz_params[i], cached[i]);
+		}
+		if (aphi)
+		{
+			store_pitz_param(aphi, cached[count_pitz_param]);
+		}
 	}
-	if (mcb1)
+	else
 	{
-		calc_pitz_param(mcb1, TK, TR);
+		if (pitz_param_tk_cache.size() >= 64)
+		{
+			pitz_param_tk_cache.clear();
+		}
+		std::vector<LDBLE> &cached = pitz_param_tk_cache[TK];
+		cached.clear();
+		for (int i = 0; i < count_pitz_param; i++)
+		{
+			calc_pitz_param(pitz_params[i], TK, TR);
+			cached.push_back(pitz_params[i]->p);
+		}
+		if (aphi)
+		{
+			calc_pitz_param(aphi, TK, TR);
+			cached.push_back(aphi->p);
+		}
 	}
-	if (mcc0)
+	for (size_t j = 0; j < pitz_terms.size(); j++)
 	{
-		calc_pitz_param(mcc0, TK, TR);
+		pitz_terms[j].p = pitz_params[pitz_terms[j].param]->p;
 	}
 #endif
 	calc_dielectrics(TK - 273.15, patm_x);
@@ -838,6 +855,14 @@ calc_pitz_param(struct pitz_param *pz_ptr, LDBLE TK, LDBLE TR)
 				 pz_ptr->a[4] * (TK * TK - TR * TR)) +
 				 pz_ptr->a[5] * (1.e0 / (TK * TK) - 1.e0 / (TR * TR));
 	}
+	return store_pitz_param(pz_ptr, param);
+}
+
+/* ---------------------------------------------------------------------- */
+int Phreeqc::
+store_pitz_param(struct pitz_param *pz_ptr, LDBLE param)
+/* ---------------------------------------------------------------------- */
+{
 	pz_ptr->p = param;
 	switch (pz_ptr->type)
 	{
@@ -880,7 +905,7 @@ calc_pitz_param(struct pitz_param *pz_ptr, LDBLE TK, LDBLE TR)
 		break;
 	case TYPE_Other:
 	default:
-		error_msg("Should not be TYPE_Other in function calc_pitz_param",
+		error_msg("Should not be TYPE_Other in function store_pitz_param",
 				  STOP);
 		break;
 	}
@@ -1227,64 +1252,162 @@ int Phreeqc::
 pitzer(void)
 /* ---------------------------------------------------------------------- */
 {
-	int i, i0, i1, i2;
-	LDBLE param, l_alpha, z0, z1;
-	LDBLE etheta, ethetap;
-	/*
-	   LDBLE CONV, XI, XX, OSUM, BIGZ, DI, F, XXX, GAMCLM, 
-	   CSUM, PHIMAC, OSMOT, BMXP, ETHEAP, CMX, BMX, PHI,
-	   BMXPHI, PHIPHI, AW, A, B;
-	 */
-	LDBLE CONV, XX, OSUM, BIGZ, DI, F, F1, F2, F_var, XXX, GAMCLM, CSUM, PHIMAC, OSMOT,
-		B, B1, B2;
-	LDBLE I, TK;
+	LDBLE CONV, I, TK;
 	/*
 	   C
 	   C     INITIALIZE
 	   C
 	 */
 	CONV = 1.0 / LOG_10;
-	XX = 0.0;
-	OSUM = 0.0;
 	I = mu_x;
 	TK = tk_x;
-	/*      DH_AB(TK, &A, &B); */
 	/*
 	   C
 	   C     TRANSFER DATA FROM TO M
 	   C
 	 */
+	pitzer_molalities(M, IPRSNT);
+	/*
+	   C
+	   C     COMPUTE PITZER COEFFICIENTS' TEMPERATURE DEPENDENCE
+	   C
+	 */
+	PTEMP(TK);
+	pitzer_sums(M, IPRSNT, I, &pitz_ionic_x, LGAMMA, &COSMOT, &AW);
+	/*s_h2o->la=log10(AW); */
+	mu_x = I;
+	for (size_t j = 0; j < s_list.size(); j++)
+	{
+		int i = s_list[j];
+		spec[i]->lg_pitzer = LGAMMA[i] * CONV;
+	}
+	/*
+	 *I_X = I;
+	 *COSMOT_X = COSMOT;
+	 */
+	return (OK);
+}
+/* ---------------------------------------------------------------------- */
+void Phreeqc::
+pitzer_molalities(LDBLE *l_M, int *l_IPRSNT)
+/* ---------------------------------------------------------------------- */
+{
+	/*
+	 *  Molalities of the species in s_list for the Pitzer sums
+	 */
  	for (size_t j = 0; j < s_list.size(); j++)
  	{
- 		i = s_list[j];
-		IPRSNT[i] = FALSE;
-		M[i] = 0.0;
+ 		int i = s_list[j];
+		l_IPRSNT[i] = FALSE;
+		l_M[i] = 0.0;
 		if (spec[i] != NULL && spec[i]->in == TRUE)
 		{
 			if (spec[i]->type == EX ||
 				spec[i]->type == SURF || spec[i]->type == SURF_PSI)
 				continue;
-			M[i] = under(spec[i]->lm);
-			if (M[i] > MIN_TOTAL)
-				IPRSNT[i] = TRUE;
+			l_M[i] = under(spec[i]->lm);
+			if (l_M[i] > MIN_TOTAL)
+				l_IPRSNT[i] = TRUE;
 		}
 	}	
 	if (ICON == TRUE)
+	{
+		l_IPRSNT[IC] = TRUE;
+	}
+}
+/* ---------------------------------------------------------------------- */
+void Phreeqc::
+pitzer_column(int i)
+/* ---------------------------------------------------------------------- */
+{
+	/*
+	 *  Same as pitzer() for column i of jacobian_pz, from the sums
+	 *  evaluated by jacobian_pz_columns
+	 */
+	struct pitz_columns *c = &pitz_columns_x;
+	LDBLE CONV = 1.0 / LOG_10;
+	size_t count = s_list.size();
+	for (size_t j = 0; j < count; j++)
+	{
+		int k = s_list[j];
+		M[k] = c->m[i * count + j];
+		IPRSNT[k] = c->iprsnt[i * count + j];
+		LGAMMA[k] = c->lgamma[i * count + j];
+		spec[k]->lg_pitzer = LGAMMA[k] * CONV;
+	}
+	if (ICON == TRUE)
 	{
 		IPRSNT[IC] = TRUE;
 	}
+	COSMOT = c->cosmot[i];
+	AW = c->aw[i];
+}
+/* ---------------------------------------------------------------------- */
+void Phreeqc::
+pitzer_ionic(struct pitz_ionic *ionic, LDBLE I)
+/* ---------------------------------------------------------------------- */
+{
 	/*
-	   C
-	   C     COMPUTE PITZER COEFFICIENTS' TEMPERATURE DEPENDENCE
-	   C
+	 *  G, GP and exp(-alpha sqrt(I)) for each alpha of the model, and the
+	 *  ethetas, are kept until I or A0 change; the numerical derivatives
+	 *  of jacobian_pz evaluate most columns at the same I.
 	 */
-	PTEMP(TK);
+	if (ionic->I == I && ionic->A0 == A0 &&
+		ionic->g.size() == pitz_alphas.size() &&
+		ionic->etheta.size() == (size_t) count_theta_param)
+		return;
+	LDBLE DI = sqrt(I);
+	ionic->g.resize(pitz_alphas.size());
+	ionic->gp.resize(pitz_alphas.size());
+	ionic->ex.resize(pitz_alphas.size());
+	for (size_t k = 0; k < pitz_alphas.size(); k++)
+	{
+		LDBLE l_alpha = pitz_alphas[k];
+		ionic->g[k] = G(l_alpha * DI);
+		ionic->gp[k] = GP(l_alpha * DI);
+		ionic->ex[k] = exp(-l_alpha * DI);
+	}
+	ionic->etheta.resize(count_theta_param);
+	ionic->ethetap.resize(count_theta_param);
+	if (use_etheta == TRUE)
+	{
+		for (int k = 0; k < count_theta_param; k++)
+		{
+			ETHETAS(theta_params[k]->zj, theta_params[k]->zk, I,
+				&ionic->etheta[k], &ionic->ethetap[k]);
+		}
+	}
+	ionic->I = I;
+	ionic->A0 = A0;
+}
+/* ---------------------------------------------------------------------- */
+int Phreeqc::
+pitzer_sums(const LDBLE *l_M, const int *l_IPRSNT, LDBLE I,
+			struct pitz_ionic *ionic, LDBLE *l_LGAMMA, LDBLE *cosmot, LDBLE *aw)
+/* ---------------------------------------------------------------------- */
+{
+	/*
+	 *  Pitzer sums for molalities l_M of the species in s_list, present
+	 *  where l_IPRSNT is TRUE, at ionic strength I.  Writes only l_LGAMMA,
+	 *  ionic, cosmot and aw.  pitzer passes M, LGAMMA and pitz_ionic_x;
+	 *  jacobian_pz_columns passes arrays of its own to each thread.
+	 */
+	int i, i0, i1, i2;
+	LDBLE param, z0;
+	LDBLE etheta, ethetap;
+	LDBLE XX, OSUM, BIGZ, DI, F, F1, F2, F_var, XXX, GAMCLM, CSUM, PHIMAC, OSMOT,
+		B, B1, B2;
+	LDBLE TK;
+
+	XX = 0.0;
+	OSUM = 0.0;
+	TK = tk_x;
 	for (size_t j = 0; j < s_list.size(); j++)
 	{
 		int i = s_list[j];
-		LGAMMA[i] = 0.0;
-		XX = XX + M[i] * fabs(spec[i]->z);
-		OSUM = OSUM + M[i];
+		l_LGAMMA[i] = 0.0;
+		XX = XX + l_M[i] * fabs(spec[i]->z);
+		OSUM = OSUM + l_M[i];
 	}
 	/*
 	   C
@@ -1328,132 +1451,86 @@ pitzer(void)
 	CSUM = 0.0;
 	OSMOT = -(A0) * pow(I, (LDBLE) 1.5) / (1.0 + B * DI);
 	/*
-	 *  Calculate ethetas
+	 *  Calculate G's and ethetas
 	 */
-	if (use_etheta == TRUE)
-	{
-		for (i = 0; i < count_theta_param; i++)
-		{
-			z0 = theta_params[i]->zj;
-			z1 = theta_params[i]->zk;
-			ETHETAS(z0, z1, I, &etheta, &ethetap);
-			theta_params[i]->etheta = etheta;
-			theta_params[i]->ethetap = ethetap;
-		}
-	}
+	pitzer_ionic(ionic, I);
 	/*
 	 *  Sums for F, LGAMMA, and OSMOT
 	 */
- 	for (size_t j = 0; j < param_list.size(); j++)
+ 	for (size_t j = 0; j < pitz_terms.size(); j++)
  	{
- 		int i = param_list[j];
-		i0 = pitz_params[i]->ispec[0];
-		i1 = pitz_params[i]->ispec[1];
-		z0 = spec[i0]->z;
-		z1 = spec[i1]->z;
-		param = pitz_params[i]->p;
-		l_alpha = pitz_params[i]->alpha;
+		const struct pitz_term *t = &pitz_terms[j];
+		i0 = t->i0;
+		i1 = t->i1;
+		param = t->p;
 		F_var = 0;
-		switch (pitz_params[i]->type)
+		switch (t->type)
 		{
 		case TYPE_B0:
-			LGAMMA[i0] += M[i1] * 2.0 * param;
-			LGAMMA[i1] += M[i0] * 2.0 * param;
-			OSMOT += M[i0] * M[i1] * param;
+			l_LGAMMA[i0] += l_M[i1] * 2.0 * param;
+			l_LGAMMA[i1] += l_M[i0] * 2.0 * param;
+			OSMOT += l_M[i0] * l_M[i1] * param;
 			break;
 		case TYPE_B1:
-			if (param != 0.0)
-			{
-				F_var = M[i0] * M[i1] * param * GP(l_alpha * DI) / I;
-				LGAMMA[i0] += M[i1] * 2.0 * param * G(l_alpha * DI);
-				LGAMMA[i1] += M[i0] * 2.0 * param * G(l_alpha * DI);
-				OSMOT += M[i0] * M[i1] * param * exp(-l_alpha * DI);
-			}
-			break;
 		case TYPE_B2:
 			if (param != 0.0)
 			{
-				F_var = M[i0] * M[i1] * param * GP(l_alpha * DI) / I;
-				LGAMMA[i0] += M[i1] * 2.0 * param * G(l_alpha * DI);
-				LGAMMA[i1] += M[i0] * 2.0 * param * G(l_alpha * DI);
-				OSMOT += M[i0] * M[i1] * param * exp(-l_alpha * DI);
+				F_var = l_M[i0] * l_M[i1] * param * ionic->gp[t->alpha] / I;
+				l_LGAMMA[i0] += l_M[i1] * 2.0 * param * ionic->g[t->alpha];
+				l_LGAMMA[i1] += l_M[i0] * 2.0 * param * ionic->g[t->alpha];
+				OSMOT += l_M[i0] * l_M[i1] * param * ionic->ex[t->alpha];
 			}
 			break;
 		case TYPE_C0:
-			CSUM +=
-				M[i0] * M[i1] * pitz_params[i]->p / (2.0 *
-													 sqrt(fabs(z0 * z1)));
-			LGAMMA[i0] += M[i1] * BIGZ * param / (2.0 * sqrt(fabs(z0 * z1)));
-			LGAMMA[i1] += M[i0] * BIGZ * param / (2.0 * sqrt(fabs(z0 * z1)));
-			OSMOT +=
-				M[i0] * M[i1] * BIGZ * param / (2.0 * sqrt(fabs(z0 * z1)));
+			CSUM += l_M[i0] * l_M[i1] * param / t->coef[0];
+			l_LGAMMA[i0] += l_M[i1] * BIGZ * param / t->coef[0];
+			l_LGAMMA[i1] += l_M[i0] * BIGZ * param / t->coef[0];
+			OSMOT += l_M[i0] * l_M[i1] * BIGZ * param / t->coef[0];
 			break;
 		case TYPE_THETA:
-			LGAMMA[i0] += 2.0 * M[i1] * (param /*+ ETHETA(z0, z1, I) */ );
-			LGAMMA[i1] += 2.0 * M[i0] * (param /*+ ETHETA(z0, z1, I) */ );
-			OSMOT += M[i0] * M[i1] * param;
+			l_LGAMMA[i0] += 2.0 * l_M[i1] * (param /*+ ETHETA(z0, z1, I) */ );
+			l_LGAMMA[i1] += 2.0 * l_M[i0] * (param /*+ ETHETA(z0, z1, I) */ );
+			OSMOT += l_M[i0] * l_M[i1] * param;
 			break;
 		case TYPE_ETHETA:
-			/*
-			   ETHETAS(z0, z1, I, &etheta, &ethetap);
-			 */
 			if (use_etheta == TRUE)
 			{
-				etheta = pitz_params[i]->thetas->etheta;
-				ethetap = pitz_params[i]->thetas->ethetap;
-				F_var = M[i0] * M[i1] * ethetap;
-				LGAMMA[i0] += 2.0 * M[i1] * etheta;
-				LGAMMA[i1] += 2.0 * M[i0] * etheta;
-				OSMOT += M[i0] * M[i1] * (etheta + I * ethetap);
+				etheta = ionic->etheta[t->theta];
+				ethetap = ionic->ethetap[t->theta];
+				F_var = l_M[i0] * l_M[i1] * ethetap;
+				l_LGAMMA[i0] += 2.0 * l_M[i1] * etheta;
+				l_LGAMMA[i1] += 2.0 * l_M[i0] * etheta;
+				OSMOT += l_M[i0] * l_M[i1] * (etheta + I * ethetap);
 			}
 			break;
 		case TYPE_PSI:
-			i2 = pitz_params[i]->ispec[2];
-			if (IPRSNT[i2] == FALSE)
+		case TYPE_ZETA:
+		case TYPE_ETA:
+			i2 = t->i2;
+			if (l_IPRSNT[i2] == FALSE)
 				continue;
-			LGAMMA[i0] += M[i1] * M[i2] * param;
-			LGAMMA[i1] += M[i0] * M[i2] * param;
-			LGAMMA[i2] += M[i0] * M[i1] * param;
-			OSMOT += M[i0] * M[i1] * M[i2] * param;
+			l_LGAMMA[i0] += l_M[i1] * l_M[i2] * param;
+			l_LGAMMA[i1] += l_M[i0] * l_M[i2] * param;
+			l_LGAMMA[i2] += l_M[i0] * l_M[i1] * param;
+			OSMOT += l_M[i0] * l_M[i1] * l_M[i2] * param;
 			break;
 		case TYPE_LAMDA:
-			LGAMMA[i0] += M[i1] * param * pitz_params[i]->ln_coef[0];
-			LGAMMA[i1] += M[i0] * param * pitz_params[i]->ln_coef[1];
-			OSMOT += M[i0] * M[i1] * param * pitz_params[i]->os_coef;
-			break;
-		case TYPE_ZETA:
-			i2 = pitz_params[i]->ispec[2];
-			if (IPRSNT[i2] == FALSE)
-				continue;
-			LGAMMA[i0] += M[i1] * M[i2] * param;
-			LGAMMA[i1] += M[i0] * M[i2] * param;
-			LGAMMA[i2] += M[i0] * M[i1] * param;
-			OSMOT += M[i0] * M[i1] * M[i2] * param;
+			l_LGAMMA[i0] += l_M[i1] * param * t->coef[0];
+			l_LGAMMA[i1] += l_M[i0] * param * t->coef[1];
+			OSMOT += l_M[i0] * l_M[i1] * param * t->os_coef;
 			break;
 		case TYPE_MU:
-			i2 = pitz_params[i]->ispec[2];
-			if (IPRSNT[i2] == FALSE)
+			i2 = t->i2;
+			if (l_IPRSNT[i2] == FALSE)
 				continue;
 
-			LGAMMA[i0] += M[i1] * M[i2] * param * pitz_params[i]->ln_coef[0];
-			LGAMMA[i1] += M[i0] * M[i2] * param * pitz_params[i]->ln_coef[1];
-			LGAMMA[i2] += M[i0] * M[i1] * param * pitz_params[i]->ln_coef[2];
-			OSMOT += M[i0] * M[i1] * M[i2] * param * pitz_params[i]->os_coef;
+			l_LGAMMA[i0] += l_M[i1] * l_M[i2] * param * t->coef[0];
+			l_LGAMMA[i1] += l_M[i0] * l_M[i2] * param * t->coef[1];
+			l_LGAMMA[i2] += l_M[i0] * l_M[i1] * param * t->coef[2];
+			OSMOT += l_M[i0] * l_M[i1] * l_M[i2] * param * t->os_coef;
 			break;
-		case TYPE_ETA:
-			i2 = pitz_params[i]->ispec[2];
-			if (IPRSNT[i2] == FALSE)
-				continue;
-			LGAMMA[i0] += M[i1] * M[i2] * param;
-			LGAMMA[i1] += M[i0] * M[i2] * param;
-			LGAMMA[i2] += M[i0] * M[i1] * param;
-			OSMOT += M[i0] * M[i1] * M[i2] * param;
-			break;
-		case TYPE_ALPHAS:
-			break;
-		case TYPE_Other:
 		default:
-			error_msg("TYPE_Other in pitz_param list.", STOP);
+			/* TYPE_ALPHAS; TYPE_Other is rejected by pitzer_make_lists */
 			break;
 		}
 		F += F_var;
@@ -1469,7 +1546,7 @@ pitzer(void)
 		int i = ion_list[j];
 		z0 = fabs(spec[i]->z);
 		F_var = (z0 == 1 ? F1 : (z0 == 2.0 ? F2 : F));
-		LGAMMA[i] += z0 * z0 * F_var + z0 * CSUM;
+		l_LGAMMA[i] += z0 * z0 * F_var + z0 * CSUM;
 	}
 	/*
 	   C
@@ -1478,7 +1555,7 @@ pitzer(void)
 	 */
 	if (ICON == TRUE)
 	{
-		PHIMAC = LGAMMA[IC] - GAMCLM;
+		PHIMAC = l_LGAMMA[IC] - GAMCLM;
 		/*
 		   C
 		   C     CORRECTED ERROR IN PHIMAC, NOVEMBER, 1989
@@ -1486,33 +1563,22 @@ pitzer(void)
 		 */
 		for (size_t j = 0; j < s_list.size(); j++)
 		{
-			int i = s_list[j];
-			LGAMMA[i] = LGAMMA[i] + spec[i]->z * PHIMAC;
+			i = s_list[j];
+			l_LGAMMA[i] = l_LGAMMA[i] + spec[i]->z * PHIMAC;
 		}
 	}
 
-	COSMOT = 1.0 + 2.0 * OSMOT / OSUM;
+	*cosmot = 1.0 + 2.0 * OSMOT / OSUM;
 	/*
 	   C
 	   C     CALCULATE THE ACTIVITY OF WATER
 	   C
 	 */
-	AW = exp(-OSUM * COSMOT / 55.50837);
+	*aw = exp(-OSUM * (*cosmot) / 55.50837);
 	/*
 	if (AW > 1.0)
 		AW = 1.0;
 	*/
-	/*s_h2o->la=log10(AW); */
-	mu_x = I;
-	for (size_t j = 0; j < s_list.size(); j++)
-	{
-		int i = s_list[j];
-		spec[i]->lg_pitzer = LGAMMA[i] * CONV;
-	}
-	/*
-	 *I_X = I;
-	 *COSMOT_X = COSMOT;
-	 */
 	return (OK);
 }
 #endif
@@ -1631,6 +1697,7 @@ C
       COMMON / MX8 / AK(0:20,2),BK(0:22),DK(0:22)
 */
    const LDBLE *AK;
+   LDBLE BK[21], DK[21];   /* local, so that threads can evaluate the sums */
    LDBLE L_Z = 0.0;
    LDBLE L_DZ = 0.0;
 
@@ -1651,6 +1718,7 @@ C
 
    BK[20] = AK[20];
    BK[19] = L_Z * AK[20] + AK[19];
+   DK[20] = 0.0;
    DK[19] = AK[20];
    for ( int i = 18; i >= 0; i-- )
    {
@@ -1988,6 +2056,7 @@ jacobian_pz(void)
 	LDBLE *base;
 	LDBLE d, d1, d2;
 	int i, j;
+	bool columns;
 
 	calculating_deriv = 1;
 Restart:
@@ -2009,93 +2078,28 @@ Restart:
 	d = 0.0001;
 	d1 = d * LOG_10;
 	d2 = 0;
-	for (i = 0; i < count_unknowns; i++)
+	/*
+	 *  Pitzer sums of the columns evaluated beforehand, on several threads
+	 */
+	columns = false;
+	if (full_pitzer == TRUE && parallel_jacobian_on &&
+		count_unknowns >= parallel_jacobian_threshold &&
+		use.Get_surface_ptr() == NULL && use.Get_gas_phase_ptr() == NULL &&
+		use.Get_ss_assemblage_ptr() == NULL)
 	{
-		switch (x[i]->type)
-		{
-		case MB:
-		case ALK:
-		case CB:
-		case SOLUTION_PHASE_BOUNDARY:
-		case EXCH:
-		case SURFACE:
-		case SURFACE_CB:
-		case SURFACE_CB1:
-		case SURFACE_CB2:
-			x[i]->master[0]->s->la += d;
-			//d2 = d1;
-			d2 = d * LOG_10;
-			break;
-		case AH2O:
-			x[i]->master[0]->s->la += d;
-			//d2 = d1;
-			d2 = d * LOG_10;
-			break;
-		case PITZER_GAMMA:
-			if (!full_pitzer) 
-				continue;
-			x[i]->s->lg += d;
-			d2 = d;
-			break;
-		case MH2O:
-			//mass_water_aq_x *= (1 + d);
-			//x[i]->master[0]->s->moles = mass_water_aq_x / gfw_water;
-			//d2 = log(1.0 + d);
-			//break;
-			// DL_pitz
-			d1 = mass_water_aq_x * d;
-			mass_water_aq_x += d1;
-			if (use.Get_surface_in() && dl_type_x == cxxSurface::DONNAN_DL)
-				mass_water_bulk_x += d1;
-			x[i]->master[0]->s->moles = mass_water_aq_x / gfw_water;
-			//d2 = log(1.0 + d);
-			d2 = d1;
-			break;
-		case MH:
-			if (pitzer_pe == TRUE)
-			{
-				s_eminus->la += d;
-				//d2 = d1;
-				d2 = d * LOG_10;
-				break;
-			}
-			else
-			{
-				continue;
-			}
-		case GAS_MOLES:
-			if (gas_in == FALSE)
-				continue;
-			d2 = d * x[i]->moles;
-			if (d2 < 1e-14)
-				d2 = 1e-14;
-			x[i]->moles += d2;
-			break;
-		case MU:
-			//continue;
-			d2 = d * mu_x;
-			mu_x += d2;
-			//k_temp(tc_x, patm_x);
+		if (jacobian_pz_columns(d, pz_max_unknowns) == ERROR)
+		{
+			base = (LDBLE *) free_check_null(base);
 			gammas_pz(false);
-			break;
-		case PP:
-			continue;
-			break;
-		case SS_MOLES:
-			//continue;
-			//break;
-			if (x[i]->ss_in == FALSE)
-				continue;
-			for (j = 0; j < count_unknowns; j++)
-			{
-				delta[j] = 0.0;
-			}
-			d2 = d * 10 * x[i]->moles;
-			delta[i] = d2;
-			reset();
-			d2 = delta[i];
-			break;
+			jacobian_sums();
+			goto Restart;
 		}
+		columns = true;
+	}
+	for (i = 0; i < count_unknowns; i++)
+	{
+		if (!jacobian_pz_perturb(i, d, &d1, &d2))
+			continue;
 		molalities(TRUE);
 		if (max_unknowns > pz_max_unknowns) 
 		{
@@ -2105,7 +2109,12 @@ Restart:
 			goto Restart;
 		}
 		if (full_pitzer == TRUE)
-			pitzer();
+		{
+			if (columns)
+				pitzer_column(i);
+			else
+				pitzer();
+		}
 		mb_sums();
 		residuals();
 		for (j = 0; j < count_unknowns; j++)
@@ -2114,55 +2123,11 @@ Restart:
 			if (x[i]->type == MH2O) // DL_pitz
 				my_array[j * (count_unknowns + 1) + i] *= mass_water_aq_x;
 		}
-		switch (x[i]->type)
-		{
-		case MB:
-		case ALK:
-		case CB:
-		case SOLUTION_PHASE_BOUNDARY:
-		case EXCH:
-		case SURFACE:
-		case SURFACE_CB:
-		case SURFACE_CB1:
-		case SURFACE_CB2:
-		case AH2O:
-			x[i]->master[0]->s->la -= d;
-			break;
-		case MH:
-			s_eminus->la -= d;
-			if (my_array[i * (count_unknowns + 1) + i] == 0)
-			{
-				my_array[i * (count_unknowns + 1) + i] =
-					exp(s_h2->lm * LOG_10) * 2;
-			}
-			break;
-		case PITZER_GAMMA:
-			x[i]->s->lg -= d;
-			break;
-		case MH2O:
-			//mass_water_aq_x /= (1 + d);
-			//x[i]->master[0]->s->moles = mass_water_aq_x / gfw_water;
-			//break;
-			//DL_pitz
-			mass_water_aq_x -= d1;
-			if (use.Get_surface_in() && dl_type_x == cxxSurface::DONNAN_DL)
-				mass_water_bulk_x -= d1;
-			x[i]->master[0]->s->moles = mass_water_aq_x / gfw_water;
-			break;
-		case MU:
-			mu_x -= d2;
-			//k_temp(tc_x, patm_x);
-			gammas_pz(false);
-			break;
-		case GAS_MOLES:
-			if (gas_in == FALSE)
-				continue;
-			x[i]->moles -= d2;
-			break;
-		case SS_MOLES:
-			delta[i] = -d2;
-			reset();
-			break;
+		jacobian_pz_unperturb(i, d, d1, d2);
+		if (x[i]->type == MH && my_array[i * (count_unknowns + 1) + i] == 0)
+		{
+			my_array[i * (count_unknowns + 1) + i] =
+				exp(s_h2->lm * LOG_10) * 2;
 		}
 	}
 	molalities(TRUE);
@@ -2174,6 +2139,289 @@ Restart:
 	calculating_deriv = 0;
 	return OK;
 }
+/* ---------------------------------------------------------------------- */
+bool Phreeqc::
+jacobian_pz_perturb(int i, LDBLE d, LDBLE *d1, LDBLE *d2)
+/* ---------------------------------------------------------------------- */
+{
+	/*
+	 *  Perturbs unknown i for column i of jacobian_pz; false if the
+	 *  column is skipped.  d2 is left as it is for other unknowns.
+	 */
+	int j;
+
+	switch (x[i]->type)
+	{
+	case MB:
+	case ALK:
+	case CB:
+	case SOLUTION_PHASE_BOUNDARY:
+	case EXCH:
+	case SURFACE:
+	case SURFACE_CB:
+	case SURFACE_CB1:
+	case SURFACE_CB2:
+		x[i]->master[0]->s->la += d;
+		//*d2 = *d1;
+		*d2 = d * LOG_10;
+		break;
+	case AH2O:
+		x[i]->master[0]->s->la += d;
+		//*d2 = *d1;
+		*d2 = d * LOG_10;
+		break;
+	case PITZER_GAMMA:
+		if (!full_pitzer) 
+			return false;
+		x[i]->s->lg += d;
+		*d2 = d;
+		break;
+	case MH2O:
+		//mass_water_aq_x *= (1 + d);
+		//x[i]->master[0]->s->moles = mass_water_aq_x / gfw_water;
+		//*d2 = log(1.0 + d);
+		//break;
+		// DL_pitz
+		*d1 = mass_water_aq_x * d;
+		mass_water_aq_x += *d1;
+		if (use.Get_surface_in() && dl_type_x == cxxSurface::DONNAN_DL)
+			mass_water_bulk_x += *d1;
+		x[i]->master[0]->s->moles = mass_water_aq_x / gfw_water;
+		//*d2 = log(1.0 + d);
+		*d2 = *d1;
+		break;
+	case MH:
+		if (pitzer_pe == TRUE)
+		{
+			s_eminus->la += d;
+			//*d2 = *d1;
+			*d2 = d * LOG_10;
+			break;
+		}
+		else
+		{
+			return false;
+		}
+	case GAS_MOLES:
+		if (gas_in == FALSE)
+			return false;
+		*d2 = d * x[i]->moles;
+		if (*d2 < 1e-14)
+			*d2 = 1e-14;
+		x[i]->moles += *d2;
+		break;
+	case MU:
+		//continue;
+		*d2 = d * mu_x;
+		mu_x += *d2;
+		//k_temp(tc_x, patm_x);
+		gammas_pz(false);
+		break;
+	case PP:
+		return false;
+		break;
+	case SS_MOLES:
+		//continue;
+		//break;
+		if (x[i]->ss_in == FALSE)
+			return false;
+		for (j = 0; j < count_unknowns; j++)
+		{
+			delta[j] = 0.0;
+		}
+		*d2 = d * 10 * x[i]->moles;
+		delta[i] = *d2;
+		reset();
+		*d2 = delta[i];
+		break;
+	}
+	return true;
+}
+/* ---------------------------------------------------------------------- */
+void Phreeqc::
+jacobian_pz_unperturb(int i, LDBLE d, LDBLE d1, LDBLE d2)
+/* ---------------------------------------------------------------------- */
+{
+	/*
+	 *  Undoes jacobian_pz_perturb for unknown i
+	 */
+	switch (x[i]->type)
+	{
+	case MB:
+	case ALK:
+	case CB:
+	case SOLUTION_PHASE_BOUNDARY:
+	case EXCH:
+	case SURFACE:
+	case SURFACE_CB:
+	case SURFACE_CB1:
+	case SURFACE_CB2:
+	case AH2O:
+		x[i]->master[0]->s->la -= d;
+		break;
+	case MH:
+		s_eminus->la -= d;
+		break;
+	case PITZER_GAMMA:
+		x[i]->s->lg -= d;
+		break;
+	case MH2O:
+		//mass_water_aq_x /= (1 + d);
+		//x[i]->master[0]->s->moles = mass_water_aq_x / gfw_water;
+		//break;
+		//DL_pitz
+		mass_water_aq_x -= d1;
+		if (use.Get_surface_in() && dl_type_x == cxxSurface::DONNAN_DL)
+			mass_water_bulk_x -= d1;
+		x[i]->master[0]->s->moles = mass_water_aq_x / gfw_water;
+		break;
+	case MU:
+		mu_x -= d2;
+		//k_temp(tc_x, patm_x);
+		gammas_pz(false);
+		break;
+	case GAS_MOLES:
+		x[i]->moles -= d2;
+		break;
+	case SS_MOLES:
+		delta[i] = -d2;
+		reset();
+		break;
+	}
+}
+/* ---------------------------------------------------------------------- */
+int Phreeqc::
+jacobian_pz_columns(LDBLE d, int pz_max_unknowns)
+/* ---------------------------------------------------------------------- */
+{
+	/*
+	 *  Gathers the molalities of every column of jacobian_pz, then
+	 *  evaluates the Pitzer sums of the columns, on several threads with
+	 *  OpenMP, into pitz_columns_x.  The sums write only their own arrays
+	 *  and the molalities do not depend on them, so the columns are the
+	 *  same as those of pitzer() called in turn.  The unknowns are
+	 *  perturbed in the same sequence as in jacobian_pz and the species
+	 *  are restored exactly afterwards.  ERROR if max_unknowns grows.
+	 */
+	struct pitz_columns *c = &pitz_columns_x;
+	int i, k;
+	LDBLE d1 = d * LOG_10, d2 = 0;
+	size_t count = s_list.size();
+	/*
+	 *  save the species the perturbations and molalities change
+	 */
+	std::vector<struct species *> saved_s(s_x, s_x + count_s_x);
+	for (i = 0; i < count_master; i++)
+	{
+		if (master[i]->in == REWRITE)
+			saved_s.push_back(master[i]->s);
+	}
+	for (i = 0; i < count_unknowns; i++)
+	{
+		if (x[i]->master != NULL && x[i]->master[0] != NULL)
+			saved_s.push_back(x[i]->master[0]->s);
+		if (x[i]->s != NULL)
+			saved_s.push_back(x[i]->s);
+	}
+	saved_s.push_back(s_eminus);
+	std::vector<LDBLE> saved(5 * saved_s.size());
+	for (size_t j = 0; j < saved_s.size(); j++)
+	{
+		saved[5 * j] = saved_s[j]->la;
+		saved[5 * j + 1] = saved_s[j]->lm;
+		saved[5 * j + 2] = saved_s[j]->lg;
+		saved[5 * j + 3] = saved_s[j]->dg;
+		saved[5 * j + 4] = saved_s[j]->moles;
+	}
+	LDBLE saved_mu_x = mu_x;
+	LDBLE saved_mass_water_aq_x = mass_water_aq_x;
+	LDBLE saved_mass_water_bulk_x = mass_water_bulk_x;
+
+	c->in.assign(count_unknowns, FALSE);
+	c->I.resize(count_unknowns);
+	c->m.resize(count_unknowns * count);
+	c->iprsnt.resize(count_unknowns * count);
+	c->lgamma.resize(count_unknowns * count);
+	c->cosmot.resize(count_unknowns);
+	c->aw.resize(count_unknowns);
+	int return_value = OK;
+	for (i = 0; i < count_unknowns; i++)
+	{
+		if (!jacobian_pz_perturb(i, d, &d1, &d2))
+			continue;
+		molalities(TRUE);
+		if (max_unknowns > pz_max_unknowns)
+		{
+			return_value = ERROR;
+			break;
+		}
+		pitzer_molalities(M, IPRSNT);
+		for (size_t j = 0; j < count; j++)
+		{
+			c->m[i * count + j] = M[s_list[j]];
+			c->iprsnt[i * count + j] = IPRSNT[s_list[j]];
+		}
+		c->I[i] = mu_x;
+		c->in[i] = TRUE;
+		jacobian_pz_unperturb(i, d, d1, d2);
+	}
+	for (size_t j = saved_s.size(); j-- > 0;)
+	{
+		saved_s[j]->la = saved[5 * j];
+		saved_s[j]->lm = saved[5 * j + 1];
+		saved_s[j]->lg = saved[5 * j + 2];
+		saved_s[j]->dg = saved[5 * j + 3];
+		saved_s[j]->moles = saved[5 * j + 4];
+	}
+	mu_x = saved_mu_x;
+	mass_water_aq_x = saved_mass_water_aq_x;
+	mass_water_bulk_x = saved_mass_water_bulk_x;
+	if (return_value == ERROR)
+		return ERROR;
+	/*
+	 *  Pitzer sums by column; each thread has its own arrays
+	 */
+	int size = IC + 1;
+	for (size_t j = 0; j < count; j++)
+	{
+		if (s_list[j] >= size)
+			size = s_list[j] + 1;
+	}
+	int n = count_unknowns;
+#if defined(USE_OPENMP)
+#pragma omp parallel
+#endif
+	{
+		std::vector<LDBLE> l_M(M, M + size);
+		std::vector<int> l_IPRSNT(IPRSNT, IPRSNT + size);
+		std::vector<LDBLE> l_LGAMMA(LGAMMA, LGAMMA + size);
+		struct pitz_ionic ionic = pitz_ionic_x;
+#if defined(USE_OPENMP)
+#pragma omp for schedule(dynamic)
+#endif
+		for (k = 0; k < n; k++)
+		{
+			if (!c->in[k])
+				continue;
+			for (size_t j = 0; j < count; j++)
+			{
+				l_M[s_list[j]] = c->m[k * count + j];
+				l_IPRSNT[s_list[j]] = c->iprsnt[k * count + j];
+			}
+			if (ICON == TRUE)
+			{
+				l_IPRSNT[IC] = TRUE;
+			}
+			pitzer_sums(&l_M[0], &l_IPRSNT[0], c->I[k], &ionic, &l_LGAMMA[0],
+				&c->cosmot[k], &c->aw[k]);
+			for (size_t j = 0; j < count; j++)
+			{
+				c->lgamma[k * count + j] = l_LGAMMA[s_list[j]];
+			}
+		}
+	}
+	return OK;
+}
 
 /* ---------------------------------------------------------------------- */
 int Phreeqc::
@@ -2695,4 +2943,56 @@ pitzer_make_lists(void)
 		}
 		param_list.push_back(i);
 	}
-}
\ No newline at end of file
+	/*
+	 *  Terms of the sums in pitzer_sums, in the order of param_list
+	 */
+	pitz_terms.clear();
+	pitz_alphas.clear();
+	pitz_ionic_x.I = -1.0;
+	for (size_t j = 0; j < param_list.size(); j++)
+	{
+		struct pitz_param *pz_ptr = pitz_params[param_list[j]];
+		struct pitz_term t;
+		t.type = pz_ptr->type;
+		t.i0 = pz_ptr->ispec[0];
+		t.i1 = pz_ptr->ispec[1];
+		t.i2 = pz_ptr->ispec[2];
+		t.param = param_list[j];
+		t.alpha = -1;
+		t.theta = -1;
+		t.p = pz_ptr->p;
+		t.coef[0] = pz_ptr->ln_coef[0];
+		t.coef[1] = pz_ptr->ln_coef[1];
+		t.coef[2] = pz_ptr->ln_coef[2];
+		t.os_coef = pz_ptr->os_coef;
+		switch (pz_ptr->type)
+		{
+		case TYPE_B1:
+		case TYPE_B2:
+			for (t.alpha = 0; t.alpha < (int) pitz_alphas.size(); t.alpha++)
+			{
+				if (pitz_alphas[t.alpha] == pz_ptr->alpha)
+					break;
+			}
+			if (t.alpha == (int) pitz_alphas.size())
+				pitz_alphas.push_back(pz_ptr->alpha);
+			break;
+		case TYPE_C0:
+			t.coef[0] = 2.0 * sqrt(fabs(spec[t.i0]->z * spec[t.i1]->z));
+			break;
+		case TYPE_ETHETA:
+			for (t.theta = 0; t.theta < count_theta_param; t.theta++)
+			{
+				if (theta_params[t.theta] == pz_ptr->thetas)
+					break;
+			}
+			break;
+		case TYPE_Other:
+			error_msg("TYPE_Other in pitz_param list.", STOP);
+			break;
+		default:
+			break;
+		}
+		pitz_terms.push_back(t);
+	}
+}
@@ -29,7 +29,15 @@ prep(void)
 
 	if (state >= REACTION)
 	{
+		int force_prep = last_model.force_prep;
 		same_model = check_same_model();
+		/*
+		 *   Look for a previously prepared model with the same components
+		 */
+		if (same_model == FALSE && force_prep == FALSE && model_cache_max > 0)
+		{
+			same_model = model_cache_find();
+		}
 	}
 	else
 	{
@@ -59,6 +67,10 @@ prep(void)
 	//	numerical_fixed_volume = false;
 	if (same_model == FALSE /*|| switch_numerical*/)
 	{
+		if (model_cache_live == TRUE)
+		{
+			model_cache_save();
+		}
 		clear();
 		setup_unknowns();
 /*
@@ -112,6 +124,14 @@ prep(void)
 		build_model();
 		adjust_setup_pure_phases();
 		adjust_setup_solution();
+/*
+ *   Reaction models without a diffuse layer can be set aside for reuse
+ */
+		model_cache_live = FALSE;
+		if (state >= REACTION && model_cache_max > 0 && dl_type_x == cxxSurface::NO_DL)
+		{
+			model_cache_live = TRUE;
+		}
 	}
 	else
 	{
@@ -1149,6 +1169,10 @@ build_model(void)
 		error_msg("Data base is missing H+, H2O, or e- species.", CONTINUE);
 		input_error++;
 	}
+/*
+ *   Mass-action equations are rewritten, log k's by temperature are void
+ */
+	logk_tc_table.clear();
 /*
  *   Make space for lists of pointers to species in the model
  */
@@ -1203,6 +1227,7 @@ build_model(void)
  *   Pick species in the model, determine reaction for model, build jacobian
  */
 	count_s_x = 0;
+	model_image_valid = false;
 	compute_gfw("H2O", &gfw_water);
 	gfw_water *= 0.001;
 	for (i = 0; i < count_s; i++)
@@ -1430,6 +1455,7 @@ build_model(void)
  *   Save model description
  */
 	save_model();
+	build_model_image();
 
 	if (input_error > 0)
 	{
@@ -1439,6 +1465,87 @@ build_model(void)
 }
 /* ---------------------------------------------------------------------- */
 int Phreeqc::
+build_model_image(void)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   Flattens the mass-action equations of the species in s_x that
+ *   molalities calculates into contiguous arrays: for each species the
+ *   coefficients and the index of each master species in model_image_la.
+ *   Terms keep the order of rxn_x, so sums are the same as summing rxn_x.
+ */
+	std::map<struct species *, int> la_index;
+	struct rxn_token *rxn_ptr;
+
+	model_image_s.clear();
+	model_image_start.clear();
+	model_image_master.clear();
+	model_image_coef.clear();
+	model_image_la_s.clear();
+	for (int i = 0; i < count_s_x; i++)
+	{
+		if (s_x[i]->type > HPLUS && s_x[i]->type != EX
+			&& s_x[i]->type != SURF)
+			continue;
+		model_image_s.push_back(s_x[i]);
+		model_image_start.push_back((int) model_image_coef.size());
+		for (rxn_ptr = s_x[i]->rxn_x->token + 1; rxn_ptr->s != NULL;
+			 rxn_ptr++)
+		{
+			std::map<struct species *, int>::iterator it = la_index.find(rxn_ptr->s);
+			if (it == la_index.end())
+			{
+				it = la_index.insert(std::make_pair(rxn_ptr->s, (int) model_image_la_s.size())).first;
+				model_image_la_s.push_back(rxn_ptr->s);
+			}
+			model_image_master.push_back(it->second);
+			model_image_coef.push_back(rxn_ptr->coef);
+		}
+	}
+	model_image_start.push_back((int) model_image_coef.size());
+	model_image_la.resize(model_image_la_s.size());
+/*
+ *   Aqueous species by activity-coefficient formula for gammas
+ */
+	model_image_gamma.clear();
+	model_image_gamma_other.clear();
+	model_image_gamma_valid = false;
+	for (int i = 0; i < count_s_x; i++)
+	{
+		int gflag = s_x[i]->gflag;
+		if ((gflag != 0 && gflag != 1 && gflag != 2 && gflag != 7)
+			|| (gflag == 7 && s_x[i]->z == 0))
+		{
+			model_image_gamma_other.push_back(i);
+			continue;
+		}
+		size_t j;
+		for (j = 0; j < model_image_gamma.size(); j++)
+		{
+			if (model_image_gamma[j].gflag == gflag)
+				break;
+		}
+		if (j == model_image_gamma.size())
+		{
+			model_image_gamma.push_back(gamma_batch());
+			model_image_gamma[j].gflag = gflag;
+		}
+		struct gamma_batch &batch = model_image_gamma[j];
+		batch.s.push_back(s_x[i]);
+		batch.z.push_back(s_x[i]->z);
+		batch.dha.push_back(s_x[i]->dha);
+		batch.dhb.push_back(s_x[i]->dhb);
+	}
+	for (size_t j = 0; j < model_image_gamma.size(); j++)
+	{
+		model_image_gamma[j].lg.resize(model_image_gamma[j].s.size());
+		model_image_gamma[j].dg_coef.resize(model_image_gamma[j].s.size());
+	}
+	model_image_valid = true;
+	return (OK);
+}
+/* ---------------------------------------------------------------------- */
+int Phreeqc::
 build_pure_phases(void)
 /* ---------------------------------------------------------------------- */
 {
@@ -2697,6 +2804,7 @@ reprep(void)
  *   Free arrays built in build_model
  */
 	s_x = (struct species **) free_check_null(s_x);
+	model_image_valid = false;
 	sum_mb1 = (struct list1 *) free_check_null(sum_mb1);
 	sum_mb2 = (struct list2 *) free_check_null(sum_mb2);
 	sum_jacob0 = (struct list0 *) free_check_null(sum_jacob0);
@@ -5749,6 +5857,7 @@ k_temp(LDBLE tc, LDBLE pa) /* pa - pressure in atm */
 	calc_vm(tc, pa);
 
 	mu_terms_in_logk = false;
+	const LDBLE *lk_tc = k_temp_table(tc);
 	for (i = 0; i < count_s_x; i++)
 	{
 		//if (s_x[i]->rxn_x->logk[vm_tc])
@@ -5757,7 +5866,7 @@ k_temp(LDBLE tc, LDBLE pa) /* pa - pressure in atm */
 		if (tc == current_tc && s_x[i]->rxn_x->logk[delta_v] == 0)
 			continue;
 		mu_terms_in_logk = true;
-		s_x[i]->lk = k_calc(s_x[i]->rxn_x->logk, tempk, pa * PASCAL_PER_ATM);
+		s_x[i]->lk = k_calc_pressure(lk_tc[i], s_x[i]->rxn_x->logk, tempk, pa * PASCAL_PER_ATM);
 	}
 /*
  *    Calculate log k for all pure phases
@@ -5771,7 +5880,7 @@ k_temp(LDBLE tc, LDBLE pa) /* pa - pressure in atm */
 				phases[i]->logk[vm0];
 			if (phases[i]->rxn_x->logk[delta_v])
 				mu_terms_in_logk = true;
-			phases[i]->lk = k_calc(phases[i]->rxn_x->logk, tempk, pa * PASCAL_PER_ATM);
+			phases[i]->lk = k_calc_pressure(lk_tc[count_s_x + i], phases[i]->rxn_x->logk, tempk, pa * PASCAL_PER_ATM);
 
 		}
 	}
@@ -5796,6 +5905,42 @@ k_temp(LDBLE tc, LDBLE pa) /* pa - pressure in atm */
 
 	return (OK);
 }
+/* ---------------------------------------------------------------------- */
+const LDBLE * Phreeqc::
+k_temp_table(LDBLE tc)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *  Returns the temperature part of log k at tc for s_x, followed by
+ *  phases, of the current model. Values are kept for logk_tc_max
+ *  temperatures, so that reactions alternating between temperatures
+ *  only need the pressure correction.
+ */
+	std::map<LDBLE, std::vector<LDBLE> >::iterator it = logk_tc_table.find(tc);
+	if (it != logk_tc_table.end() && (int) it->second.size() == count_s_x + count_phases)
+	{
+		return &it->second[0];
+	}
+	if ((int) logk_tc_table.size() >= logk_tc_max)
+	{
+		logk_tc_table.clear();
+	}
+	LDBLE tempk = tc + 273.15;
+	std::vector<LDBLE> &lk_tc = logk_tc_table[tc];
+	lk_tc.assign(count_s_x + count_phases, 0.0);
+	for (int i = 0; i < count_s_x; i++)
+	{
+		lk_tc[i] = k_calc_tc(s_x[i]->rxn_x->logk, tempk);
+	}
+	for (int i = 0; i < count_phases; i++)
+	{
+		if (phases[i]->in == TRUE)
+		{
+			lk_tc[count_s_x + i] = k_calc_tc(phases[i]->rxn_x->logk, tempk);
+		}
+	}
+	return &lk_tc[0];
+}
 
 /* ---------------------------------------------------------------------- */
 LDBLE Phreeqc::
@@ -5808,14 +5953,21 @@ k_calc(LDBLE * l_logk, LDBLE tempk, LDBLE presPa)
 	 *
 	 *   delta_v is in cm3/mol.
 	 */
+	return k_calc_pressure(k_calc_tc(l_logk, tempk), l_logk, tempk, presPa);
+}
+/* ---------------------------------------------------------------------- */
+LDBLE Phreeqc::
+k_calc_tc(LDBLE * l_logk, LDBLE tempk)
+/* ---------------------------------------------------------------------- */
+{
+	/*
+	 *   Calculates log k at specified temperature and reference pressure
+	 */
 
 	/* Molar energy */
 	LDBLE me = tempk * R_KJ_DEG_MOL;
 
-	/* Pressure difference */
-	LDBLE delta_p = presPa - REF_PRES_PASCAL;
-
-	/* Calculate new log k value for this temperature and pressure */
+	/* Calculate new log k value for this temperature */
 	LDBLE lk = l_logk[logK_T0] 
 		- l_logk[delta_h] * (298.15 - tempk) / (LOG_10 * me * 298.15)
 		+ l_logk[T_A1]
@@ -5824,6 +5976,23 @@ k_calc(LDBLE * l_logk, LDBLE tempk, LDBLE presPa)
 		+ l_logk[T_A4] * log10(tempk)
 		+ l_logk[T_A5] / (tempk * tempk)
 		+ l_logk[T_A6] * tempk * tempk;
+	return lk;
+}
+/* ---------------------------------------------------------------------- */
+LDBLE Phreeqc::
+k_calc_pressure(LDBLE lk, LDBLE * l_logk, LDBLE tempk, LDBLE presPa)
+/* ---------------------------------------------------------------------- */
+{
+	/*
+	 *   Corrects log k at reference pressure, lk, for pressure
+	 */
+
+	/* Molar energy */
+	LDBLE me = tempk * R_KJ_DEG_MOL;
+
+	/* Pressure difference */
+	LDBLE delta_p = presPa - REF_PRES_PASCAL;
+
 	if (delta_p > 0)
 		/* cm3 * J /mol = 1e-9 m3 * kJ /mol */
 		lk -= l_logk[delta_v] * 1E-9 * delta_p / (LOG_10 * me);
@@ -6064,6 +6233,18 @@ check_same_model(void)
 			continue;
 		return (FALSE);
 	}
+	return (check_same_model_reactants());
+}
+/* ---------------------------------------------------------------------- */
+int Phreeqc::
+check_same_model_reactants(void)
+/* ---------------------------------------------------------------------- */
+{
+	int i;
+/*
+ *   Compares gas phase, solid solutions, pure phases, and surface of use
+ *   with last_model; master species are checked in check_same_model
+ */
 /*
  *   Check gas_phase
  */
@@ -6224,6 +6405,455 @@ check_same_model(void)
 }
 /* ---------------------------------------------------------------------- */
 int Phreeqc::
+model_cache_find(void)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   Searches the cache of prepared models for one with the same master
+ *   species, gas phase, solid solutions, pure phases, and surface as the
+ *   current reaction. If found, the current model is saved to the cache,
+ *   the cached model is made current, and TRUE is returned.
+ */
+	int i;
+	struct model save_model;
+
+	if (dl_type_x != cxxSurface::NO_DL)
+		return (FALSE);
+	for (size_t n = 0; n < model_cache.size(); n++)
+	{
+		struct model_cache_entry *entry_ptr = model_cache[n];
+		if ((int) entry_ptr->s_in.size() != count_s ||
+			(int) entry_ptr->phase_in.size() != count_phases ||
+			(int) entry_ptr->master_in.size() != count_master)
+			continue;
+/*
+ *   Check master species
+ */
+		for (i = 0; i < count_master; i++)
+		{
+			if (master[i]->s == s_hplus || master[i]->s == s_h2o)
+				continue;
+			if (master[i]->total > MIN_TOTAL && entry_ptr->master_last_model[i] == TRUE
+				&& entry_ptr->master_has_unknown[i] == TRUE)
+				continue;
+			if (master[i]->total <= MIN_TOTAL && entry_ptr->master_last_model[i] == FALSE)
+				continue;
+			break;
+		}
+		if (i < count_master)
+			continue;
+/*
+ *   Check reactants against the cached model description
+ */
+		save_model = last_model;
+		last_model = entry_ptr->model;
+		int same = check_same_model_reactants();
+		entry_ptr->model = last_model;
+		last_model = save_model;
+		if (same == FALSE)
+			continue;
+/*
+ *   Swap current model for cached model
+ */
+		model_cache.erase(model_cache.begin() + n);
+		if (model_cache_live == TRUE)
+		{
+			model_cache_save();
+		}
+		model_cache_restore(entry_ptr);
+		model_cache_hits++;
+		return (TRUE);
+	}
+	model_cache_misses++;
+	return (FALSE);
+}
+/* ---------------------------------------------------------------------- */
+int Phreeqc::
+model_cache_save(void)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   Moves the current model, unknowns, lists, and model data of species,
+ *   phases, and masters to the front of the cache. The current model is
+ *   left empty; prep must rebuild or restore a model before it is used.
+ */
+	int i;
+	struct model_cache_entry *entry_ptr = new struct model_cache_entry;
+/*
+ *   Model description
+ */
+	entry_ptr->model = last_model;
+	entry_ptr->model.force_prep = FALSE;
+	last_model.exchange = NULL;
+	last_model.gas_phase = NULL;
+	last_model.ss_assemblage = NULL;
+	last_model.pp_assemblage = NULL;
+	last_model.add_formula = NULL;
+	last_model.si = NULL;
+	last_model.surface_comp = NULL;
+	last_model.surface_charge = NULL;
+/*
+ *   Unknowns and lists
+ */
+	entry_ptr->x = x;
+	entry_ptr->count_unknowns = count_unknowns;
+	entry_ptr->max_unknowns = max_unknowns;
+	x = NULL;
+	count_unknowns = 0;
+	max_unknowns = 0;
+	entry_ptr->my_array = my_array;
+	entry_ptr->delta = delta;
+	entry_ptr->residual = residual;
+	my_array = NULL;
+	delta = NULL;
+	residual = NULL;
+	entry_ptr->s_x = s_x;
+	entry_ptr->count_s_x = count_s_x;
+	entry_ptr->max_s_x = max_s_x;
+	s_x = NULL;
+	count_s_x = 0;
+	model_image_valid = false;
+	entry_ptr->sum_mb1 = sum_mb1;
+	entry_ptr->count_sum_mb1 = count_sum_mb1;
+	entry_ptr->max_sum_mb1 = max_sum_mb1;
+	sum_mb1 = NULL;
+	count_sum_mb1 = 0;
+	entry_ptr->sum_mb2 = sum_mb2;
+	entry_ptr->count_sum_mb2 = count_sum_mb2;
+	entry_ptr->max_sum_mb2 = max_sum_mb2;
+	sum_mb2 = NULL;
+	count_sum_mb2 = 0;
+	entry_ptr->sum_jacob0 = sum_jacob0;
+	entry_ptr->count_sum_jacob0 = count_sum_jacob0;
+	entry_ptr->max_sum_jacob0 = max_sum_jacob0;
+	sum_jacob0 = NULL;
+	count_sum_jacob0 = 0;
+	entry_ptr->sum_jacob1 = sum_jacob1;
+	entry_ptr->count_sum_jacob1 = count_sum_jacob1;
+	entry_ptr->max_sum_jacob1 = max_sum_jacob1;
+	sum_jacob1 = NULL;
+	count_sum_jacob1 = 0;
+	entry_ptr->sum_jacob2 = sum_jacob2;
+	entry_ptr->count_sum_jacob2 = count_sum_jacob2;
+	entry_ptr->max_sum_jacob2 = max_sum_jacob2;
+	sum_jacob2 = NULL;
+	count_sum_jacob2 = 0;
+	entry_ptr->sum_delta = sum_delta;
+	entry_ptr->count_sum_delta = count_sum_delta;
+	entry_ptr->max_sum_delta = max_sum_delta;
+	sum_delta = NULL;
+	count_sum_delta = 0;
+	entry_ptr->species_list = species_list;
+	entry_ptr->count_species_list = count_species_list;
+	entry_ptr->max_species_list = max_species_list;
+	species_list = NULL;
+	count_species_list = 0;
+	entry_ptr->gas_unknowns.swap(gas_unknowns);
+	gas_unknowns.clear();
+	entry_ptr->mb_unknown = mb_unknown;
+	entry_ptr->ah2o_unknown = ah2o_unknown;
+	entry_ptr->mass_hydrogen_unknown = mass_hydrogen_unknown;
+	entry_ptr->mass_oxygen_unknown = mass_oxygen_unknown;
+	entry_ptr->mu_unknown = mu_unknown;
+	entry_ptr->alkalinity_unknown = alkalinity_unknown;
+	entry_ptr->carbon_unknown = carbon_unknown;
+	entry_ptr->ph_unknown = ph_unknown;
+	entry_ptr->pe_unknown = pe_unknown;
+	entry_ptr->charge_balance_unknown = charge_balance_unknown;
+	entry_ptr->solution_phase_boundary_unknown = solution_phase_boundary_unknown;
+	entry_ptr->pure_phase_unknown = pure_phase_unknown;
+	entry_ptr->exchange_unknown = exchange_unknown;
+	entry_ptr->surface_unknown = surface_unknown;
+	entry_ptr->gas_unknown = gas_unknown;
+	entry_ptr->ss_unknown = ss_unknown;
+	entry_ptr->pe_x = pe_x;
+	entry_ptr->default_pe_x = default_pe_x;
+	entry_ptr->gfw_water = gfw_water;
+	entry_ptr->logk_tc_table.swap(logk_tc_table);
+/*
+ *   Species in model, mass-action equations are owned by the cache
+ */
+	entry_ptr->s_in.resize(count_s);
+	entry_ptr->s_rxn_x.resize(count_s, NULL);
+	entry_ptr->s_next_sys_total.resize(count_s, NULL);
+	entry_ptr->s_dz.resize(3 * count_s, 0.0);
+	for (i = 0; i < count_s; i++)
+	{
+		entry_ptr->s_in[i] = s[i]->in;
+		if (s[i]->in != TRUE)
+			continue;
+		entry_ptr->s_rxn_x[i] = s[i]->rxn_x;
+		entry_ptr->s_next_sys_total[i] = s[i]->next_sys_total;
+		s[i]->rxn_x = NULL;
+		s[i]->next_sys_total = NULL;
+		for (int j = 0; j < 3; j++)
+		{
+			entry_ptr->s_dz[3 * i + j] = s[i]->dz[j];
+		}
+	}
+/*
+ *   Phases in model
+ */
+	entry_ptr->phase_in.resize(count_phases);
+	entry_ptr->phase_rxn_x.resize(count_phases, NULL);
+	entry_ptr->phase_next_sys_total.resize(count_phases, NULL);
+	for (i = 0; i < count_phases; i++)
+	{
+		entry_ptr->phase_in[i] = phases[i]->in;
+		if (phases[i]->in != TRUE)
+			continue;
+		entry_ptr->phase_rxn_x[i] = phases[i]->rxn_x;
+		entry_ptr->phase_next_sys_total[i] = phases[i]->next_sys_total;
+		phases[i]->rxn_x = NULL;
+		phases[i]->next_sys_total = NULL;
+	}
+/*
+ *   Master species
+ */
+	entry_ptr->master_in.resize(count_master);
+	entry_ptr->master_last_model.resize(count_master);
+	entry_ptr->master_has_unknown.resize(count_master);
+	entry_ptr->master_unknown.resize(count_master);
+	entry_ptr->master_pe_rxn.resize(count_master);
+	entry_ptr->master_rxn_secondary.resize(count_master);
+	for (i = 0; i < count_master; i++)
+	{
+		entry_ptr->master_in[i] = master[i]->in;
+		entry_ptr->master_last_model[i] = master[i]->last_model;
+		if (master[i]->s->secondary != NULL)
+		{
+			entry_ptr->master_has_unknown[i] = (master[i]->s->secondary->unknown != NULL) ? TRUE : FALSE;
+		}
+		else
+		{
+			entry_ptr->master_has_unknown[i] = (master[i]->unknown != NULL) ? TRUE : FALSE;
+		}
+		entry_ptr->master_unknown[i] = master[i]->unknown;
+		entry_ptr->master_pe_rxn[i] = master[i]->pe_rxn;
+		entry_ptr->master_rxn_secondary[i] = master[i]->rxn_secondary;
+		master[i]->rxn_secondary = NULL;
+		master[i]->unknown = NULL;
+	}
+	model_cache_live = FALSE;
+/*
+ *   Most recently used first, drop least recently used
+ */
+	model_cache.insert(model_cache.begin(), entry_ptr);
+	while ((int) model_cache.size() > model_cache_max)
+	{
+		model_cache_entry_free(model_cache.back());
+		model_cache.pop_back();
+	}
+	return (OK);
+}
+/* ---------------------------------------------------------------------- */
+int Phreeqc::
+model_cache_restore(struct model_cache_entry *entry_ptr)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   Makes a cached model current and deletes the cache entry.
+ *   The current model must have been saved or freed.
+ */
+	int i;
+/*
+ *   Model description
+ */
+	last_model.exchange = (struct master **) free_check_null(last_model.exchange);
+	last_model.gas_phase = (struct phase **) free_check_null(last_model.gas_phase);
+	last_model.ss_assemblage = (const char **) free_check_null(last_model.ss_assemblage);
+	last_model.pp_assemblage = (struct phase **) free_check_null(last_model.pp_assemblage);
+	last_model.add_formula = (const char **) free_check_null(last_model.add_formula);
+	last_model.si = (LDBLE *) free_check_null(last_model.si);
+	last_model.surface_comp = (const char **) free_check_null(last_model.surface_comp);
+	last_model.surface_charge = (const char **) free_check_null(last_model.surface_charge);
+	last_model = entry_ptr->model;
+/*
+ *   Unknowns and lists
+ */
+	free_model_allocs();
+	species_list = (struct species_list *) free_check_null(species_list);
+	x = entry_ptr->x;
+	count_unknowns = entry_ptr->count_unknowns;
+	max_unknowns = entry_ptr->max_unknowns;
+	my_array = entry_ptr->my_array;
+	delta = entry_ptr->delta;
+	residual = entry_ptr->residual;
+	s_x = entry_ptr->s_x;
+	count_s_x = entry_ptr->count_s_x;
+	max_s_x = entry_ptr->max_s_x;
+	sum_mb1 = entry_ptr->sum_mb1;
+	count_sum_mb1 = entry_ptr->count_sum_mb1;
+	max_sum_mb1 = entry_ptr->max_sum_mb1;
+	sum_mb2 = entry_ptr->sum_mb2;
+	count_sum_mb2 = entry_ptr->count_sum_mb2;
+	max_sum_mb2 = entry_ptr->max_sum_mb2;
+	sum_jacob0 = entry_ptr->sum_jacob0;
+	count_sum_jacob0 = entry_ptr->count_sum_jacob0;
+	max_sum_jacob0 = entry_ptr->max_sum_jacob0;
+	sum_jacob1 = entry_ptr->sum_jacob1;
+	count_sum_jacob1 = entry_ptr->count_sum_jacob1;
+	max_sum_jacob1 = entry_ptr->max_sum_jacob1;
+	sum_jacob2 = entry_ptr->sum_jacob2;
+	count_sum_jacob2 = entry_ptr->count_sum_jacob2;
+	max_sum_jacob2 = entry_ptr->max_sum_jacob2;
+	sum_delta = entry_ptr->sum_delta;
+	count_sum_delta = entry_ptr->count_sum_delta;
+	max_sum_delta = entry_ptr->max_sum_delta;
+	species_list = entry_ptr->species_list;
+	count_species_list = entry_ptr->count_species_list;
+	max_species_list = entry_ptr->max_species_list;
+	gas_unknowns.swap(entry_ptr->gas_unknowns);
+	mb_unknown = entry_ptr->mb_unknown;
+	ah2o_unknown = entry_ptr->ah2o_unknown;
+	mass_hydrogen_unknown = entry_ptr->mass_hydrogen_unknown;
+	mass_oxygen_unknown = entry_ptr->mass_oxygen_unknown;
+	mu_unknown = entry_ptr->mu_unknown;
+	alkalinity_unknown = entry_ptr->alkalinity_unknown;
+	carbon_unknown = entry_ptr->carbon_unknown;
+	ph_unknown = entry_ptr->ph_unknown;
+	pe_unknown = entry_ptr->pe_unknown;
+	charge_balance_unknown = entry_ptr->charge_balance_unknown;
+	solution_phase_boundary_unknown = entry_ptr->solution_phase_boundary_unknown;
+	pure_phase_unknown = entry_ptr->pure_phase_unknown;
+	exchange_unknown = entry_ptr->exchange_unknown;
+	surface_unknown = entry_ptr->surface_unknown;
+	gas_unknown = entry_ptr->gas_unknown;
+	ss_unknown = entry_ptr->ss_unknown;
+	pe_x.swap(entry_ptr->pe_x);
+	default_pe_x = entry_ptr->default_pe_x;
+	gfw_water = entry_ptr->gfw_water;
+	logk_tc_table.swap(entry_ptr->logk_tc_table);
+/*
+ *   Species in model
+ */
+	for (i = 0; i < count_s; i++)
+	{
+		s[i]->in = entry_ptr->s_in[i];
+		if (entry_ptr->s_in[i] != TRUE)
+			continue;
+		rxn_free(s[i]->rxn_x);
+		s[i]->rxn_x = entry_ptr->s_rxn_x[i];
+		s[i]->next_sys_total =
+			(struct elt_list *) free_check_null(s[i]->next_sys_total);
+		s[i]->next_sys_total = entry_ptr->s_next_sys_total[i];
+		for (int j = 0; j < 3; j++)
+		{
+			s[i]->dz[j] = entry_ptr->s_dz[3 * i + j];
+		}
+	}
+/*
+ *   Phases in model
+ */
+	for (i = 0; i < count_phases; i++)
+	{
+		phases[i]->in = entry_ptr->phase_in[i];
+		if (entry_ptr->phase_in[i] != TRUE)
+			continue;
+		rxn_free(phases[i]->rxn_x);
+		phases[i]->rxn_x = entry_ptr->phase_rxn_x[i];
+		phases[i]->next_sys_total =
+			(struct elt_list *) free_check_null(phases[i]->next_sys_total);
+		phases[i]->next_sys_total = entry_ptr->phase_next_sys_total[i];
+	}
+/*
+ *   Master species
+ */
+	for (i = 0; i < count_master; i++)
+	{
+		master[i]->in = entry_ptr->master_in[i];
+		master[i]->last_model = entry_ptr->master_last_model[i];
+		master[i]->unknown = entry_ptr->master_unknown[i];
+		master[i]->pe_rxn = entry_ptr->master_pe_rxn[i];
+		rxn_free(master[i]->rxn_secondary);
+		master[i]->rxn_secondary = entry_ptr->master_rxn_secondary[i];
+	}
+	delete entry_ptr;
+/*
+ *   log k values of the mass-action equations must be recalculated
+ */
+	sum_species_map_db.clear();
+	sum_species_map.clear();
+	current_tc = NAN;
+	current_pa = NAN;
+	current_mu = NAN;
+	mu_terms_in_logk = true;
+	model_cache_live = TRUE;
+	build_model_image();
+	return (OK);
+}
+/* ---------------------------------------------------------------------- */
+int Phreeqc::
+model_cache_entry_free(struct model_cache_entry *entry_ptr)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   Frees space owned by a cache entry and the entry
+ */
+	int i;
+	if (entry_ptr == NULL)
+		return (ERROR);
+	free_check_null(entry_ptr->model.exchange);
+	free_check_null(entry_ptr->model.gas_phase);
+	free_check_null(entry_ptr->model.ss_assemblage);
+	free_check_null(entry_ptr->model.pp_assemblage);
+	free_check_null(entry_ptr->model.add_formula);
+	free_check_null(entry_ptr->model.si);
+	free_check_null(entry_ptr->model.surface_comp);
+	free_check_null(entry_ptr->model.surface_charge);
+	if (entry_ptr->x != NULL)
+	{
+		for (i = 0; i < entry_ptr->max_unknowns; i++)
+		{
+			unknown_free(entry_ptr->x[i]);
+		}
+	}
+	free_check_null(entry_ptr->x);
+	free_check_null(entry_ptr->my_array);
+	free_check_null(entry_ptr->delta);
+	free_check_null(entry_ptr->residual);
+	free_check_null(entry_ptr->s_x);
+	free_check_null(entry_ptr->sum_mb1);
+	free_check_null(entry_ptr->sum_mb2);
+	free_check_null(entry_ptr->sum_jacob0);
+	free_check_null(entry_ptr->sum_jacob1);
+	free_check_null(entry_ptr->sum_jacob2);
+	free_check_null(entry_ptr->sum_delta);
+	free_check_null(entry_ptr->species_list);
+	for (i = 0; i < (int) entry_ptr->s_rxn_x.size(); i++)
+	{
+		rxn_free(entry_ptr->s_rxn_x[i]);
+		free_check_null(entry_ptr->s_next_sys_total[i]);
+	}
+	for (i = 0; i < (int) entry_ptr->phase_rxn_x.size(); i++)
+	{
+		rxn_free(entry_ptr->phase_rxn_x[i]);
+		free_check_null(entry_ptr->phase_next_sys_total[i]);
+	}
+	for (i = 0; i < (int) entry_ptr->master_rxn_secondary.size(); i++)
+	{
+		rxn_free(entry_ptr->master_rxn_secondary[i]);
+	}
+	delete entry_ptr;
+	return (OK);
+}
+/* ---------------------------------------------------------------------- */
+int Phreeqc::
+model_cache_free(void)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   Frees all cached models; the current model is not changed
+ */
+	for (size_t i = 0; i < model_cache.size(); i++)
+	{
+		model_cache_entry_free(model_cache[i]);
+	}
+	model_cache.clear();
+	return (OK);
+}
+/* ---------------------------------------------------------------------- */
+int Phreeqc::
 build_min_exch(void)
 /* ---------------------------------------------------------------------- */
 {
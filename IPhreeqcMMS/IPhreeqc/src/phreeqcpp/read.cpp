@@ -29,45 +29,7 @@ read_input(void)
 	char token[2 * MAX_LENGTH];
 #define LAST_C_KEYWORD 61
 
-	parse_error = 0;
-	input_error = 0;
-	next_keyword = Keywords::KEY_NONE;
-	count_warnings = 0;
-
-	Rxn_new_exchange.clear();
-	Rxn_new_gas_phase.clear();
-	Rxn_new_kinetics.clear();      // not used
-	Rxn_new_mix.clear();           // not used
-	Rxn_new_pp_assemblage.clear();
-	Rxn_new_pressure.clear();      // not used
-	Rxn_new_reaction.clear();      // not used
-	Rxn_new_solution.clear();
-	Rxn_new_ss_assemblage.clear();
-	Rxn_new_surface.clear();
-	Rxn_new_temperature.clear();   // not used
-	phrq_io->Set_echo_on(true);
-/*
- *  Initialize keyword counters
- */
-	for (i = 0; i < Keywords::KEY_COUNT_KEYWORDS; i++)
-	{
-		keycount[i] = 0;
-	}
-/*
- *  Initialize use and save pointers
- */
-	use.init();
-
-	save.solution = FALSE;
-	save.mix = FALSE;
-	save.reaction = FALSE;
-	save.kinetics = FALSE;
-	save.pp_assemblage = FALSE;
-	save.exchange = FALSE;
-	save.surface = FALSE;
-	save.gas_phase = FALSE;
-	save.ss_assemblage = FALSE;
-	title_x = (char *) free_check_null(title_x);
+	init_read_input();
 
 	while ((i =	check_line("Subroutine Read", FALSE, TRUE, TRUE, TRUE)) != KEYWORD)
 	{
@@ -383,6 +345,57 @@ read_input(void)
 	return (OK);
 }
 /* ---------------------------------------------------------------------- */
+void Phreeqc::
+init_read_input(void)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   Resets error counts, keyword counters and use/save structures
+ *   at the start of each simulation
+ */
+	int i;
+
+	parse_error = 0;
+	input_error = 0;
+	next_keyword = Keywords::KEY_NONE;
+	count_warnings = 0;
+
+	Rxn_new_exchange.clear();
+	Rxn_new_gas_phase.clear();
+	Rxn_new_kinetics.clear();      // not used
+	Rxn_new_mix.clear();           // not used
+	Rxn_new_pp_assemblage.clear();
+	Rxn_new_pressure.clear();      // not used
+	Rxn_new_reaction.clear();      // not used
+	Rxn_new_solution.clear();
+	Rxn_new_ss_assemblage.clear();
+	Rxn_new_surface.clear();
+	Rxn_new_temperature.clear();   // not used
+	phrq_io->Set_echo_on(true);
+/*
+ *  Initialize keyword counters
+ */
+	for (i = 0; i < Keywords::KEY_COUNT_KEYWORDS; i++)
+	{
+		keycount[i] = 0;
+	}
+/*
+ *  Initialize use and save pointers
+ */
+	use.init();
+
+	save.solution = FALSE;
+	save.mix = FALSE;
+	save.reaction = FALSE;
+	save.kinetics = FALSE;
+	save.pp_assemblage = FALSE;
+	save.exchange = FALSE;
+	save.surface = FALSE;
+	save.gas_phase = FALSE;
+	save.ss_assemblage = FALSE;
+	title_x = (char *) free_check_null(title_x);
+}
+/* ---------------------------------------------------------------------- */
 int Phreeqc::
 read_exchange_species(void)
 /* ---------------------------------------------------------------------- */
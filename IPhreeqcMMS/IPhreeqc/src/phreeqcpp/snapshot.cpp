@@ -0,0 +1,791 @@
+#include "Phreeqc.h"
+#include "phqalloc.h"
+#include <iostream>
+#include <sstream>
+
+/*
+ *   Binary snapshot of the database, written after read_database and
+ *   restored in place of read_input.  The snapshot holds the data read
+ *   from the database (elements, named expressions, species, phases,
+ *   master species, isotopes, calculate values, rates and llnl
+ *   parameters); tidy_model is run again when it is restored.
+ *
+ *   Structures are stored with their in-memory layout, so a snapshot is
+ *   only valid for the build that wrote it.  The header records the
+ *   format version and the sizes of the structures and the caller
+ *   supplies a key (for example a checksum of the database file).  Any
+ *   mismatch makes read_database_snapshot return false so the caller
+ *   can fall back to parsing the database.
+ */
+#define SNAPSHOT_MAGIC   "PHRQSNAP"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_END     0x534e4150
+#define SNAPSHOT_MAX     (1 << 24)
+
+static void
+snapshot_put(std::ostream &os, const void *p, size_t n)
+{
+	os.write((const char *) p, (std::streamsize) n);
+}
+static void
+snapshot_put_int(std::ostream &os, int i)
+{
+	snapshot_put(os, &i, sizeof(int));
+}
+static void
+snapshot_put_double(std::ostream &os, LDBLE d)
+{
+	snapshot_put(os, &d, sizeof(LDBLE));
+}
+static void
+snapshot_put_string(std::ostream &os, const char *str)
+{
+	if (str == NULL)
+	{
+		snapshot_put_int(os, -1);
+		return;
+	}
+	int l = (int) strlen(str);
+	snapshot_put_int(os, l);
+	snapshot_put(os, str, (size_t) l);
+}
+static bool
+snapshot_get(std::istream &is, void *p, size_t n)
+{
+	is.read((char *) p, (std::streamsize) n);
+	return (is.good());
+}
+static bool
+snapshot_get_int(std::istream &is, int &i)
+{
+	return (snapshot_get(is, &i, sizeof(int)));
+}
+static bool
+snapshot_get_count(std::istream &is, int &n)
+{
+	return (snapshot_get_int(is, n) && n >= 0 && n < SNAPSHOT_MAX);
+}
+static bool
+snapshot_get_double(std::istream &is, LDBLE &d)
+{
+	return (snapshot_get(is, &d, sizeof(LDBLE)));
+}
+/* null is set when the string was written from a NULL pointer */
+static bool
+snapshot_get_string(std::istream &is, std::string &str, bool &null)
+{
+	int l;
+	str.clear();
+	null = false;
+	if (!snapshot_get_int(is, l) || l >= SNAPSHOT_MAX)
+		return (false);
+	if (l < 0)
+	{
+		null = true;
+		return (true);
+	}
+	str.resize((size_t) l);
+	return (l == 0 || snapshot_get(is, &str[0], (size_t) l));
+}
+static void
+snapshot_put_doubles(std::ostream &os, const LDBLE *d, int count)
+{
+	snapshot_put_int(os, count);
+	if (count > 0)
+		snapshot_put(os, d, (size_t) count * sizeof(LDBLE));
+}
+
+/* ---------------------------------------------------------------------- */
+bool Phreeqc::
+database_snapshot_supported(void)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   Only databases made of the keywords restored by read_database_snapshot
+ *   can be written.  keycount still holds the keywords of read_database.
+ */
+	for (int i = 0; i < (int) keycount.size(); i++)
+	{
+		if (keycount[i] == 0)
+			continue;
+		switch (i)
+		{
+		case Keywords::KEY_NONE:
+		case Keywords::KEY_END:
+		case Keywords::KEY_SOLUTION_SPECIES:
+		case Keywords::KEY_SOLUTION_MASTER_SPECIES:
+		case Keywords::KEY_PHASES:
+		case Keywords::KEY_EXCHANGE_SPECIES:
+		case Keywords::KEY_EXCHANGE_MASTER_SPECIES:
+		case Keywords::KEY_SURFACE_SPECIES:
+		case Keywords::KEY_SURFACE_MASTER_SPECIES:
+		case Keywords::KEY_RATES:
+		case Keywords::KEY_LLNL_AQUEOUS_MODEL_PARAMETERS:
+		case Keywords::KEY_NAMED_EXPRESSIONS:
+		case Keywords::KEY_ISOTOPES:
+		case Keywords::KEY_CALCULATE_VALUES:
+		case Keywords::KEY_ISOTOPE_RATIOS:
+		case Keywords::KEY_ISOTOPE_ALPHAS:
+			break;
+		default:
+			return false;
+		}
+	}
+	return (!pitzer_model && !sit_model);
+}
+
+/* ---------------------------------------------------------------------- */
+void Phreeqc::
+snapshot_write_header(std::ostream &os, const std::string &key)
+/* ---------------------------------------------------------------------- */
+{
+	snapshot_put(os, SNAPSHOT_MAGIC, 8);
+	snapshot_put_int(os, SNAPSHOT_VERSION);
+	snapshot_put_int(os, (int) sizeof(int));
+	snapshot_put_int(os, (int) sizeof(LDBLE));
+	snapshot_put_int(os, (int) sizeof(struct logk));
+	snapshot_put_int(os, (int) sizeof(struct species));
+	snapshot_put_int(os, (int) sizeof(struct phase));
+	snapshot_put_int(os, (int) sizeof(struct master));
+	snapshot_put_int(os, (int) sizeof(struct master_isotope));
+	snapshot_put_int(os, MAX_LOG_K_INDICES);
+	snapshot_put_int(os, Keywords::KEY_COUNT_KEYWORDS);
+	snapshot_put_string(os, key.c_str());
+}
+
+/* ---------------------------------------------------------------------- */
+bool Phreeqc::
+snapshot_read_header(std::istream &is, const std::string &key)
+/* ---------------------------------------------------------------------- */
+{
+	std::ostringstream oss;
+	snapshot_write_header(oss, key);
+	std::string header = oss.str();
+
+	std::string str(header.size(), '\0');
+	return (snapshot_get(is, &str[0], str.size()) && str == header);
+}
+
+/* ---------------------------------------------------------------------- */
+void Phreeqc::
+snapshot_write_name_coef(std::ostream &os, const struct name_coef *nc, int count)
+/* ---------------------------------------------------------------------- */
+{
+	for (int i = 0; i < count; i++)
+	{
+		snapshot_put_string(os, nc[i].name);
+		snapshot_put_double(os, nc[i].coef);
+	}
+}
+
+/* ---------------------------------------------------------------------- */
+bool Phreeqc::
+snapshot_read_name_coef(std::istream &is, struct name_coef **nc, int count)
+/* ---------------------------------------------------------------------- */
+{
+	*nc = NULL;
+	if (count <= 0)
+		return true;
+	*nc = (struct name_coef *) PHRQ_malloc((size_t) count * sizeof(struct name_coef));
+	if (*nc == NULL)
+		malloc_error();
+	for (int i = 0; i < count; i++)
+	{
+		(*nc)[i].name = NULL;
+		(*nc)[i].coef = 0.0;
+	}
+	std::string name;
+	bool null;
+	for (int i = 0; i < count; i++)
+	{
+		if (!snapshot_get_string(is, name, null) || !snapshot_get_double(is, (*nc)[i].coef))
+			return false;
+		(*nc)[i].name = null ? NULL : string_hsave(name.c_str());
+	}
+	return true;
+}
+
+/* ---------------------------------------------------------------------- */
+void Phreeqc::
+snapshot_write_elt_list(std::ostream &os, const struct elt_list *elts)
+/* ---------------------------------------------------------------------- */
+{
+	if (elts == NULL)
+	{
+		snapshot_put_int(os, -1);
+		return;
+	}
+	int count = 0;
+	while (elts[count].elt != NULL)
+		count++;
+	snapshot_put_int(os, count);
+	for (int i = 0; i < count; i++)
+	{
+		snapshot_put_string(os, elts[i].elt->name);
+		snapshot_put_double(os, elts[i].coef);
+	}
+}
+
+/* ---------------------------------------------------------------------- */
+bool Phreeqc::
+snapshot_read_elt_list(std::istream &is, struct elt_list **elts)
+/* ---------------------------------------------------------------------- */
+{
+	int count;
+	*elts = NULL;
+	if (!snapshot_get_int(is, count) || count >= SNAPSHOT_MAX)
+		return false;
+	if (count < 0)
+		return true;
+	*elts = (struct elt_list *) PHRQ_malloc((size_t) (count + 1) * sizeof(struct elt_list));
+	if (*elts == NULL)
+		malloc_error();
+	for (int i = 0; i <= count; i++)
+	{
+		(*elts)[i].elt = NULL;
+		(*elts)[i].coef = 0.0;
+	}
+	std::string name;
+	bool null;
+	for (int i = 0; i < count; i++)
+	{
+		if (!snapshot_get_string(is, name, null) || null || !snapshot_get_double(is, (*elts)[i].coef))
+			return false;
+		(*elts)[i].elt = element_store(name.c_str());
+	}
+	return true;
+}
+
+/* ---------------------------------------------------------------------- */
+void Phreeqc::
+snapshot_write_rxn(std::ostream &os, const struct reaction *rxn)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   token[0] is always present; the list ends with a token that has
+ *   neither a species nor a name (see cxxChemRxn)
+ */
+	if (rxn == NULL)
+	{
+		snapshot_put_int(os, -1);
+		return;
+	}
+	int count = 1;
+	while (rxn->token[count].s != NULL || rxn->token[count].name != NULL)
+		count++;
+	snapshot_put_int(os, count);
+	snapshot_put(os, rxn->logk, sizeof(rxn->logk));
+	snapshot_put(os, rxn->dz, sizeof(rxn->dz));
+	for (int i = 0; i < count; i++)
+	{
+		snapshot_put_string(os, rxn->token[i].s ? rxn->token[i].s->name : NULL);
+		snapshot_put_string(os, rxn->token[i].name);
+		snapshot_put_double(os, rxn->token[i].coef);
+	}
+}
+
+/* ---------------------------------------------------------------------- */
+bool Phreeqc::
+snapshot_read_rxn(std::istream &is, struct reaction **rxn)
+/* ---------------------------------------------------------------------- */
+{
+	int count;
+	*rxn = NULL;
+	if (!snapshot_get_int(is, count) || count >= SNAPSHOT_MAX)
+		return false;
+	if (count < 0)
+		return true;
+	*rxn = rxn_alloc(count + 1);
+	if (!snapshot_get(is, (*rxn)->logk, sizeof((*rxn)->logk)) ||
+		!snapshot_get(is, (*rxn)->dz, sizeof((*rxn)->dz)))
+		return false;
+	std::string name;
+	bool null;
+	for (int i = 0; i < count; i++)
+	{
+		struct rxn_token *token_ptr = &(*rxn)->token[i];
+		if (!snapshot_get_string(is, name, null))
+			return false;
+		if (!null)
+		{
+			token_ptr->s = s_search(name.c_str());
+			if (token_ptr->s == NULL)
+				return false;
+		}
+		if (!snapshot_get_string(is, name, null) || !snapshot_get_double(is, token_ptr->coef))
+			return false;
+		token_ptr->name = null ? NULL : string_hsave(name.c_str());
+	}
+	return true;
+}
+
+/* ---------------------------------------------------------------------- */
+bool Phreeqc::
+write_database_snapshot(std::ostream &os, const std::string &key)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   Writes the database read by read_database
+ *
+ *   Returns false if the database uses keywords that are not saved
+ *   or if the stream fails.
+ */
+	int i, j;
+
+	if (!database_snapshot_supported())
+		return false;
+
+	snapshot_write_header(os, key);
+	snapshot_put_int(os, (int) keycount.size());
+	for (i = 0; i < (int) keycount.size(); i++)
+	{
+		snapshot_put_int(os, keycount[i]);
+	}
+	snapshot_put_int(os, print_density);
+	snapshot_put_int(os, print_viscosity);
+/*
+ *   elements
+ */
+	snapshot_put_int(os, count_elements);
+	for (i = 0; i < count_elements; i++)
+	{
+		snapshot_put_string(os, elements[i]->name);
+		snapshot_put_double(os, elements[i]->gfw);
+	}
+/*
+ *   named expressions
+ */
+	snapshot_put_int(os, count_logk);
+	for (i = 0; i < count_logk; i++)
+	{
+		snapshot_put(os, logk[i], sizeof(struct logk));
+		snapshot_put_string(os, logk[i]->name);
+		snapshot_write_name_coef(os, logk[i]->add_logk, logk[i]->count_add_logk);
+	}
+/*
+ *   species, all species are stored before their reactions
+ */
+	snapshot_put_int(os, count_s);
+	for (i = 0; i < count_s; i++)
+	{
+		snapshot_put(os, s[i], sizeof(struct species));
+		snapshot_put_string(os, s[i]->name);
+		snapshot_put_string(os, s[i]->mole_balance);
+	}
+	for (i = 0; i < count_s; i++)
+	{
+		snapshot_write_name_coef(os, s[i]->add_logk, s[i]->count_add_logk);
+		snapshot_write_elt_list(os, s[i]->next_elt);
+		snapshot_write_elt_list(os, s[i]->next_secondary);
+		snapshot_write_elt_list(os, s[i]->next_sys_total);
+		snapshot_write_rxn(os, s[i]->rxn);
+		snapshot_write_rxn(os, s[i]->rxn_s);
+		snapshot_write_rxn(os, s[i]->rxn_x);
+	}
+/*
+ *   phases
+ */
+	snapshot_put_int(os, count_phases);
+	for (i = 0; i < count_phases; i++)
+	{
+		snapshot_put(os, phases[i], sizeof(struct phase));
+		snapshot_put_string(os, phases[i]->name);
+		snapshot_put_string(os, phases[i]->formula);
+		snapshot_write_name_coef(os, phases[i]->add_logk, phases[i]->count_add_logk);
+		snapshot_write_elt_list(os, phases[i]->next_elt);
+		snapshot_write_elt_list(os, phases[i]->next_sys_total);
+		snapshot_write_rxn(os, phases[i]->rxn);
+		snapshot_write_rxn(os, phases[i]->rxn_s);
+		snapshot_write_rxn(os, phases[i]->rxn_x);
+	}
+/*
+ *   master species
+ */
+	snapshot_put_int(os, count_master);
+	for (i = 0; i < count_master; i++)
+	{
+		snapshot_put(os, master[i], sizeof(struct master));
+		snapshot_put_string(os, master[i]->elt->name);
+		snapshot_put_string(os, master[i]->gfw_formula);
+		snapshot_put_string(os, master[i]->s->name);
+		snapshot_write_rxn(os, master[i]->rxn_primary);
+		snapshot_write_rxn(os, master[i]->rxn_secondary);
+	}
+/*
+ *   isotopes
+ */
+	snapshot_put_int(os, count_master_isotope);
+	for (i = 0; i < count_master_isotope; i++)
+	{
+		snapshot_put(os, master_isotope[i], sizeof(struct master_isotope));
+		snapshot_put_string(os, master_isotope[i]->name);
+		snapshot_put_string(os, master_isotope[i]->elt ? master_isotope[i]->elt->name : NULL);
+		snapshot_put_string(os, master_isotope[i]->units);
+	}
+	snapshot_put_int(os, count_calculate_value);
+	for (i = 0; i < count_calculate_value; i++)
+	{
+		snapshot_put_string(os, calculate_value[i]->name);
+		snapshot_put_double(os, calculate_value[i]->value);
+		snapshot_put_string(os, calculate_value[i]->commands);
+	}
+	snapshot_put_int(os, count_isotope_ratio);
+	for (i = 0; i < count_isotope_ratio; i++)
+	{
+		snapshot_put_string(os, isotope_ratio[i]->name);
+		snapshot_put_string(os, isotope_ratio[i]->isotope_name);
+		snapshot_put_double(os, isotope_ratio[i]->ratio);
+		snapshot_put_double(os, isotope_ratio[i]->converted_ratio);
+	}
+	snapshot_put_int(os, count_isotope_alpha);
+	for (i = 0; i < count_isotope_alpha; i++)
+	{
+		snapshot_put_string(os, isotope_alpha[i]->name);
+		snapshot_put_string(os, isotope_alpha[i]->named_logk);
+		snapshot_put_double(os, isotope_alpha[i]->value);
+	}
+/*
+ *   rates
+ */
+	snapshot_put_int(os, count_rates);
+	for (i = 0; i < count_rates; i++)
+	{
+		snapshot_put_string(os, rates[i].name);
+		snapshot_put_string(os, rates[i].commands);
+	}
+/*
+ *   llnl aqueous model parameters
+ */
+	snapshot_put_doubles(os, llnl_temp, llnl_count_temp);
+	snapshot_put_doubles(os, llnl_adh, llnl_count_adh);
+	snapshot_put_doubles(os, llnl_bdh, llnl_count_bdh);
+	snapshot_put_doubles(os, llnl_bdot, llnl_count_bdot);
+	snapshot_put_doubles(os, llnl_co2_coefs, llnl_count_co2_coefs);
+
+	j = SNAPSHOT_END;
+	snapshot_put_int(os, j);
+	os.flush();
+	return (os.good());
+}
+
+/* ---------------------------------------------------------------------- */
+bool Phreeqc::
+snapshot_read_doubles(std::istream &is, LDBLE **d, int *count)
+/* ---------------------------------------------------------------------- */
+{
+	if (!snapshot_get_count(is, *count))
+		return false;
+	if (*count == 0)
+		return true;
+	*d = (LDBLE *) free_check_null(*d);
+	*d = (LDBLE *) PHRQ_malloc((size_t) *count * sizeof(LDBLE));
+	if (*d == NULL)
+		malloc_error();
+	return (snapshot_get(is, *d, (size_t) *count * sizeof(LDBLE)));
+}
+
+/* ---------------------------------------------------------------------- */
+bool Phreeqc::
+read_database_snapshot(std::istream &is, const std::string &key)
+/* ---------------------------------------------------------------------- */
+{
+/*
+ *   Restores a database written by write_database_snapshot into a newly
+ *   initialized instance and tidies it as read_database does.
+ *
+ *   Returns false if the header or key do not match or the snapshot is
+ *   damaged; the instance must then be reinitialized before the
+ *   database is read as text.  Otherwise input errors from tidy_model
+ *   are counted as for read_database.
+ */
+	int i, n;
+	std::string name, str;
+	bool null;
+
+	if (count_elements != 0 || count_s != 0 || count_phases != 0 || count_master != 0)
+		return false;
+	if (!snapshot_read_header(is, key))
+		return false;
+/*
+ *   keycount, so tidy_model sees the keywords of the database, and
+ *   the flags set by read_species
+ */
+	if (!snapshot_get_int(is, n) || n != (int) keycount.size())
+		return false;
+	for (i = 0; i < n; i++)
+	{
+		if (!snapshot_get_int(is, keycount[i]))
+			return false;
+	}
+	if (!snapshot_get_int(is, print_density) || !snapshot_get_int(is, print_viscosity))
+		return false;
+/*
+ *   elements
+ */
+	if (!snapshot_get_count(is, n))
+		return false;
+	for (i = 0; i < n; i++)
+	{
+		LDBLE gfw;
+		if (!snapshot_get_string(is, name, null) || null || !snapshot_get_double(is, gfw))
+			return false;
+		element_store(name.c_str())->gfw = gfw;
+	}
+	element_h_one = element_store("H(1)");
+/*
+ *   named expressions
+ */
+	if (!snapshot_get_count(is, n))
+		return false;
+	for (i = 0; i < n; i++)
+	{
+		struct logk logk_save;
+		if (!snapshot_get(is, &logk_save, sizeof(struct logk)) ||
+			!snapshot_get_string(is, name, null) || null)
+			return false;
+		char *token = string_duplicate(name.c_str());
+		struct logk *logk_ptr = logk_store(token, FALSE);
+		free_check_null(token);
+		memcpy(logk_ptr, &logk_save, sizeof(struct logk));
+		logk_ptr->name = string_hsave(name.c_str());
+		logk_ptr->add_logk = NULL;
+		if (!snapshot_read_name_coef(is, &logk_ptr->add_logk, logk_ptr->count_add_logk))
+			return false;
+	}
+/*
+ *   species
+ */
+	if (!snapshot_get_count(is, n))
+		return false;
+	for (i = 0; i < n; i++)
+	{
+		struct species s_save;
+		if (!snapshot_get(is, &s_save, sizeof(struct species)) ||
+			!snapshot_get_string(is, name, null) || null ||
+			!snapshot_get_string(is, str, null))
+			return false;
+		struct species *s_ptr = s_store(name.c_str(), s_save.z, FALSE);
+		memcpy(s_ptr, &s_save, sizeof(struct species));
+		s_ptr->name = string_hsave(name.c_str());
+		s_ptr->mole_balance = null ? NULL : string_hsave(str.c_str());
+		s_ptr->primary = NULL;
+		s_ptr->secondary = NULL;
+		s_ptr->add_logk = NULL;
+		s_ptr->next_elt = NULL;
+		s_ptr->next_secondary = NULL;
+		s_ptr->next_sys_total = NULL;
+		s_ptr->rxn = NULL;
+		s_ptr->rxn_s = NULL;
+		s_ptr->rxn_x = NULL;
+	}
+	if (count_s != n)
+		return false;
+	for (i = 0; i < n; i++)
+	{
+		struct species *s_ptr = s[i];
+		if (!snapshot_read_name_coef(is, &s_ptr->add_logk, s_ptr->count_add_logk) ||
+			!snapshot_read_elt_list(is, &s_ptr->next_elt) ||
+			!snapshot_read_elt_list(is, &s_ptr->next_secondary) ||
+			!snapshot_read_elt_list(is, &s_ptr->next_sys_total) ||
+			!snapshot_read_rxn(is, &s_ptr->rxn) ||
+			!snapshot_read_rxn(is, &s_ptr->rxn_s) ||
+			!snapshot_read_rxn(is, &s_ptr->rxn_x))
+			return false;
+	}
+	s_h2o = s_search("H2O");
+	s_hplus = s_search("H+");
+	s_h3oplus = s_search("H3O+");
+	s_eminus = s_search("e-");
+	s_co3 = s_search("CO3-2");
+	s_h2 = s_search("H2");
+	s_o2 = s_search("O2");
+/*
+ *   phases
+ */
+	if (!snapshot_get_count(is, n))
+		return false;
+	for (i = 0; i < n; i++)
+	{
+		struct phase phase_save;
+		if (!snapshot_get(is, &phase_save, sizeof(struct phase)) ||
+			!snapshot_get_string(is, name, null) || null ||
+			!snapshot_get_string(is, str, null))
+			return false;
+		struct phase *phase_ptr = phase_store(name.c_str());
+		memcpy(phase_ptr, &phase_save, sizeof(struct phase));
+		phase_ptr->name = string_hsave(name.c_str());
+		phase_ptr->formula = null ? NULL : string_hsave(str.c_str());
+		phase_ptr->add_logk = NULL;
+		phase_ptr->next_elt = NULL;
+		phase_ptr->next_sys_total = NULL;
+		phase_ptr->rxn = NULL;
+		phase_ptr->rxn_s = NULL;
+		phase_ptr->rxn_x = NULL;
+		if (!snapshot_read_name_coef(is, &phase_ptr->add_logk, phase_ptr->count_add_logk) ||
+			!snapshot_read_elt_list(is, &phase_ptr->next_elt) ||
+			!snapshot_read_elt_list(is, &phase_ptr->next_sys_total) ||
+			!snapshot_read_rxn(is, &phase_ptr->rxn) ||
+			!snapshot_read_rxn(is, &phase_ptr->rxn_s) ||
+			!snapshot_read_rxn(is, &phase_ptr->rxn_x))
+			return false;
+	}
+/*
+ *   master species
+ */
+	if (!snapshot_get_count(is, n))
+		return false;
+	space((void **) ((void *) &master), n + 1, &max_master, sizeof(struct master *));
+	dbg_master = master;
+	for (i = 0; i < n; i++)
+	{
+		struct master master_save;
+		std::string elt_name;
+		if (!snapshot_get(is, &master_save, sizeof(struct master)) ||
+			!snapshot_get_string(is, elt_name, null) || null ||
+			!snapshot_get_string(is, str, null))
+			return false;
+		master[i] = master_alloc();
+		count_master = i + 1;
+		memcpy(master[i], &master_save, sizeof(struct master));
+		master[i]->elt = element_store(elt_name.c_str());
+		master[i]->gfw_formula = null ? NULL : string_hsave(str.c_str());
+		master[i]->unknown = NULL;
+		master[i]->s = NULL;
+		master[i]->rxn_primary = NULL;
+		master[i]->rxn_secondary = NULL;
+		master[i]->pe_rxn = NULL;
+		if (!snapshot_get_string(is, name, null) || null)
+			return false;
+		master[i]->s = s_search(name.c_str());
+		if (master[i]->s == NULL ||
+			!snapshot_read_rxn(is, &master[i]->rxn_primary) ||
+			!snapshot_read_rxn(is, &master[i]->rxn_secondary))
+			return false;
+	}
+/*
+ *   isotopes
+ */
+	if (!snapshot_get_count(is, n))
+		return false;
+	for (i = 0; i < n; i++)
+	{
+		struct master_isotope master_isotope_save;
+		std::string elt_name;
+		bool elt_null;
+		if (!snapshot_get(is, &master_isotope_save, sizeof(struct master_isotope)) ||
+			!snapshot_get_string(is, name, null) || null ||
+			!snapshot_get_string(is, elt_name, elt_null) ||
+			!snapshot_get_string(is, str, null))
+			return false;
+		struct master_isotope *master_isotope_ptr = master_isotope_store(name.c_str(), FALSE);
+		memcpy(master_isotope_ptr, &master_isotope_save, sizeof(struct master_isotope));
+		master_isotope_ptr->name = string_hsave(name.c_str());
+		master_isotope_ptr->master = NULL;	/* set by tidy_master_isotope */
+		master_isotope_ptr->elt = elt_null ? NULL : element_store(elt_name.c_str());
+		master_isotope_ptr->units = null ? NULL : string_hsave(str.c_str());
+	}
+	if (!snapshot_get_count(is, n))
+		return false;
+	for (i = 0; i < n; i++)
+	{
+		LDBLE value;
+		if (!snapshot_get_string(is, name, null) || null ||
+			!snapshot_get_double(is, value) ||
+			!snapshot_get_string(is, str, null))
+			return false;
+		struct calculate_value *calculate_value_ptr = calculate_value_store(name.c_str(), FALSE);
+		calculate_value_ptr->value = value;
+		if (!null)
+		{
+			calculate_value_ptr->commands = string_duplicate(str.c_str());
+		}
+	}
+	if (!snapshot_get_count(is, n))
+		return false;
+	for (i = 0; i < n; i++)
+	{
+		struct isotope_ratio *isotope_ratio_ptr;
+		if (!snapshot_get_string(is, name, null) || null ||
+			!snapshot_get_string(is, str, null))
+			return false;
+		isotope_ratio_ptr = isotope_ratio_store(name.c_str(), FALSE);
+		isotope_ratio_ptr->name = string_hsave(name.c_str());
+		isotope_ratio_ptr->isotope_name = null ? NULL : string_hsave(str.c_str());
+		if (!snapshot_get_double(is, isotope_ratio_ptr->ratio) ||
+			!snapshot_get_double(is, isotope_ratio_ptr->converted_ratio))
+			return false;
+	}
+	if (!snapshot_get_count(is, n))
+		return false;
+	for (i = 0; i < n; i++)
+	{
+		struct isotope_alpha *isotope_alpha_ptr;
+		if (!snapshot_get_string(is, name, null) || null ||
+			!snapshot_get_string(is, str, null))
+			return false;
+		isotope_alpha_ptr = isotope_alpha_store(name.c_str(), FALSE);
+		isotope_alpha_ptr->named_logk = null ? NULL : string_hsave(str.c_str());
+		if (!snapshot_get_double(is, isotope_alpha_ptr->value))
+			return false;
+	}
+/*
+ *   rates
+ */
+	if (!snapshot_get_count(is, n))
+		return false;
+	if (n > 0)
+	{
+		rates = (struct rate *) free_check_null(rates);
+		rates = (struct rate *) PHRQ_malloc((size_t) n * sizeof(struct rate));
+		if (rates == NULL)
+			malloc_error();
+		for (i = 0; i < n; i++)
+		{
+			rates[i].name = NULL;
+			rates[i].commands = NULL;
+			rates[i].new_def = TRUE;
+			rates[i].linebase = NULL;
+			rates[i].varbase = NULL;
+			rates[i].loopbase = NULL;
+		}
+		count_rates = n;
+		for (i = 0; i < n; i++)
+		{
+			if (!snapshot_get_string(is, name, null) || null ||
+				!snapshot_get_string(is, str, null))
+				return false;
+			rates[i].name = string_hsave(name.c_str());
+			rates[i].commands = null ? NULL : string_duplicate(str.c_str());
+		}
+	}
+	rates_map.clear();
+/*
+ *   llnl aqueous model parameters
+ */
+	if (!snapshot_read_doubles(is, &llnl_temp, &llnl_count_temp) ||
+		!snapshot_read_doubles(is, &llnl_adh, &llnl_count_adh) ||
+		!snapshot_read_doubles(is, &llnl_bdh, &llnl_count_bdh) ||
+		!snapshot_read_doubles(is, &llnl_bdot, &llnl_count_bdot) ||
+		!snapshot_read_doubles(is, &llnl_co2_coefs, &llnl_count_co2_coefs))
+		return false;
+
+	if (!snapshot_get_int(is, n) || n != SNAPSHOT_END)
+		return false;
+/*
+ *   tidy as read_database does
+ */
+	simulation = 0;
+	try
+	{
+		set_reading_database(TRUE);
+		dup_print("Reading data base.", TRUE);
+		tidy_model();
+		status(0, NULL);
+	}
+	catch (const PhreeqcStop&)
+	{
+		return true;
+	}
+	set_reading_database(FALSE);
+	return true;
+}
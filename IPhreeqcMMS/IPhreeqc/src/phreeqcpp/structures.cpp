@@ -43,6 +43,7 @@ clean_up(void)
 		(char *) free_check_null(moles_per_kilogram_string);
 	pe_string = (char *) free_check_null(pe_string);
 /* model */
+	model_cache_free();
 	last_model.exchange =
 		(struct master **) free_check_null(last_model.exchange);
 	last_model.gas_phase =
@@ -49,7 +49,14 @@ fill_tally_table(int *n_user, int index_conservative, int n_buffer)
 				       index_conservative is solution number
 				           where conservative mixing is stored
                                        slot is 1 for final
-store_tally_table(LDBLE *array, int row_dim, int col_dim, LDBLE fill_factor) 
+select_tally_table_columns(int *n_user, int *columns, int count)
+                                       optional, limits the columns filled and
+                                       stored to the entities in n_user and,
+                                       if count > 0, the C column numbers in
+                                       columns
+
+store_tally_table(LDBLE *array, int row_dim, int col_dim, LDBLE fill_factor,
+                  std::vector<char> *written) 
                                        row_dim is Fortran dimension
                                        col_dim is Fortran dimension
 				       array is space from Fortran
@@ -57,6 +64,9 @@ store_tally_table(LDBLE *array, int row_dim, int col_dim, LDBLE fill_factor)
 				       stores reaction (column 1)
 				       difference between slot 1 and slot 0 for
 				       all other entities (columns 2-n)
+				       columns that are not selected are zeroed,
+				       or, if written is given, only those that
+				       were stored since array was last zeroed
 
 Finalization:
 -------------
@@ -216,7 +226,8 @@ get_all_components(void)
 #endif
 /* ---------------------------------------------------------------------- */
 int Phreeqc::
-store_tally_table(LDBLE * l_array, int row_dim_in, int col_dim, LDBLE fill_factor)
+store_tally_table(LDBLE * l_array, int row_dim_in, int col_dim, LDBLE fill_factor,
+				  std::vector<char> *written)
 /* ---------------------------------------------------------------------- */
 {
 	int i, j;
@@ -244,6 +255,29 @@ store_tally_table(LDBLE * l_array, int row_dim_in, int col_dim, LDBLE fill_facto
 			 CONTINUE);
 		return (ERROR);
 	}
+	/*
+	 * zero columns that are not filled for this calculation
+	 */
+	std::vector<char> selected(count_tally_table_columns, tally_columns.empty());
+	for (size_t n = 0; n < tally_columns.size(); n++)
+	{
+		selected[tally_columns[n]] = TRUE;
+	}
+	if (written != NULL)
+	{
+		written->resize(count_tally_table_columns, TRUE);
+	}
+	for (i = 0; i < count_tally_table_columns; i++)
+	{
+		if (selected[i] || (written != NULL && !(*written)[i]))
+			continue;
+		for (j = 0; j <= count_tally_table_rows; j++)
+		{
+			l_array[i * row_dim + j] = 0.0;
+		}
+		if (written != NULL)
+			(*written)[i] = FALSE;
+	}
 	/*
 	 * store conservative mixing solution
 	 */
@@ -269,6 +303,8 @@ store_tally_table(LDBLE * l_array, int row_dim_in, int col_dim, LDBLE fill_facto
 	 */
 	for (i = 2; i < count_tally_table_columns; i++)
 	{
+		if (!selected[i])
+			continue;
 		for (j = 0; j < count_tally_table_rows; j++)
 		{
 			l_array[i * row_dim + j] =
@@ -281,8 +317,57 @@ store_tally_table(LDBLE * l_array, int row_dim_in, int col_dim, LDBLE fill_facto
 	 */
 	for (i = 0; i < count_tally_table_columns; i++)
 	{
+		if (!selected[i])
+			continue;
 		l_array[i * row_dim + count_tally_table_rows] =
 				tally_table[i].moles / fill_factor;
+		if (written != NULL)
+			(*written)[i] = TRUE;
+	}
+	return (OK);
+}
+
+/* ---------------------------------------------------------------------- */
+int Phreeqc::
+select_tally_table_columns(int *n_user, const int *columns, int count)
+/* ---------------------------------------------------------------------- */
+{
+	/*
+	 *  Selects the columns that zero, fill, diff, and store work on:
+	 *  the solution columns, and the columns of entity types with
+	 *  n_user >= 0 that are in columns, if count > 0. Other columns
+	 *  would be zero.
+	 */
+	int i;
+	tally_columns.clear();
+	if (tally_table == NULL)
+		return (OK);
+	std::vector<char> listed(count_tally_table_columns, count <= 0);
+	for (i = 0; i < count; i++)
+	{
+		if (columns[i] >= 0 && columns[i] < count_tally_table_columns)
+			listed[columns[i]] = TRUE;
+	}
+	for (i = 0; i < count_tally_table_columns; i++)
+	{
+		switch (tally_table[i].type)
+		{
+		case Solution:
+			break;
+		case Reaction:
+		case Pure_phase:
+		case Exchange:
+		case Surface:
+		case Ss_phase:
+		case Gas_phase:
+		case Kinetics:
+			if (n_user[tally_table[i].type] < 0 || !listed[i])
+				continue;
+			break;
+		default:
+			continue;
+		}
+		tally_columns.push_back(i);
 	}
 	return (OK);
 }
@@ -386,6 +471,7 @@ free_tally_table(void)
 	}
 	tally_table = (struct tally *) free_check_null(tally_table);
 	t_buffer = (struct tally_buffer *) free_check_null(t_buffer);
+	tally_columns.clear();
 	return (OK);
 }
 
@@ -395,8 +481,10 @@ zero_tally_table(void)
 /* ---------------------------------------------------------------------- */
 {
 	int i, j, k;
-	for (i = 0; i < count_tally_table_columns; i++)
+	int count_columns = tally_columns.empty() ? count_tally_table_columns : (int) tally_columns.size();
+	for (int n = 0; n < count_columns; n++)
 	{
+		i = tally_columns.empty() ? n : tally_columns[n];
 		tally_table[i].moles = 0.0;
 		for (j = 0; j < count_tally_table_rows; j++)
 		{
@@ -418,8 +506,10 @@ diff_tally_table(void)
 	/*
 	   output_msg("Difference\n\n");
 	 */
-	for (i = 0; i < count_tally_table_columns; i++)
+	int count_columns = tally_columns.empty() ? count_tally_table_columns : (int) tally_columns.size();
+	for (int n = 0; n < count_columns; n++)
 	{
+		i = tally_columns.empty() ? n : tally_columns[n];
 		for (j = 0; j < count_tally_table_rows; j++)
 		{
 			tally_table[i].total[2][j].moles =
@@ -476,10 +566,12 @@ fill_tally_table(int *n_user, int index_conservative, int n_buffer)
 	LDBLE moles;
 	//char *ptr;
 	/*
-	 *  Cycle through tally table columns
+	 *  Cycle through selected tally table columns
 	 */
-	for (int i = 0; i < count_tally_table_columns; i++)
+	int count_columns = tally_columns.empty() ? count_tally_table_columns : (int) tally_columns.size();
+	for (int n = 0; n < count_columns; n++)
 	{
+		int i = tally_columns.empty() ? n : tally_columns[n];
 		switch (tally_table[i].type)
 		{
 		case Solution:
@@ -916,6 +1008,7 @@ build_tally_table(void)
  *  find nuber of columns
  */
 	count_tally_table_columns = 0;
+	tally_columns.clear();
 /*
  *   add one for conservative mixing
  */
@@ -16,7 +16,7 @@ tidy_model(void)
 /* ---------------------------------------------------------------------- */
 {
 	int n_user, last;
-	int new_named_logk;
+	int new_named_logk, new_calculate_values;
 	/*
 	 * Determine if any new elements, species, phases have been read
 	 */
@@ -38,6 +38,8 @@ tidy_model(void)
 	new_kinetics = FALSE;
 	new_pitzer = FALSE;
 	new_named_logk = FALSE;
+	new_calculate_values = FALSE;
+	tidy_count++;
 
 	if (keycount[Keywords::KEY_SOLUTION_SPECIES] > 0				||	/*"species" */
 		keycount[Keywords::KEY_SOLUTION_MASTER_SPECIES] > 0			||	/*"master" */
@@ -46,12 +48,10 @@ tidy_model(void)
 		keycount[Keywords::KEY_EXCHANGE_MASTER_SPECIES] > 0			||	/*"master_exchange_species" */
 		keycount[Keywords::KEY_SURFACE_SPECIES] > 0					||	/*"surface_species" */
 		keycount[Keywords::KEY_SURFACE_MASTER_SPECIES] > 0			||	/*"master_surface_species" */
-		keycount[Keywords::KEY_RATES] > 0							||	/*"rates" */
 		keycount[Keywords::KEY_LLNL_AQUEOUS_MODEL_PARAMETERS] > 0	||	/*"llnl_aqueous_model_parameters" */
 		(keycount[Keywords::KEY_DATABASE] > 0 && simulation == 0)	||	/*"database" */
 		keycount[Keywords::KEY_NAMED_EXPRESSIONS] > 0				||	/*"named_analytical_expressions" */
 		keycount[Keywords::KEY_ISOTOPES] > 0						||	/*"isotopes" */
-		keycount[Keywords::KEY_CALCULATE_VALUES] > 0				||	/*"calculate_values" */
 		keycount[Keywords::KEY_ISOTOPE_RATIOS] > 0					||	/*"isotopes_ratios", */
 		keycount[Keywords::KEY_ISOTOPE_ALPHAS] > 0					||	/*"isotopes_alphas" */
 		keycount[Keywords::KEY_PITZER] > 0							||	/*"pitzer" */
@@ -142,6 +142,32 @@ tidy_model(void)
 	{
 		new_named_logk = TRUE;						/*"named_log_k" */
 	}
+	if (keycount[Keywords::KEY_CALCULATE_VALUES] > 0)
+	{
+		new_calculate_values = TRUE;				/*"calculate_values" */
+	}
+	/*
+	 *   RATES, MIX, REACTION, REACTION_TEMPERATURE, USE, SAVE and COPY
+	 *   need no tidying; rates are looked up by name when kinetics are run.
+	 *   Skip the rest if nothing else was read since the last complete tidy.
+	 */
+	if (tidy_valid &&
+		!new_model && !new_pp_assemblage && !new_surface && !new_exchange &&
+		!new_solution && !new_gas_phase && !new_ss_assemblage && !new_kinetics &&
+		!new_inverse && !new_punch && !new_named_logk && !new_calculate_values)
+	{
+		tidy_skipped++;
+		if (get_input_errors() > 0 || parse_error > 0)
+		{
+			error_msg("Calculations terminating due to input errors.", STOP);
+		}
+		return (OK);
+	}
+	tidy_valid = FALSE;
+	if (new_model)
+	{
+		tidy_rebuilds++;
+	}
 
 /*
  *   Sort arrays
@@ -244,7 +270,7 @@ tidy_model(void)
 	{
 		tidy_isotopes();
 	}
-	if (new_model)
+	if (new_model || new_calculate_values)
 	{
 		tidy_isotope_ratios();
 		tidy_isotope_alphas();
@@ -281,7 +307,7 @@ tidy_model(void)
 /*
  *   Tidy punch information
  */
-	if (get_input_errors() == 0 && (new_punch || new_model))
+	if (get_input_errors() == 0 && (new_punch || new_model || new_calculate_values))
 	{
 		tidy_punch();
 	}
@@ -400,6 +426,7 @@ tidy_model(void)
 	{
 		error_msg("Calculations terminating due to input errors.", STOP);
 	}
+	tidy_valid = TRUE;
 
 	return (OK);
 }
@@ -3388,9 +3415,13 @@ tidy_isotopes(void)
 
 	int primary_number = 0;
 	primary_ptr = NULL;
-	std::map<int, cxxSolution>::iterator it;
-	for (it = Rxn_solution_map.begin(); it != Rxn_solution_map.end(); it++)
+	//std::map<int, cxxSolution>::iterator it;
+	//for (it = Rxn_solution_map.begin(); it != Rxn_solution_map.end(); it++)
+	for (std::set<int>::const_iterator nit = Rxn_new_solution.begin(); nit != Rxn_new_solution.end(); nit++)
 	{
+		std::map<int, cxxSolution>::iterator it = Rxn_solution_map.find(*nit);
+		if (it == Rxn_solution_map.end())
+			continue;
 		std::map<std::string, cxxSolutionIsotope> new_isotopes;
 		cxxSolution &solution_ref = it->second;
 		if (!solution_ref.Get_new_def())
@@ -5502,6 +5533,11 @@ reset_last_model(void)
 	last_model.count_surface_charge = 0;
 	last_model.surface_charge =
 		(const char **) free_check_null(last_model.surface_charge);
+/*
+ *   Prepared models refer to the old species and phases
+ */
+	model_cache_free();
+	model_cache_live = FALSE;
 	return (OK);
 }
 /* ---------------------------------------------------------------------- */
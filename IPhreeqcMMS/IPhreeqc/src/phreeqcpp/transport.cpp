@@ -9,47 +9,7 @@
 #include "Solution.h"
 #include <limits.h>
 
-LDBLE F_Re3 = F_C_MOL / (R_KJ_DEG_MOL * 1e3);
-LDBLE tk_x2; // average tk_x of icell and jcell
-LDBLE dV_dcell; // difference in Volt among icell and jcell
-int find_current;
-char token[MAX_LENGTH];
-
-// implicit...
-std::set <std::string> dif_spec_names;
-std::set <std::string> dif_els_names;
-std::map<int, std::map<std::string, double> > neg_moles;
-std::map<std::string, double> els;
-double *Ct2, *l_tk_x2, **A, **LU, **mixf, **mixf_stag;
-int mixf_comp_size = 0;
-
-struct CURRENT_CELLS
-{
-	LDBLE dif, ele, R; // diffusive and electric components, relative cell resistance
-} *current_cells;
-LDBLE sum_R, sum_Rd; // sum of R, sum of (current_cells[0].dif - current_cells[i].dif) * R
-struct V_M   // For calculating Vinograd and McBain's zero-charge, diffusive tranfer of individual solutes
-{
-	LDBLE grad, D, z, c, zc, Dz, Dzc;
-	LDBLE b_ij; // harmonic mean of cell properties, with EDL enrichment
-};
-struct CT /* summed parts of V_M and mcd transfer in a timestep for all cells, for free + DL water */
-{
-	LDBLE kgw, dl_s, Dz2c, Dz2c_stag, visc1, visc2, J_ij_sum;
-	LDBLE A_ij_il, Dz2c_il, mixf_il;
-	int J_ij_count_spec, J_ij_il_count_spec;
-	struct V_M *v_m, *v_m_il;
-	struct J_ij *J_ij, *J_ij_il;
-	int count_m_s;
-	struct M_S *m_s;
-	int v_m_size, J_ij_size, m_s_size;
-} *ct = NULL;
-struct MOLES_ADDED /* total moles added to balance negative conc's */
-{
-	char *name;
-	LDBLE moles;
-} *moles_added;
-int count_moles_added;
+const LDBLE F_Re3 = F_C_MOL / (R_KJ_DEG_MOL * 1e3);
 
 /* ---------------------------------------------------------------------- */
 int Phreeqc::
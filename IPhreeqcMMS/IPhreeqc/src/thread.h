@@ -51,14 +51,9 @@
 
 #if !defined (_INC_PHREEQC_H)  || defined (PHREEQC) || defined (PHREEQC_PARALLEL)
 	mutex_t map_lock = MUTEX_INITIALIZER;
-	mutex_t qsort_lock = MUTEX_INITIALIZER;
 #else
 	extern mutex_t map_lock;
-	extern mutex_t qsort_lock;
 #endif
 
-#ifndef WIN32
-	#define qsort(a, b, c, d) mutex_lock(&qsort_lock); \
-				qsort(a, b, c, d); \
-				mutex_unlock(&qsort_lock)
-#endif
+/*	qsort is not wrapped in a lock: the comparison functions use only
+	their arguments, so instances can sort concurrently */
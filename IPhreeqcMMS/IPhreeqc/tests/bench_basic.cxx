@@ -0,0 +1,111 @@
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <IPhreeqc.hpp>
+
+// Compares interpreted BASIC rates with compiled ones, whose MOL, ACT,
+// SI, TOT, ... look up their species once instead of on every call.
+// The loop in the rate stands for rates that call such functions many
+// times.  Usage: bench_basic [runs] [calls] [database]
+
+static const int steps = 50;
+
+static const char input[] =
+  "RATES\n"
+  "Calcite_bench\n"
+  "  -start\n"
+  "   10 si_cc = SI(\"Calcite\")\n"
+  "   20 IF (M <= 0 AND si_cc < 0) THEN GOTO 200\n"
+  "   30 k1 = 10^(0.198 - 444.0 / TK)\n"
+  "   40 k2 = 10^(2.84 - 2177.0 / TK)\n"
+  "   50 IF TC <= 25 THEN k3 = 10^(-5.86 - 317.0 / TK)\n"
+  "   60 IF TC > 25 THEN k3 = 10^(-1.1 - 1737.0 / TK)\n"
+  "   80 IF M0 > 0 THEN area = PARM(1) * M0 * (M / M0)^PARM(2) ELSE area = PARM(1) * M\n"
+  "  110 rate = area * (k1 * ACT(\"H+\") + k2 * ACT(\"CO2\") + k3 * ACT(\"H2O\"))\n"
+  "  120 rate = rate * (1 - 10^(2 / 3 * si_cc))\n"
+  "  130 moles = rate * 0.001 * TIME\n"
+  "  140 FOR i = 1 TO PARM(3)\n"
+  "  150   x = MOL(\"Ca+2\") + LA(\"HCO3-\") + TOT(\"Ca\") + TOTMOLE(\"Mg\") + SR(\"Dolomite\") + GFW(\"CaCO3\")\n"
+  "  160 NEXT i\n"
+  "  200 SAVE moles\n"
+  "  -end\n"
+  "SOLUTION 1\n"
+  "  pH 6.0\n"
+  "  Mg 0.1\n"
+  "  C 1.0 CO2(g) -2.0\n"
+  "KINETICS 1\n"
+  "Calcite_bench\n"
+  "  -formula CaCO3\n"
+  "  -m0 3e-3\n"
+  "  -parms 50 0.6 %d\n"
+  "  -steps 86400 in 50 steps\n"
+  "SELECTED_OUTPUT\n"
+  "  -reset false\n"
+  "  -totals Ca\n"
+  "  -si Calcite\n"
+  "END\n";
+
+static double
+elapsed(clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static bool
+run(bool bytecode_on, int runs, int calls, const char* database, double* seconds, std::string* selected)
+{
+  char buffer[sizeof(input) + 16];
+  ::snprintf(buffer, sizeof(buffer), input, calls);
+
+  IPhreeqc obj;
+  obj.SetBasicBytecodeOn(bytecode_on);
+  if (obj.LoadDatabase(database) != 0)
+  {
+    std::cerr << obj.GetErrorString();
+    return false;
+  }
+  obj.SetSelectedOutputStringOn(true);
+  clock_t start = clock();
+  for (int i = 0; i < runs; ++i)
+  {
+    if (obj.RunString(buffer) != 0)
+    {
+      std::cerr << obj.GetErrorString();
+      return false;
+    }
+  }
+  *seconds = elapsed(start);
+  *selected = obj.GetSelectedOutputString();
+  return true;
+}
+
+int
+main(int argc, const char* argv[])
+{
+  int runs = (argc > 1) ? atoi(argv[1]) : 20;
+  int calls = (argc > 2) ? atoi(argv[2]) : 100;
+  const char* database = (argc > 3) ? argv[3] : "phreeqc.dat";
+
+  double t_interpreted, t_compiled;
+  std::string interpreted, compiled;
+  if (!run(false, runs, calls, database, &t_interpreted, &interpreted) ||
+      !run(true, runs, calls, database, &t_compiled, &compiled))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // compiled rates must give the same results
+  if (interpreted != compiled)
+  {
+    std::cerr << "Compiled results differ from interpreted results" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  int integrations = runs * steps;
+  ::printf("kinetic steps:  %d, %d calls of 6 functions per rate (%s)\n", integrations, calls, database);
+  ::printf("interpreted:    %.3f s (%.3f ms/step)\n", t_interpreted, 1e3 * t_interpreted / integrations);
+  ::printf("compiled:       %.3f s (%.3f ms/step)\n", t_compiled, 1e3 * t_compiled / integrations);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,102 @@
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <IPhreeqc.hpp>
+
+// Compares Clone with LoadDatabase followed by the run that defines the
+// reactants, as when starting workers or ensemble members from a common
+// initial state.  Usage: bench_clone [copies] [database]
+
+static const char setup[] =
+  "SOLUTION 1\n"
+  "  pH 7.0\n"
+  "  Ca 1.0\n"
+  "  Na 2.0\n"
+  "  Cl 4.0 charge\n"
+  "EQUILIBRIUM_PHASES 1\n"
+  "  Calcite 0 10\n"
+  "EXCHANGE 1\n"
+  "  X 0.1\n"
+  "  -equilibrate 1\n"
+  "END\n";
+
+static const char run[] =
+  "USE solution 1\n"
+  "USE equilibrium_phases 1\n"
+  "USE exchange 1\n"
+  "REACTION 1\n"
+  "  NaCl 1\n"
+  "  0.001\n"
+  "SELECTED_OUTPUT\n"
+  "  -reset false\n"
+  "  -pH true\n"
+  "  -totals Ca Na\n"
+  "  -si Calcite\n"
+  "END\n";
+
+static double
+elapsed(clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int
+main(int argc, const char* argv[])
+{
+  int copies = (argc > 1) ? atoi(argv[1]) : 50;
+  const char* database = (argc > 2) ? argv[2] : "phreeqc.dat";
+
+  clock_t start = clock();
+  for (int i = 0; i < copies; ++i)
+  {
+    IPhreeqc loaded;
+    if (loaded.LoadDatabase(database) != 0 || loaded.RunString(setup) != 0)
+    {
+      std::cerr << loaded.GetErrorString();
+      return EXIT_FAILURE;
+    }
+  }
+  double t_loaded = elapsed(start);
+
+  IPhreeqc master;
+  if (master.LoadDatabase(database) != 0 || master.RunString(setup) != 0)
+  {
+    std::cerr << master.GetErrorString();
+    return EXIT_FAILURE;
+  }
+  start = clock();
+  for (int i = 0; i < copies; ++i)
+  {
+    IPhreeqc* clone = master.Clone();
+    if (clone->GetErrorStringLineCount() != 0)
+    {
+      std::cerr << clone->GetErrorString();
+      return EXIT_FAILURE;
+    }
+    delete clone;
+  }
+  double t_cloned = elapsed(start);
+
+  // a clone must give the same results as its source
+  IPhreeqc* clone = master.Clone();
+  master.SetSelectedOutputStringOn(true);
+  clone->SetSelectedOutputStringOn(true);
+  if (master.RunString(run) != 0 || clone->RunString(run) != 0)
+  {
+    std::cerr << master.GetErrorString() << clone->GetErrorString();
+    return EXIT_FAILURE;
+  }
+  if (std::string(master.GetSelectedOutputString()) != clone->GetSelectedOutputString())
+  {
+    std::cerr << "Clone result differs from its source" << std::endl;
+    return EXIT_FAILURE;
+  }
+  delete clone;
+
+  ::printf("copies:                 %d (%s)\n", copies, database);
+  ::printf("LoadDatabase+RunString: %.3f s (%.2f ms/copy)\n", t_loaded, 1e3 * t_loaded / copies);
+  ::printf("Clone:                  %.3f s (%.2f ms/copy)\n", t_cloned, 1e3 * t_cloned / copies);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,115 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <IPhreeqc.hpp>
+
+// Evaporates a sea water, adding salt in small steps so that the ionic
+// strength changes a little between steps and the solver iterates with
+// many aqueous species.  Compares recomputing activity coefficients for
+// every new ionic strength with reusing them within a relative tolerance.
+// Usage: bench_gammas database [runs] [tolerance]
+// e.g. bench_gammas llnl.dat, bench_gammas phreeqc_web_lite.dat
+
+static const int steps = 40;
+
+static const char input[] =
+  "SOLUTION 1 Sea water\n"
+  "  units ppm\n"
+  "  pH 8.22; pe 8.451; density 1.023; temp 25\n"
+  "  Ca 412.3; Mg 1291.8; Na 10768.0; K 399.1\n"
+  "  Cl 19353.0; Alkalinity 141.682 as HCO3; S(6) 2712.0\n"
+  "EQUILIBRIUM_PHASES 1\n"
+  "  Calcite 0 0\n"
+  "  Gypsum 0 0\n"
+  "REACTION 1\n"
+  "  NaCl 1.0\n"
+  "  2.0 moles in 40 steps\n"
+  "SELECTED_OUTPUT\n"
+  "  -reset false\n"
+  "  -ionic_strength true\n"
+  "  -pH true\n"
+  "  -si Calcite Gypsum Halite\n"
+  "END\n";
+
+static double
+elapsed(clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static bool
+run(double tolerance, int runs, const char* database, double* seconds, IPhreeqc& obj)
+{
+  obj.SetGammaMuTolerance(tolerance);
+  if (obj.LoadDatabase(database) != 0)
+  {
+    std::cerr << obj.GetErrorString();
+    return false;
+  }
+  clock_t start = clock();
+  for (int i = 0; i < runs; ++i)
+  {
+    if (obj.RunString(input) != 0)
+    {
+      std::cerr << obj.GetErrorString();
+      return false;
+    }
+  }
+  *seconds = elapsed(start);
+  return true;
+}
+
+int
+main(int argc, const char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: bench_gammas database [runs] [tolerance]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const char* database = argv[1];
+  int runs = (argc > 2) ? atoi(argv[2]) : 20;
+  double tolerance = (argc > 3) ? atof(argv[3]) : 1e-8;
+
+  IPhreeqc exact, reused;
+  double t_exact, t_reused;
+  if (!run(0.0, runs, database, &t_exact, exact) ||
+      !run(tolerance, runs, database, &t_reused, reused))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // reused activity coefficients must give the same results within the tolerances of the solver
+  double diff = 0.0;
+  for (int row = 1; row < exact.GetSelectedOutputRowCount(); ++row)
+  {
+    for (int col = 0; col < exact.GetSelectedOutputColumnCount(); ++col)
+    {
+      VAR v1, v2;
+      ::VarInit(&v1);
+      ::VarInit(&v2);
+      exact.GetSelectedOutputValue(row, col, &v1);
+      reused.GetSelectedOutputValue(row, col, &v2);
+      if (v1.type == TT_DOUBLE && v2.type == TT_DOUBLE)
+      {
+        if (std::fabs(v1.dVal - v2.dVal) > diff) diff = std::fabs(v1.dVal - v2.dVal);
+      }
+      ::VarClear(&v1);
+      ::VarClear(&v2);
+    }
+  }
+  if (diff > 1e-6)
+  {
+    std::cerr << "Results with reused activity coefficients differ by " << diff << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  int calculations = runs * (steps + 1);
+  ::printf("calculations:   %d (%s)\n", calculations, database);
+  ::printf("tolerance 0:    %.3f s (%.3f ms/calculation)\n", t_exact, 1e3 * t_exact / calculations);
+  ::printf("tolerance %g: %.3f s (%.3f ms/calculation), max difference %g\n", tolerance, t_reused, 1e3 * t_reused / calculations, diff);
+  return EXIT_SUCCESS;
+}
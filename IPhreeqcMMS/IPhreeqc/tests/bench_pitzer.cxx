@@ -0,0 +1,101 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <IPhreeqc.hpp>
+
+// Evaporates Black Sea water to halite saturation with the Pitzer model,
+// in turn at three temperatures, as reservoirs at different temperatures
+// would be.  Most of the time is spent in the Pitzer sums of the
+// numerical derivatives.  Runs once with the columns of the derivatives
+// evaluated one after another and once on several threads (with OpenMP
+// builds), and checks that the results are identical.
+// Usage: bench_pitzer [runs] [database] [threshold]
+
+static const int steps = 10;
+static const double temps[] = { 10.0, 25.0, 40.0 };
+
+static const char input[] =
+  "SOLUTION 1 Black Sea water\n"
+  "  units mg/L; density 1.014; pH 8.0; temp %g\n"
+  "  Ca 233; Mg 679; Na 5820; K 193; S(6) 1460; Cl 10340; Br 35\n"
+  "  C 1 CO2(g) -3.5\n"
+  "EQUILIBRIUM_PHASES 1\n"
+  "  CO2(g) -3.5 10; Calcite 0 0; Gypsum 0 0; Halite 0 0\n"
+  "  Glauberite 0 0; Polyhalite 0 0\n"
+  "REACTION 1\n"
+  "  H2O -1.0\n"
+  "  50 moles in 10 steps\n"
+  "SELECTED_OUTPUT\n"
+  "  -reset false\n"
+  "  -ionic_strength true\n"
+  "  -water true\n"
+  "  -si Halite Gypsum Polyhalite\n"
+  "END\n";
+
+static double
+elapsed(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool
+run(bool parallel, int threshold, int runs, const char* database, double* seconds, std::string& results)
+{
+  IPhreeqc obj;
+  obj.SetParallelJacobianOn(parallel);
+  obj.SetParallelJacobianThreshold(threshold);
+  if (obj.LoadDatabase(database) != 0)
+  {
+    std::cerr << obj.GetErrorString();
+    return false;
+  }
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int i = 0; i < runs; ++i)
+  {
+    for (int t = 0; t < 3; ++t)
+    {
+      char buffer[sizeof(input) + 16];
+      ::snprintf(buffer, sizeof(buffer), input, temps[t]);
+      if (obj.RunString(buffer) != 0)
+      {
+        std::cerr << obj.GetErrorString();
+        return false;
+      }
+      results += obj.GetSelectedOutputString();
+    }
+  }
+  *seconds = elapsed(start);
+  return true;
+}
+
+int
+main(int argc, const char* argv[])
+{
+  int runs = (argc > 1) ? atoi(argv[1]) : 20;
+  const char* database = (argc > 2) ? argv[2] : "pitzer.dat";
+  int threshold = (argc > 3) ? atoi(argv[3]) : 16;
+
+  std::string serial, parallel;
+  double t_serial, t_parallel;
+  if (!run(false, threshold, runs, database, &t_serial, serial) ||
+      !run(true, threshold, runs, database, &t_parallel, parallel))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // columns evaluated on several threads must give exactly the same results
+  if (serial != parallel)
+  {
+    std::cerr << "Results with parallel Jacobian columns differ" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  int calculations = runs * 3 * (steps + 1);
+  ::printf("calculations: %d at 3 temperatures (%s)\n", calculations, database);
+  ::printf("serial:       %.3f s (%.3f ms/calculation)\n", t_serial, 1e3 * t_serial / calculations);
+  ::printf("parallel:     %.3f s (%.3f ms/calculation), threshold %d unknowns\n", t_parallel, 1e3 * t_parallel / calculations, threshold);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,109 @@
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <IPhreeqc.hpp>
+
+// Compares RunAccumulated with RunPrepared on a phr_mix-like workload:
+// each run mixes two saved solutions with new fractions and saves the
+// result.  Usage: bench_prepared [runs]
+
+static const char setup[] =
+  "SOLUTION 1\n"
+  "  pH 7.0\n"
+  "  Na 1.0\n"
+  "  Cl 1.0\n"
+  "SOLUTION 2\n"
+  "  pH 8.0\n"
+  "  Ca 2.0\n"
+  "  Cl 4.0\n"
+  "END\n"
+  "SELECTED_OUTPUT\n"
+  "  -reset false\n"
+  "  -pH true\n"
+  "  -totals Na Ca Cl\n"
+  "END\n";
+
+static double
+elapsed(clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int
+main(int argc, const char* argv[])
+{
+  int runs = (argc > 1) ? atoi(argv[1]) : 2000;
+
+  IPhreeqc accumulated;
+  IPhreeqc prepared;
+  if (accumulated.LoadDatabase("phreeqc.dat") != 0 || prepared.LoadDatabase("phreeqc.dat") != 0)
+  {
+    std::cerr << accumulated.GetErrorString() << prepared.GetErrorString();
+    return EXIT_FAILURE;
+  }
+  if (accumulated.RunString(setup) != 0 || prepared.RunString(setup) != 0)
+  {
+    std::cerr << accumulated.GetErrorString() << prepared.GetErrorString();
+    return EXIT_FAILURE;
+  }
+
+  clock_t start = clock();
+  for (int i = 0; i < runs; ++i)
+  {
+    char line[80];
+    double f = (double)(i % 100) / 100.0;
+    accumulated.AccumulateLine("MIX 3");
+    ::sprintf(line, "  1 %.17g", f);
+    accumulated.AccumulateLine(line);
+    ::sprintf(line, "  2 %.17g", 1.0 - f);
+    accumulated.AccumulateLine(line);
+    ::sprintf(line, "SAVE solution %d", 10 + i % 10);
+    accumulated.AccumulateLine(line);
+    accumulated.AccumulateLine("END");
+    if (accumulated.RunAccumulated() != 0)
+    {
+      std::cerr << accumulated.GetErrorString();
+      return EXIT_FAILURE;
+    }
+  }
+  double t_accumulated = elapsed(start);
+
+  start = clock();
+  int n = prepared.PrepareString("MIX 3\n  1 {f1}\n  2 {f2}\nSAVE solution {out}\nEND\n");
+  for (int i = 0; i < runs; ++i)
+  {
+    double f = (double)(i % 100) / 100.0;
+    prepared.SetPreparedValue(n, "f1", f);
+    prepared.SetPreparedValue(n, "f2", 1.0 - f);
+    prepared.SetPreparedInteger(n, "out", 10 + i % 10);
+    if (prepared.RunPrepared(n) != 0)
+    {
+      std::cerr << prepared.GetErrorString();
+      return EXIT_FAILURE;
+    }
+  }
+  double t_prepared = elapsed(start);
+
+  // both must end with the same results
+  for (int col = 0; col < accumulated.GetSelectedOutputColumnCount(); ++col)
+  {
+    VAR v1, v2;
+    VarInit(&v1);
+    VarInit(&v2);
+    accumulated.GetSelectedOutputValue(1, col, &v1);
+    prepared.GetSelectedOutputValue(1, col, &v2);
+    if (v1.type != v2.type || (v1.type == TT_DOUBLE && v1.dVal != v2.dVal))
+    {
+      std::cerr << "RunPrepared result differs from RunAccumulated in column " << col << std::endl;
+      return EXIT_FAILURE;
+    }
+    VarClear(&v1);
+    VarClear(&v2);
+  }
+
+  ::printf("runs:           %d\n", runs);
+  ::printf("RunAccumulated: %.3f s (%.1f us/run)\n", t_accumulated, 1e6 * t_accumulated / runs);
+  ::printf("RunPrepared:    %.3f s (%.1f us/run)\n", t_prepared, 1e6 * t_prepared / runs);
+  return EXIT_SUCCESS;
+}
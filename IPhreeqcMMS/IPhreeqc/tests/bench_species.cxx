@@ -0,0 +1,95 @@
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <IPhreeqc.hpp>
+
+// Replays a recorded set of models, a fresh water, a sea water, and a
+// sea water in contact with an exchanger and a surface, so that most of
+// the time is spent solving for molalities of the species in each model.
+// Usage: bench_species [runs] [database]
+
+static const int models = 3;
+
+static const char input[] =
+  "SOLUTION 1 Fresh water\n"
+  "  units mg/L\n"
+  "  pH 7.2\n"
+  "  Ca 40; Mg 12; Na 20; K 3\n"
+  "  Cl 30; S(6) 25; Alkalinity 150 as HCO3; Si 10; Fe 0.1\n"
+  "SOLUTION 2 Sea water\n"
+  "  units ppm\n"
+  "  pH 8.22; pe 8.451; density 1.023; temp 25\n"
+  "  Ca 412.3; Mg 1291.8; Na 10768.0; K 399.1; Fe 0.002\n"
+  "  Mn 0.0002 pe; Si 4.28; Cl 19353.0; Alkalinity 141.682 as HCO3\n"
+  "  S(6) 2712.0; N(5) 0.29 gfw 62.0; N(-3) 0.03 gfw 18.0\n"
+  "SOLUTION 3 Sea water\n"
+  "  units ppm\n"
+  "  pH 8.22; pe 8.451; density 1.023; temp 25\n"
+  "  Ca 412.3; Mg 1291.8; Na 10768.0; K 399.1\n"
+  "  Cl 19353.0; Alkalinity 141.682 as HCO3; S(6) 2712.0\n"
+  "EXCHANGE 3\n"
+  "  X 0.1\n"
+  "  -equilibrate 3\n"
+  "SURFACE 3\n"
+  "  Hfo_wOH 1e-3 600 1\n"
+  "  Hfo_sOH 2.5e-5\n"
+  "  -equilibrate 3\n"
+  "SELECTED_OUTPUT\n"
+  "  -reset false\n"
+  "  -pH true\n"
+  "  -molalities CaX2 Hfo_wOCa+ CaSO4 MgCO3\n"
+  "END\n";
+
+static double
+elapsed(clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int
+main(int argc, const char* argv[])
+{
+  int runs = (argc > 1) ? atoi(argv[1]) : 500;
+  const char* database = (argc > 2) ? argv[2] : "phreeqc.dat";
+
+  IPhreeqc obj;
+  if (obj.LoadDatabase(database) != 0)
+  {
+    std::cerr << obj.GetErrorString();
+    return EXIT_FAILURE;
+  }
+  obj.SetSelectedOutputStringOn(true);
+
+  // record the models once
+  if (obj.RunString(input) != 0)
+  {
+    std::cerr << obj.GetErrorString();
+    return EXIT_FAILURE;
+  }
+  std::string recorded = obj.GetSelectedOutputString();
+
+  clock_t start = clock();
+  for (int i = 0; i < runs; ++i)
+  {
+    if (obj.RunString(input) != 0)
+    {
+      std::cerr << obj.GetErrorString();
+      return EXIT_FAILURE;
+    }
+  }
+  double seconds = elapsed(start);
+
+  // replayed models must give the same results
+  if (obj.GetSelectedOutputString() != recorded)
+  {
+    std::cerr << "Replayed results differ from recorded results" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  int replays = runs * models;
+  ::printf("models replayed: %d (%s)\n", replays, database);
+  ::printf("time:            %.3f s (%.3f ms/model)\n", seconds, 1e3 * seconds / replays);
+  return EXIT_SUCCESS;
+}
@@ -4653,3 +4653,790 @@ void TestIPhreeqc::TestEx10(void)
 		CPPUNIT_ASSERT_EQUAL( std::string(expected), obj.GetAccumulatedLines() );
 	}
 }
+
+void TestIPhreeqc::TestRunPrepared(void)
+{
+	const char setup[] =
+		"SOLUTION 1\n"
+		"        pH 7.0\n"
+		"        Na 1.0\n"
+		"        Cl 1.0\n"
+		"SOLUTION 2\n"
+		"        pH 8.0\n"
+		"        Ca 2.0\n"
+		"        Cl 4.0\n"
+		"END\n"
+		"SELECTED_OUTPUT\n"
+		"        -reset false\n"
+		"        -pH true\n"
+		"        -totals Na Ca Cl\n"
+		"END\n";
+
+	IPhreeqc expected;
+	IPhreeqc obj;
+	CPPUNIT_ASSERT_EQUAL(0,     expected.LoadDatabase("phreeqc.dat"));
+	CPPUNIT_ASSERT_EQUAL(0,     obj.LoadDatabase("phreeqc.dat"));
+	CPPUNIT_ASSERT_EQUAL(0,     expected.RunString(setup));
+	CPPUNIT_ASSERT_EQUAL(0,     obj.RunString(setup));
+
+	int n = obj.PrepareString("MIX 3\n 1 {f1}\n 2 {f2}\nSAVE solution {out}\nEND\n");
+	CPPUNIT_ASSERT_EQUAL(0, n);
+
+	// not all placeholders have values
+	CPPUNIT_ASSERT_EQUAL(1,     obj.RunPrepared(n));
+	CPPUNIT_ASSERT_EQUAL(VR_INVALIDARG, obj.SetPreparedValue(n, "f3", 0.5));
+	CPPUNIT_ASSERT_EQUAL(VR_INVALIDARG, obj.SetPreparedValue(n + 1, "f1", 0.5));
+
+	for (int i = 0; i < 5; ++i)
+	{
+		char input[256];
+		double f = 0.2 * i;
+		::sprintf(input, "MIX 3\n 1 %.17g\n 2 %.17g\nSAVE solution %d\nEND\n", f, 1.0 - f, 10 + i);
+		CPPUNIT_ASSERT_EQUAL(0,     expected.RunString(input));
+
+		CPPUNIT_ASSERT_EQUAL(VR_OK, obj.SetPreparedValue(n, "f1", f));
+		CPPUNIT_ASSERT_EQUAL(VR_OK, obj.SetPreparedValue(n, "f2", 1.0 - f));
+		CPPUNIT_ASSERT_EQUAL(VR_OK, obj.SetPreparedInteger(n, "out", 10 + i));
+		CPPUNIT_ASSERT_EQUAL(0,     obj.RunPrepared(n));
+
+		CPPUNIT_ASSERT_EQUAL(expected.GetSelectedOutputRowCount(),    obj.GetSelectedOutputRowCount());
+		CPPUNIT_ASSERT_EQUAL(expected.GetSelectedOutputColumnCount(), obj.GetSelectedOutputColumnCount());
+		for (int col = 0; col < obj.GetSelectedOutputColumnCount(); ++col)
+		{
+			CVar v1, v2;
+			CPPUNIT_ASSERT_EQUAL(VR_OK, expected.GetSelectedOutputValue(1, col, &v1));
+			CPPUNIT_ASSERT_EQUAL(VR_OK, obj.GetSelectedOutputValue(1, col, &v2));
+			CPPUNIT_ASSERT_EQUAL(TT_DOUBLE, v2.type);
+			CPPUNIT_ASSERT_EQUAL(v1.dVal, v2.dVal);
+		}
+	}
+
+	// simulations with other keywords are read with the current values
+	int m = obj.PrepareString("USE solution {s}\nREACTION_TEMPERATURE\n {t}\nEND\n");
+	CPPUNIT_ASSERT_EQUAL(1, m);
+	CPPUNIT_ASSERT_EQUAL(VR_OK, obj.SetPreparedInteger(m, "s", 12));
+	CPPUNIT_ASSERT_EQUAL(VR_OK, obj.SetPreparedValue(m, "t", 40.0));
+	CPPUNIT_ASSERT_EQUAL(0,     expected.RunString("USE solution 12\nREACTION_TEMPERATURE\n 40\nEND\n"));
+	CPPUNIT_ASSERT_EQUAL(0,     obj.RunPrepared(m));
+	CPPUNIT_ASSERT_EQUAL(expected.GetSelectedOutputRowCount(), obj.GetSelectedOutputRowCount());
+	for (int col = 0; col < obj.GetSelectedOutputColumnCount(); ++col)
+	{
+		CVar v1, v2;
+		CPPUNIT_ASSERT_EQUAL(VR_OK, expected.GetSelectedOutputValue(1, col, &v1));
+		CPPUNIT_ASSERT_EQUAL(VR_OK, obj.GetSelectedOutputValue(1, col, &v2));
+		CPPUNIT_ASSERT_EQUAL(v1.dVal, v2.dVal);
+	}
+
+	obj.ClearPrepared();
+	CPPUNIT_ASSERT_EQUAL(1,     obj.RunPrepared(m));
+}
+
+static int CountLines(const char* filename, const char* text)
+{
+	int n = 0;
+	std::string line;
+	std::ifstream ifs(filename);
+	while (std::getline(ifs, line))
+	{
+		if (::strstr(line.c_str(), text)) ++n;
+	}
+	return n;
+}
+
+void TestIPhreeqc::TestPersistentFiles(void)
+{
+	char OUTPUT_FILENAME[80];
+	sprintf(OUTPUT_FILENAME, "persistent.%06d.out", ::rand());
+	std::string BACKUP_FILENAME = std::string(OUTPUT_FILENAME) + ".1";
+	if (::FileExists(OUTPUT_FILENAME))
+	{
+		::DeleteFile(OUTPUT_FILENAME);
+	}
+	if (::FileExists(BACKUP_FILENAME.c_str()))
+	{
+		::DeleteFile(BACKUP_FILENAME.c_str());
+	}
+
+	IPhreeqc obj;
+	CPPUNIT_ASSERT_EQUAL( 0,     obj.LoadDatabase("phreeqc.dat") );
+	obj.SetOutputFileOn(true);
+	obj.SetOutputFileName(OUTPUT_FILENAME);
+
+	CPPUNIT_ASSERT_EQUAL( false, obj.GetPersistentFilesOn() );
+	obj.SetPersistentFilesOn(true);
+	CPPUNIT_ASSERT_EQUAL( true,  obj.GetPersistentFilesOn() );
+
+	// each run appends to the same file
+	for (int i = 0; i < 3; ++i)
+	{
+		CPPUNIT_ASSERT_EQUAL( VR_OK, ::SOLUTION(obj, 1.0, 1.0, 1.0) );
+		CPPUNIT_ASSERT_EQUAL( 0,     obj.RunAccumulated() );
+	}
+	obj.FlushOutputFiles();
+	CPPUNIT_ASSERT_EQUAL( 3,     ::CountLines(OUTPUT_FILENAME, "Initial solution 1.") );
+
+	// turning the file off only stops writing to it
+	obj.SetOutputFileOn(false);
+	CPPUNIT_ASSERT_EQUAL( VR_OK, ::SOLUTION(obj, 1.0, 1.0, 1.0) );
+	CPPUNIT_ASSERT_EQUAL( 0,     obj.RunAccumulated() );
+	obj.SetOutputFileOn(true);
+	obj.FlushOutputFiles();
+	CPPUNIT_ASSERT_EQUAL( 3,     ::CountLines(OUTPUT_FILENAME, "Initial solution 1.") );
+
+	// files past the limit are rotated by the next flush
+	obj.SetPersistentFilesLimit(1);
+	CPPUNIT_ASSERT_EQUAL( 1,     obj.GetPersistentFilesLimit() );
+	obj.FlushOutputFiles();
+	CPPUNIT_ASSERT_EQUAL( true,  ::FileExists(BACKUP_FILENAME.c_str()) );
+	CPPUNIT_ASSERT_EQUAL( 3,     ::CountLines(BACKUP_FILENAME.c_str(), "Initial solution 1.") );
+	CPPUNIT_ASSERT_EQUAL( (size_t)0, ::FileSize(OUTPUT_FILENAME) );
+
+	CPPUNIT_ASSERT_EQUAL( VR_OK, ::SOLUTION(obj, 1.0, 1.0, 1.0) );
+	CPPUNIT_ASSERT_EQUAL( 0,     obj.RunAccumulated() );
+
+	// turning the switch off flushes and closes the file
+	obj.SetPersistentFilesOn(false);
+	CPPUNIT_ASSERT_EQUAL( 1,     ::CountLines(OUTPUT_FILENAME, "Initial solution 1.") );
+
+	::DeleteFile(OUTPUT_FILENAME);
+	::DeleteFile(BACKUP_FILENAME.c_str());
+}
+
+void TestIPhreeqc::TestLoadDatabaseSnapshot(void)
+{
+	char DATABASE_FILENAME[80];
+	sprintf(DATABASE_FILENAME, "snapshot.%06d.dat", ::rand());
+	std::string SNAPSHOT_FILENAME = std::string(DATABASE_FILENAME) + ".snap";
+	if (::FileExists(SNAPSHOT_FILENAME.c_str()))
+	{
+		::DeleteFile(SNAPSHOT_FILENAME.c_str());
+	}
+	{
+		std::ifstream ifs("phreeqc.dat", std::ios_base::binary);
+		std::ofstream ofs(DATABASE_FILENAME, std::ios_base::binary);
+		ofs << ifs.rdbuf();
+	}
+
+	const char input[] =
+		"SOLUTION 1\n"
+		"  Ca 1.0; Na 2.0; Cl 4.0 charge\n"
+		"SELECTED_OUTPUT\n"
+		"  -reset false; -pH; -ionic_strength; -si Calcite Halite\n"
+		"END\n";
+
+	IPhreeqc text;
+	CPPUNIT_ASSERT_EQUAL( 0,     text.LoadDatabase(DATABASE_FILENAME) );
+	text.SetSelectedOutputStringOn(true);
+	CPPUNIT_ASSERT_EQUAL( 0,     text.RunString(input) );
+
+	// the first load reads the text and writes the snapshot
+	IPhreeqc first;
+	CPPUNIT_ASSERT_EQUAL( 0,     first.LoadDatabaseSnapshot(SNAPSHOT_FILENAME.c_str(), DATABASE_FILENAME) );
+	CPPUNIT_ASSERT_EQUAL( true,  ::FileExists(SNAPSHOT_FILENAME.c_str()) );
+	CPPUNIT_ASSERT( ::FileSize(SNAPSHOT_FILENAME.c_str()) > 0 );
+
+	// the second load restores the snapshot and gives the same results
+	IPhreeqc second;
+	CPPUNIT_ASSERT_EQUAL( 0,     second.LoadDatabaseSnapshot(SNAPSHOT_FILENAME.c_str(), DATABASE_FILENAME) );
+	second.SetSelectedOutputStringOn(true);
+	CPPUNIT_ASSERT_EQUAL( 0,     second.RunString(input) );
+	CPPUNIT_ASSERT_EQUAL( std::string(text.GetSelectedOutputString()), std::string(second.GetSelectedOutputString()) );
+
+	// a changed database is read as text and the snapshot is rewritten
+	{
+		std::ifstream ifs("phreeqc.dat", std::ios_base::binary);
+		std::ofstream ofs(DATABASE_FILENAME, std::ios_base::binary);
+		ofs << "PHASES\nFake_calcite\n\tCaCO3 = CO3-2 + Ca+2\n\tlog_k -9.0\n";
+		ofs << ifs.rdbuf();
+	}
+	size_t size = ::FileSize(SNAPSHOT_FILENAME.c_str());
+	IPhreeqc changed;
+	CPPUNIT_ASSERT_EQUAL( 0,     changed.LoadDatabaseSnapshot(SNAPSHOT_FILENAME.c_str(), DATABASE_FILENAME) );
+	CPPUNIT_ASSERT( ::FileSize(SNAPSHOT_FILENAME.c_str()) > size );
+	CPPUNIT_ASSERT_EQUAL( 0,     changed.RunString("SOLUTION 1\nEQUILIBRIUM_PHASES\n  Fake_calcite\nEND\n") );
+
+	// a missing database is an error whether or not a snapshot exists
+	IPhreeqc missing;
+	CPPUNIT_ASSERT_EQUAL( 1,     missing.LoadDatabaseSnapshot(SNAPSHOT_FILENAME.c_str(), "missing.file") );
+
+	::DeleteFile(DATABASE_FILENAME);
+	::DeleteFile(SNAPSHOT_FILENAME.c_str());
+}
+
+void TestIPhreeqc::TestClone(void)
+{
+	const char setup[] =
+		"SOLUTION 1\n"
+		"  Ca 1.0; Na 2.0; Cl 4.0 charge\n"
+		"EQUILIBRIUM_PHASES 1\n"
+		"  Calcite 0 10\n"
+		"EXCHANGE 1\n"
+		"  X 0.1; -equilibrate 1\n"
+		"SELECTED_OUTPUT\n"
+		"  -reset false; -pH; -totals Ca Na; -molalities CaX2\n"
+		"END\n";
+	const char run[] =
+		"USE solution 1\n"
+		"USE equilibrium_phases 1\n"
+		"USE exchange 1\n"
+		"REACTION 1\n"
+		"  NaCl 1; 0.001\n"
+		"END\n";
+
+	IPhreeqc expected;
+	CPPUNIT_ASSERT_EQUAL( 0,     expected.LoadDatabase("phreeqc.dat") );
+	CPPUNIT_ASSERT_EQUAL( 0,     expected.RunString(setup) );
+	expected.SetSelectedOutputStringOn(true);
+	CPPUNIT_ASSERT_EQUAL( 0,     expected.RunString(run) );
+
+	IPhreeqc* source = new IPhreeqc;
+	CPPUNIT_ASSERT_EQUAL( 0,     source->LoadDatabase("phreeqc.dat") );
+	CPPUNIT_ASSERT_EQUAL( 0,     source->RunString(setup) );
+	source->SetSelectedOutputStringOn(true);
+
+	// the clone owns its copy of the database and reactants
+	IPhreeqc* clone = source->Clone();
+	delete source;
+	CPPUNIT_ASSERT_EQUAL( 0,     clone->GetErrorStringLineCount() );
+	CPPUNIT_ASSERT_EQUAL( true,  clone->GetSelectedOutputStringOn() );
+	CPPUNIT_ASSERT_EQUAL( 0,     clone->RunString(run) );
+	CPPUNIT_ASSERT_EQUAL( std::string(expected.GetSelectedOutputString()), std::string(clone->GetSelectedOutputString()) );
+
+	// a clone of a clone
+	IPhreeqc* second = clone->Clone();
+	delete clone;
+	second->SetSelectedOutputStringOn(true);
+	CPPUNIT_ASSERT_EQUAL( 0,     second->RunString(run) );
+	CPPUNIT_ASSERT_EQUAL( std::string(expected.GetSelectedOutputString()), std::string(second->GetSelectedOutputString()) );
+	delete second;
+
+	// a clone of an instance without a database has none
+	IPhreeqc empty;
+	IPhreeqc* none = empty.Clone();
+	CPPUNIT_ASSERT_EQUAL( 1,     none->RunString(run) );
+	delete none;
+}
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <pthread.h>
+#endif
+
+// phreeqc3-examples that need no include files and run in a tenth of a second or so
+static const char* CONCURRENT_EXAMPLES[][2] = {
+	{"ex1",   "phreeqc.dat"}, {"ex2",   "phreeqc.dat"}, {"ex2b",  "phreeqc.dat"}, {"ex3",   "phreeqc.dat"},
+	{"ex4",   "phreeqc.dat"}, {"ex5",   "phreeqc.dat"}, {"ex6",   "phreeqc.dat"}, {"ex7",   "phreeqc.dat"},
+	{"ex9",   "phreeqc.dat"}, {"ex10",  "phreeqc.dat"}, {"ex13a", "phreeqc.dat"}, {"ex13b", "phreeqc.dat"},
+	{"ex13c", "phreeqc.dat"}, {"ex14",  "phreeqc.dat"}, {"ex16",  "phreeqc.dat"}, {"ex17",  "pitzer.dat"},
+	{"ex17b", "pitzer.dat"},  {"ex18",  "phreeqc.dat"}, {"ex19",  "phreeqc.dat"}, {"ex19b", "phreeqc.dat"},
+	{"ex20a", "iso.dat"},     {"ex22",  "phreeqc.dat"}
+};
+static const int CONCURRENT_EXAMPLE_COUNT = (int)(sizeof(CONCURRENT_EXAMPLES) / sizeof(CONCURRENT_EXAMPLES[0]));
+
+static bool RunConcurrentExample(int n, std::string& output, std::string& selected, bool bytecode_on = true)
+{
+	std::string input = std::string("../phreeqc3-examples/") + CONCURRENT_EXAMPLES[n][0];
+	std::string database = std::string("../database/") + CONCURRENT_EXAMPLES[n][1];
+
+	IPhreeqc obj;
+	obj.SetBasicBytecodeOn(bytecode_on);
+	obj.SetOutputStringOn(true);
+	if (obj.LoadDatabase(database.c_str()) != 0)
+	{
+		output = obj.GetErrorString();
+		selected.clear();
+		return false;
+	}
+	obj.SetSelectedOutputStringOn(true);
+	if (obj.RunFile(input.c_str()) != 0)
+	{
+		output = obj.GetErrorString();
+		selected.clear();
+		return false;
+	}
+	output = obj.GetOutputString();
+	selected = obj.GetSelectedOutputString();
+
+	// the run time, and so the length of the dashed line above it,
+	// differs from run to run
+	size_t pos = output.rfind("End of Run after");
+	if (pos != std::string::npos)
+	{
+		pos = output.find_last_not_of("-\n", pos - 1);
+		output.erase(pos == std::string::npos ? 0 : pos + 1);
+	}
+	return true;
+}
+
+struct ConcurrentWorker
+{
+	const std::vector<std::string>* outputs;
+	const std::vector<std::string>* selected;
+	int first;                                    // threads start on different examples
+	int rounds;
+	int mismatches;
+	std::string mismatch;
+};
+
+#if defined(_WIN32)
+static unsigned __stdcall ConcurrentWorkerMain(void* arg)
+#else
+static void* ConcurrentWorkerMain(void* arg)
+#endif
+{
+	ConcurrentWorker* worker = (ConcurrentWorker*)arg;
+	for (int i = 0; i < worker->rounds * CONCURRENT_EXAMPLE_COUNT; ++i)
+	{
+		int n = (worker->first + i) % CONCURRENT_EXAMPLE_COUNT;
+		std::string output, selected;
+		RunConcurrentExample(n, output, selected);
+		if (output != (*worker->outputs)[n] || selected != (*worker->selected)[n])
+		{
+			if (worker->mismatches++ == 0)
+			{
+				worker->mismatch = CONCURRENT_EXAMPLES[n][0];
+			}
+		}
+	}
+	return 0;
+}
+
+void TestIPhreeqc::TestConcurrentInstances(void)
+{
+	const int THREADS = 4;
+	const int ROUNDS  = 1;
+
+	// serial runs give the expected results
+	std::vector<std::string> outputs(CONCURRENT_EXAMPLE_COUNT);
+	std::vector<std::string> selected(CONCURRENT_EXAMPLE_COUNT);
+	for (int n = 0; n < CONCURRENT_EXAMPLE_COUNT; ++n)
+	{
+		CPPUNIT_ASSERT_EQUAL( true,  RunConcurrentExample(n, outputs[n], selected[n]) );
+	}
+
+	// distinct instances running in parallel must give the same results byte for byte
+	ConcurrentWorker workers[THREADS];
+#if defined(_WIN32)
+	HANDLE threads[THREADS];
+#else
+	pthread_t threads[THREADS];
+#endif
+	for (int t = 0; t < THREADS; ++t)
+	{
+		workers[t].outputs    = &outputs;
+		workers[t].selected   = &selected;
+		workers[t].first      = t * CONCURRENT_EXAMPLE_COUNT / THREADS;
+		workers[t].rounds     = ROUNDS;
+		workers[t].mismatches = 0;
+#if defined(_WIN32)
+		threads[t] = (HANDLE)::_beginthreadex(NULL, 0, ConcurrentWorkerMain, &workers[t], 0, NULL);
+		CPPUNIT_ASSERT( threads[t] != 0 );
+#else
+		CPPUNIT_ASSERT_EQUAL( 0, ::pthread_create(&threads[t], NULL, ConcurrentWorkerMain, &workers[t]) );
+#endif
+	}
+	for (int t = 0; t < THREADS; ++t)
+	{
+#if defined(_WIN32)
+		::WaitForSingleObject(threads[t], INFINITE);
+		::CloseHandle(threads[t]);
+#else
+		::pthread_join(threads[t], NULL);
+#endif
+	}
+	for (int t = 0; t < THREADS; ++t)
+	{
+		// names the first example that differed
+		CPPUNIT_ASSERT_EQUAL( std::string(), workers[t].mismatch );
+		CPPUNIT_ASSERT_EQUAL( 0,     workers[t].mismatches );
+	}
+}
+
+static std::string RunBasicBytecode(const char* input, bool bytecode_on)
+{
+	IPhreeqc obj;
+	obj.SetBasicBytecodeOn(bytecode_on);
+	CPPUNIT_ASSERT_EQUAL( bytecode_on, obj.GetBasicBytecodeOn() );
+	CPPUNIT_ASSERT_EQUAL( 0,           obj.LoadDatabase("../database/phreeqc.dat") );
+	obj.SetOutputStringOn(true);
+	obj.SetSelectedOutputStringOn(true);
+	obj.RunString(input);
+
+	std::string output = obj.GetOutputString();
+	size_t pos = output.rfind("End of Run after");
+	if (pos != std::string::npos)
+	{
+		pos = output.find_last_not_of("-\n", pos - 1);
+		output.erase(pos == std::string::npos ? 0 : pos + 1);
+	}
+	return output + obj.GetSelectedOutputString() + obj.GetErrorString() + obj.GetWarningString();
+}
+
+void TestIPhreeqc::TestBasicBytecode(void)
+{
+	// compiled programs must give the same results as interpreted ones
+	const char program[] =
+		"SOLUTION 1\n"
+		"  pH 7; Na 1; Cl 1\n"
+		"SELECTED_OUTPUT\n"
+		"  -reset false\n"
+		"USER_PUNCH\n"
+		"  -headings s t u and or str log10 si mol\n"
+		"  10 DIM x(5)\n"
+		"  20 FOR i = 1 TO 5 : x(i) = i * i : NEXT i\n"
+		"  30 s = 0\n"
+		"  40 FOR i = 5 TO 1 STEP -2\n"
+		"  50   s = s + x(i)\n"
+		"  60 NEXT i\n"
+		"  70 FOR j = 3 TO 1 : s = s + 1000 : NEXT j\n"
+		"  80 GOSUB 500\n"
+		"  90 IF s > 30 THEN t = 1 ELSE t = 2\n"
+		" 100 IF s < 30 THEN 120\n"
+		" 110 t = t + 10\n"
+		" 120 u = 2^10 - 7 MOD 3 + (1 / 0) + -2^2 + 3 * (s - 1) / 2\n"
+		" 130 PUNCH s, t, u, t AND 3, t OR 4, \"str\"\n"
+		" 140 PUNCH LOG10(TOT(\"Na\")), SI(\"Halite\"), MOL(\"Na+\") * 1e3\n"
+		" 150 END\n"
+		" 500 FOR k = 1 TO 3\n"
+		" 510   IF k = 2 THEN GOTO 530\n"
+		" 520   s = s + k\n"
+		" 530 NEXT k\n"
+		" 540 RETURN\n"
+		"USER_PRINT\n"
+		"  10 i = 0\n"
+		"  20 WHILE i < 3\n"
+		"  30   i = i + 1\n"
+		"  40 WEND\n"
+		"  50 a$ = \"i = \" + STR$(i)\n"
+		"  60 PRINT a$, SQRT(ABS(-16)), EXP(LOG(2))\n"
+		"END\n";
+	CPPUNIT_ASSERT_EQUAL( RunBasicBytecode(program, false), RunBasicBytecode(program, true) );
+	CPPUNIT_ASSERT( RunBasicBytecode(program, true).find("Zero divide") != std::string::npos );
+
+	// names are looked up again when the model is rebuilt
+	const char rebuilt[] =
+		"SOLUTION 1\n"
+		"  Na 1; Cl 1\n"
+		"USER_PRINT\n"
+		"  10 PRINT SI(\"Fooite\"), SR(\"Fooite\"), MOL(\"NaFoo\"), TOT(\"Na\"), TOTMOLE(\"water\"), GFW(\"NaCl\")\n"
+		"END\n"
+		"PHASES\n"
+		"Fooite\n"
+		"  NaCl = Na+ + Cl-\n"
+		"  log_k 1.0\n"
+		"SOLUTION 2\n"
+		"  Na 1; Cl 1\n"
+		"END\n";
+	CPPUNIT_ASSERT_EQUAL( RunBasicBytecode(rebuilt, false), RunBasicBytecode(rebuilt, true) );
+	CPPUNIT_ASSERT( RunBasicBytecode(rebuilt, true).find("Mineral Fooite, not found.") != std::string::npos );
+
+	// errors are reported the same way
+	const char next_without_for[] =
+		"SOLUTION 1\n"
+		"USER_PRINT\n"
+		"  10 i = 1\n"
+		"  20 NEXT i\n"
+		"END\n";
+	CPPUNIT_ASSERT_EQUAL( RunBasicBytecode(next_without_for, false), RunBasicBytecode(next_without_for, true) );
+	CPPUNIT_ASSERT( RunBasicBytecode(next_without_for, true).find("NEXT without FOR") != std::string::npos );
+
+	for (int n = 0; n < CONCURRENT_EXAMPLE_COUNT; ++n)
+	{
+		std::string interpreted_output, interpreted_selected;
+		std::string compiled_output, compiled_selected;
+		CPPUNIT_ASSERT_EQUAL( true,  RunConcurrentExample(n, interpreted_output, interpreted_selected, false) );
+		CPPUNIT_ASSERT_EQUAL( true,  RunConcurrentExample(n, compiled_output, compiled_selected, true) );
+		CPPUNIT_ASSERT_EQUAL( interpreted_output,   compiled_output );
+		CPPUNIT_ASSERT_EQUAL( interpreted_selected, compiled_selected );
+	}
+}
+
+void TestIPhreeqc::TestCvodeJacobianReuse(void)
+{
+	// three first-order decays whose rates do not depend on one another,
+	// then a new KINETICS 1 with one of them
+	const char input[] =
+		"RATES\n"
+		"Decay_1; -start; 10 SAVE PARM(1) * M * TIME; -end\n"
+		"Decay_2; -start; 10 SAVE PARM(1) * M * TIME; -end\n"
+		"Decay_3; -start; 10 SAVE PARM(1) * M * TIME; -end\n"
+		"SOLUTION 1\n"
+		"KINETICS 1\n"
+		"Decay_1; -formula Br 1e-6; -m 1; -parms 1e-5\n"
+		"Decay_2; -formula Br 1e-6; -m 1; -parms 1e-4\n"
+		"Decay_3; -formula Br 1e-6; -m 1; -parms 1e-3\n"
+		"  -steps 86400 in 24 steps\n"
+		"  -cvode true\n"
+		"INCREMENTAL_REACTIONS true\n"
+		"SELECTED_OUTPUT\n"
+		"  -reset false\n"
+		"  -kinetic_reactants Decay_1 Decay_2 Decay_3\n"
+		"END\n"
+		"USE solution 1\n"
+		"KINETICS 1\n"
+		"Decay_2; -formula Br 1e-6; -m 1; -parms 1e-4\n"
+		"  -steps 86400 in 24 steps\n"
+		"  -cvode true\n"
+		"END\n";
+	const double k[3] = { 1e-5, 1e-4, 1e-3 };
+
+	double m[2][3];
+	long jacobians[2], f_evals[2];
+	for (int reuse = 0; reuse < 2; ++reuse)
+	{
+		IPhreeqc obj;
+		obj.SetCvodeJacobianReuseOn(reuse != 0);
+		CPPUNIT_ASSERT_EQUAL( reuse != 0, obj.GetCvodeJacobianReuseOn() );
+		CPPUNIT_ASSERT_EQUAL( 0,          obj.LoadDatabase("../database/phreeqc.dat") );
+		CPPUNIT_ASSERT_EQUAL( 0,          obj.RunString(input) );
+
+		// the last row of the first simulation
+		CVar v;
+		int row = 25;
+		for (int i = 0; i < 3; ++i)
+		{
+			CPPUNIT_ASSERT_EQUAL( VR_OK,     obj.GetSelectedOutputValue(row, 2 * i, &v) );
+			CPPUNIT_ASSERT_EQUAL( TT_DOUBLE, v.type );
+			m[reuse][i] = v.dVal;
+			CPPUNIT_ASSERT_DOUBLES_EQUAL( ::exp(-k[i] * 86400.), m[reuse][i], 1e-6 );
+		}
+		CPPUNIT_ASSERT_EQUAL( 48L, obj.PhreeqcPtr->cvode_integrations );
+		jacobians[reuse] = obj.PhreeqcPtr->cvode_jac_evals;
+		f_evals[reuse] = obj.PhreeqcPtr->cvode_f_evals;
+		CPPUNIT_ASSERT( obj.PhreeqcPtr->cvode_factorizations > 0 );
+	}
+	for (int i = 0; i < 3; ++i)
+	{
+		CPPUNIT_ASSERT_DOUBLES_EQUAL( m[0][i], m[1][i], 1e-6 );
+	}
+	CPPUNIT_ASSERT( jacobians[1] < jacobians[0] );
+	CPPUNIT_ASSERT( f_evals[1] < f_evals[0] );
+}
+
+void TestIPhreeqc::TestIneqLU(void)
+{
+	// a solution alone, whose Newton steps have only equalities, then
+	// the solution with calcite, whose steps have an inequality
+	const char input[] =
+		"SOLUTION 1\n"
+		"  units mmol/kgw\n"
+		"  pH 7.5; Ca 2; Mg 1; Na 3; Cl 4; C 4; S(6) 1\n"
+		"END\n"
+		"USE solution 1\n"
+		"EQUILIBRIUM_PHASES 1\n"
+		"  Calcite 0 1\n"
+		"END\n";
+	const char selected[] =
+		"SELECTED_OUTPUT\n"
+		"  -reset false\n"
+		"  -pH true\n"
+		"  -molalities Ca+2 CO3-2 CaHCO3+ MgSO4\n";
+
+	double values[2][2][5];
+	for (int lu = 0; lu < 2; ++lu)
+	{
+		IPhreeqc obj;
+		obj.SetIneqLUOn(lu != 0);
+		CPPUNIT_ASSERT_EQUAL( lu != 0, obj.GetIneqLUOn() );
+		CPPUNIT_ASSERT_EQUAL( 0,       obj.LoadDatabase("../database/phreeqc.dat") );
+		CPPUNIT_ASSERT_EQUAL( 0,       obj.RunString(selected) );
+		CPPUNIT_ASSERT_EQUAL( 0,       obj.RunString(input) );
+
+		CVar v;
+		for (int row = 1; row <= 2; ++row)
+		{
+			for (int col = 0; col < 5; ++col)
+			{
+				CPPUNIT_ASSERT_EQUAL( VR_OK,     obj.GetSelectedOutputValue(row, col, &v) );
+				CPPUNIT_ASSERT_EQUAL( TT_DOUBLE, v.type );
+				values[lu][row - 1][col] = v.dVal;
+			}
+		}
+		CPPUNIT_ASSERT( obj.PhreeqcPtr->ineq_solves > 0 );
+		CPPUNIT_ASSERT_EQUAL( 0L, obj.PhreeqcPtr->ineq_lu_rejects );
+		if (lu)
+		{
+			CPPUNIT_ASSERT( obj.PhreeqcPtr->ineq_lu_solves > 0 );
+			CPPUNIT_ASSERT( obj.PhreeqcPtr->ineq_lu_solves < obj.PhreeqcPtr->ineq_solves );
+		}
+		else
+		{
+			CPPUNIT_ASSERT_EQUAL( 0L, obj.PhreeqcPtr->ineq_lu_solves );
+		}
+	}
+	for (int row = 0; row < 2; ++row)
+	{
+		CPPUNIT_ASSERT_DOUBLES_EQUAL( values[0][row][0], values[1][row][0], 1e-8 );
+		for (int col = 1; col < 5; ++col)
+		{
+			CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0, values[1][row][col] / values[0][row][col], 1e-6 );
+		}
+	}
+}
+
+void TestIPhreeqc::TestGammaMuTolerance(void)
+{
+	// salt added in steps, so that the ionic strength changes between
+	// steps, with the Debye-Huckel gammas of phreeqc.dat and llnl.dat
+	const char input[] =
+		"SOLUTION 1\n"
+		"  units mmol/kgw\n"
+		"  pH 7.5; Ca 2; Mg 1; Na 3; Cl 4; Alkalinity 4; S(6) 1\n"
+		"REACTION 1\n"
+		"  NaCl 1.0\n"
+		"  0.5 moles in 5 steps\n"
+		"SELECTED_OUTPUT\n"
+		"  -reset false\n"
+		"  -pH true\n"
+		"  -molalities Ca+2 CaHCO3+ HCO3- Na+\n"
+		"END\n";
+	const char *databases[] = { "../database/phreeqc.dat", "../database/llnl.dat" };
+
+	for (int db = 0; db < 2; ++db)
+	{
+		double values[2][6][5];
+		for (int t = 0; t < 2; ++t)
+		{
+			double tolerance = t ? 1e-6 : 0.0;
+			IPhreeqc obj;
+			CPPUNIT_ASSERT_EQUAL( 0.0,       obj.GetGammaMuTolerance() );
+			obj.SetGammaMuTolerance(tolerance);
+			CPPUNIT_ASSERT_EQUAL( tolerance, obj.GetGammaMuTolerance() );
+			CPPUNIT_ASSERT_EQUAL( 0,         obj.LoadDatabase(databases[db]) );
+			CPPUNIT_ASSERT_EQUAL( tolerance, obj.PhreeqcPtr->gamma_mu_tolerance );
+			CPPUNIT_ASSERT_EQUAL( 0,         obj.RunString(input) );
+			CPPUNIT_ASSERT( !obj.PhreeqcPtr->model_image_gamma.empty() );
+
+			CVar v;
+			CPPUNIT_ASSERT_EQUAL( 7, obj.GetSelectedOutputRowCount() );
+			for (int row = 1; row <= 6; ++row)
+			{
+				for (int col = 0; col < 5; ++col)
+				{
+					CPPUNIT_ASSERT_EQUAL( VR_OK,     obj.GetSelectedOutputValue(row, col, &v) );
+					CPPUNIT_ASSERT_EQUAL( TT_DOUBLE, v.type );
+					values[t][row - 1][col] = v.dVal;
+				}
+			}
+		}
+		for (int row = 0; row < 6; ++row)
+		{
+			CPPUNIT_ASSERT_DOUBLES_EQUAL( values[0][row][0], values[1][row][0], 1e-6 );
+			for (int col = 1; col < 5; ++col)
+			{
+				CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0, values[1][row][col] / values[0][row][col], 1e-5 );
+			}
+		}
+	}
+}
+
+void TestIPhreeqc::TestPitzerTemperatureCache(void)
+{
+	// a brine at 40 C, then at 10 C, then again at 40 C, whose Pitzer
+	// parameters come from the cache the third time
+	const char input[] =
+		"SOLUTION 1\n"
+		"  temp %g\n"
+		"  units mol/kgw\n"
+		"  pH 7; Na 4; Mg 1; K 0.5; Cl 6; S(6) 0.75; Br 0.01\n"
+		"EQUILIBRIUM_PHASES 1\n"
+		"  Gypsum 0 0; Halite 0 0\n"
+		"SELECTED_OUTPUT\n"
+		"  -reset false\n"
+		"  -ionic_strength true\n"
+		"  -water true\n"
+		"  -activities Na+ Mg+2 Cl- SO4-2\n"
+		"END\n";
+	const double temps[] = { 40.0, 10.0, 40.0 };
+
+	IPhreeqc cached;
+	CPPUNIT_ASSERT_EQUAL( 0, cached.LoadDatabase("../database/pitzer.dat") );
+	for (int t = 0; t < 3; ++t)
+	{
+		char buffer[sizeof(input) + 16];
+		sprintf(buffer, input, temps[t]);
+		CPPUNIT_ASSERT_EQUAL( 0, cached.RunString(buffer) );
+	}
+	CPPUNIT_ASSERT_EQUAL( (size_t)1, cached.PhreeqcPtr->pitz_param_tk_cache.count(40.0 + 273.15) );
+	CPPUNIT_ASSERT_EQUAL( (size_t)1, cached.PhreeqcPtr->pitz_param_tk_cache.count(10.0 + 273.15) );
+	CPPUNIT_ASSERT( !cached.PhreeqcPtr->pitz_terms.empty() );
+
+	IPhreeqc fresh;
+	char buffer[sizeof(input) + 16];
+	sprintf(buffer, input, temps[2]);
+	CPPUNIT_ASSERT_EQUAL( 0, fresh.LoadDatabase("../database/pitzer.dat") );
+	CPPUNIT_ASSERT_EQUAL( 0, fresh.RunString(buffer) );
+
+	// the same results as evaluating the parameters at 40 C
+	CPPUNIT_ASSERT_EQUAL( fresh.GetSelectedOutputRowCount(),    cached.GetSelectedOutputRowCount() );
+	CPPUNIT_ASSERT_EQUAL( fresh.GetSelectedOutputColumnCount(), cached.GetSelectedOutputColumnCount() );
+	CVar v1, v2;
+	for (int row = 1; row < fresh.GetSelectedOutputRowCount(); ++row)
+	{
+		for (int col = 0; col < fresh.GetSelectedOutputColumnCount(); ++col)
+		{
+			CPPUNIT_ASSERT_EQUAL( VR_OK,     fresh.GetSelectedOutputValue(row, col, &v1) );
+			CPPUNIT_ASSERT_EQUAL( VR_OK,     cached.GetSelectedOutputValue(row, col, &v2) );
+			CPPUNIT_ASSERT_EQUAL( TT_DOUBLE, v1.type );
+			CPPUNIT_ASSERT_EQUAL( TT_DOUBLE, v2.type );
+			CPPUNIT_ASSERT_EQUAL( v1.dVal,   v2.dVal );
+		}
+	}
+}
+
+void TestIPhreeqc::TestParallelJacobian(void)
+{
+	// Black Sea water evaporated to halite saturation, whose numerical
+	// Pitzer derivatives are partly evaluated with the full Pitzer sums
+	const char input[] =
+		"SOLUTION 1 Black Sea water\n"
+		"  units mg/L; density 1.014; pH 8.0\n"
+		"  Ca 233; Mg 679; Na 5820; K 193; S(6) 1460; Cl 10340; Br 35\n"
+		"  C 1 CO2(g) -3.5\n"
+		"EQUILIBRIUM_PHASES 1\n"
+		"  CO2(g) -3.5 10; Calcite 0 0; Gypsum 0 0; Halite 0 0\n"
+		"  Glauberite 0 0; Polyhalite 0 0\n"
+		"REACTION 1\n"
+		"  H2O -1.0\n"
+		"  50 moles in 10 steps\n"
+		"SELECTED_OUTPUT\n"
+		"  -reset false\n"
+		"  -ionic_strength true\n"
+		"  -water true\n"
+		"  -pH true\n"
+		"  -si Halite Gypsum Polyhalite\n"
+		"END\n";
+
+	IPhreeqc serial;
+	CPPUNIT_ASSERT_EQUAL( false, serial.GetParallelJacobianOn() );
+	CPPUNIT_ASSERT_EQUAL( 16,    serial.GetParallelJacobianThreshold() );
+	CPPUNIT_ASSERT_EQUAL( 0,     serial.LoadDatabase("../database/pitzer.dat") );
+	CPPUNIT_ASSERT_EQUAL( 0,     serial.RunString(input) );
+	CPPUNIT_ASSERT( serial.PhreeqcPtr->pitz_columns_x.in.empty() );
+
+	IPhreeqc parallel;
+	parallel.SetParallelJacobianOn(true);
+	parallel.SetParallelJacobianThreshold(1);
+	CPPUNIT_ASSERT_EQUAL( 0,     parallel.LoadDatabase("../database/pitzer.dat") );
+	CPPUNIT_ASSERT_EQUAL( true,  parallel.GetParallelJacobianOn() );
+	CPPUNIT_ASSERT_EQUAL( 1,     parallel.GetParallelJacobianThreshold() );
+	CPPUNIT_ASSERT_EQUAL( 0,     parallel.RunString(input) );
+	CPPUNIT_ASSERT( !parallel.PhreeqcPtr->pitz_columns_x.in.empty() );
+
+	// columns evaluated beforehand give exactly the same results
+	CPPUNIT_ASSERT_EQUAL( serial.GetSelectedOutputRowCount(),    parallel.GetSelectedOutputRowCount() );
+	CPPUNIT_ASSERT_EQUAL( serial.GetSelectedOutputColumnCount(), parallel.GetSelectedOutputColumnCount() );
+	CVar v1, v2;
+	for (int row = 1; row < serial.GetSelectedOutputRowCount(); ++row)
+	{
+		for (int col = 0; col < serial.GetSelectedOutputColumnCount(); ++col)
+		{
+			CPPUNIT_ASSERT_EQUAL( VR_OK,     serial.GetSelectedOutputValue(row, col, &v1) );
+			CPPUNIT_ASSERT_EQUAL( VR_OK,     parallel.GetSelectedOutputValue(row, col, &v2) );
+			CPPUNIT_ASSERT_EQUAL( TT_DOUBLE, v1.type );
+			CPPUNIT_ASSERT_EQUAL( TT_DOUBLE, v2.type );
+			CPPUNIT_ASSERT_EQUAL( v1.dVal,   v2.dVal );
+		}
+	}
+}
@@ -87,6 +87,17 @@ class TestIPhreeqc : public CppUnit::TestFixture
 	CPPUNIT_TEST( TestGetAccumulatedLinesAfterRunString );
 	CPPUNIT_TEST( TestPBasicStopThrow );
 	CPPUNIT_TEST( TestEx10 );
+	CPPUNIT_TEST( TestRunPrepared );
+	CPPUNIT_TEST( TestPersistentFiles );
+	CPPUNIT_TEST( TestLoadDatabaseSnapshot );
+	CPPUNIT_TEST( TestClone );
+	CPPUNIT_TEST( TestConcurrentInstances );
+	CPPUNIT_TEST( TestBasicBytecode );
+	CPPUNIT_TEST( TestCvodeJacobianReuse );
+	CPPUNIT_TEST( TestIneqLU );
+	CPPUNIT_TEST( TestGammaMuTolerance );
+	CPPUNIT_TEST( TestPitzerTemperatureCache );
+	CPPUNIT_TEST( TestParallelJacobian );
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -174,6 +185,17 @@ public:
 	void TestGetAccumulatedLinesAfterRunString(void);
 	void TestPBasicStopThrow(void);
 	void TestEx10(void);
+	void TestRunPrepared(void);
+	void TestPersistentFiles(void);
+	void TestLoadDatabaseSnapshot(void);
+	void TestClone(void);
+	void TestConcurrentInstances(void);
+	void TestBasicBytecode(void);
+	void TestCvodeJacobianReuse(void);
+	void TestIneqLU(void);
+	void TestGammaMuTolerance(void);
+	void TestPitzerTemperatureCache(void);
+	void TestParallelJacobian(void);
 
 protected:
 	void TestFileOnOff(const char* FILENAME, bool output_file_on, bool error_file_on, bool log_file_on, bool selected_output_file_on, bool dump_file_on);
@@ -692,3 +692,64 @@ TestSelectedOutput::TestLongHeadings()
 	CVar v1 = co.Get(1, 0);
 	CPPUNIT_ASSERT_EQUAL(TT_EMPTY, v1.type);
 }
+
+void
+TestSelectedOutput::TestGetDoubles()
+{
+	CSelectedOutput co;
+
+	// row 1
+	CPPUNIT_ASSERT_EQUAL(0,  co.PushBackDouble("pH", 7.0));
+	CPPUNIT_ASSERT_EQUAL(0,  co.PushBackLong("step", 1));
+	CPPUNIT_ASSERT_EQUAL(0,  co.PushBackString("state", "react"));
+	CPPUNIT_ASSERT_EQUAL(0,  co.EndRow());
+
+	// row 2 (no state)
+	CPPUNIT_ASSERT_EQUAL(0,  co.PushBackDouble("pH", 8.5));
+	CPPUNIT_ASSERT_EQUAL(0,  co.PushBackLong("step", 2));
+	CPPUNIT_ASSERT_EQUAL(0,  co.EndRow());
+
+	CPPUNIT_ASSERT_EQUAL((size_t)3, co.GetColCount());
+	CPPUNIT_ASSERT_EQUAL((size_t)3, co.GetRowCount());
+
+	double values[3] = { -1.0, -1.0, -1.0 };
+	int types[3];
+
+	CPPUNIT_ASSERT_EQUAL(VR_OK, co.GetRowDoubles(1, values, types));
+	CPPUNIT_ASSERT_EQUAL(7.0,  values[0]);
+	CPPUNIT_ASSERT_EQUAL(1.0,  values[1]);
+	CPPUNIT_ASSERT_EQUAL(-1.0, values[2]);
+	CPPUNIT_ASSERT_EQUAL((int)TT_DOUBLE, types[0]);
+	CPPUNIT_ASSERT_EQUAL((int)TT_LONG,   types[1]);
+	CPPUNIT_ASSERT_EQUAL((int)TT_STRING, types[2]);
+
+	CPPUNIT_ASSERT_EQUAL(VR_OK, co.GetRowDoubles(2, values, NULL));
+	CPPUNIT_ASSERT_EQUAL(8.5,  values[0]);
+	CPPUNIT_ASSERT_EQUAL(2.0,  values[1]);
+
+	CPPUNIT_ASSERT_EQUAL(VR_INVALIDROW, co.GetRowDoubles(0, values, types));
+	CPPUNIT_ASSERT_EQUAL(VR_INVALIDROW, co.GetRowDoubles(3, values, types));
+
+	// all numbers
+	CPPUNIT_ASSERT_EQUAL(VR_OK, co.GetColumnDoubles(0, values, types));
+	CPPUNIT_ASSERT_EQUAL(7.0,  values[0]);
+	CPPUNIT_ASSERT_EQUAL(8.5,  values[1]);
+	CPPUNIT_ASSERT_EQUAL((int)TT_DOUBLE, types[1]);
+
+	values[0] = values[1] = -1.0;
+	CPPUNIT_ASSERT_EQUAL(VR_OK, co.GetColumnDoubles(2, values, types));
+	CPPUNIT_ASSERT_EQUAL(-1.0, values[0]);
+	CPPUNIT_ASSERT_EQUAL(-1.0, values[1]);
+	CPPUNIT_ASSERT_EQUAL((int)TT_STRING, types[0]);
+	CPPUNIT_ASSERT_EQUAL((int)TT_EMPTY,  types[1]);
+
+	CPPUNIT_ASSERT_EQUAL(VR_INVALIDCOL, co.GetColumnDoubles(3, values, types));
+
+	// the cells are still available one at a time
+	CVar v = co.Get(1, 2);
+	CPPUNIT_ASSERT_EQUAL(TT_STRING, v.type);
+	CPPUNIT_ASSERT_EQUAL(std::string("react"), std::string(v.sVal));
+	v = co.Get(2, 1);
+	CPPUNIT_ASSERT_EQUAL(TT_LONG, v.type);
+	CPPUNIT_ASSERT_EQUAL(2L, v.lVal);
+}
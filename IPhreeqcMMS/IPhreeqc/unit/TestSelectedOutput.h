@@ -31,6 +31,7 @@ class TestSelectedOutput :
 	CPPUNIT_TEST( TestInvalidCol );
 	CPPUNIT_TEST( TestGet );
 	CPPUNIT_TEST( TestLongHeadings );
+	CPPUNIT_TEST( TestGetDoubles );
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -55,6 +56,7 @@ public:
 	void TestInvalidCol();
 	void TestGet();
 	void TestLongHeadings();
+	void TestGetDoubles();
 };
 
 #endif // TESTSELECTEDOUTPUT_H_INCLUDED
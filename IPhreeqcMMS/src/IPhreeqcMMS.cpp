@@ -4,6 +4,16 @@
 #include "global_structures.h"      // OK, STOP
 #include "IPhreeqc.h"
 #include "Solution.h"
+#include "ISolution.h"
+#include "cxxMix.h"
+#include "Reaction.h"
+#include "Exchange.h"
+#include "Surface.h"
+#include "GasPhase.h"
+#include "PPassemblage.h"
+#include "SSassemblage.h"
+#include "cxxKinetics.h"
+#include "Temperature.h"
 
 void padfstring(char *dest, const char *src, int *len);
 
@@ -31,11 +41,15 @@ IPhreeqcMMS::IPhreeqcMMS(void)
 // COMMENT: {6/6/2012 5:05:49 PM}: pfn_pre(0)
 // COMMENT: {6/6/2012 5:05:49 PM}, pfn_post(0)
 // COMMENT: {6/6/2012 5:05:49 PM}, cookie(0)
+: MixSkipTolerance(-1.0)
+, MixSkipped(false)
+, MixPendingValid(false)
 {
 }
 
 IPhreeqcMMS::~IPhreeqcMMS(void)
 {
+	this->clear_workers();
 }
 
 // COMMENT: {6/6/2012 5:05:45 PM}void IPhreeqcMMS::SetCallbackCookie(void* c)
@@ -312,16 +326,59 @@ int IPhreeqcMMS::CatchGetTallyRowHeading(int row, char *string, unsigned int str
 	return rvalue;
 }
 
+static const char *
+mix_keyword(int key)
+{
+	switch (key)
+	{
+	case Keywords::KEY_REACTION:             return "reaction";
+	case Keywords::KEY_EXCHANGE:             return "exchange";
+	case Keywords::KEY_SURFACE:              return "surface";
+	case Keywords::KEY_GAS_PHASE:            return "gas_phase";
+	case Keywords::KEY_EQUILIBRIUM_PHASES:   return "equilibrium_phases";
+	case Keywords::KEY_SOLID_SOLUTIONS:      return "solid_solution";
+	case Keywords::KEY_KINETICS:             return "kinetics";
+	case Keywords::KEY_REACTION_TEMPERATURE: return "reaction_temperature";
+	}
+	return "";
+}
+
+static double
+mix_fraction(double frac)
+{
+	// MIX fractions have always been written with %g; round them the
+	// same way so the native path matches the script path exactly
+	char token[40];
+	double d;
+	::sprintf(token, "%g", frac);
+	::sscanf(token, SCANFORMAT, &d);
+	return d;
+}
+
 int IPhreeqcMMS::PreMixCallback(struct MixVars* pvars)
 {
-// COMMENT: {6/6/2012 5:18:37 PM}	struct MixVars *pvars;
 	int i;
 	char line[80];
 	bool evap_or_sublimation;
 
+	this->MixPlan.clear();
 	if (!pvars) return ERROR;
 
-// COMMENT: {6/6/2012 5:14:41 PM}	pvars = (struct MixVars *)cookie;
+	// a mix whose inputs have not changed since it was last run is
+	// replayed by RunMix and PostMixCallback
+	this->MixSkipped = this->quiescent_mix(pvars);
+	if (this->MixSkipped) return OK;
+
+	// only the tally columns of entities in the mix are filled
+	std::map<int, std::vector<int> >::const_iterator ct = this->TallyColumns.find(pvars->res_class);
+	if (ct != this->TallyColumns.end())
+	{
+		this->PhreeqcPtr->select_tally_table_columns(pvars->n_user, &ct->second[0], (int)ct->second.size());
+	}
+	else
+	{
+		this->PhreeqcPtr->select_tally_table_columns(pvars->n_user, NULL, 0);
+	}
 
 	if (pvars->fill_factor <= 0.0) 
 	{
@@ -376,10 +433,8 @@ int IPhreeqcMMS::PreMixCallback(struct MixVars* pvars)
 		}
 	}
 
-	/* MIX */
-	if (::AccumulateLine(pvars->id, "MIX") != IPQ_OK) {
-		return ERROR;
-	}
+	/* MIX; SAVE solution n_user[Solution]; COPY SOLUTION n_user[Solution] index_conserv; END */
+	MixBlock conserv;
 	for (i = 0; i < pvars->count; ++i) {
 		double factor;
 		if (evap_or_sublimation)
@@ -390,28 +445,11 @@ int IPhreeqcMMS::PreMixCallback(struct MixVars* pvars)
 		{
 			factor = 1.0;
 		}
-		sprintf(line, "\t%d %g", pvars->solutions[i], pvars->fracs[i]*factor);
-		if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-			return ERROR;
-		}
-	}
-
-	/* SAVE solution n_user[Solution] */
-	sprintf(line, "SAVE solution %d", pvars->n_user[Solution]);
-	if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-		return ERROR;
-	}
-
-	/* COPY SOLUTION n_user[Solution] index_conserv */
-	sprintf(line, "COPY SOLUTION %d %d", pvars->n_user[Solution], pvars->index_conserv);
-	if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-		return ERROR;
-	}
-
-	/* END */
-	if (::AccumulateLine(pvars->id, "END") != IPQ_OK) {
-		return ERROR;
+		conserv.mix.push_back(std::make_pair(pvars->solutions[i], pvars->fracs[i]*factor));
 	}
+	conserv.n_save = pvars->n_user[Solution];
+	conserv.n_copy = pvars->index_conserv;
+	this->MixPlan.push_back(conserv);
 
 
 	if (pvars->n_user[Reaction]    < 0
@@ -430,8 +468,6 @@ int IPhreeqcMMS::PreMixCallback(struct MixVars* pvars)
 		&&
 		pvars->n_user[Temperature] < 0)
 	{
-	  if (pvars->files_on) this->OutputAccumulatedLines();
-
 	  this->PhreeqcPtr->zero_tally_table();
 	  this->PhreeqcPtr->fill_tally_table(pvars->n_user, pvars->index_conserv, 0); /* initial */
 
@@ -439,29 +475,17 @@ int IPhreeqcMMS::PreMixCallback(struct MixVars* pvars)
 	}
 
 
-	/* MIX */
-	if (::AccumulateLine(pvars->id, "MIX") != IPQ_OK) {
-		return ERROR;
-	}
-	sprintf(line, "\t%d %g", pvars->n_user[Solution], pvars->fill_factor);
-	if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-		return ERROR;
-	}
-
-	/* SAVE solution n_user[Solution] */
-	sprintf(line, "SAVE solution %d", pvars->n_user[Solution]);
-	if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-		return ERROR;
-	}
+	/* MIX; SAVE solution n_user[Solution]; USE/SAVE entities; END */
+	MixBlock rxn;
+	rxn.mix.push_back(std::make_pair(pvars->n_user[Solution], pvars->fill_factor));
+	rxn.n_save = pvars->n_user[Solution];
+	rxn.n_copy = -1;
 
 	/* Reaction */
 	if (pvars->n_user[Reaction] >= 0) {
 		if (this->PhreeqcPtr->entity_exists("reaction", pvars->n_user[Reaction])) {
 			this->PhreeqcPtr->set_reaction_moles(pvars->n_user[Reaction], pvars->rxnmols * pvars->fill_factor);
-			sprintf(line, "USE reaction %d", pvars->n_user[Reaction]);
-			if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-				return ERROR;
-			}
+			rxn.use.push_back(std::make_pair((int)Keywords::KEY_REACTION, pvars->n_user[Reaction]));
 		}
 		else {
 			sprintf(line, "REACTION %d doesn't exist\n", pvars->n_user[Reaction]);
@@ -473,14 +497,8 @@ int IPhreeqcMMS::PreMixCallback(struct MixVars* pvars)
 	/* Exchange */
 	if (pvars->n_user[Exchange] >= 0) {
 		if (this->PhreeqcPtr->entity_exists("exchange", pvars->n_user[Exchange])) {
-			sprintf(line, "USE exchange %d", pvars->n_user[Exchange]);
-			if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-				return ERROR;
-			}
-			sprintf(line, "SAVE exchange %d", pvars->n_user[Exchange]);
-			if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-				return ERROR;
-			}
+			rxn.use.push_back(std::make_pair((int)Keywords::KEY_EXCHANGE, pvars->n_user[Exchange]));
+			rxn.save.push_back(std::make_pair((int)Keywords::KEY_EXCHANGE, pvars->n_user[Exchange]));
 		}
 		else {
 			sprintf(line, "EXCHANGE %d doesn't exist\n", pvars->n_user[Exchange]);
@@ -490,14 +508,8 @@ int IPhreeqcMMS::PreMixCallback(struct MixVars* pvars)
 	/* Surface */
 	if (pvars->n_user[Surface] >= 0) {
 		if (this->PhreeqcPtr->entity_exists("surface", pvars->n_user[Surface])) {
-			sprintf(line, "USE surface %d", pvars->n_user[Surface]);
-			if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-				return ERROR;
-			}
-			sprintf(line, "SAVE surface %d", pvars->n_user[Surface]);
-			if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-				return ERROR;
-			}
+			rxn.use.push_back(std::make_pair((int)Keywords::KEY_SURFACE, pvars->n_user[Surface]));
+			rxn.save.push_back(std::make_pair((int)Keywords::KEY_SURFACE, pvars->n_user[Surface]));
 		}
 		else {
 			sprintf(line, "SURFACE %d doesn't exist\n", pvars->n_user[Surface]);
@@ -507,14 +519,8 @@ int IPhreeqcMMS::PreMixCallback(struct MixVars* pvars)
 	/* Gas_phase */
 	if (pvars->n_user[Gas_phase] >= 0) {
 		if (this->PhreeqcPtr->entity_exists("gas_phase", pvars->n_user[Gas_phase])) {
-			sprintf(line, "USE gas_phase %d", pvars->n_user[Gas_phase]);
-			if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-				return ERROR;
-			}
-			sprintf(line, "SAVE gas_phase %d", pvars->n_user[Gas_phase]);
-			if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-				return ERROR;
-			}
+			rxn.use.push_back(std::make_pair((int)Keywords::KEY_GAS_PHASE, pvars->n_user[Gas_phase]));
+			rxn.save.push_back(std::make_pair((int)Keywords::KEY_GAS_PHASE, pvars->n_user[Gas_phase]));
 		}
 		else {
 			sprintf(line, "GAS_PHASE %d doesn't exist\n", pvars->n_user[Gas_phase]);
@@ -524,14 +530,8 @@ int IPhreeqcMMS::PreMixCallback(struct MixVars* pvars)
 	/* Pure_phase */
 	if (pvars->n_user[Pure_phase] >= 0) {
 		if (this->PhreeqcPtr->entity_exists("equilibrium_phases", pvars->n_user[Pure_phase])) {
-			sprintf(line, "USE equilibrium_phases %d", pvars->n_user[Pure_phase]);
-			if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-				return ERROR;
-			}
-			sprintf(line, "SAVE equilibrium_phases %d", pvars->n_user[Pure_phase]);
-			if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-				return ERROR;
-			}
+			rxn.use.push_back(std::make_pair((int)Keywords::KEY_EQUILIBRIUM_PHASES, pvars->n_user[Pure_phase]));
+			rxn.save.push_back(std::make_pair((int)Keywords::KEY_EQUILIBRIUM_PHASES, pvars->n_user[Pure_phase]));
 		}
 		else {
 			sprintf(line, "EQUILIBRIUM_PHASES %d doesn't exist\n", pvars->n_user[Pure_phase]);
@@ -541,14 +541,8 @@ int IPhreeqcMMS::PreMixCallback(struct MixVars* pvars)
 	/* Ss_phase */
 	if (pvars->n_user[Ss_phase] >= 0) {
 		if (this->PhreeqcPtr->entity_exists("solid_solution", pvars->n_user[Ss_phase])) {
-			sprintf(line, "USE solid_solution %d", pvars->n_user[Ss_phase]);
-			if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-				return ERROR;
-			}
-			sprintf(line, "SAVE solid_solution %d", pvars->n_user[Ss_phase]);
-			if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-				return ERROR;
-			}
+			rxn.use.push_back(std::make_pair((int)Keywords::KEY_SOLID_SOLUTIONS, pvars->n_user[Ss_phase]));
+			rxn.save.push_back(std::make_pair((int)Keywords::KEY_SOLID_SOLUTIONS, pvars->n_user[Ss_phase]));
 		}
 		else {
 			sprintf(line, "SOLID_SOLUTION %d doesn't exist\n", pvars->n_user[Ss_phase]);
@@ -558,11 +552,8 @@ int IPhreeqcMMS::PreMixCallback(struct MixVars* pvars)
 	/* Kinetics */
 	if (pvars->n_user[Kinetics] >= 0) {
 		if (this->PhreeqcPtr->entity_exists("kinetics", pvars->n_user[Kinetics])) {
-			sprintf(line, "USE kinetics %d", pvars->n_user[Kinetics]);
 			this->PhreeqcPtr->set_kinetics_time(pvars->n_user[Kinetics], pvars->tsec);
-			if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-				return ERROR;
-			}
+			rxn.use.push_back(std::make_pair((int)Keywords::KEY_KINETICS, pvars->n_user[Kinetics]));
 		}
 		else {
 			sprintf(line, "KINETICS %d doesn't exist\n", pvars->n_user[Kinetics]);
@@ -572,162 +563,1306 @@ int IPhreeqcMMS::PreMixCallback(struct MixVars* pvars)
 	/* Temperature */
 	if (pvars->n_user[Temperature] >= 0) {
 		if (this->PhreeqcPtr->entity_exists("reaction_temperature", pvars->n_user[Temperature])) {
-			sprintf(line, "USE reaction_temperature %d", pvars->n_user[Temperature]);
 			this->PhreeqcPtr->set_reaction_temperature(pvars->n_user[Temperature], pvars->tempc);
-			if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-				return ERROR;
-			}
+			rxn.use.push_back(std::make_pair((int)Keywords::KEY_REACTION_TEMPERATURE, pvars->n_user[Temperature]));
 		}
 		else {
 			sprintf(line, "REACTION_TEMPERATURE %d doesn't exist\n", pvars->n_user[Temperature]);
 			this->warning_msg(line);
 		}
 	}
+	this->MixPlan.push_back(rxn);
 
-	/* END */
-	if (::AccumulateLine(pvars->id, "END") != IPQ_OK) {
-		return ERROR;
+	/* MIX; SAVE solution n_user[Solution]; END */
+	MixBlock unfill;
+	unfill.mix.push_back(std::make_pair(pvars->n_user[Solution], 1.0 / pvars->fill_factor));
+	unfill.n_save = pvars->n_user[Solution];
+	unfill.n_copy = -1;
+	this->MixPlan.push_back(unfill);
+
+	this->PhreeqcPtr->zero_tally_table();
+	this->PhreeqcPtr->fill_tally_table(pvars->n_user, pvars->index_conserv, 0); /* initial */
+
+	if (pvars->files_on)
+	{
+		pvars->orig_out = this->GetOutputFileOn() ? 1 : 0;
+		this->SetOutputFileOn(true);
 	}
 
-	/* MIX */
-	if (::AccumulateLine(pvars->id, "MIX") != IPQ_OK) {
-		return ERROR;
+	return OK;
+}
+
+int IPhreeqcMMS::PostMixCallback(struct MixVars* pvars)
+{
+	if (!pvars) return ERROR;
+
+	int row_dim, col_dim;
+	std::vector<char> *written;
+	double *array = this->tally_output(pvars, &row_dim, &col_dim, &written);
+
+	if (this->MixSkipped)
+	{
+		const MixRecord& record = this->MixRecords[pvars->n_user[Solution]];
+		std::copy(record.tally.begin(), record.tally.end(), array);
+		if (written) written->assign(written->size(), TRUE);
+		return OK;
 	}
-	sprintf(line, "\t%d %g", pvars->n_user[Solution], 1.0 / pvars->fill_factor);
-	if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-		return ERROR;
+
+	if (pvars->files_on && this->MixPlan.size() > 1)
+	{
+		this->SetOutputFileOn(pvars->orig_out != 0);
 	}
 
-	/* SAVE solution n_user[Solution] */
-	sprintf(line, "SAVE solution %d", pvars->n_user[Solution]);
-	if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-		return ERROR;
+
+	this->PhreeqcPtr->fill_tally_table(pvars->n_user, pvars->index_conserv, 1); /* final */
+	this->PhreeqcPtr->store_tally_table(array, row_dim, col_dim, pvars->fill_factor, written);
+	this->save_mix_record(pvars, array, row_dim, col_dim);
+	return OK;
+}
+
+int IPhreeqcMMS::RunMix(struct MixVars* pvars)
+{
+	static const char sz_routine[] = "RunMix";
+
+	if (this->MixSkipped)
+	{
+		// selected output of the last run of this mix
+		const MixRecord& record = this->MixRecords[pvars->n_user[Solution]];
+		std::map< int, CSelectedOutput* >::iterator it = this->SelectedOutputMap.find(this->CurrentSelectedOutputUserNumber);
+		if (it == this->SelectedOutputMap.end())
+		{
+			it = this->SelectedOutputMap.insert(std::make_pair(this->CurrentSelectedOutputUserNumber, new CSelectedOutput)).first;
+		}
+		*it->second = record.selected;
+		return 0;
 	}
 
-#ifdef SKIP
-	/* MIX */
-	
-	sprintf(line, "SOLUTION_MIX %d", pvars->n_user[Solution]);
-	if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-		return ERROR;
+	// the script path echoes the input, which is only wanted when
+	// output is being written
+	if (pvars->files_on || this->OutputFileOn || this->OutputStringOn)
+	{
+		if (this->accumulate_mix_plan(pvars) != OK)
+		{
+			return ERROR;
+		}
+		if (pvars->files_on && this->MixPlan.size() == 1) this->OutputAccumulatedLines();
+		return this->RunAccumulated();
 	}
-	sprintf(line, "\t%d %g", pvars->n_user[Solution], 1.0 / pvars->fill_factor);
-	if (::AccumulateLine(pvars->id, line) != IPQ_OK) {
-		return ERROR;
+
+	try
+	{
+		// these may throw
+		this->open_output_files(sz_routine);
+		this->check_database(sz_routine);
+
+		this->PhreeqcPtr->input_error = 0;
+		this->io_error_count = 0;
+
+		// this may throw
+		this->do_mix_plan();
 	}
-#endif
-	/* END */
-	if (::AccumulateLine(pvars->id, "END") != IPQ_OK) {
-		return ERROR;
+	catch (const IPhreeqcStop&)
+	{
+		// do nothing
+	}
+	catch(std::exception &e)
+	{
+		std::string errmsg("RunMix: ");
+		errmsg += e.what();
+		try
+		{
+			this->PhreeqcPtr->error_msg(errmsg.c_str(), STOP); // throws PhreeqcStop
+		}
+		catch (const IPhreeqcStop&)
+		{
+			// do nothing
+		}
+		throw;
+	}
+	catch(...)
+	{
+		const char *errmsg = "RunMix: An unhandled exception occured.\n";
+		try
+		{
+			this->PhreeqcPtr->error_msg(errmsg, STOP); // throws PhreeqcStop
+		}
+		catch (const IPhreeqcStop&)
+		{
+			// do nothing
+		}
+		throw;
 	}
 
-	/* OutputLines(); */
+	this->close_output_files();
+	this->update_errors();
 
-	this->PhreeqcPtr->zero_tally_table();
-	this->PhreeqcPtr->fill_tally_table(pvars->n_user, pvars->index_conserv, 0); /* initial */
+	return this->PhreeqcPtr->get_input_errors();
+}
 
-	if (pvars->files_on)
+static void
+clear_mix_results(double *ph, double *ph_final, double *tempc, double *conc_conserv, int conc_dim)
+{
+	*ph       = -987654321.;
+	*ph_final = -987654321.;
+	*tempc    = -987654321.;
+	for (int i = 0; i < conc_dim; ++i)
 	{
-		pvars->orig_out = ::GetOutputFileOn(pvars->id);
-		::SetOutputFileOn(pvars->id, 1);
+		conc_conserv[i] = -987654321.;
 	}
+}
 
-	return OK;
+int IPhreeqcMMS::RunMixBatch(int nmix, struct MixVars* pvars, double *ph, double *ph_final, double *tempc, double *conc_conserv, int conc_dim)
+{
+	int i;
+	int errors = 0;
+
+	for (i = 0; i < nmix; ++i)
+	{
+		// later mixes may use solutions saved by this one
+		errors += this->run_mix_results(i, &pvars[i], &ph[i], &ph_final[i], &tempc[i], &conc_conserv[i * conc_dim], conc_dim);
+		if (errors) break;
+	}
+	return errors;
 }
 
-int IPhreeqcMMS::PostMixCallback(struct MixVars* pvars)
+int IPhreeqcMMS::run_mix_results(int index, struct MixVars* pvars, double *ph, double *ph_final, double *tempc, double *conc_conserv, int conc_dim)
 {
-	if (!pvars) return ERROR;
+	// a mix that could not be set up leaves the selected output and the
+	// tally of the previous mix, so none of its results are returned
+	if (this->PreMixCallback(pvars) != OK)
+	{
+		clear_mix_results(ph, ph_final, tempc, conc_conserv, conc_dim);
+		std::ostringstream oss;
+		oss << "RunMixBatch: Unable to set up mix " << index + 1 << " (solution " << pvars->n_user[Solution] << ").\n";
+		this->AddError(oss.str().c_str());
+		return 1;
+	}
+	int errors = this->RunMix(pvars);
+	this->PostMixCallback(pvars);
+	errors += this->get_mix_results(ph, ph_final, tempc, conc_conserv, conc_dim);
+	return errors;
+}
 
-	if (pvars->files_on)
+static bool
+check_mix_heading(IPhreeqcMMS *ptr, int col, const char *heading)
+{
+	bool ok = false;
+	VAR v;
+	::VarInit(&v);
+	if (ptr->GetSelectedOutputValue(0, col, &v) == VR_OK && v.type == TT_STRING)
 	{
-		::SetOutputFileOn(pvars->id, pvars->orig_out);
+		ok = (::strncmp(v.sVal, heading, ::strlen(heading)) == 0);
 	}
+	::VarClear(&v);
+	return ok;
+}
+
+int IPhreeqcMMS::get_mix_results(double *ph, double *ph_final, double *tempc, double *conc_conserv, int conc_dim)
+{
+	int i;
 
+	clear_mix_results(ph, ph_final, tempc, conc_conserv, conc_dim);
 
-	this->PhreeqcPtr->fill_tally_table(pvars->n_user, pvars->index_conserv, 1); /* final */
-	this->PhreeqcPtr->store_tally_table(pvars->array, pvars->row_dim, pvars->col_dim, pvars->fill_factor);
-	return OK;
+	/* same layout phr_mix expects: pH, temp(C), conservative concentrations */
+	/* (the row count includes the headings) */
+	int rows = this->GetSelectedOutputRowCount() - 1;
+	if (rows != 1 && rows != 3)
+	{
+		this->AddError("RunMixBatch: Expected rows = 1 or 3. No selected_output defined?\n");
+		return 1;
+	}
+	if (!check_mix_heading(this, 0, "pH") || !check_mix_heading(this, 1, "temp(C)"))
+	{
+		this->AddWarning("RunMixBatch: Expected pH and temp(C) in the first selected_output columns.\n");
+	}
+
+	// fetch whole rows: row 1 is the mix, row 2 (if any) the reaction
+	int cols = this->GetSelectedOutputColumnCount();
+	if (cols < 2)
+	{
+		return 1;
+	}
+	std::vector<double> values(cols);
+	std::vector<int> vtypes(cols);
+	if (this->GetSelectedOutputRowDoubles(1, &values[0], &vtypes[0]) != VR_OK
+		|| (vtypes[0] != TT_DOUBLE && vtypes[0] != TT_LONG)
+		|| (vtypes[1] != TT_DOUBLE && vtypes[1] != TT_LONG))
+	{
+		return 1;
+	}
+	*ph    = values[0];
+	*tempc = values[1];
+	for (i = 2; i < cols && i - 2 < conc_dim; ++i)
+	{
+		if (vtypes[i] == TT_DOUBLE || vtypes[i] == TT_LONG)
+		{
+			conc_conserv[i - 2] = values[i];
+		}
+	}
+
+	if (rows > 1 && this->GetSelectedOutputRowDoubles(2, &values[0], &vtypes[0]) == VR_OK
+		&& (vtypes[0] == TT_DOUBLE || vtypes[0] == TT_LONG))
+	{
+		*ph_final = values[0];
+	}
+	return 0;
 }
 
-int IPhreeqcMMS::Melt_pack(int ipack, int imelt, double eps, double ipf, double fmelt, double rstd)
+static bool
+mix_close(double a, double b, double tol)
+{
+	return fabs(a - b) <= tol * std::max(fabs(a), fabs(b));
+}
+
+static void
+get_mix_state(const cxxSolution& soln, MixSolutionState& state)
+{
+	state.totals     = soln.Get_totals();
+	state.total_h    = soln.Get_total_h();
+	state.total_o    = soln.Get_total_o();
+	state.cb         = soln.Get_cb();
+	state.mass_water = soln.Get_mass_water();
+	state.tc         = soln.Get_tc();
+	state.patm       = soln.Get_patm();
+}
+
+static bool
+same_mix_state(const cxxSolution& soln, const MixSolutionState& state, double tol)
+{
+	if (!mix_close(soln.Get_total_h(), state.total_h, tol)) return false;
+	if (!mix_close(soln.Get_total_o(), state.total_o, tol)) return false;
+	if (!mix_close(soln.Get_mass_water(), state.mass_water, tol)) return false;
+	if (!mix_close(soln.Get_tc() + 273.15, state.tc + 273.15, tol)) return false;
+	if (!mix_close(soln.Get_patm(), state.patm, tol)) return false;
+
+	const cxxNameDouble& totals = soln.Get_totals();
+	if (totals.size() != state.totals.size()) return false;
+	double sum = 0.0;
+	cxxNameDouble::const_iterator it = totals.begin();
+	cxxNameDouble::const_iterator jt = state.totals.begin();
+	for (; it != totals.end(); ++it, ++jt)
+	{
+		if (it->first != jt->first) return false;
+		if (!mix_close(it->second, jt->second, tol)) return false;
+		sum += fabs(it->second);
+	}
+
+	// charge imbalance is compared relative to the dissolved load
+	double cb = soln.Get_cb();
+	return fabs(cb - state.cb) <= tol * std::max(std::max(fabs(cb), fabs(state.cb)), sum);
+}
+
+bool IPhreeqcMMS::quiescent_mix(const struct MixVars* pvars)
+{
+	//
+	// Collects the inputs of the mix in MixPending and returns true if
+	// they are within MixSkipTolerance of the inputs of the last run of
+	// the same mix, and that run's results have not been changed since.
+	// Running the mix again would then reproduce those results.
+	//
+	Phreeqc* phreeqc_ptr = this->PhreeqcPtr;
+	int i;
+
+	this->MixPendingValid = false;
+	int n_save = pvars->n_user[Solution];
+	int res_class = pvars->res_class;
+
+	// output was asked for
+	if (this->MixSkipTolerance < 0.0 || pvars->files_on || this->OutputFileOn || this->OutputStringOn
+		|| this->get_sel_out_file_on(this->CurrentSelectedOutputUserNumber)
+		|| this->get_sel_out_string_on(this->CurrentSelectedOutputUserNumber))
+	{
+		this->MixesRun[res_class]++;
+		return false;
+	}
+
+	MixRecord& pending = this->MixPending;
+	pending.solutions.assign(pvars->solutions, pvars->solutions + pvars->count);
+	pending.fracs.assign(pvars->fracs, pvars->fracs + pvars->count);
+	pending.n_user.assign(pvars->n_user, pvars->n_user + Temperature + 1);
+	pending.index_conserv = pvars->index_conserv;
+	pending.fill_factor   = pvars->fill_factor;
+	pending.rxnmols       = pvars->rxnmols;
+	pending.tempc         = pvars->tempc;
+	pending.tsec          = pvars->tsec;
+	pending.inputs.resize(pvars->count);
+	for (i = 0; i < pvars->count; ++i)
+	{
+		const cxxSolution* soln_ptr = Utilities::Rxn_find(phreeqc_ptr->Rxn_solution_map, pvars->solutions[i]);
+		if (soln_ptr == NULL)
+		{
+			this->MixesRun[res_class]++;
+			return false;
+		}
+		get_mix_state(*soln_ptr, pending.inputs[i]);
+	}
+	this->MixPendingValid = true;
+
+	bool same = false;
+	std::map<int, MixRecord>::const_iterator it = this->MixRecords.find(n_save);
+	if (it != this->MixRecords.end())
+	{
+		const MixRecord& record = it->second;
+		double tol = this->MixSkipTolerance;
+
+		// the saved columns are copied back into the array of this mix,
+		// which must have the dimensions they were stored with
+		int row_dim, col_dim;
+		std::vector<char> *written;
+		this->tally_output(pvars, &row_dim, &col_dim, &written);
+
+		same = (record.row_dim == row_dim
+			&& record.col_dim == col_dim
+			&& record.solutions == pending.solutions
+			&& record.n_user == pending.n_user
+			&& record.index_conserv == pending.index_conserv
+			&& record.fill_factor == pending.fill_factor
+			&& record.rxnmols == pending.rxnmols
+			&& record.tsec == pending.tsec
+			&& mix_close(record.tempc + 273.15, pending.tempc + 273.15, tol));
+		for (i = 0; same && i < pvars->count; ++i)
+		{
+			same = mix_close(record.fracs[i], pending.fracs[i], tol);
+		}
+
+		// exchangers, surfaces, phases and kinetic reactants keep their
+		// state between mixes; it is unchanged only if the mix is a
+		// reservoir reacting with itself and nothing else
+		bool entities = false;
+		for (i = Exchange; i <= Kinetics; ++i)
+		{
+			if (pvars->n_user[i] >= 0) entities = true;
+		}
+		if (same && entities)
+		{
+			same = (pvars->count == 1 && pvars->solutions[0] == n_save && pvars->fracs[0] == 1.0
+				&& (pvars->n_user[Reaction] < 0 || pvars->rxnmols == 0.0)
+				&& (pvars->n_user[Kinetics] < 0 || pvars->tsec == 0.0));
+		}
+
+		for (i = 0; same && i < pvars->count; ++i)
+		{
+			const cxxSolution* soln_ptr = Utilities::Rxn_find(phreeqc_ptr->Rxn_solution_map, pvars->solutions[i]);
+			same = same_mix_state(*soln_ptr, record.inputs[i], tol);
+		}
+		if (same)
+		{
+			const cxxSolution* out_ptr = Utilities::Rxn_find(phreeqc_ptr->Rxn_solution_map, n_save);
+			const cxxSolution* conserv_ptr = Utilities::Rxn_find(phreeqc_ptr->Rxn_solution_map, pvars->index_conserv);
+			same = (out_ptr != NULL && conserv_ptr != NULL
+				&& same_mix_state(*out_ptr, record.output, tol)
+				&& same_mix_state(*conserv_ptr, record.conserv, tol));
+		}
+	}
+
+	if (same)
+	{
+		this->MixesSkipped[res_class]++;
+	}
+	else
+	{
+		this->MixesRun[res_class]++;
+	}
+	return same;
+}
+
+void IPhreeqcMMS::save_mix_record(const struct MixVars* pvars, const double *array, int row_dim, int col_dim)
+{
+	// keeps the inputs and results of a mix that ran without errors
+	Phreeqc* phreeqc_ptr = this->PhreeqcPtr;
+	int n_save = pvars->n_user[Solution];
+
+	if (!this->MixPendingValid || phreeqc_ptr->get_input_errors() > 0)
+	{
+		this->MixRecords.erase(n_save);
+		return;
+	}
+	const cxxSolution* out_ptr = Utilities::Rxn_find(phreeqc_ptr->Rxn_solution_map, n_save);
+	const cxxSolution* conserv_ptr = Utilities::Rxn_find(phreeqc_ptr->Rxn_solution_map, pvars->index_conserv);
+	std::map< int, CSelectedOutput* >::const_iterator ci = this->SelectedOutputMap.find(this->CurrentSelectedOutputUserNumber);
+	if (out_ptr == NULL || conserv_ptr == NULL || ci == this->SelectedOutputMap.end())
+	{
+		this->MixRecords.erase(n_save);
+		return;
+	}
+
+	MixRecord& record = this->MixRecords[n_save];
+	std::swap(record, this->MixPending);
+	get_mix_state(*out_ptr, record.output);
+	get_mix_state(*conserv_ptr, record.conserv);
+	size_t n = (size_t)(row_dim + 1) * phreeqc_ptr->count_tally_table_columns;
+	record.tally.assign(array, array + n);
+	record.row_dim = row_dim;
+	record.col_dim = col_dim;
+	record.selected = *ci->second;
+	this->MixPendingValid = false;
+}
+
+int IPhreeqcMMS::CreateWorkers(int n)
+{
+	int i;
+
+	this->clear_workers();
+	for (i = 0; i < n; ++i)
+	{
+		IPhreeqcMMS* worker = new IPhreeqcMMS;
+
+		// Phreeqc::operator= points the output streams at the console
+		*worker->PhreeqcPtr = *this->PhreeqcPtr;
+		worker->Set_output_ostream(NULL);
+		worker->Set_error_ostream(NULL);
+		worker->DatabaseLoaded = this->DatabaseLoaded;
+		worker->MixSkipTolerance = this->MixSkipTolerance;
+		worker->TallyColumns = this->TallyColumns;
+		worker->TallyBuffers = this->TallyBuffers;
+		this->Workers.push_back(worker);
+
+		// the tally table holds pointers into its own instance, so it is
+		// rebuilt; this gives the same table only if nothing has been
+		// defined since the master table was built
+		if (this->PhreeqcPtr->tally_table != NULL)
+		{
+			int rows, columns;
+			bool same = (worker->CatchBuildTally() == OK);
+			if (same)
+			{
+				worker->PhreeqcPtr->get_tally_table_rows_columns(&rows, &columns);
+				same = (rows == this->PhreeqcPtr->count_tally_table_rows && columns == this->PhreeqcPtr->count_tally_table_columns);
+			}
+			for (int j = 0; same && j < this->PhreeqcPtr->count_tally_table_columns; ++j)
+			{
+				same = (::strcmp(worker->PhreeqcPtr->tally_table[j].name, this->PhreeqcPtr->tally_table[j].name) == 0);
+			}
+			if (!same)
+			{
+				this->AddError("CreateWorkers: Unable to reproduce the tally table; create workers right after build_tally_table.\n");
+				this->clear_workers();
+				return 0;
+			}
+		}
+	}
+	this->reset_tally_buffers();
+	return (int)this->Workers.size();
+}
+
+int IPhreeqcMMS::GetWorkerCount(void)const
+{
+	return (int)this->Workers.size();
+}
+
+void IPhreeqcMMS::SetWarmStart(bool bValue)
+{
+	// start reaction calculations from the last converged state of the saved solution
+	this->PhreeqcPtr->warm_start = bValue ? TRUE : FALSE;
+	if (!bValue)
+	{
+		this->PhreeqcPtr->warm_start_map.clear();
+	}
+	for (size_t w = 0; w < this->Workers.size(); ++w)
+	{
+		this->Workers[w]->SetWarmStart(bValue);
+	}
+}
+
+void IPhreeqcMMS::GetSolverStats(long *solves, long *iterations, long *warm_starts, long *fallbacks)const
 {
-	std::ostringstream strm;
-	strm << "USE solution " << ipack << "\n";
-	strm << "REACTION 1" << "\n";
-	strm << "SELECTED_OUTPUT" << "\n";
-	strm << "-reset false; -high\n";
-	strm << "USER_PUNCH; -start\n";
-	strm << "10 eps = " << -eps << "\n"; 
-	strm << "20 rstd = " << rstd << "\n";
-	strm << "30 fm = " << fmelt << "\n";
-	strm << "40 ipf = " << ipf << "\n";
-	strm << "50 fracp = 1/(1+ipf*fm/(1-fm))\n";
-	strm << "60 fracm = 1-fracp\n";
-	strm << "70 xfer_p = TOT(\"water\")*((1-fm)-fracp)/(0.001*GFW(\"H2O\"))\n";
-	strm << "80 xfer_m = TOT(\"water\")*(fm-fracm)/(0.001*GFW(\"H2O\"))\n";
-	strm << "90 PUNCH \"TITLE Makes melt water\", EOL$\n";
-	strm << "100 PUNCH \"MIX\", EOL$\n";
-	strm << "110 PUNCH " << "\"" << ipack <<"\"" <<" fracm, EOL$\n";
-	strm << "120 PUNCH \"REACTION 1\", EOL$\n";
-	strm << "130 PUNCH \"H2O \", xfer_m, EOL$\n";
-	strm << "140 o_p = fracp*TOTMOLE(\"O\")+xfer_p\n";
-	strm << "150 o_m = fracm*TOTMOLE(\"O\")+xfer_m\n";
-	strm << "160 o18_m = (TOTMOLE(\"[18O]\")/o_p-eps/1000*rstd)/(1/o_m+1/o_p)\n";
-	strm << "170 o18_p = (TOTMOLE(\"[18O]\")/o_m+eps/1000*rstd)/(1/o_p+1/o_m)\n";
-	strm << "180 diff = o18_m-fracm*TOTMOLE(\"[18O]\")\n";
-	strm << "190 PUNCH \"H2[18O] \", diff, EOL$\n";
-	strm << "200 PUNCH 1, EOL$\n";
-	strm << "210 PUNCH \"SAVE solution \" " << "\"" << imelt <<"\"" << ", EOL$\n";
-	//strm << "220 PUNCH \"END\", EOL$\n";
-	strm << "-end\n";
-	//strm << "SAVE solution " << imelt  << "\n";
-	strm << "END\n";
-
-	this->SetSelectedOutputStringOn(true);
-	//this->SetOutputStringOn(true);	
-	//std::cerr << strm.str().c_str() << std::endl;
-	this->RunString(strm.str().c_str());
-	std::string selout = this->GetSelectedOutputString();
-	//std::cerr << this->GetSelectedOutputString() << std::endl;
-	//std::cerr << this->GetOutputString() << std::endl;
-	//this->RunString("PRINT;-selected_output false");
-	this->SetSelectedOutputStringOn(false);
-	
-	// Add selected output for mass of water
-	VAR pvar1, pvar2;
-	VarInit(&pvar1);
-	VarInit(&pvar2);	
-	selout.append("SELECTED_OUTPUT; -reset false\n");
-	selout.append("USER_PUNCH; -heading mass_water\n");
-	selout.append("10 PUNCH TOT(\"water\")\n");
-	selout.append("END\n");
-	
-	// Make melt
-	this->RunString(selout.c_str());
-	this->GetSelectedOutputValue(1,0, &pvar1);	
-	//std::cerr << this->GetOutputString() << std::endl;
-
-	// Make snowpack
-	std::ostringstream strm0;
-	strm0 << "MIX 1 Make snowpack\n";
-	strm0 << ipack << " 1\n";
-	strm0 << imelt << " -1\n";
-	strm0 << "SAVE solution " << ipack  << "\n";
-	this->RunString(strm0.str().c_str());
-	this->GetSelectedOutputValue(1,0, &pvar2);
-	//std::cerr << this->GetOutputString() << std::endl;
-
-	std::ostringstream strm2;
-	strm2 << "SOLUTION_MIX " << imelt << "\n";
-	strm2 << imelt << " " << 1./pvar1.dVal << "\n";
-	strm2 << "END\n";
-	strm2 << "SOLUTION_MIX " << ipack << "\n";
-	strm2 << ipack << " " << 1./pvar2.dVal << "\n";
-	strm2 << "END" << "\n";
-	
-	//std::cerr << strm2.str().c_str();
-	this->RunString(strm2.str().c_str());
-	//std::cerr << this->GetOutputString() << std::endl;
+	*solves      = this->PhreeqcPtr->solve_count;
+	*iterations  = this->PhreeqcPtr->solve_iterations;
+	*warm_starts = this->PhreeqcPtr->warm_start_count;
+	*fallbacks   = this->PhreeqcPtr->warm_start_fallbacks;
+	for (size_t w = 0; w < this->Workers.size(); ++w)
+	{
+		long s, i, ws, f;
+		this->Workers[w]->GetSolverStats(&s, &i, &ws, &f);
+		*solves      += s;
+		*iterations  += i;
+		*warm_starts += ws;
+		*fallbacks   += f;
+	}
+}
+
+void IPhreeqcMMS::SetModelCacheSize(int n)
+{
+	// number of prepared chemical models kept for reuse by prep, 0 disables the cache
+	Phreeqc *p = this->PhreeqcPtr;
+	p->model_cache_max = (n > 0) ? n : 0;
+	while ((int)p->model_cache.size() > p->model_cache_max)
+	{
+		p->model_cache_entry_free(p->model_cache.back());
+		p->model_cache.pop_back();
+	}
+	if (p->model_cache_max == 0)
+	{
+		p->model_cache_live = FALSE;
+	}
+	for (size_t w = 0; w < this->Workers.size(); ++w)
+	{
+		this->Workers[w]->SetModelCacheSize(n);
+	}
+}
+
+void IPhreeqcMMS::GetModelCacheStats(long *hits, long *misses)const
+{
+	*hits   = this->PhreeqcPtr->model_cache_hits;
+	*misses = this->PhreeqcPtr->model_cache_misses;
+	for (size_t w = 0; w < this->Workers.size(); ++w)
+	{
+		long h, m;
+		this->Workers[w]->GetModelCacheStats(&h, &m);
+		*hits   += h;
+		*misses += m;
+	}
+}
+
+void IPhreeqcMMS::GetTidyStats(long *calls, long *skipped, long *rebuilds)const
+{
+	// calls of tidy_model, calls that found nothing to tidy, and calls
+	// that rebuilt the species, phase and master lists
+	*calls    = this->PhreeqcPtr->tidy_count;
+	*skipped  = this->PhreeqcPtr->tidy_skipped;
+	*rebuilds = this->PhreeqcPtr->tidy_rebuilds;
+	for (size_t w = 0; w < this->Workers.size(); ++w)
+	{
+		long c, s, r;
+		this->Workers[w]->GetTidyStats(&c, &s, &r);
+		*calls    += c;
+		*skipped  += s;
+		*rebuilds += r;
+	}
+}
+
+void IPhreeqcMMS::GetCvodeStats(long *integrations, long *f_evaluations, long *jacobians, long *factorizations)const
+{
+	// CVODE kinetics integrations and their rate evaluations (each an
+	// equilibrium calculation), Jacobian evaluations and factorizations
+	*integrations   = this->PhreeqcPtr->cvode_integrations;
+	*f_evaluations  = this->PhreeqcPtr->cvode_f_evals;
+	*jacobians      = this->PhreeqcPtr->cvode_jac_evals;
+	*factorizations = this->PhreeqcPtr->cvode_factorizations;
+	for (size_t w = 0; w < this->Workers.size(); ++w)
+	{
+		long n, f, j, m;
+		this->Workers[w]->GetCvodeStats(&n, &f, &j, &m);
+		*integrations   += n;
+		*f_evaluations  += f;
+		*jacobians      += j;
+		*factorizations += m;
+	}
+}
+
+void IPhreeqcMMS::SetIneqLU(bool bValue)
+{
+	// solve Newton steps that have only equality constraints by LU before trying cl1
+	this->SetIneqLUOn(bValue);
+	for (size_t w = 0; w < this->Workers.size(); ++w)
+	{
+		this->Workers[w]->SetIneqLU(bValue);
+	}
+}
+
+void IPhreeqcMMS::GetIneqStats(long *solves, long *lu_solves, long *lu_rejects)const
+{
+	// Newton steps solved, those solved by LU, and those that had only
+	// equality constraints but were left to cl1 as singular
+	*solves     = this->PhreeqcPtr->ineq_solves;
+	*lu_solves  = this->PhreeqcPtr->ineq_lu_solves;
+	*lu_rejects = this->PhreeqcPtr->ineq_lu_rejects;
+	for (size_t w = 0; w < this->Workers.size(); ++w)
+	{
+		long n, s, r;
+		this->Workers[w]->GetIneqStats(&n, &s, &r);
+		*solves     += n;
+		*lu_solves  += s;
+		*lu_rejects += r;
+	}
+}
+
+void IPhreeqcMMS::SetMixSkipTolerance(double tol)
+{
+	// mixes whose inputs are within the relative tolerance tol of the
+	// last run of the same mix are not rerun; tol < 0 runs every mix
+	this->MixSkipTolerance = tol;
+	this->MixRecords.clear();
+	for (size_t w = 0; w < this->Workers.size(); ++w)
+	{
+		this->Workers[w]->SetMixSkipTolerance(tol);
+	}
+}
+
+int IPhreeqcMMS::GetMixSkipStats(long *skipped, long *executed, int n)const
+{
+	// counts of the master and its workers by the reservoir class passed
+	// with each mix; skipped[i] and executed[i] are for class i.
+	// Returns one more than the largest class counted.
+	int i, classes = 0;
+	for (i = 0; i < n; ++i)
+	{
+		skipped[i]  = 0;
+		executed[i] = 0;
+	}
+	std::vector<const IPhreeqcMMS*> instances(1, this);
+	instances.insert(instances.end(), this->Workers.begin(), this->Workers.end());
+	for (size_t k = 0; k < instances.size(); ++k)
+	{
+		std::map<int, long>::const_iterator it = instances[k]->MixesSkipped.begin();
+		for (; it != instances[k]->MixesSkipped.end(); ++it)
+		{
+			if (it->first >= 0 && it->first < n) skipped[it->first] += it->second;
+			if (it->first >= classes) classes = it->first + 1;
+		}
+		for (it = instances[k]->MixesRun.begin(); it != instances[k]->MixesRun.end(); ++it)
+		{
+			if (it->first >= 0 && it->first < n) executed[it->first] += it->second;
+			if (it->first >= classes) classes = it->first + 1;
+		}
+	}
+	return classes;
+}
+
+void IPhreeqcMMS::SetTallyColumns(int res_class, const int *columns, int n)
+{
+	// limits the entity columns filled for mixes of reservoir class
+	// res_class (see MixVars) to the C column numbers in columns;
+	// n <= 0 fills every column of the entities in the mix
+	if (n > 0)
+	{
+		this->TallyColumns[res_class].assign(columns, columns + n);
+	}
+	else
+	{
+		this->TallyColumns.erase(res_class);
+	}
+	for (size_t w = 0; w < this->Workers.size(); ++w)
+	{
+		this->Workers[w]->SetTallyColumns(res_class, columns, n);
+	}
+}
+
+int IPhreeqcMMS::BindTallyBuffer(int n_user, double *buffer)
+{
+	// mixes saved to solution n_user store their tally in buffer,
+	// (rows + 1) x columns of get_tally_table_rows_columns, instead of
+	// the array passed to the mix; only the columns a mix fills are
+	// written, the others stay zero. buffer == NULL removes the binding
+	Phreeqc* phreeqc_ptr = this->PhreeqcPtr;
+	this->MixRecords.erase(n_user);
+	if (buffer == NULL)
+	{
+		this->TallyBuffers.erase(n_user);
+	}
+	else
+	{
+		if (phreeqc_ptr->tally_table == NULL)
+		{
+			this->AddError("BindTallyBuffer: Tally table not defined.\n");
+			return ERROR;
+		}
+		TallyBuffer& bound = this->TallyBuffers[n_user];
+		bound.array = buffer;
+		bound.written.assign(phreeqc_ptr->count_tally_table_columns, FALSE);
+		std::fill(buffer, buffer + (phreeqc_ptr->count_tally_table_rows + 1) * phreeqc_ptr->count_tally_table_columns, 0.0);
+	}
+	for (size_t w = 0; w < this->Workers.size(); ++w)
+	{
+		IPhreeqcMMS* worker = this->Workers[w];
+		worker->MixRecords.erase(n_user);
+		if (buffer == NULL)
+		{
+			worker->TallyBuffers.erase(n_user);
+		}
+		else
+		{
+			worker->TallyBuffers[n_user] = this->TallyBuffers[n_user];
+		}
+	}
+	return OK;
+}
+
+double* IPhreeqcMMS::tally_output(const struct MixVars* pvars, int *row_dim, int *col_dim, std::vector<char> **written)
+{
+	// the bound buffer of the saved solution, or the array of the mix
+	std::map<int, TallyBuffer>::iterator it = this->TallyBuffers.find(pvars->n_user[Solution]);
+	if (it != this->TallyBuffers.end())
+	{
+		*row_dim = this->PhreeqcPtr->count_tally_table_rows;
+		*col_dim = this->PhreeqcPtr->count_tally_table_columns;
+		*written = &it->second.written;
+		return it->second.array;
+	}
+	*row_dim = pvars->row_dim;
+	*col_dim = pvars->col_dim;
+	*written = NULL;
+	return pvars->array;
+}
+
+void IPhreeqcMMS::reset_tally_buffers(void)
+{
+	// any column of a bound buffer may be nonzero; the next mix zeroes
+	// the columns it does not fill
+	std::map<int, TallyBuffer>::iterator it = this->TallyBuffers.begin();
+	for (; it != this->TallyBuffers.end(); ++it)
+	{
+		it->second.written.assign(it->second.written.size(), TRUE);
+	}
+	for (size_t w = 0; w < this->Workers.size(); ++w)
+	{
+		this->Workers[w]->reset_tally_buffers();
+	}
+}
+
+void IPhreeqcMMS::clear_workers(void)
+{
+	std::vector<IPhreeqcMMS*>::iterator it = this->Workers.begin();
+	for (; it != this->Workers.end(); ++it)
+	{
+		delete (*it);
+	}
+	this->Workers.clear();
+}
+
+template <typename T>
+static void
+copy_entity(std::map<int, T>& dest, const std::map<int, T>& src, int n_user, PHRQ_io *io)
+{
+	if (n_user < 0) return;
+
+	typename std::map<int, T>::const_iterator it = src.find(n_user);
+	if (it != src.end())
+	{
+		dest[n_user] = it->second;
+		dest[n_user].Set_io(io);
+	}
+	else
+	{
+		dest.erase(n_user);
+	}
+}
+
+void IPhreeqcMMS::copy_mix_entities(IPhreeqcMMS* dest_mms, const IPhreeqcMMS* src_mms, const struct MixVars* pvars, bool sources)
+{
+	int i;
+	Phreeqc* dest = dest_mms->PhreeqcPtr;
+	const Phreeqc* src = src_mms->PhreeqcPtr;
+	PHRQ_io *io = dest->Get_phrq_io();
+
+	if (sources)
+	{
+		for (i = 0; i < pvars->count; ++i)
+		{
+			copy_entity(dest->Rxn_solution_map, src->Rxn_solution_map, pvars->solutions[i], io);
+		}
+	}
+	copy_entity(dest->Rxn_solution_map,       src->Rxn_solution_map,       pvars->n_user[Solution],    io);
+	copy_entity(dest->Rxn_solution_map,       src->Rxn_solution_map,       pvars->index_conserv,       io);
+	copy_entity(dest->Rxn_reaction_map,       src->Rxn_reaction_map,       pvars->n_user[Reaction],    io);
+	copy_entity(dest->Rxn_exchange_map,       src->Rxn_exchange_map,       pvars->n_user[Exchange],    io);
+	copy_entity(dest->Rxn_surface_map,        src->Rxn_surface_map,        pvars->n_user[Surface],     io);
+	copy_entity(dest->Rxn_gas_phase_map,      src->Rxn_gas_phase_map,      pvars->n_user[Gas_phase],   io);
+	copy_entity(dest->Rxn_pp_assemblage_map,  src->Rxn_pp_assemblage_map,  pvars->n_user[Pure_phase],  io);
+	copy_entity(dest->Rxn_ss_assemblage_map,  src->Rxn_ss_assemblage_map,  pvars->n_user[Ss_phase],    io);
+	copy_entity(dest->Rxn_kinetics_map,       src->Rxn_kinetics_map,       pvars->n_user[Kinetics],    io);
+	copy_entity(dest->Rxn_temperature_map,    src->Rxn_temperature_map,    pvars->n_user[Temperature], io);
+
+	// the last run of the mix, for the quiescent-mix test
+	std::map<int, MixRecord>::const_iterator rt = src_mms->MixRecords.find(pvars->n_user[Solution]);
+	if (rt != src_mms->MixRecords.end())
+	{
+		dest_mms->MixRecords[pvars->n_user[Solution]] = rt->second;
+	}
+	else
+	{
+		dest_mms->MixRecords.erase(pvars->n_user[Solution]);
+	}
+
+	// the converged state that warm starts the next reaction of the mix
+	std::map<int, struct warm_start_guess>::const_iterator wt = src->warm_start_map.find(pvars->n_user[Solution]);
+	if (wt != src->warm_start_map.end())
+	{
+		dest->warm_start_map[pvars->n_user[Solution]] = wt->second;
+	}
+	else
+	{
+		dest->warm_start_map.erase(pvars->n_user[Solution]);
+	}
+
+	// the CVODE Jacobian kept for the kinetics block; it is marked with
+	// the model of the instance that holds it
+	if (pvars->n_user[Kinetics] >= 0)
+	{
+		std::map<int, struct cvode_jacobian>::const_iterator jt = src->cvode_jacobian_map.find(pvars->n_user[Kinetics]);
+		if (jt != src->cvode_jacobian_map.end() && jt->second.model == src->tidy_rebuilds)
+		{
+			struct cvode_jacobian &jac_ref = dest->cvode_jacobian_map[pvars->n_user[Kinetics]];
+			jac_ref = jt->second;
+			jac_ref.model = dest->tidy_rebuilds;
+		}
+		else
+		{
+			dest->cvode_jacobian_map.erase(pvars->n_user[Kinetics]);
+		}
+	}
+}
+
+void IPhreeqcMMS::reset_solver_state(void)
+{
+	// caches one calculation leaves for the next in the same instance:
+	// the last model (with the prepared model cache, the log k's by
+	// temperature and the activity-coefficient batches) and the Pitzer
+	// parameters by temperature
+	this->PhreeqcPtr->reset_last_model();
+	this->PhreeqcPtr->pitz_param_tk_cache.clear();
+}
+
+int IPhreeqcMMS::RunMixPool(int nmix, struct MixVars* pvars, const int *groups, double *ph, double *ph_final, double *tempc, double *conc_conserv, int conc_dim)
+{
+	int i, w;
+
+	if (this->Workers.empty())
+	{
+		return this->RunMixBatch(nmix, pvars, ph, ph_final, tempc, conc_conserv, conc_dim);
+	}
+
+	//
+	// mixes of a group run in order on one worker; groups are dealt to
+	// workers in order of first appearance, and a worker runs its groups
+	// one after the other
+	//
+	int nworkers = (int)this->Workers.size();
+	std::map<int, int> group_index;
+	std::vector< std::vector<int> > group_mixes;
+	std::vector< std::vector<int> > worker_groups(nworkers);
+	for (i = 0; i < nmix; ++i)
+	{
+		std::map<int, int>::iterator it = group_index.find(groups[i]);
+		if (it == group_index.end())
+		{
+			int g = (int)group_mixes.size();
+			it = group_index.insert(std::make_pair(groups[i], g)).first;
+			group_mixes.push_back(std::vector<int>());
+			worker_groups[g % nworkers].push_back(g);
+		}
+		group_mixes[it->second].push_back(i);
+	}
+
+	//
+	// each group starts from the entities, mix records and kinetics
+	// Jacobians of the master and from empty solver caches, so its
+	// results do not depend on the worker that runs it
+	//
+	for (i = 0; i < nmix; ++i)
+	{
+		w = group_index[groups[i]] % nworkers;
+		copy_mix_entities(this->Workers[w], this, &pvars[i], true);
+	}
+
+	std::vector<int> worker_errors(nworkers, 0);
+#if defined(USE_OPENMP)
+#pragma omp parallel for schedule(dynamic) num_threads(nworkers)
+#endif
+	for (w = 0; w < nworkers; ++w)
+	{
+		IPhreeqcMMS* worker = this->Workers[w];
+		std::vector<int>::const_iterator gt = worker_groups[w].begin();
+		for (; gt != worker_groups[w].end() && !worker_errors[w]; ++gt)
+		{
+			worker->reset_solver_state();
+			std::vector<int>::const_iterator it = group_mixes[*gt].begin();
+			for (; it != group_mixes[*gt].end(); ++it)
+			{
+				int n = *it;
+				try
+				{
+					worker_errors[w] += worker->run_mix_results(n, &pvars[n], &ph[n], &ph_final[n], &tempc[n], &conc_conserv[n * conc_dim], conc_dim);
+				}
+				catch (...)
+				{
+					worker->AddError("RunMixPool: An unhandled exception occured.\n");
+					worker_errors[w]++;
+				}
+				if (worker_errors[w]) break;
+			}
+		}
+	}
+
+	// merge results back in mix order
+	int errors = 0;
+	for (i = 0; i < nmix; ++i)
+	{
+		w = group_index[groups[i]] % nworkers;
+		copy_mix_entities(this, this->Workers[w], &pvars[i], false);
+	}
+
+	// bound tally buffers were written by more than one instance
+	this->reset_tally_buffers();
+	for (w = 0; w < nworkers; ++w)
+	{
+		if (this->Workers[w]->GetWarningStringLineCount() > 0)
+		{
+			this->AddWarning(this->Workers[w]->GetWarningString());
+		}
+		if (worker_errors[w])
+		{
+			this->AddError(this->Workers[w]->GetErrorString());
+			errors += worker_errors[w];
+		}
+	}
+	return errors;
+}
+
+int IPhreeqcMMS::accumulate_mix_plan(struct MixVars* pvars)
+{
+	char line[80];
+	size_t i, j;
+
+	for (i = 0; i < this->MixPlan.size(); ++i)
+	{
+		const MixBlock& block = this->MixPlan[i];
+
+		/* MIX */
+		if (this->AccumulateLine("MIX") != VR_OK) {
+			return ERROR;
+		}
+		for (j = 0; j < block.mix.size(); ++j) {
+			sprintf(line, "\t%d %g", block.mix[j].first, block.mix[j].second);
+			if (this->AccumulateLine(line) != VR_OK) {
+				return ERROR;
+			}
+		}
+
+		/* SAVE solution */
+		sprintf(line, "SAVE solution %d", block.n_save);
+		if (this->AccumulateLine(line) != VR_OK) {
+			return ERROR;
+		}
+
+		/* COPY SOLUTION */
+		if (block.n_copy >= 0) {
+			sprintf(line, "COPY SOLUTION %d %d", block.n_save, block.n_copy);
+			if (this->AccumulateLine(line) != VR_OK) {
+				return ERROR;
+			}
+		}
+
+		/* USE and SAVE entities */
+		for (j = 0; j < block.use.size(); ++j) {
+			sprintf(line, "USE %s %d", mix_keyword(block.use[j].first), block.use[j].second);
+			if (this->AccumulateLine(line) != VR_OK) {
+				return ERROR;
+			}
+			for (size_t k = 0; k < block.save.size(); ++k) {
+				if (block.save[k].first == block.use[j].first) {
+					sprintf(line, "SAVE %s %d", mix_keyword(block.save[k].first), block.save[k].second);
+					if (this->AccumulateLine(line) != VR_OK) {
+						return ERROR;
+					}
+				}
+			}
+		}
+
+		/* END */
+		if (this->AccumulateLine("END") != VR_OK) {
+			return ERROR;
+		}
+	}
+	return OK;
+}
+
+void IPhreeqcMMS::do_mix_plan(void)
+{
+	static const char sz_routine[] = "RunMix";
+	char token[MAX_LENGTH];
+	Phreeqc *phreeqc_ptr = this->PhreeqcPtr;
+
+	phreeqc_ptr->first_read_input = TRUE;
+	for (phreeqc_ptr->simulation = 1; ; phreeqc_ptr->simulation++)
+	{
+		::sprintf(token, "Reading input data for simulation %d.", phreeqc_ptr->simulation);
+		phreeqc_ptr->dup_print(token, TRUE);
+		phreeqc_ptr->init_read_input();
+		if (phreeqc_ptr->simulation > (int) this->MixPlan.size())
+			break;
+
+		this->do_mix_block(sz_routine, this->MixPlan[phreeqc_ptr->simulation - 1]);
+	}
+	this->do_run_end(NULL, NULL);
+}
+
+void IPhreeqcMMS::do_mix_block(const char* sz_routine, const MixBlock& block)
+{
+	Phreeqc *phreeqc_ptr = this->PhreeqcPtr;
+	size_t i;
+
+	/*
+	 *   Set the same data that read_input sets for MIX, SAVE, COPY
+	 *   and USE, as RunPrepared does for a prepared input; WEBMOD
+	 *   runs its mixes through the mix plan, not through RunPrepared
+	 */
+	cxxMix temp_mix;
+	temp_mix.Set_n_user(1);
+	temp_mix.Set_n_user_end(1);
+	temp_mix.Set_description("");
+	for (i = 0; i < block.mix.size(); ++i)
+	{
+		temp_mix.Add(block.mix[i].first, mix_fraction(block.mix[i].second));
+	}
+	this->set_mix_input(temp_mix);
+	this->set_save_input(Keywords::KEY_SOLUTION, block.n_save);
+	if (block.n_copy >= 0)
+	{
+		this->set_copy_input(Keywords::KEY_SOLUTION, block.n_save, block.n_copy);
+	}
+	for (i = 0; i < block.use.size(); ++i)
+	{
+		this->set_use_input(block.use[i].first, block.use[i].second);
+	}
+	for (i = 0; i < block.save.size(); ++i)
+	{
+		this->set_save_input(block.save[i].first, block.save[i].second);
+	}
+	phreeqc_ptr->next_keyword = Keywords::KEY_END;
+	phreeqc_ptr->keycount[Keywords::KEY_END]++;
+	phreeqc_ptr->first_read_input = FALSE;
+
+	this->do_simulation(sz_routine);
+}
+
+int IPhreeqcMMS::DefineSolution(int n_user, int count, const char *const *species, const double *conc, double tempc, double ph)
+{
+	return this->DefineSolutions(1, &n_user, count, species, conc, 1, &tempc, &ph);
+}
+
+int IPhreeqcMMS::DefineSolutions(int nsoln, const int *n_user, int count, const char *const *species, const double *conc, int conc_dim, const double *tempc, const double *ph)
+{
+	static const char sz_routine[] = "DefineSolutions";
+
+	// the script path echoes the input, which is only wanted when
+	// output is being written
+	if (this->OutputFileOn || this->OutputStringOn)
+	{
+		if (this->accumulate_solutions(nsoln, n_user, count, species, conc, conc_dim, tempc, ph) != OK)
+		{
+			return ERROR;
+		}
+		return this->RunAccumulated();
+	}
+
+	try
+	{
+		// these may throw
+		this->open_output_files(sz_routine);
+		this->check_database(sz_routine);
+
+		this->PhreeqcPtr->input_error = 0;
+		this->io_error_count = 0;
+
+		// this may throw
+		this->do_define_solutions(sz_routine, nsoln, n_user, count, species, conc, conc_dim, tempc, ph);
+	}
+	catch (const IPhreeqcStop&)
+	{
+		// do nothing
+	}
+	catch(std::exception &e)
+	{
+		std::string errmsg("DefineSolutions: ");
+		errmsg += e.what();
+		try
+		{
+			this->PhreeqcPtr->error_msg(errmsg.c_str(), STOP); // throws PhreeqcStop
+		}
+		catch (const IPhreeqcStop&)
+		{
+			// do nothing
+		}
+		throw;
+	}
+	catch(...)
+	{
+		const char *errmsg = "DefineSolutions: An unhandled exception occured.\n";
+		try
+		{
+			this->PhreeqcPtr->error_msg(errmsg, STOP); // throws PhreeqcStop
+		}
+		catch (const IPhreeqcStop&)
+		{
+			// do nothing
+		}
+		throw;
+	}
+
+	this->close_output_files();
+	this->update_errors();
+
+	return this->PhreeqcPtr->get_input_errors();
+}
+
+int IPhreeqcMMS::accumulate_solutions(int nsoln, const int *n_user, int count, const char *const *species, const double *conc, int conc_dim, const double *tempc, const double *ph)
+{
+	char line[MAX_LENGTH];
+	int i, j;
+
+	for (i = 0; i < nsoln; ++i)
+	{
+		/* SOLUTION */
+		sprintf(line, "SOLUTION %d", n_user[i]);
+		if (this->AccumulateLine(line) != VR_OK) {
+			return ERROR;
+		}
+		if (this->AccumulateLine("\t-units mol/kgw") != VR_OK) {
+			return ERROR;
+		}
+		sprintf(line, "\t-temp %.17g", tempc[i]);
+		if (this->AccumulateLine(line) != VR_OK) {
+			return ERROR;
+		}
+		sprintf(line, "\t-pH %.17g", ph[i]);
+		if (this->AccumulateLine(line) != VR_OK) {
+			return ERROR;
+		}
+		for (j = 0; j < count; ++j) {
+			sprintf(line, "\t%s %.17g", species[j], conc[i + j * conc_dim]);
+			if (this->AccumulateLine(line) != VR_OK) {
+				return ERROR;
+			}
+		}
+	}
+
+	/* END */
+	if (this->AccumulateLine("END") != VR_OK) {
+		return ERROR;
+	}
+	return OK;
+}
+
+void IPhreeqcMMS::do_define_solutions(const char* sz_routine, int nsoln, const int *n_user, int count, const char *const *species, const double *conc, int conc_dim, const double *tempc, const double *ph)
+{
+	char token[MAX_LENGTH];
+	Phreeqc *phreeqc_ptr = this->PhreeqcPtr;
+	int i, j;
+
+	phreeqc_ptr->first_read_input = TRUE;
+	for (phreeqc_ptr->simulation = 1; ; phreeqc_ptr->simulation++)
+	{
+		::sprintf(token, "Reading input data for simulation %d.", phreeqc_ptr->simulation);
+		phreeqc_ptr->dup_print(token, TRUE);
+		phreeqc_ptr->init_read_input();
+		if (phreeqc_ptr->simulation > 1)
+			break;
+
+		/*
+		 *   Set the same data that read_solution sets for
+		 *   -units mol/kgw, -temp, -pH and one concentration
+		 *   per master species
+		 */
+		std::string units("mol/kgw");
+		if (phreeqc_ptr->check_units(units, false, false, "mMol/kgw", false) != CParser::PARSER_OK)
+		{
+			phreeqc_ptr->input_error++;
+		}
+		for (i = 0; i < nsoln; ++i)
+		{
+			cxxSolution temp_solution;
+			temp_solution.Set_new_def(true);
+			temp_solution.Create_initial_data();
+			cxxISolution *isoln_ptr = temp_solution.Get_initial_data();
+
+			temp_solution.Set_n_user(n_user[i]);
+			temp_solution.Set_n_user_end(n_user[i]);
+			temp_solution.Set_description("");
+			temp_solution.Set_tc(tempc[i]);
+			temp_solution.Set_ph(ph[i]);
+			isoln_ptr->Set_units(units);
+
+			for (j = 0; j < count; ++j)
+			{
+				cxxISolutionComp temp_comp(phreeqc_ptr->phrq_io);
+				temp_comp.Set_description(species[j]);
+				temp_comp.Set_input_conc(conc[i + j * conc_dim]);
+				temp_comp.Set_units(units.c_str());
+				temp_comp.Set_pe_reaction(isoln_ptr->Get_default_pe());
+				isoln_ptr->Get_comps()[temp_comp.Get_description()] = temp_comp;
+			}
+
+			if (!phreeqc_ptr->use.Get_solution_in())
+			{
+				phreeqc_ptr->use.Set_solution_in(true);
+				phreeqc_ptr->use.Set_n_solution_user(n_user[i]);
+			}
+			phreeqc_ptr->Rxn_solution_map[n_user[i]] = temp_solution;
+			phreeqc_ptr->Rxn_new_solution.insert(n_user[i]);
+			phreeqc_ptr->keycount[Keywords::KEY_SOLUTION]++;
+		}
+
+		phreeqc_ptr->next_keyword = Keywords::KEY_END;
+		phreeqc_ptr->keycount[Keywords::KEY_END]++;
+		phreeqc_ptr->first_read_input = FALSE;
+
+		this->do_simulation(sz_routine);
+	}
+	this->do_run_end(NULL, NULL);
+}
+
+static void
+add_h2o(cxxSolution &soln, double h2o, double h2o18, double gfw_water)
+{
+	// adds moles of H2O and H2[18O] to a solution without re-equilibrating
+	soln.Set_total_h(soln.Get_total_h() + 2. * (h2o + h2o18));
+	soln.Set_total_o(soln.Get_total_o() + h2o);
+	soln.Set_mass_water(soln.Get_mass_water() + h2o * gfw_water);
+	soln.Get_totals().add("[18O]", h2o18);
+}
+
+int IPhreeqcMMS::Melt_pack(int ipack, int imelt, double eps, double ipf, double fmelt, double rstd)
+{
+	//
+	// Splits snowpack solution ipack into melt (saved as solution imelt) and
+	// remaining pack. The melt carries the ionic pulse (ipf) and its [18O]
+	// differs from the pack by eps permil. Both solutions are then
+	// normalized to 1 kg of water.
+	//
+	Phreeqc* phreeqc_ptr = this->PhreeqcPtr;
+	cxxSolution *pack_ptr = Utilities::Rxn_find(phreeqc_ptr->Rxn_solution_map, ipack);
+	if (pack_ptr == NULL)
+	{
+		std::ostringstream oss;
+		oss << "Melt_pack: Solution " << ipack << " not found.\n";
+		this->AddError(oss.str().c_str());
+		return 0;
+	}
+	LDBLE gfw_h2o;
+	if (phreeqc_ptr->compute_gfw("H2O", &gfw_h2o) == ERROR)
+	{
+		this->AddError("Melt_pack: Unable to compute gram formula weight of H2O.\n");
+		return 0;
+	}
+
+	// fraction of pack solutes going to pack and melt, water moved to balance volumes
+	double fracp = 1. / (1. + ipf * fmelt / (1. - fmelt));
+	double fracm = 1. - fracp;
+	double mass_water = pack_ptr->Get_mass_water();
+	double xfer_p = mass_water * ((1. - fmelt) - fracp) / (0.001 * gfw_h2o);
+	double xfer_m = mass_water * (fmelt - fracm) / (0.001 * gfw_h2o);
+
+	// partition [18O] so that melt differs from pack by eps permil
+	double o_tot = pack_ptr->Get_total_o();
+	double o18_tot = pack_ptr->Get_totals().Get_total_element("[18O]");
+	double o_p = fracp * o_tot + xfer_p;
+	double o_m = fracm * o_tot + xfer_m;
+	double o18_m = (o18_tot / o_p + eps / 1000. * rstd) / (1. / o_m + 1. / o_p);
+	double diff = o18_m - fracm * o18_tot;
+
+	// melt: fracm of pack plus xfer_m H2O and diff H2[18O]
+	cxxSolution melt(*pack_ptr);
+	melt.Set_n_user_both(imelt);
+	melt.multiply(fracm);
+	add_h2o(melt, xfer_m, diff, phreeqc_ptr->gfw_water);
+
+	// pack: what remains after the melt is removed
+	pack_ptr->multiply(fracp);
+	add_h2o(*pack_ptr, -xfer_m, -diff, phreeqc_ptr->gfw_water);
+
+	melt.multiply(1. / melt.Get_mass_water());
+	pack_ptr->multiply(1. / pack_ptr->Get_mass_water());
+	phreeqc_ptr->Rxn_solution_map[imelt] = melt;
 	return 1;
-}
\ No newline at end of file
+}
\ No newline at end of file
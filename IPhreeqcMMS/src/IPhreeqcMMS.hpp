@@ -2,6 +2,7 @@
 
 #include "IPhreeqc.hpp"
 #include "Phreeqc.h"
+#include "CSelectedOutput.hxx"
 
 #if defined(_WINDLL)
 #define IPQ_DLL_EXPORT __declspec(dllexport)
@@ -18,6 +19,7 @@ struct MixVars
   int          index_conserv;
   double       fill_factor;
   int         *n_user;
+  int          res_class;     // reservoir class, for SetTallyColumns and GetMixSkipStats
   double       rxnmols;
   double       tempc;
   double       tsec;
@@ -29,6 +31,59 @@ struct MixVars
 };
 
 
+// One MIX ... END simulation of a phr_mix call
+struct MixBlock
+{
+  std::vector< std::pair<int, double> > mix;      // solution number, fraction
+  int                                   n_save;   // SAVE solution n_save
+  int                                   n_copy;   // COPY SOLUTION n_save n_copy (-1 if none)
+  std::vector< std::pair<int, int> >    use;      // Keywords::KEYWORDS, n_user
+  std::vector< std::pair<int, int> >    save;     // Keywords::KEYWORDS, n_user
+};
+
+
+// Solution composition compared by the quiescent-mix test
+struct MixSolutionState
+{
+  cxxNameDouble                         totals;
+  double                                total_h;
+  double                                total_o;
+  double                                cb;
+  double                                mass_water;
+  double                                tc;
+  double                                patm;
+};
+
+
+// Inputs and results of the last phr_mix run for a saved solution
+struct MixRecord
+{
+  std::vector<int>                      solutions;
+  std::vector<double>                   fracs;
+  std::vector<int>                      n_user;   // Solution ... Temperature
+  int                                   index_conserv;
+  double                                fill_factor;
+  double                                rxnmols;
+  double                                tempc;
+  double                                tsec;
+  std::vector<MixSolutionState>         inputs;   // one per solution
+  MixSolutionState                      output;   // n_user[Solution] after the mix
+  MixSolutionState                      conserv;  // index_conserv after the mix
+  std::vector<double>                   tally;    // columns stored by store_tally_table
+  int                                   row_dim;  // dimensions of the array tally was stored in
+  int                                   col_dim;
+  CSelectedOutput                       selected;
+};
+
+
+// Tally output buffer bound to a saved solution by BindTallyBuffer
+struct TallyBuffer
+{
+  double*                               array;    // (rows + 1) x columns, Fortran order
+  std::vector<char>                     written;  // columns that may be nonzero
+};
+
+
 class IPQ_DLL_EXPORT IPhreeqcMMS : public IPhreeqc
 {
 public:
@@ -58,11 +113,59 @@ public:
 	int PreMixCallback(struct MixVars* pvars);
 	/*static*/
 	int PostMixCallback(struct MixVars* pvars);
+	int RunMix(struct MixVars* pvars);
+	int RunMixBatch(int nmix, struct MixVars* pvars, double *ph, double *ph_final, double *tempc, double *conc_conserv, int conc_dim);
+	int RunMixPool(int nmix, struct MixVars* pvars, const int *groups, double *ph, double *ph_final, double *tempc, double *conc_conserv, int conc_dim);
+	int CreateWorkers(int n);
+	int GetWorkerCount(void)const;
+	void SetWarmStart(bool bValue);
+	void GetSolverStats(long *solves, long *iterations, long *warm_starts, long *fallbacks)const;
+	void SetModelCacheSize(int n);
+	void GetModelCacheStats(long *hits, long *misses)const;
+	void GetTidyStats(long *calls, long *skipped, long *rebuilds)const;
+	void GetCvodeStats(long *integrations, long *f_evaluations, long *jacobians, long *factorizations)const;
+	void SetIneqLU(bool bValue);
+	void GetIneqStats(long *solves, long *lu_solves, long *lu_rejects)const;
 	int Melt_pack(int ipack, int imelt, double eps, double ipf, double fmelt, double rstd);
+	void SetMixSkipTolerance(double tol);
+	int GetMixSkipStats(long *skipped, long *executed, int n)const;
+	void SetTallyColumns(int res_class, const int *columns, int n);
+	int BindTallyBuffer(int n_user, double *buffer);
+	int DefineSolution(int n_user, int count, const char *const *species, const double *conc, double tempc, double ph);
+	int DefineSolutions(int nsoln, const int *n_user, int count, const char *const *species, const double *conc, int conc_dim, const double *tempc, const double *ph);
 
 // COMMENT: {6/6/2012 5:01:22 PM}protected:
 // COMMENT: {6/6/2012 5:01:22 PM}	virtual void do_run(const char* sz_routine, std::istream* pis, PFN_PRERUN_CALLBACK pfn_pre, PFN_POSTRUN_CALLBACK pfn_post, void *cookie);
 
+protected:
+	int accumulate_mix_plan(struct MixVars* pvars);
+	int run_mix_results(int index, struct MixVars* pvars, double *ph, double *ph_final, double *tempc, double *conc_conserv, int conc_dim);
+	int get_mix_results(double *ph, double *ph_final, double *tempc, double *conc_conserv, int conc_dim);
+	void do_mix_plan(void);
+	void do_mix_block(const char* sz_routine, const MixBlock& block);
+	void clear_workers(void);
+	static void copy_mix_entities(IPhreeqcMMS* dest, const IPhreeqcMMS* src, const struct MixVars* pvars, bool sources);
+	void reset_solver_state(void);
+	bool quiescent_mix(const struct MixVars* pvars);
+	void save_mix_record(const struct MixVars* pvars, const double *array, int row_dim, int col_dim);
+	double* tally_output(const struct MixVars* pvars, int *row_dim, int *col_dim, std::vector<char> **written);
+	void reset_tally_buffers(void);
+	int accumulate_solutions(int nsoln, const int *n_user, int count, const char *const *species, const double *conc, int conc_dim, const double *tempc, const double *ph);
+	void do_define_solutions(const char* sz_routine, int nsoln, const int *n_user, int count, const char *const *species, const double *conc, int conc_dim, const double *tempc, const double *ph);
+
+protected:
+	std::vector<MixBlock> MixPlan;
+	std::vector<IPhreeqcMMS*> Workers;     // clones used by RunMixPool
+	double MixSkipTolerance;               // relative tolerance of the quiescent-mix test, < 0 disables it
+	bool MixSkipped;                       // current mix is replayed from MixRecords
+	bool MixPendingValid;                  // MixPending holds the inputs of the current mix
+	MixRecord MixPending;
+	std::map<int, MixRecord> MixRecords;   // last run mix, by n_user[Solution]
+	std::map<int, long> MixesSkipped;      // by reservoir class
+	std::map<int, long> MixesRun;          // by reservoir class
+	std::map<int, std::vector<int> > TallyColumns;  // entity columns used, by reservoir class
+	std::map<int, TallyBuffer> TallyBuffers;        // bound output, by n_user[Solution]
+
 protected:
 // COMMENT: {6/6/2012 5:05:58 PM}	PFN_PRERUN_CALLBACK pfn_pre;
 // COMMENT: {6/6/2012 5:05:58 PM}	PFN_POSTRUN_CALLBACK pfn_post;
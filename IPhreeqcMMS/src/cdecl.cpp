@@ -206,36 +206,36 @@ IPQ_DLL_EXPORT int get_tally_table_row_heading_(int *id, int *row, char *string,
 // /iface:default /names:default
 IPQ_DLL_EXPORT int RUNMIXF(int *id, int *count, int *solutions, double *fracs, int *index_conserv,
 		double *fill_factor, int *index_rxn, double *conc_conserv, int *files_on,
-		int *n_user, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
+		int *n_user, int *res_class, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
 		int *row_dim, int *col_dim)
 {
 	return RunMixF(id, count, solutions, fracs, index_conserv,
 		fill_factor, index_rxn, conc_conserv, files_on,
-		n_user, rxnmols, tempc, ph, tsec, array,
+		n_user, res_class, rxnmols, tempc, ph, tsec, array,
 		row_dim, col_dim);
 }
 
 // /iface:default /names:default /assume:underscore
 IPQ_DLL_EXPORT int RUNMIXF_(int *id, int *count, int *solutions, double *fracs, int *index_conserv,
 		double *fill_factor, int *index_rxn, double *conc_conserv, int *files_on,
-		int *n_user, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
+		int *n_user, int *res_class, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
 		int *row_dim, int *col_dim)
 {
 	return RunMixF(id, count, solutions, fracs, index_conserv,
 		fill_factor, index_rxn, conc_conserv, files_on,
-		n_user, rxnmols, tempc, ph, tsec, array,
+		n_user, res_class, rxnmols, tempc, ph, tsec, array,
 		row_dim, col_dim);
 }
 
 // /iface:default /names:lowercase
 IPQ_DLL_EXPORT int runmixf(int *id, int *count, int *solutions, double *fracs, int *index_conserv,
 		double *fill_factor, int *index_rxn, double *conc_conserv, int *files_on,
-		int *n_user, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
+		int *n_user, int *res_class, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
 		int *row_dim, int *col_dim)
 {
 	return RunMixF(id, count, solutions, fracs, index_conserv,
 		fill_factor, index_rxn, conc_conserv, files_on,
-		n_user, rxnmols, tempc, ph, tsec, array,
+		n_user, res_class, rxnmols, tempc, ph, tsec, array,
 		row_dim, col_dim);
 }
 
@@ -243,15 +243,590 @@ IPQ_DLL_EXPORT int runmixf(int *id, int *count, int *solutions, double *fracs, i
 // /iface:cref /assume:underscore
 IPQ_DLL_EXPORT int runmixf_(int *id, int *count, int *solutions, double *fracs, int *index_conserv,
 		double *fill_factor, int *index_rxn, double *conc_conserv, int *files_on,
-		int *n_user, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
+		int *n_user, int *res_class, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
 		int *row_dim, int *col_dim)
 {
 	return RunMixF(id, count, solutions, fracs, index_conserv,
 		fill_factor, index_rxn, conc_conserv, files_on,
-		n_user, rxnmols, tempc, ph, tsec, array,
+		n_user, res_class, rxnmols, tempc, ph, tsec, array,
 		row_dim, col_dim);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+//
+// RunMixBatch
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int RUNMIXBATCHF(int *id, int *nmix, int *counts, int *solutions, double *fracs, int *index_conserv,
+		double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+		int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+		double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	return RunMixBatchF(id, nmix, counts, solutions, fracs, index_conserv,
+		fill_factor, index_rxn, conc_conserv, conc_dim,
+		n_user, n_user_dim, res_class, rxnmols, tempc, ph, ph_final,
+		tsec, array, row_dim, col_dim);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int RUNMIXBATCHF_(int *id, int *nmix, int *counts, int *solutions, double *fracs, int *index_conserv,
+		double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+		int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+		double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	return RunMixBatchF(id, nmix, counts, solutions, fracs, index_conserv,
+		fill_factor, index_rxn, conc_conserv, conc_dim,
+		n_user, n_user_dim, res_class, rxnmols, tempc, ph, ph_final,
+		tsec, array, row_dim, col_dim);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int runmixbatchf(int *id, int *nmix, int *counts, int *solutions, double *fracs, int *index_conserv,
+		double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+		int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+		double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	return RunMixBatchF(id, nmix, counts, solutions, fracs, index_conserv,
+		fill_factor, index_rxn, conc_conserv, conc_dim,
+		n_user, n_user_dim, res_class, rxnmols, tempc, ph, ph_final,
+		tsec, array, row_dim, col_dim);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int runmixbatchf_(int *id, int *nmix, int *counts, int *solutions, double *fracs, int *index_conserv,
+		double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+		int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+		double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	return RunMixBatchF(id, nmix, counts, solutions, fracs, index_conserv,
+		fill_factor, index_rxn, conc_conserv, conc_dim,
+		n_user, n_user_dim, res_class, rxnmols, tempc, ph, ph_final,
+		tsec, array, row_dim, col_dim);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// RunMixPool
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int RUNMIXPOOLF(int *id, int *nmix, int *groups, int *counts, int *solutions, double *fracs, int *index_conserv,
+		double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+		int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+		double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	return RunMixPoolF(id, nmix, groups, counts, solutions, fracs, index_conserv,
+		fill_factor, index_rxn, conc_conserv, conc_dim,
+		n_user, n_user_dim, res_class, rxnmols, tempc, ph, ph_final,
+		tsec, array, row_dim, col_dim);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int RUNMIXPOOLF_(int *id, int *nmix, int *groups, int *counts, int *solutions, double *fracs, int *index_conserv,
+		double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+		int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+		double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	return RunMixPoolF(id, nmix, groups, counts, solutions, fracs, index_conserv,
+		fill_factor, index_rxn, conc_conserv, conc_dim,
+		n_user, n_user_dim, res_class, rxnmols, tempc, ph, ph_final,
+		tsec, array, row_dim, col_dim);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int runmixpoolf(int *id, int *nmix, int *groups, int *counts, int *solutions, double *fracs, int *index_conserv,
+		double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+		int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+		double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	return RunMixPoolF(id, nmix, groups, counts, solutions, fracs, index_conserv,
+		fill_factor, index_rxn, conc_conserv, conc_dim,
+		n_user, n_user_dim, res_class, rxnmols, tempc, ph, ph_final,
+		tsec, array, row_dim, col_dim);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int runmixpoolf_(int *id, int *nmix, int *groups, int *counts, int *solutions, double *fracs, int *index_conserv,
+		double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+		int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+		double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	return RunMixPoolF(id, nmix, groups, counts, solutions, fracs, index_conserv,
+		fill_factor, index_rxn, conc_conserv, conc_dim,
+		n_user, n_user_dim, res_class, rxnmols, tempc, ph, ph_final,
+		tsec, array, row_dim, col_dim);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// CreateMixWorkers
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int CREATEMIXWORKERSF(int *id, int *n)
+{
+	return CreateMixWorkersF(id, n);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int CREATEMIXWORKERSF_(int *id, int *n)
+{
+	return CreateMixWorkersF(id, n);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int createmixworkersf(int *id, int *n)
+{
+	return CreateMixWorkersF(id, n);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int createmixworkersf_(int *id, int *n)
+{
+	return CreateMixWorkersF(id, n);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// SetWarmStart
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int SETWARMSTARTF(int *id, int *tf)
+{
+	return SetWarmStartF(id, tf);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int SETWARMSTARTF_(int *id, int *tf)
+{
+	return SetWarmStartF(id, tf);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int setwarmstartf(int *id, int *tf)
+{
+	return SetWarmStartF(id, tf);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int setwarmstartf_(int *id, int *tf)
+{
+	return SetWarmStartF(id, tf);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// GetSolverStats
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int GETSOLVERSTATSF(int *id, long long *solves, long long *iterations, long long *warm_starts, long long *fallbacks)
+{
+	return GetSolverStatsF(id, solves, iterations, warm_starts, fallbacks);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int GETSOLVERSTATSF_(int *id, long long *solves, long long *iterations, long long *warm_starts, long long *fallbacks)
+{
+	return GetSolverStatsF(id, solves, iterations, warm_starts, fallbacks);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int getsolverstatsf(int *id, long long *solves, long long *iterations, long long *warm_starts, long long *fallbacks)
+{
+	return GetSolverStatsF(id, solves, iterations, warm_starts, fallbacks);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int getsolverstatsf_(int *id, long long *solves, long long *iterations, long long *warm_starts, long long *fallbacks)
+{
+	return GetSolverStatsF(id, solves, iterations, warm_starts, fallbacks);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// SetModelCacheSize
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int SETMODELCACHESIZEF(int *id, int *n)
+{
+	return SetModelCacheSizeF(id, n);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int SETMODELCACHESIZEF_(int *id, int *n)
+{
+	return SetModelCacheSizeF(id, n);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int setmodelcachesizef(int *id, int *n)
+{
+	return SetModelCacheSizeF(id, n);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int setmodelcachesizef_(int *id, int *n)
+{
+	return SetModelCacheSizeF(id, n);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// GetModelCacheStats
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int GETMODELCACHESTATSF(int *id, long long *hits, long long *misses)
+{
+	return GetModelCacheStatsF(id, hits, misses);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int GETMODELCACHESTATSF_(int *id, long long *hits, long long *misses)
+{
+	return GetModelCacheStatsF(id, hits, misses);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int getmodelcachestatsf(int *id, long long *hits, long long *misses)
+{
+	return GetModelCacheStatsF(id, hits, misses);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int getmodelcachestatsf_(int *id, long long *hits, long long *misses)
+{
+	return GetModelCacheStatsF(id, hits, misses);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// GetTidyStats
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int GETTIDYSTATSF(int *id, long long *calls, long long *skipped, long long *rebuilds)
+{
+	return GetTidyStatsF(id, calls, skipped, rebuilds);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int GETTIDYSTATSF_(int *id, long long *calls, long long *skipped, long long *rebuilds)
+{
+	return GetTidyStatsF(id, calls, skipped, rebuilds);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int gettidystatsf(int *id, long long *calls, long long *skipped, long long *rebuilds)
+{
+	return GetTidyStatsF(id, calls, skipped, rebuilds);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int gettidystatsf_(int *id, long long *calls, long long *skipped, long long *rebuilds)
+{
+	return GetTidyStatsF(id, calls, skipped, rebuilds);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// GetCvodeStats
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int GETCVODESTATSF(int *id, long long *integrations, long long *f_evaluations, long long *jacobians, long long *factorizations)
+{
+	return GetCvodeStatsF(id, integrations, f_evaluations, jacobians, factorizations);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int GETCVODESTATSF_(int *id, long long *integrations, long long *f_evaluations, long long *jacobians, long long *factorizations)
+{
+	return GetCvodeStatsF(id, integrations, f_evaluations, jacobians, factorizations);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int getcvodestatsf(int *id, long long *integrations, long long *f_evaluations, long long *jacobians, long long *factorizations)
+{
+	return GetCvodeStatsF(id, integrations, f_evaluations, jacobians, factorizations);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int getcvodestatsf_(int *id, long long *integrations, long long *f_evaluations, long long *jacobians, long long *factorizations)
+{
+	return GetCvodeStatsF(id, integrations, f_evaluations, jacobians, factorizations);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// SetIneqLU
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int SETINEQLUF(int *id, int *tf)
+{
+	return SetIneqLUF(id, tf);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int SETINEQLUF_(int *id, int *tf)
+{
+	return SetIneqLUF(id, tf);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int setineqluf(int *id, int *tf)
+{
+	return SetIneqLUF(id, tf);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int setineqluf_(int *id, int *tf)
+{
+	return SetIneqLUF(id, tf);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// GetIneqStats
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int GETINEQSTATSF(int *id, long long *solves, long long *lu_solves, long long *lu_rejects)
+{
+	return GetIneqStatsF(id, solves, lu_solves, lu_rejects);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int GETINEQSTATSF_(int *id, long long *solves, long long *lu_solves, long long *lu_rejects)
+{
+	return GetIneqStatsF(id, solves, lu_solves, lu_rejects);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int getineqstatsf(int *id, long long *solves, long long *lu_solves, long long *lu_rejects)
+{
+	return GetIneqStatsF(id, solves, lu_solves, lu_rejects);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int getineqstatsf_(int *id, long long *solves, long long *lu_solves, long long *lu_rejects)
+{
+	return GetIneqStatsF(id, solves, lu_solves, lu_rejects);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// SetMixSkipTolerance
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int SETMIXSKIPTOLERANCEF(int *id, double *tol)
+{
+	return SetMixSkipToleranceF(id, tol);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int SETMIXSKIPTOLERANCEF_(int *id, double *tol)
+{
+	return SetMixSkipToleranceF(id, tol);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int setmixskiptolerancef(int *id, double *tol)
+{
+	return SetMixSkipToleranceF(id, tol);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int setmixskiptolerancef_(int *id, double *tol)
+{
+	return SetMixSkipToleranceF(id, tol);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// GetMixSkipStats
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int GETMIXSKIPSTATSF(int *id, long long *skipped, long long *executed, int *n)
+{
+	return GetMixSkipStatsF(id, skipped, executed, n);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int GETMIXSKIPSTATSF_(int *id, long long *skipped, long long *executed, int *n)
+{
+	return GetMixSkipStatsF(id, skipped, executed, n);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int getmixskipstatsf(int *id, long long *skipped, long long *executed, int *n)
+{
+	return GetMixSkipStatsF(id, skipped, executed, n);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int getmixskipstatsf_(int *id, long long *skipped, long long *executed, int *n)
+{
+	return GetMixSkipStatsF(id, skipped, executed, n);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// SetTallyColumns
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int SETTALLYCOLUMNSF(int *id, int *res_class, int *columns, int *n)
+{
+	return SetTallyColumnsF(id, res_class, columns, n);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int SETTALLYCOLUMNSF_(int *id, int *res_class, int *columns, int *n)
+{
+	return SetTallyColumnsF(id, res_class, columns, n);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int settallycolumnsf(int *id, int *res_class, int *columns, int *n)
+{
+	return SetTallyColumnsF(id, res_class, columns, n);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int settallycolumnsf_(int *id, int *res_class, int *columns, int *n)
+{
+	return SetTallyColumnsF(id, res_class, columns, n);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// BindTallyBuffer
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int BINDTALLYBUFFERF(int *id, int *n_user, double *buffer)
+{
+	return BindTallyBufferF(id, n_user, buffer);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int BINDTALLYBUFFERF_(int *id, int *n_user, double *buffer)
+{
+	return BindTallyBufferF(id, n_user, buffer);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int bindtallybufferf(int *id, int *n_user, double *buffer)
+{
+	return BindTallyBufferF(id, n_user, buffer);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int bindtallybufferf_(int *id, int *n_user, double *buffer)
+{
+	return BindTallyBufferF(id, n_user, buffer);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// DefineSolution
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int DEFINESOLUTIONF(int *id, int *n_user, int *count, char *species, double *conc, double *tempc, double *ph, unsigned int species_length)
+{
+	return DefineSolutionF(id, n_user, count, species, conc, tempc, ph, species_length);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int DEFINESOLUTIONF_(int *id, int *n_user, int *count, char *species, double *conc, double *tempc, double *ph, unsigned int species_length)
+{
+	return DefineSolutionF(id, n_user, count, species, conc, tempc, ph, species_length);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int definesolutionf(int *id, int *n_user, int *count, char *species, double *conc, double *tempc, double *ph, unsigned int species_length)
+{
+	return DefineSolutionF(id, n_user, count, species, conc, tempc, ph, species_length);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int definesolutionf_(int *id, int *n_user, int *count, char *species, double *conc, double *tempc, double *ph, unsigned int species_length)
+{
+	return DefineSolutionF(id, n_user, count, species, conc, tempc, ph, species_length);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// DefineSolutions
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int DEFINESOLUTIONSF(int *id, int *nsoln, int *n_user, int *count, char *species, double *conc, int *conc_dim, double *tempc, double *ph, unsigned int species_length)
+{
+	return DefineSolutionsF(id, nsoln, n_user, count, species, conc, conc_dim, tempc, ph, species_length);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int DEFINESOLUTIONSF_(int *id, int *nsoln, int *n_user, int *count, char *species, double *conc, int *conc_dim, double *tempc, double *ph, unsigned int species_length)
+{
+	return DefineSolutionsF(id, nsoln, n_user, count, species, conc, conc_dim, tempc, ph, species_length);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int definesolutionsf(int *id, int *nsoln, int *n_user, int *count, char *species, double *conc, int *conc_dim, double *tempc, double *ph, unsigned int species_length)
+{
+	return DefineSolutionsF(id, nsoln, n_user, count, species, conc, conc_dim, tempc, ph, species_length);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int definesolutionsf_(int *id, int *nsoln, int *n_user, int *count, char *species, double *conc, int *conc_dim, double *tempc, double *ph, unsigned int species_length)
+{
+	return DefineSolutionsF(id, nsoln, n_user, count, species, conc, conc_dim, tempc, ph, species_length);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // MeltPack
@@ -66,7 +66,7 @@ get_tally_table_row_headingF(int *id, int *row, char *string, unsigned int strin
 int
 RunMixF(int *id, int *count, int *solutions, double *fracs, int *index_conserv,
 		double *fill_factor, int *index_rxn, double *conc_conserv, int *files_on,
-		int *n_user, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
+		int *n_user, int *res_class, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
 		int *row_dim, int *col_dim)
 {
 	IPhreeqcMMS* IPhreeqcMMSPtr = IPhreeqcMMSLib::GetInstance(*id);
@@ -81,6 +81,7 @@ RunMixF(int *id, int *count, int *solutions, double *fracs, int *index_conserv,
 		vars.index_conserv = *index_conserv;
 		vars.fill_factor   = *fill_factor;
 		vars.n_user        = n_user;
+		vars.res_class     = *res_class;
 		vars.rxnmols       = *rxnmols;	
 		vars.tempc         = *tempc;
 		vars.tsec          = *tsec;
@@ -92,13 +93,333 @@ RunMixF(int *id, int *count, int *solutions, double *fracs, int *index_conserv,
 		n_user[Solution] = *index_rxn;
 
 		IPhreeqcMMSPtr->PreMixCallback(&vars);
-		int n = IPhreeqcMMSPtr->RunAccumulated();
+		int n = IPhreeqcMMSPtr->RunMix(&vars);
 		IPhreeqcMMSPtr->PostMixCallback(&vars);
 
 		return n;
 	}
 	return IPQ_BADINSTANCE;
 }
+static void
+fill_mix_vars(std::vector<struct MixVars>& vars, int *id, int *nmix, int *counts, int *solutions, double *fracs,
+		int *index_conserv, double *fill_factor, int *index_rxn, int *n_user, int *n_user_dim, int *res_class,
+		double *rxnmols, double *tempc, double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	//
+	// solutions and fracs hold counts[i] entries for each mix, one after the other;
+	// n_user(n_user_dim, nmix) and array(row_dim + 1, col_dim, nmix) are
+	// Fortran arrays with one column per mix
+	//
+	vars.resize(*nmix > 0 ? *nmix : 0);
+	int offset = 0;
+	for (int i = 0; i < *nmix; ++i)
+	{
+		vars[i].id            = *id;
+		vars[i].count         = counts[i];
+		vars[i].solutions     = &solutions[offset];
+		vars[i].fracs         = &fracs[offset];
+		vars[i].index_conserv = index_conserv[i];
+		vars[i].fill_factor   = fill_factor[i];
+		vars[i].n_user        = &n_user[i * (*n_user_dim)];
+		vars[i].res_class     = res_class[i];
+		vars[i].rxnmols       = rxnmols[i];
+		vars[i].tempc         = tempc[i];
+		vars[i].tsec          = tsec[i];
+		vars[i].array         = &array[i * (*row_dim + 1) * (*col_dim)];
+		vars[i].row_dim       = *row_dim;
+		vars[i].col_dim       = *col_dim;
+		vars[i].files_on      = 0;
+		vars[i].orig_out      = 0;
+
+		vars[i].n_user[Solution] = index_rxn[i];
+		offset += counts[i];
+	}
+}
+
+// Runs the mixes in order, as consecutive RunMixF calls would.
+// WEBMOD still calls phr_mix one mix at a time: after most mixes it
+// posts the tally to c_chem with update_chem or modifies solutions with
+// AccumulateLine before the next mix, so its calls cannot be gathered
+// into one batch without reordering the time step.
+int
+RunMixBatchF(int *id, int *nmix, int *counts, int *solutions, double *fracs, int *index_conserv,
+		double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+		int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+		double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	IPhreeqcMMS* IPhreeqcMMSPtr = IPhreeqcMMSLib::GetInstance(*id);
+	if (IPhreeqcMMSPtr)
+	{
+		std::vector<struct MixVars> vars;
+		fill_mix_vars(vars, id, nmix, counts, solutions, fracs, index_conserv, fill_factor, index_rxn,
+			n_user, n_user_dim, res_class, rxnmols, tempc, tsec, array, row_dim, col_dim);
+		if (vars.empty()) return 0;
+
+		return IPhreeqcMMSPtr->RunMixBatch(*nmix, &vars[0], ph, ph_final, tempc, conc_conserv, *conc_dim);
+	}
+	return IPQ_BADINSTANCE;
+}
+
+// Runs independent groups of mixes on the workers made by
+// CreateMixWorkersF.  WEBMOD does not use the pool: within a time step
+// its reservoirs mix the solutions just saved by upstream reservoirs,
+// every MRU modifies and mixes the same precipitation solution, and
+// each result is posted to c_chem before the next mix is set up, so its
+// phr_mix calls are not independent (see the MRU loop of phreeq_mms.F90).
+int
+RunMixPoolF(int *id, int *nmix, int *groups, int *counts, int *solutions, double *fracs, int *index_conserv,
+		double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+		int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+		double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	IPhreeqcMMS* IPhreeqcMMSPtr = IPhreeqcMMSLib::GetInstance(*id);
+	if (IPhreeqcMMSPtr)
+	{
+		std::vector<struct MixVars> vars;
+		fill_mix_vars(vars, id, nmix, counts, solutions, fracs, index_conserv, fill_factor, index_rxn,
+			n_user, n_user_dim, res_class, rxnmols, tempc, tsec, array, row_dim, col_dim);
+		if (vars.empty()) return 0;
+
+		return IPhreeqcMMSPtr->RunMixPool(*nmix, &vars[0], groups, ph, ph_final, tempc, conc_conserv, *conc_dim);
+	}
+	return IPQ_BADINSTANCE;
+}
+
+int
+CreateMixWorkersF(int *id, int *n)
+{
+	IPhreeqcMMS* IPhreeqcMMSPtr = IPhreeqcMMSLib::GetInstance(*id);
+	if (IPhreeqcMMSPtr)
+	{
+		return IPhreeqcMMSPtr->CreateWorkers(*n);
+	}
+	return IPQ_BADINSTANCE;
+}
+
+int
+SetWarmStartF(int *id, int *tf)
+{
+	IPhreeqcMMS* IPhreeqcMMSPtr = IPhreeqcMMSLib::GetInstance(*id);
+	if (IPhreeqcMMSPtr)
+	{
+		IPhreeqcMMSPtr->SetWarmStart(*tf != 0);
+		return IPQ_OK;
+	}
+	return IPQ_BADINSTANCE;
+}
+
+int
+GetSolverStatsF(int *id, long long *solves, long long *iterations, long long *warm_starts, long long *fallbacks)
+{
+	IPhreeqcMMS* IPhreeqcMMSPtr = IPhreeqcMMSLib::GetInstance(*id);
+	if (IPhreeqcMMSPtr)
+	{
+		long s, i, ws, f;
+		IPhreeqcMMSPtr->GetSolverStats(&s, &i, &ws, &f);
+		*solves      = s;
+		*iterations  = i;
+		*warm_starts = ws;
+		*fallbacks   = f;
+		return IPQ_OK;
+	}
+	return IPQ_BADINSTANCE;
+}
+
+int
+SetModelCacheSizeF(int *id, int *n)
+{
+	IPhreeqcMMS* IPhreeqcMMSPtr = IPhreeqcMMSLib::GetInstance(*id);
+	if (IPhreeqcMMSPtr)
+	{
+		IPhreeqcMMSPtr->SetModelCacheSize(*n);
+		return IPQ_OK;
+	}
+	return IPQ_BADINSTANCE;
+}
+
+int
+GetModelCacheStatsF(int *id, long long *hits, long long *misses)
+{
+	IPhreeqcMMS* IPhreeqcMMSPtr = IPhreeqcMMSLib::GetInstance(*id);
+	if (IPhreeqcMMSPtr)
+	{
+		long h, m;
+		IPhreeqcMMSPtr->GetModelCacheStats(&h, &m);
+		*hits   = h;
+		*misses = m;
+		return IPQ_OK;
+	}
+	return IPQ_BADINSTANCE;
+}
+
+int
+GetTidyStatsF(int *id, long long *calls, long long *skipped, long long *rebuilds)
+{
+	IPhreeqcMMS* IPhreeqcMMSPtr = IPhreeqcMMSLib::GetInstance(*id);
+	if (IPhreeqcMMSPtr)
+	{
+		long c, s, r;
+		IPhreeqcMMSPtr->GetTidyStats(&c, &s, &r);
+		*calls    = c;
+		*skipped  = s;
+		*rebuilds = r;
+		return IPQ_OK;
+	}
+	return IPQ_BADINSTANCE;
+}
+
+int
+GetCvodeStatsF(int *id, long long *integrations, long long *f_evaluations, long long *jacobians, long long *factorizations)
+{
+	IPhreeqcMMS* IPhreeqcMMSPtr = IPhreeqcMMSLib::GetInstance(*id);
+	if (IPhreeqcMMSPtr)
+	{
+		long n, f, j, m;
+		IPhreeqcMMSPtr->GetCvodeStats(&n, &f, &j, &m);
+		*integrations   = n;
+		*f_evaluations  = f;
+		*jacobians      = j;
+		*factorizations = m;
+		return IPQ_OK;
+	}
+	return IPQ_BADINSTANCE;
+}
+
+int
+SetIneqLUF(int *id, int *tf)
+{
+	IPhreeqcMMS* IPhreeqcMMSPtr = IPhreeqcMMSLib::GetInstance(*id);
+	if (IPhreeqcMMSPtr)
+	{
+		IPhreeqcMMSPtr->SetIneqLU(*tf != 0);
+		return IPQ_OK;
+	}
+	return IPQ_BADINSTANCE;
+}
+
+int
+GetIneqStatsF(int *id, long long *solves, long long *lu_solves, long long *lu_rejects)
+{
+	IPhreeqcMMS* IPhreeqcMMSPtr = IPhreeqcMMSLib::GetInstance(*id);
+	if (IPhreeqcMMSPtr)
+	{
+		long n, s, r;
+		IPhreeqcMMSPtr->GetIneqStats(&n, &s, &r);
+		*solves     = n;
+		*lu_solves  = s;
+		*lu_rejects = r;
+		return IPQ_OK;
+	}
+	return IPQ_BADINSTANCE;
+}
+
+int
+SetMixSkipToleranceF(int *id, double *tol)
+{
+	IPhreeqcMMS* IPhreeqcMMSPtr = IPhreeqcMMSLib::GetInstance(*id);
+	if (IPhreeqcMMSPtr)
+	{
+		IPhreeqcMMSPtr->SetMixSkipTolerance(*tol);
+		return IPQ_OK;
+	}
+	return IPQ_BADINSTANCE;
+}
+
+int
+GetMixSkipStatsF(int *id, long long *skipped, long long *executed, int *n)
+{
+	IPhreeqcMMS* IPhreeqcMMSPtr = IPhreeqcMMSLib::GetInstance(*id);
+	if (IPhreeqcMMSPtr)
+	{
+		std::vector<long> s(*n > 0 ? *n : 1), e(*n > 0 ? *n : 1);
+		int classes = IPhreeqcMMSPtr->GetMixSkipStats(&s[0], &e[0], *n);
+		for (int i = 0; i < *n; ++i)
+		{
+			skipped[i]  = s[i];
+			executed[i] = e[i];
+		}
+		return classes;
+	}
+	return IPQ_BADINSTANCE;
+}
+
+int
+SetTallyColumnsF(int *id, int *res_class, int *columns, int *n)
+{
+	IPhreeqcMMS* IPhreeqcMMSPtr = IPhreeqcMMSLib::GetInstance(*id);
+	if (IPhreeqcMMSPtr)
+	{
+		// Fortran column numbers
+		std::vector<int> c;
+		for (int i = 0; i < *n; ++i)
+		{
+			c.push_back(columns[i] - 1);
+		}
+		IPhreeqcMMSPtr->SetTallyColumns(*res_class, c.empty() ? NULL : &c[0], (int)c.size());
+		return IPQ_OK;
+	}
+	return IPQ_BADINSTANCE;
+}
+
+int
+BindTallyBufferF(int *id, int *n_user, double *buffer)
+{
+	IPhreeqcMMS* IPhreeqcMMSPtr = IPhreeqcMMSLib::GetInstance(*id);
+	if (IPhreeqcMMSPtr)
+	{
+		return (IPhreeqcMMSPtr->BindTallyBuffer(*n_user, buffer) == OK) ? IPQ_OK : IPQ_INVALIDARG;
+	}
+	return IPQ_BADINSTANCE;
+}
+
+static void
+fortran_names(const char *names, int count, unsigned int name_length, std::vector<std::string> &s, std::vector<const char*> &p)
+{
+	// blank-padded Fortran CHARACTER array to C strings
+	s.resize(count);
+	p.resize(count);
+	for (int i = 0; i < count; ++i)
+	{
+		const char *name = names + (size_t)i * name_length;
+		unsigned int len = name_length;
+		while (len > 0 && (name[len - 1] == ' ' || name[len - 1] == '\0')) --len;
+		s[i].assign(name, len);
+	}
+	for (int i = 0; i < count; ++i)
+	{
+		p[i] = s[i].c_str();
+	}
+}
+
+int
+DefineSolutionF(int *id, int *n_user, int *count, char *species, double *conc, double *tempc, double *ph, unsigned int species_length)
+{
+	IPhreeqcMMS* IPhreeqcMMSPtr = IPhreeqcMMSLib::GetInstance(*id);
+	if (IPhreeqcMMSPtr)
+	{
+		std::vector<std::string> s;
+		std::vector<const char*> p;
+		fortran_names(species, *count, species_length, s, p);
+		return IPhreeqcMMSPtr->DefineSolution(*n_user, *count, p.empty() ? NULL : &p[0], conc, *tempc, *ph);
+	}
+	return IPQ_BADINSTANCE;
+}
+
+int
+DefineSolutionsF(int *id, int *nsoln, int *n_user, int *count, char *species, double *conc, int *conc_dim,
+			double *tempc, double *ph, unsigned int species_length)
+{
+	IPhreeqcMMS* IPhreeqcMMSPtr = IPhreeqcMMSLib::GetInstance(*id);
+	if (IPhreeqcMMSPtr)
+	{
+		std::vector<std::string> s;
+		std::vector<const char*> p;
+		fortran_names(species, *count, species_length, s, p);
+		return IPhreeqcMMSPtr->DefineSolutions(*nsoln, n_user, *count, p.empty() ? NULL : &p[0], conc, *conc_dim, tempc, ph);
+	}
+	return IPQ_BADINSTANCE;
+}
+
 int
 MeltPackF(int *id, int *ipack, int *imelt, double *eps, double *ipf, double *fmelt, double *rstd)
 {
@@ -16,9 +16,50 @@ int get_tally_table_row_headingF(int *id, int *row, char *string, unsigned int s
 
 int RunMixF(int *id, int *count, int *solutions, double *fracs, int *index_conserv,
 			double *fill_factor, int *index_rxn, double *conc_conserv, int *files_on,
-			int *n_user, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
+			int *n_user, int *res_class, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
 			int *row_dim, int *col_dim);
 
+int RunMixBatchF(int *id, int *nmix, int *counts, int *solutions, double *fracs, int *index_conserv,
+			double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+			int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+			double *tsec, double *array, int *row_dim, int *col_dim);
+
+int RunMixPoolF(int *id, int *nmix, int *groups, int *counts, int *solutions, double *fracs, int *index_conserv,
+			double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+			int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+			double *tsec, double *array, int *row_dim, int *col_dim);
+
+int CreateMixWorkersF(int *id, int *n);
+
+int SetWarmStartF(int *id, int *tf);
+
+int GetSolverStatsF(int *id, long long *solves, long long *iterations, long long *warm_starts, long long *fallbacks);
+
+int SetModelCacheSizeF(int *id, int *n);
+
+int GetModelCacheStatsF(int *id, long long *hits, long long *misses);
+
+int GetTidyStatsF(int *id, long long *calls, long long *skipped, long long *rebuilds);
+
+int GetCvodeStatsF(int *id, long long *integrations, long long *f_evaluations, long long *jacobians, long long *factorizations);
+
+int SetIneqLUF(int *id, int *tf);
+
+int GetIneqStatsF(int *id, long long *solves, long long *lu_solves, long long *lu_rejects);
+
+int SetMixSkipToleranceF(int *id, double *tol);
+
+int GetMixSkipStatsF(int *id, long long *skipped, long long *executed, int *n);
+
+int SetTallyColumnsF(int *id, int *res_class, int *columns, int *n);
+
+int BindTallyBufferF(int *id, int *n_user, double *buffer);
+
+int DefineSolutionF(int *id, int *n_user, int *count, char *species, double *conc, double *tempc, double *ph, unsigned int species_length);
+
+int DefineSolutionsF(int *id, int *nsoln, int *n_user, int *count, char *species, double *conc, int *conc_dim,
+			double *tempc, double *ph, unsigned int species_length);
+
 int MeltPackF(int *id, int *ipack, int *imelt, double *eps, double *ipf, double *fmelt, double *rstd);
 
 
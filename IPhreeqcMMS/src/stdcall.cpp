@@ -213,12 +213,12 @@ IPQ_DLL_EXPORT int __stdcall get_tally_table_row_heading_(int *id, int *row, cha
 // /iface:stdcall /names:uppercase
 IPQ_DLL_EXPORT int __stdcall RUNMIXF(int *id, int *count, int *solutions, double *fracs, int *index_conserv,
 		double *fill_factor, int *index_rxn, double *conc_conserv, int *files_on,
-		int *n_user, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
+		int *n_user, int *res_class, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
 		int *row_dim, int *col_dim)
 {
 	return RunMixF(id, count, solutions, fracs, index_conserv,
 		fill_factor, index_rxn, conc_conserv, files_on,
-		n_user, rxnmols, tempc, ph, tsec, array,
+		n_user, res_class, rxnmols, tempc, ph, tsec, array,
 		row_dim, col_dim);
 }
 
@@ -226,38 +226,613 @@ IPQ_DLL_EXPORT int __stdcall RUNMIXF(int *id, int *count, int *solutions, double
 // /iface:stdcall /names:uppercase /assume:underscore
 IPQ_DLL_EXPORT int __stdcall RUNMIXF_(int *id, int *count, int *solutions, double *fracs, int *index_conserv,
 		double *fill_factor, int *index_rxn, double *conc_conserv, int *files_on,
-		int *n_user, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
+		int *n_user, int *res_class, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
 		int *row_dim, int *col_dim)
 {
 	return RunMixF(id, count, solutions, fracs, index_conserv,
 		fill_factor, index_rxn, conc_conserv, files_on,
-		n_user, rxnmols, tempc, ph, tsec, array,
+		n_user, res_class, rxnmols, tempc, ph, tsec, array,
 		row_dim, col_dim);
 }
 
 // /iface:stdcall
 IPQ_DLL_EXPORT int __stdcall runmixf(int *id, int *count, int *solutions, double *fracs, int *index_conserv,
 		double *fill_factor, int *index_rxn, double *conc_conserv, int *files_on,
-		int *n_user, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
+		int *n_user, int *res_class, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
 		int *row_dim, int *col_dim)
 {
 	return RunMixF(id, count, solutions, fracs, index_conserv,
 		fill_factor, index_rxn, conc_conserv, files_on,
-		n_user, rxnmols, tempc, ph, tsec, array,
+		n_user, res_class, rxnmols, tempc, ph, tsec, array,
 		row_dim, col_dim);
 }
 
 // /iface:stdcall /assume:underscore
 IPQ_DLL_EXPORT int __stdcall runmixf_(int *id, int *count, int *solutions, double *fracs, int *index_conserv,
 		double *fill_factor, int *index_rxn, double *conc_conserv, int *files_on,
-		int *n_user, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
+		int *n_user, int *res_class, double *rxnmols, double *tempc, double *ph, double *tsec, double *array,
 		int *row_dim, int *col_dim)
 {
 	return RunMixF(id, count, solutions, fracs, index_conserv,
 		fill_factor, index_rxn, conc_conserv, files_on,
-		n_user, rxnmols, tempc, ph, tsec, array,
+		n_user, res_class, rxnmols, tempc, ph, tsec, array,
 		row_dim, col_dim);
 }
+///////////////////////////////////////////////////////////////////////////////
+//
+// RunMixBatch
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int __stdcall RUNMIXBATCHF(int *id, int *nmix, int *counts, int *solutions, double *fracs, int *index_conserv,
+		double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+		int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+		double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	return RunMixBatchF(id, nmix, counts, solutions, fracs, index_conserv,
+		fill_factor, index_rxn, conc_conserv, conc_dim,
+		n_user, n_user_dim, res_class, rxnmols, tempc, ph, ph_final,
+		tsec, array, row_dim, col_dim);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int __stdcall RUNMIXBATCHF_(int *id, int *nmix, int *counts, int *solutions, double *fracs, int *index_conserv,
+		double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+		int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+		double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	return RunMixBatchF(id, nmix, counts, solutions, fracs, index_conserv,
+		fill_factor, index_rxn, conc_conserv, conc_dim,
+		n_user, n_user_dim, res_class, rxnmols, tempc, ph, ph_final,
+		tsec, array, row_dim, col_dim);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int __stdcall runmixbatchf(int *id, int *nmix, int *counts, int *solutions, double *fracs, int *index_conserv,
+		double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+		int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+		double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	return RunMixBatchF(id, nmix, counts, solutions, fracs, index_conserv,
+		fill_factor, index_rxn, conc_conserv, conc_dim,
+		n_user, n_user_dim, res_class, rxnmols, tempc, ph, ph_final,
+		tsec, array, row_dim, col_dim);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int __stdcall runmixbatchf_(int *id, int *nmix, int *counts, int *solutions, double *fracs, int *index_conserv,
+		double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+		int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+		double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	return RunMixBatchF(id, nmix, counts, solutions, fracs, index_conserv,
+		fill_factor, index_rxn, conc_conserv, conc_dim,
+		n_user, n_user_dim, res_class, rxnmols, tempc, ph, ph_final,
+		tsec, array, row_dim, col_dim);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// RunMixPool
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int __stdcall RUNMIXPOOLF(int *id, int *nmix, int *groups, int *counts, int *solutions, double *fracs, int *index_conserv,
+		double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+		int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+		double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	return RunMixPoolF(id, nmix, groups, counts, solutions, fracs, index_conserv,
+		fill_factor, index_rxn, conc_conserv, conc_dim,
+		n_user, n_user_dim, res_class, rxnmols, tempc, ph, ph_final,
+		tsec, array, row_dim, col_dim);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int __stdcall RUNMIXPOOLF_(int *id, int *nmix, int *groups, int *counts, int *solutions, double *fracs, int *index_conserv,
+		double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+		int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+		double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	return RunMixPoolF(id, nmix, groups, counts, solutions, fracs, index_conserv,
+		fill_factor, index_rxn, conc_conserv, conc_dim,
+		n_user, n_user_dim, res_class, rxnmols, tempc, ph, ph_final,
+		tsec, array, row_dim, col_dim);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int __stdcall runmixpoolf(int *id, int *nmix, int *groups, int *counts, int *solutions, double *fracs, int *index_conserv,
+		double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+		int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+		double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	return RunMixPoolF(id, nmix, groups, counts, solutions, fracs, index_conserv,
+		fill_factor, index_rxn, conc_conserv, conc_dim,
+		n_user, n_user_dim, res_class, rxnmols, tempc, ph, ph_final,
+		tsec, array, row_dim, col_dim);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int __stdcall runmixpoolf_(int *id, int *nmix, int *groups, int *counts, int *solutions, double *fracs, int *index_conserv,
+		double *fill_factor, int *index_rxn, double *conc_conserv, int *conc_dim,
+		int *n_user, int *n_user_dim, int *res_class, double *rxnmols, double *tempc, double *ph, double *ph_final,
+		double *tsec, double *array, int *row_dim, int *col_dim)
+{
+	return RunMixPoolF(id, nmix, groups, counts, solutions, fracs, index_conserv,
+		fill_factor, index_rxn, conc_conserv, conc_dim,
+		n_user, n_user_dim, res_class, rxnmols, tempc, ph, ph_final,
+		tsec, array, row_dim, col_dim);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// CreateMixWorkers
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int __stdcall CREATEMIXWORKERSF(int *id, int *n)
+{
+	return CreateMixWorkersF(id, n);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int __stdcall CREATEMIXWORKERSF_(int *id, int *n)
+{
+	return CreateMixWorkersF(id, n);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int __stdcall createmixworkersf(int *id, int *n)
+{
+	return CreateMixWorkersF(id, n);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int __stdcall createmixworkersf_(int *id, int *n)
+{
+	return CreateMixWorkersF(id, n);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// SetWarmStart
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int __stdcall SETWARMSTARTF(int *id, int *tf)
+{
+	return SetWarmStartF(id, tf);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int __stdcall SETWARMSTARTF_(int *id, int *tf)
+{
+	return SetWarmStartF(id, tf);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int __stdcall setwarmstartf(int *id, int *tf)
+{
+	return SetWarmStartF(id, tf);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int __stdcall setwarmstartf_(int *id, int *tf)
+{
+	return SetWarmStartF(id, tf);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// GetSolverStats
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int __stdcall GETSOLVERSTATSF(int *id, long long *solves, long long *iterations, long long *warm_starts, long long *fallbacks)
+{
+	return GetSolverStatsF(id, solves, iterations, warm_starts, fallbacks);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int __stdcall GETSOLVERSTATSF_(int *id, long long *solves, long long *iterations, long long *warm_starts, long long *fallbacks)
+{
+	return GetSolverStatsF(id, solves, iterations, warm_starts, fallbacks);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int __stdcall getsolverstatsf(int *id, long long *solves, long long *iterations, long long *warm_starts, long long *fallbacks)
+{
+	return GetSolverStatsF(id, solves, iterations, warm_starts, fallbacks);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int __stdcall getsolverstatsf_(int *id, long long *solves, long long *iterations, long long *warm_starts, long long *fallbacks)
+{
+	return GetSolverStatsF(id, solves, iterations, warm_starts, fallbacks);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// SetModelCacheSize
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int __stdcall SETMODELCACHESIZEF(int *id, int *n)
+{
+	return SetModelCacheSizeF(id, n);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int __stdcall SETMODELCACHESIZEF_(int *id, int *n)
+{
+	return SetModelCacheSizeF(id, n);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int __stdcall setmodelcachesizef(int *id, int *n)
+{
+	return SetModelCacheSizeF(id, n);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int __stdcall setmodelcachesizef_(int *id, int *n)
+{
+	return SetModelCacheSizeF(id, n);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// GetModelCacheStats
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int __stdcall GETMODELCACHESTATSF(int *id, long long *hits, long long *misses)
+{
+	return GetModelCacheStatsF(id, hits, misses);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int __stdcall GETMODELCACHESTATSF_(int *id, long long *hits, long long *misses)
+{
+	return GetModelCacheStatsF(id, hits, misses);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int __stdcall getmodelcachestatsf(int *id, long long *hits, long long *misses)
+{
+	return GetModelCacheStatsF(id, hits, misses);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int __stdcall getmodelcachestatsf_(int *id, long long *hits, long long *misses)
+{
+	return GetModelCacheStatsF(id, hits, misses);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// GetTidyStats
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int __stdcall GETTIDYSTATSF(int *id, long long *calls, long long *skipped, long long *rebuilds)
+{
+	return GetTidyStatsF(id, calls, skipped, rebuilds);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int __stdcall GETTIDYSTATSF_(int *id, long long *calls, long long *skipped, long long *rebuilds)
+{
+	return GetTidyStatsF(id, calls, skipped, rebuilds);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int __stdcall gettidystatsf(int *id, long long *calls, long long *skipped, long long *rebuilds)
+{
+	return GetTidyStatsF(id, calls, skipped, rebuilds);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int __stdcall gettidystatsf_(int *id, long long *calls, long long *skipped, long long *rebuilds)
+{
+	return GetTidyStatsF(id, calls, skipped, rebuilds);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// GetCvodeStats
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int __stdcall GETCVODESTATSF(int *id, long long *integrations, long long *f_evaluations, long long *jacobians, long long *factorizations)
+{
+	return GetCvodeStatsF(id, integrations, f_evaluations, jacobians, factorizations);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int __stdcall GETCVODESTATSF_(int *id, long long *integrations, long long *f_evaluations, long long *jacobians, long long *factorizations)
+{
+	return GetCvodeStatsF(id, integrations, f_evaluations, jacobians, factorizations);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int __stdcall getcvodestatsf(int *id, long long *integrations, long long *f_evaluations, long long *jacobians, long long *factorizations)
+{
+	return GetCvodeStatsF(id, integrations, f_evaluations, jacobians, factorizations);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int __stdcall getcvodestatsf_(int *id, long long *integrations, long long *f_evaluations, long long *jacobians, long long *factorizations)
+{
+	return GetCvodeStatsF(id, integrations, f_evaluations, jacobians, factorizations);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// SetIneqLU
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int __stdcall SETINEQLUF(int *id, int *tf)
+{
+	return SetIneqLUF(id, tf);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int __stdcall SETINEQLUF_(int *id, int *tf)
+{
+	return SetIneqLUF(id, tf);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int __stdcall setineqluf(int *id, int *tf)
+{
+	return SetIneqLUF(id, tf);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int __stdcall setineqluf_(int *id, int *tf)
+{
+	return SetIneqLUF(id, tf);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// GetIneqStats
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int __stdcall GETINEQSTATSF(int *id, long long *solves, long long *lu_solves, long long *lu_rejects)
+{
+	return GetIneqStatsF(id, solves, lu_solves, lu_rejects);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int __stdcall GETINEQSTATSF_(int *id, long long *solves, long long *lu_solves, long long *lu_rejects)
+{
+	return GetIneqStatsF(id, solves, lu_solves, lu_rejects);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int __stdcall getineqstatsf(int *id, long long *solves, long long *lu_solves, long long *lu_rejects)
+{
+	return GetIneqStatsF(id, solves, lu_solves, lu_rejects);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int __stdcall getineqstatsf_(int *id, long long *solves, long long *lu_solves, long long *lu_rejects)
+{
+	return GetIneqStatsF(id, solves, lu_solves, lu_rejects);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// SetMixSkipTolerance
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int __stdcall SETMIXSKIPTOLERANCEF(int *id, double *tol)
+{
+	return SetMixSkipToleranceF(id, tol);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int __stdcall SETMIXSKIPTOLERANCEF_(int *id, double *tol)
+{
+	return SetMixSkipToleranceF(id, tol);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int __stdcall setmixskiptolerancef(int *id, double *tol)
+{
+	return SetMixSkipToleranceF(id, tol);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int __stdcall setmixskiptolerancef_(int *id, double *tol)
+{
+	return SetMixSkipToleranceF(id, tol);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// GetMixSkipStats
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int __stdcall GETMIXSKIPSTATSF(int *id, long long *skipped, long long *executed, int *n)
+{
+	return GetMixSkipStatsF(id, skipped, executed, n);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int __stdcall GETMIXSKIPSTATSF_(int *id, long long *skipped, long long *executed, int *n)
+{
+	return GetMixSkipStatsF(id, skipped, executed, n);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int __stdcall getmixskipstatsf(int *id, long long *skipped, long long *executed, int *n)
+{
+	return GetMixSkipStatsF(id, skipped, executed, n);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int __stdcall getmixskipstatsf_(int *id, long long *skipped, long long *executed, int *n)
+{
+	return GetMixSkipStatsF(id, skipped, executed, n);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// SetTallyColumns
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int __stdcall SETTALLYCOLUMNSF(int *id, int *res_class, int *columns, int *n)
+{
+	return SetTallyColumnsF(id, res_class, columns, n);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int __stdcall SETTALLYCOLUMNSF_(int *id, int *res_class, int *columns, int *n)
+{
+	return SetTallyColumnsF(id, res_class, columns, n);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int __stdcall settallycolumnsf(int *id, int *res_class, int *columns, int *n)
+{
+	return SetTallyColumnsF(id, res_class, columns, n);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int __stdcall settallycolumnsf_(int *id, int *res_class, int *columns, int *n)
+{
+	return SetTallyColumnsF(id, res_class, columns, n);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// BindTallyBuffer
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int __stdcall BINDTALLYBUFFERF(int *id, int *n_user, double *buffer)
+{
+	return BindTallyBufferF(id, n_user, buffer);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int __stdcall BINDTALLYBUFFERF_(int *id, int *n_user, double *buffer)
+{
+	return BindTallyBufferF(id, n_user, buffer);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int __stdcall bindtallybufferf(int *id, int *n_user, double *buffer)
+{
+	return BindTallyBufferF(id, n_user, buffer);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int __stdcall bindtallybufferf_(int *id, int *n_user, double *buffer)
+{
+	return BindTallyBufferF(id, n_user, buffer);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// DefineSolution
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int __stdcall DEFINESOLUTIONF(int *id, int *n_user, int *count, char *species, double *conc, double *tempc, double *ph, unsigned int species_length)
+{
+	return DefineSolutionF(id, n_user, count, species, conc, tempc, ph, species_length);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int __stdcall DEFINESOLUTIONF_(int *id, int *n_user, int *count, char *species, double *conc, double *tempc, double *ph, unsigned int species_length)
+{
+	return DefineSolutionF(id, n_user, count, species, conc, tempc, ph, species_length);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int __stdcall definesolutionf(int *id, int *n_user, int *count, char *species, double *conc, double *tempc, double *ph, unsigned int species_length)
+{
+	return DefineSolutionF(id, n_user, count, species, conc, tempc, ph, species_length);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int __stdcall definesolutionf_(int *id, int *n_user, int *count, char *species, double *conc, double *tempc, double *ph, unsigned int species_length)
+{
+	return DefineSolutionF(id, n_user, count, species, conc, tempc, ph, species_length);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// DefineSolutions
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// /iface:default /names:default
+IPQ_DLL_EXPORT int __stdcall DEFINESOLUTIONSF(int *id, int *nsoln, int *n_user, int *count, char *species, double *conc, int *conc_dim, double *tempc, double *ph, unsigned int species_length)
+{
+	return DefineSolutionsF(id, nsoln, n_user, count, species, conc, conc_dim, tempc, ph, species_length);
+}
+
+// /iface:default /names:default /assume:underscore
+IPQ_DLL_EXPORT int __stdcall DEFINESOLUTIONSF_(int *id, int *nsoln, int *n_user, int *count, char *species, double *conc, int *conc_dim, double *tempc, double *ph, unsigned int species_length)
+{
+	return DefineSolutionsF(id, nsoln, n_user, count, species, conc, conc_dim, tempc, ph, species_length);
+}
+
+// /iface:default /names:lowercase
+IPQ_DLL_EXPORT int __stdcall definesolutionsf(int *id, int *nsoln, int *n_user, int *count, char *species, double *conc, int *conc_dim, double *tempc, double *ph, unsigned int species_length)
+{
+	return DefineSolutionsF(id, nsoln, n_user, count, species, conc, conc_dim, tempc, ph, species_length);
+}
+
+// /iface:default /names:lowercase /assume:underscore
+// /iface:cref /assume:underscore
+IPQ_DLL_EXPORT int __stdcall definesolutionsf_(int *id, int *nsoln, int *n_user, int *count, char *species, double *conc, int *conc_dim, double *tempc, double *ph, unsigned int species_length)
+{
+	return DefineSolutionsF(id, nsoln, n_user, count, species, conc, conc_dim, tempc, ph, species_length);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // MeltPack
@@ -0,0 +1,192 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "IPhreeqcMMS.hpp"
+
+// Runs the same phr_mix-like time steps through RunMixPool with 1, 2
+// and one worker per reservoir and checks that every result is
+// bit-identical.  Each reservoir is mixed twice per step and the order
+// of the reservoirs is reversed every other step, so a worker alternates
+// between groups and a group moves between workers.  The runs use the
+// model cache, the quiescent-mix test, warm starts and kept CVODE
+// Jacobians, whose state carries over from one mix to the next.
+// Usage: test_pool [database]
+
+static const char setup[] =
+  "SOLUTION 1\n"
+  "  pH 5.6\n"
+  "  Ca 0.05\n"
+  "  Na 0.1\n"
+  "  Cl 0.2\n"
+  "SOLUTION 2\n"
+  "  pH 7.8\n"
+  "  Ca 2.0\n"
+  "  Mg 0.8\n"
+  "  Na 1.5\n"
+  "  Cl 1.0\n"
+  "  Alkalinity 4.0\n"
+  "  S(6) 0.5\n"
+  "SOLUTION 11-16\n"
+  "  pH 7.0\n"
+  "  Ca 1.0\n"
+  "  Na 1.0\n"
+  "  Cl 1.0 charge\n"
+  "END\n"
+  "EQUILIBRIUM_PHASES 11\n"
+  "  Calcite 0 0\n"
+  "  CO2(g) -2.5\n"
+  "EQUILIBRIUM_PHASES 13\n"
+  "  Calcite 0 0\n"
+  "EQUILIBRIUM_PHASES 15\n"
+  "  Calcite 0.5 0\n"
+  "  Gypsum 0 0\n"
+  "EXCHANGE 12\n"
+  "  X 0.01\n"
+  "  -equilibrate with solution 12\n"
+  "EXCHANGE 15\n"
+  "  X 0.02\n"
+  "  -equilibrate with solution 15\n"
+  "KINETICS 14\n"
+  "  Calcite\n"
+  "  -m0 0.001\n"
+  "  -parms 5 0.6\n"
+  "  -cvode true\n"
+  "END\n"
+  "SELECTED_OUTPUT\n"
+  "  -reset false\n"
+  "  -pH true\n"
+  "  -temperature true\n"
+  "  -totals Ca Mg Na Cl C(4) S(6)\n"
+  "END\n";
+
+static const int nres   = 6;
+static const int nsteps = 4;
+static const int nconc  = 6;
+
+struct PoolRun
+{
+  std::vector<double> ph, ph_final, tempc, conc, tally;
+};
+
+static int
+run_pool(const char *database, int nworkers, PoolRun &run)
+{
+  IPhreeqcMMS ipq;
+  if (ipq.LoadDatabase(database) != 0 || ipq.RunString(setup) != 0)
+  {
+    std::cerr << ipq.GetErrorString();
+    return EXIT_FAILURE;
+  }
+  int rows, cols;
+  if (ipq.CatchBuildTally() != 1 || ipq.CatchGetTallyRowsColumns(&rows, &cols) != 1)
+  {
+    std::cerr << "test_pool: build_tally_table failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  ipq.SetCvodeJacobianReuseOn(true);
+  ipq.SetWarmStart(true);
+  ipq.SetMixSkipTolerance(1e-9);
+  if (ipq.CreateWorkers(nworkers) != nworkers)
+  {
+    std::cerr << ipq.GetErrorString();
+    return EXIT_FAILURE;
+  }
+
+  int nmix = 2 * nres;
+  size_t nt = (size_t)(rows + 1) * cols;
+  std::vector<MixVars> vars(nmix);
+  std::vector<int> groups(nmix);
+  std::vector< std::vector<int> > solutions(nmix, std::vector<int>(2)), n_user(nmix);
+  std::vector< std::vector<double> > fracs(nmix, std::vector<double>(2));
+  std::vector<double> ph(nmix), ph_final(nmix), tempc(nmix), conc(nmix * nconc);
+  std::vector<double> tally(nmix * nt);
+
+  for (int step = 0; step < nsteps; ++step)
+  {
+    for (int k = 0; k < nmix; ++k)
+    {
+      int r = (step % 2 == 0) ? k % nres : nres - 1 - k % nres;
+      int n = 11 + r;
+      solutions[k][0] = 1 + (step + k / nres) % 2;
+      solutions[k][1] = n;
+      fracs[k][0]     = 0.1 + 0.05 * r;
+      fracs[k][1]     = 1.0 - fracs[k][0];
+      n_user[k].assign(UnKnown, -1);
+      n_user[k][Solution] = n;
+      if (r == 0 || r == 2 || r == 4) n_user[k][Pure_phase] = n;
+      if (r == 1 || r == 4) n_user[k][Exchange] = n;
+      if (r == 3) n_user[k][Kinetics] = n;
+
+      MixVars &v = vars[k];
+      ::memset(&v, 0, sizeof(v));
+      v.id            = -1;
+      v.count         = 2;
+      v.solutions     = &solutions[k][0];
+      v.fracs         = &fracs[k][0];
+      v.index_conserv = 21 + r;
+      v.fill_factor   = 1.0;
+      v.n_user        = &n_user[k][0];
+      v.tempc         = 5.0 + r;
+      v.tsec          = 3600.0;
+      v.array         = &tally[k * nt];
+      v.row_dim       = rows;
+      v.col_dim       = cols;
+      groups[k]       = n;
+
+      // the last reservoir is closed, so its mixes become quiescent
+      if (r == nres - 1)
+      {
+        solutions[k][0] = n;
+        fracs[k][0]     = 1.0;
+        v.count         = 1;
+      }
+    }
+    if (ipq.RunMixPool(nmix, &vars[0], &groups[0], &ph[0], &ph_final[0], &tempc[0], &conc[0], nconc) != 0)
+    {
+      std::cerr << ipq.GetErrorString();
+      return EXIT_FAILURE;
+    }
+    run.ph.insert(run.ph.end(), ph.begin(), ph.end());
+    run.ph_final.insert(run.ph_final.end(), ph_final.begin(), ph_final.end());
+    run.tempc.insert(run.tempc.end(), tempc.begin(), tempc.end());
+    run.conc.insert(run.conc.end(), conc.begin(), conc.end());
+    run.tally.insert(run.tally.end(), tally.begin(), tally.end());
+  }
+  return EXIT_SUCCESS;
+}
+
+static bool
+same(const std::vector<double> &a, const std::vector<double> &b)
+{
+  return a.size() == b.size() && (a.empty() || ::memcmp(&a[0], &b[0], a.size() * sizeof(double)) == 0);
+}
+
+int
+main(int argc, const char* argv[])
+{
+  const char *database = (argc > 1) ? argv[1] : "phreeqc.dat";
+  const int workers[] = { 1, 2, nres };
+
+  PoolRun first;
+  if (run_pool(database, workers[0], first) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  for (size_t i = 1; i < sizeof(workers) / sizeof(workers[0]); ++i)
+  {
+    PoolRun run;
+    if (run_pool(database, workers[i], run) != EXIT_SUCCESS)
+    {
+      return EXIT_FAILURE;
+    }
+    if (!same(first.ph, run.ph) || !same(first.ph_final, run.ph_final) || !same(first.tempc, run.tempc)
+      || !same(first.conc, run.conc) || !same(first.tally, run.tally))
+    {
+      std::cerr << "test_pool: results with " << workers[i] << " workers differ from 1 worker" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}